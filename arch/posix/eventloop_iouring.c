@@ -0,0 +1,1052 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "eventloop_posix.h"
+
+#if defined(UA_ENABLE_EVENTLOOP_IOURING) && defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <endian.h>
+
+/**
+ * io_uring EventLoop
+ * ==================
+ * This EventLoop implementation reuses the generic parts of the "POSIX"
+ * EventLoop (arch/posix/eventloop_posix.c) -- the timer, the delayed-callback
+ * queue, the EventSource lifecycle and the ConnectionManagers (TCP, UDP,
+ * Ethernet, ...) are all shared. What differs is how the EventLoop waits for
+ * file-descriptor readiness: Every registered fd has a poll request in an
+ * io_uring instance. The requests are one-shot and re-armed after their event
+ * was processed. This gives the level-triggered semantics that the
+ * ConnectionManagers expect (e.g. TCP reads at most one buffer per event).
+ *
+ * If the rfd has an accept or receive callback (the TCP ConnectionManager),
+ * the kernel does the I/O instead of signaling readiness. Listen sockets get a
+ * multishot accept request that completes for every new connection. Connection
+ * sockets get a multishot recv request. The kernel receives into a ring of
+ * provided buffers that is shared by all connections. A buffer is handed back
+ * to the kernel after the callback has returned. The poll request then only
+ * covers the other events (e.g. the socket becomes writable). The readiness
+ * callback of the EventSource still handles the end of the stream, errors and
+ * the case when all provided buffers are in use. Multishot accept and the
+ * provided buffers require Linux 5.19, multishot recv Linux 6.0. With older
+ * kernels, the EventLoop falls back to the poll requests.
+ *
+ * New, modified, re-armed and removed poll requests are only queued in the
+ * submission ring. They are submitted together with the wait for the next
+ * completions in a single io_uring_enter system call. The ring is accessed
+ * directly via the kernel interface, so there is no dependency on liburing.
+ * Requires Linux 5.11 (IORING_FEAT_EXT_ARG for the wait timeout). */
+
+#define IOURING_ENTRIES 256
+
+/* Provided buffers for the multishot recv requests */
+#define IOURING_RECVBUFS 32 /* Power of two */
+#define IOURING_RECVBUFSIZE (1u << 16)
+#define IOURING_BUFGROUP 0
+
+/* The user_data of a request points to its UA_IOURingPoll. The following
+ * values are reserved. The completion of poll updates, removals and
+ * cancellations is ignored. Failures are covered by the completion of the
+ * request itself. */
+#define IOURING_TAG_IGNORE 0
+#define IOURING_TAG_SELFPIPE 1
+
+/* Set in the user_data of the multishot request. The poll request of the
+ * same rfd uses the plain pointer. */
+#define IOURING_TAG_MULTISHOT 1
+
+typedef struct UA_IOURingPoll {
+    LIST_ENTRY(UA_IOURingPoll) pointers;
+    UA_RegisteredFD *rfd;    /* NULL after the fd was deregistered */
+    UA_Boolean armed;        /* A poll request is pending in the kernel */
+    UA_Boolean multishot;    /* A multishot accept/recv is pending */
+    UA_Byte multishotOp;     /* IORING_OP_ACCEPT or IORING_OP_RECV */
+    UA_Boolean dispatching;  /* The event callback of the rfd is executing */
+} UA_IOURingPoll;
+
+typedef struct {
+    int fd;
+
+    /* Submission queue. Only the EventLoop (with the lock) writes to it. */
+    void *sqRing;
+    size_t sqRingSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqArray;
+    unsigned sqMask;
+    unsigned sqEntries;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    /* Completion queue */
+    void *cqRing;
+    size_t cqRingSize;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    struct io_uring_cqe *cqes;
+
+    /* The EventLoop thread waits in io_uring_enter without holding the lock.
+     * Requests queued by other threads in the meantime are submitted right
+     * away. */
+    UA_Boolean waiting;
+
+    /* All poll requests, including those waiting for their cancellation */
+    LIST_HEAD(, UA_IOURingPoll) polls;
+
+    /* Ring of provided buffers for multishot recv. NULL if the kernel does not
+     * support it. */
+    struct io_uring_buf_ring *bufRing;
+    size_t bufRingSize;
+    UA_Byte *bufs;
+    UA_UInt16 bufTail;
+
+    /* Use multishot requests for the rfds with an accept/recv callback.
+     * Disabled if the kernel rejects them. */
+    UA_Boolean multishotAccept;
+    UA_Boolean multishotRecv;
+} UA_IOURing;
+
+/*********************/
+/* Ring Interactions */
+/*********************/
+
+static int
+iouringSetup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int
+iouringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags,
+             void *arg, size_t argSize) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                        flags, arg, argSize);
+}
+
+static int
+iouringRegister(int fd, unsigned opcode, void *arg, unsigned nrArgs) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+static void
+deleteRing(UA_IOURing *ring) {
+    /* Close the connections that were accepted but not yet processed */
+    if(ring->cqes) {
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        for(; head != tail; head++) {
+            const struct io_uring_cqe *cqe = &ring->cqes[head & ring->cqMask];
+            if(cqe->user_data <= IOURING_TAG_SELFPIPE ||
+               !(cqe->user_data & IOURING_TAG_MULTISHOT) || cqe->res < 0)
+                continue;
+            UA_IOURingPoll *poll = (UA_IOURingPoll*)(uintptr_t)
+                (cqe->user_data & ~(UA_UInt64)IOURING_TAG_MULTISHOT);
+            if(poll->multishotOp == IORING_OP_ACCEPT)
+                UA_close((UA_FD)cqe->res);
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    /* Free the remaining poll requests. Closing the ring fd cancels them in
+     * the kernel. */
+    UA_IOURingPoll *poll, *poll_tmp;
+    LIST_FOREACH_SAFE(poll, &ring->polls, pointers, poll_tmp) {
+        if(poll->rfd)
+            poll->rfd->iouringPoll = NULL;
+        LIST_REMOVE(poll, pointers);
+        UA_free(poll);
+    }
+
+    if(ring->sqes)
+        munmap(ring->sqes, ring->sqesSize);
+    if(ring->cqRing && ring->cqRing != ring->sqRing)
+        munmap(ring->cqRing, ring->cqRingSize);
+    if(ring->sqRing)
+        munmap(ring->sqRing, ring->sqRingSize);
+    if(ring->fd >= 0)
+        UA_close(ring->fd);
+
+    /* The provided buffers are released with the ring fd */
+    if(ring->bufRing)
+        munmap(ring->bufRing, ring->bufRingSize);
+    UA_free(ring->bufs);
+    UA_free(ring);
+}
+
+/* Hand the buffer (back) to the kernel for the next multishot recv */
+static void
+recycleBuffer(UA_IOURing *ring, UA_UInt16 bid) {
+    struct io_uring_buf *buf =
+        &ring->bufRing->bufs[ring->bufTail & (IOURING_RECVBUFS - 1)];
+    buf->addr = (UA_UInt64)(uintptr_t)
+        (ring->bufs + (size_t)bid * IOURING_RECVBUFSIZE);
+    buf->len = IOURING_RECVBUFSIZE;
+    buf->bid = bid;
+    ring->bufTail++;
+    __atomic_store_n(&ring->bufRing->tail, ring->bufTail, __ATOMIC_RELEASE);
+}
+
+/* Register the provided buffers. Multishot requests are only used if this
+ * succeeds (Linux 5.19). */
+static void
+setupBufRing(UA_EventLoopPOSIX *el, UA_IOURing *ring) {
+    ring->bufRingSize = IOURING_RECVBUFS * sizeof(struct io_uring_buf);
+    void *bufRing = mmap(NULL, ring->bufRingSize, PROT_READ | PROT_WRITE,
+                         MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(bufRing == MAP_FAILED)
+        return;
+    ring->bufs = (UA_Byte*)UA_malloc(IOURING_RECVBUFS * IOURING_RECVBUFSIZE);
+    if(!ring->bufs) {
+        munmap(bufRing, ring->bufRingSize);
+        return;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(struct io_uring_buf_reg));
+    reg.ring_addr = (UA_UInt64)(uintptr_t)bufRing;
+    reg.ring_entries = IOURING_RECVBUFS;
+    reg.bgid = IOURING_BUFGROUP;
+    if(iouringRegister(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                    "Eventloop\t| The io_uring of the kernel does not support "
+                    "provided buffers (Linux 5.19 or newer). "
+                    "Multishot accept/recv is not used.");
+        munmap(bufRing, ring->bufRingSize);
+        UA_free(ring->bufs);
+        ring->bufs = NULL;
+        return;
+    }
+
+    ring->bufRing = (struct io_uring_buf_ring*)bufRing;
+    for(UA_UInt16 i = 0; i < IOURING_RECVBUFS; i++)
+        recycleBuffer(ring, i);
+    ring->multishotAccept = true;
+    ring->multishotRecv = true;
+}
+
+static void *
+mapRing(int fd, size_t size, off_t offset) {
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, offset);
+    return (ptr == MAP_FAILED) ? NULL : ptr;
+}
+
+static UA_IOURing *
+newRing(UA_EventLoopPOSIX *el) {
+    UA_IOURing *ring = (UA_IOURing*)UA_calloc(1, sizeof(UA_IOURing));
+    if(!ring)
+        return NULL;
+    LIST_INIT(&ring->polls);
+
+    /* The completion queue is larger. So that the completions of many
+     * connections can be collected while the EventLoop is busy. */
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(struct io_uring_params));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = IOURING_ENTRIES * 4;
+    ring->fd = iouringSetup(IOURING_ENTRIES, &p);
+    if(ring->fd < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not create the io_uring (%s)",
+                          errno_str));
+        UA_free(ring);
+        return NULL;
+    }
+
+    if(!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| The io_uring of the kernel does not support "
+                       "the required features (Linux 5.11 or newer)");
+        deleteRing(ring);
+        return NULL;
+    }
+
+    /* Map the rings into user space */
+    ring->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        if(ring->cqRingSize > ring->sqRingSize)
+            ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = ring->sqRingSize;
+    }
+    ring->sqRing = mapRing(ring->fd, ring->sqRingSize, IORING_OFF_SQ_RING);
+    if(ring->sqRing && (p.features & IORING_FEAT_SINGLE_MMAP))
+        ring->cqRing = ring->sqRing;
+    else if(ring->sqRing)
+        ring->cqRing = mapRing(ring->fd, ring->cqRingSize, IORING_OFF_CQ_RING);
+    ring->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)
+        mapRing(ring->fd, ring->sqesSize, IORING_OFF_SQES);
+    if(!ring->sqRing || !ring->cqRing || !ring->sqes) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not map the io_uring (%s)",
+                          errno_str));
+        deleteRing(ring);
+        return NULL;
+    }
+
+    char *sq = (char*)ring->sqRing;
+    ring->sqHead = (unsigned*)(sq + p.sq_off.head);
+    ring->sqTail = (unsigned*)(sq + p.sq_off.tail);
+    ring->sqArray = (unsigned*)(sq + p.sq_off.array);
+    ring->sqMask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    ring->sqEntries = *(unsigned*)(sq + p.sq_off.ring_entries);
+
+    char *cq = (char*)ring->cqRing;
+    ring->cqHead = (unsigned*)(cq + p.cq_off.head);
+    ring->cqTail = (unsigned*)(cq + p.cq_off.tail);
+    ring->cqMask = *(unsigned*)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    setupBufRing(el, ring);
+    return ring;
+}
+
+/* Queued requests that were not yet consumed by the kernel */
+static unsigned
+pendingRequests(const UA_IOURing *ring) {
+    return *ring->sqTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+}
+
+static void
+submitRequests(UA_EventLoopPOSIX *el, UA_IOURing *ring) {
+    unsigned toSubmit = pendingRequests(ring);
+    if(toSubmit == 0)
+        return;
+    int ret = iouringEnter(ring->fd, toSubmit, 0, 0, NULL, 0);
+    if(ret < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not submit to the io_uring (%s)",
+                          errno_str));
+    }
+}
+
+static UA_StatusCode
+queueRequest(UA_EventLoopPOSIX *el, UA_IOURing *ring,
+             const struct io_uring_sqe *req) {
+    /* The submission queue is full. Submit the queued requests first. */
+    if(pendingRequests(ring) >= ring->sqEntries) {
+        submitRequests(el, ring);
+        if(pendingRequests(ring) >= ring->sqEntries)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* Copy into the next slot and publish the new tail */
+    unsigned tail = *ring->sqTail;
+    unsigned idx = tail & ring->sqMask;
+    ring->sqes[idx] = *req;
+    ring->sqArray[idx] = idx;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    /* The EventLoop thread is blocked in io_uring_enter. Submit now so that
+     * the request does not wait for the next iteration. */
+    if(ring->waiting)
+        submitRequests(el, ring);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_UInt32
+pollEvents(short listenEvents) {
+    UA_UInt32 events = 0;
+    if(listenEvents & UA_FDEVENT_IN)
+        events |= POLLIN;
+    if(listenEvents & UA_FDEVENT_OUT)
+        events |= POLLOUT;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    /* The kernel expects the 32bit poll mask with swapped 16bit halves */
+    events = (events << 16) | (events >> 16);
+#endif
+    return events;
+}
+
+static UA_StatusCode
+armPoll(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_FD fd,
+        UA_UInt32 events, UA_UInt64 userData) {
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(struct io_uring_sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = events;
+    sqe.user_data = userData;
+    return queueRequest(el, ring, &sqe);
+}
+
+/* Incoming connections/data of the rfd are handled by a multishot request */
+static UA_Boolean
+useMultishot(const UA_IOURing *ring, const UA_RegisteredFD *rfd) {
+    return (rfd->acceptCB && ring->multishotAccept) ||
+        (rfd->recvCB && ring->multishotRecv);
+}
+
+/* The events of the poll request. Without the in-event if that is covered by
+ * the multishot request. */
+static short
+pollListenEvents(const UA_IOURing *ring, const UA_RegisteredFD *rfd) {
+    if(useMultishot(ring, rfd))
+        return rfd->listenEvents & ~UA_FDEVENT_IN;
+    return rfd->listenEvents;
+}
+
+static UA_StatusCode
+armMultishot(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll) {
+    UA_RegisteredFD *rfd = poll->rfd;
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(struct io_uring_sqe));
+    sqe.fd = rfd->fd;
+    sqe.user_data = (UA_UInt64)(uintptr_t)poll | IOURING_TAG_MULTISHOT;
+    if(rfd->acceptCB) {
+        sqe.opcode = IORING_OP_ACCEPT;
+        sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    } else {
+        /* The kernel selects a buffer from the group for every completion */
+        sqe.opcode = IORING_OP_RECV;
+        sqe.ioprio = IORING_RECV_MULTISHOT;
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = IOURING_BUFGROUP;
+    }
+    UA_StatusCode res = queueRequest(el, ring, &sqe);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    poll->multishot = true;
+    poll->multishotOp = sqe.opcode;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+cancelMultishot(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll) {
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(struct io_uring_sqe));
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.addr = (UA_UInt64)(uintptr_t)poll | IOURING_TAG_MULTISHOT;
+    sqe.user_data = IOURING_TAG_IGNORE;
+    return queueRequest(el, ring, &sqe);
+}
+
+/* Arm the requests of the rfd that are not pending with the current events.
+ * Errors and hangups are always signaled by the kernel. */
+static void
+armRegisteredFD(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll) {
+    UA_RegisteredFD *rfd = poll->rfd;
+    if(!poll->multishot && (rfd->listenEvents & UA_FDEVENT_IN) &&
+       useMultishot(ring, rfd) &&
+       armMultishot(el, ring, poll) != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| Could not queue the multishot request "
+                       "for fd %u", (unsigned)rfd->fd);
+    }
+
+    short events = pollListenEvents(ring, rfd);
+    if(poll->armed || events == 0)
+        return; /* Armed when modifyFD selects the events */
+    UA_StatusCode res = armPoll(el, ring, rfd->fd, pollEvents(events),
+                                (UA_UInt64)(uintptr_t)poll);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| Could not queue the poll request for fd %u",
+                       (unsigned)rfd->fd);
+        return;
+    }
+    poll->armed = true;
+}
+
+/* Remove the pending poll request. Or update its events in place. */
+static UA_StatusCode
+updatePoll(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll,
+           UA_Boolean remove) {
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(struct io_uring_sqe));
+    sqe.opcode = IORING_OP_POLL_REMOVE;
+    sqe.addr = (UA_UInt64)(uintptr_t)poll;
+    sqe.user_data = IOURING_TAG_IGNORE;
+    if(!remove) {
+        sqe.len = IORING_POLL_UPDATE_EVENTS;
+        sqe.poll32_events = pollEvents(pollListenEvents(ring, poll->rfd));
+    }
+    return queueRequest(el, ring, &sqe);
+}
+
+/**********************/
+/* FD Poll Management */
+/**********************/
+
+static UA_StatusCode
+registerFD_iouring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "Registering fd: %u", (unsigned)rfd->fd);
+
+    UA_IOURing *ring = (UA_IOURing*)el->iouring;
+    if(!ring)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_IOURingPoll *poll = (UA_IOURingPoll*)UA_calloc(1, sizeof(UA_IOURingPoll));
+    if(!poll)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    poll->rfd = rfd;
+    rfd->iouringPoll = poll;
+    LIST_INSERT_HEAD(&ring->polls, poll, pointers);
+    armRegisteredFD(el, ring, poll);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+modifyFD_iouring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOURing *ring = (UA_IOURing*)el->iouring;
+    UA_IOURingPoll *poll = (UA_IOURingPoll*)rfd->iouringPoll;
+    if(!ring || !poll)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Cancel the multishot request if the rfd no longer listens for incoming
+     * connections/data */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(poll->multishot && !(rfd->listenEvents & UA_FDEVENT_IN))
+        res |= cancelMultishot(el, ring, poll);
+
+    /* Update the pending poll request. If it has completed in the meantime,
+     * the update fails. Then the completion re-arms with the new events. */
+    if(poll->armed)
+        res |= updatePoll(el, ring, poll, (pollListenEvents(ring, rfd) == 0));
+
+    /* Arm the requests that are not pending. During the dispatch, this is done
+     * after the callback has returned. */
+    if(!poll->dispatching)
+        armRegisteredFD(el, ring, poll);
+    return res;
+}
+
+static void
+deregisterFD_iouring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "Unregistering fd: %u", (unsigned)rfd->fd);
+
+    UA_IOURingPoll *poll = (UA_IOURingPoll*)rfd->iouringPoll;
+    if(!poll)
+        return;
+    rfd->iouringPoll = NULL;
+    poll->rfd = NULL;
+
+    /* Cancel the pending requests. The poll is freed when the requests
+     * have completed. */
+    UA_IOURing *ring = (UA_IOURing*)el->iouring;
+    if(poll->multishot && cancelMultishot(el, ring, poll) != UA_STATUSCODE_GOOD)
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| Could not cancel the multishot request "
+                       "for fd %u", (unsigned)rfd->fd);
+    if(poll->armed && updatePoll(el, ring, poll, true) != UA_STATUSCODE_GOOD)
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| Could not cancel the poll request "
+                       "for fd %u", (unsigned)rfd->fd);
+
+    /* Freed after the callback returns */
+    if(poll->armed || poll->multishot || poll->dispatching)
+        return;
+
+    LIST_REMOVE(poll, pointers);
+    UA_free(poll);
+}
+
+/*****************/
+/* Event Polling */
+/*****************/
+
+static void
+flushSelfPipe(UA_SOCKET s) {
+    char buf[128];
+    int i;
+    do {
+        i = UA_recv(s, buf, 128, 0);
+    } while(i > 0);
+}
+
+/* Free the poll of a deregistered fd when its last request has completed.
+ * Otherwise re-arm for the next event. */
+static void
+finishCompletion(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll) {
+    if(!poll->rfd) {
+        if(!poll->armed && !poll->multishot && !poll->dispatching) {
+            LIST_REMOVE(poll, pointers);
+            UA_free(poll);
+        }
+        return;
+    }
+
+    /* The rfd is registered for removal. Don't process incoming events any
+     * longer. */
+    if(poll->rfd->dc.callback)
+        return;
+
+    armRegisteredFD(el, ring, poll);
+}
+
+/* Completion of a multishot accept or recv */
+static void
+processMultishot(UA_EventLoopPOSIX *el, UA_IOURing *ring, UA_IOURingPoll *poll,
+                 const struct io_uring_cqe *cqe) {
+    /* More completions follow unless the request has ended */
+    if(!(cqe->flags & IORING_CQE_F_MORE))
+        poll->multishot = false;
+
+    /* The buffer that was selected for the received data */
+    UA_Boolean hasBuffer = ((cqe->flags & IORING_CQE_F_BUFFER) != 0);
+    UA_UInt16 bid = (UA_UInt16)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+    UA_RegisteredFD *rfd = poll->rfd;
+    UA_Boolean accept = (poll->multishotOp == IORING_OP_ACCEPT);
+    if(!rfd || rfd->dc.callback) {
+        /* Deregistered or closing. Drop the new connection/data. */
+        if(accept && cqe->res >= 0)
+            UA_close((UA_FD)cqe->res);
+    } else if(cqe->res > 0 || (accept && cqe->res == 0)) {
+        /* Hand over the new connection/data. The rfd might be deregistered
+         * (and freed) in the callback. */
+        poll->dispatching = true;
+        if(accept) {
+            rfd->acceptCB(rfd->es, rfd, (UA_FD)cqe->res);
+        } else {
+            UA_ByteString buf;
+            buf.data = ring->bufs + (size_t)bid * IOURING_RECVBUFSIZE;
+            buf.length = (size_t)cqe->res;
+            rfd->recvCB(rfd->es, rfd, buf);
+        }
+        poll->dispatching = false;
+    } else if(cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+        /* Not supported by the kernel. Poll for the in-event instead. */
+        UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                    "Eventloop\t| The io_uring of the kernel does not support "
+                    "multishot %s. Fall back to polling.",
+                    accept ? "accept" : "recv");
+        if(accept)
+            ring->multishotAccept = false;
+        else
+            ring->multishotRecv = false;
+        if(poll->armed)
+            updatePoll(el, ring, poll, false);
+    } else if(cqe->res != -ECANCELED) {
+        /* End of the stream, an error or all provided buffers are in use. The
+         * readiness callback of the EventSource handles this with its own
+         * accept/recv. Afterwards the multishot request is re-armed. */
+        poll->dispatching = true;
+        rfd->eventSourceCB(rfd->es, rfd, UA_FDEVENT_IN);
+        poll->dispatching = false;
+    }
+
+    /* The data was processed. Hand the buffer back to the kernel. */
+    if(hasBuffer)
+        recycleBuffer(ring, bid);
+
+    finishCompletion(el, ring, poll);
+}
+
+static void
+processCompletion(UA_EventLoopPOSIX *el, UA_IOURing *ring,
+                  const struct io_uring_cqe *cqe) {
+    if(cqe->user_data == IOURING_TAG_IGNORE)
+        return;
+
+    /* The self-pipe has received */
+    if(cqe->user_data == IOURING_TAG_SELFPIPE) {
+        flushSelfPipe(el->selfpipe[0]);
+        armPoll(el, ring, el->selfpipe[0], pollEvents(UA_FDEVENT_IN),
+                IOURING_TAG_SELFPIPE);
+        return;
+    }
+
+    /* Multishot accept/recv */
+    if(cqe->user_data & IOURING_TAG_MULTISHOT) {
+        UA_IOURingPoll *poll = (UA_IOURingPoll*)(uintptr_t)
+            (cqe->user_data & ~(UA_UInt64)IOURING_TAG_MULTISHOT);
+        processMultishot(el, ring, poll, cqe);
+        return;
+    }
+
+    /* The poll request is done now. Deregistered or closing rfds are not
+     * processed any longer. */
+    UA_IOURingPoll *poll = (UA_IOURingPoll*)(uintptr_t)cqe->user_data;
+    poll->armed = false;
+    UA_RegisteredFD *rfd = poll->rfd;
+    if(!rfd || rfd->dc.callback) {
+        finishCompletion(el, ring, poll);
+        return;
+    }
+
+    /* Get the event. Cancelled requests (modified to listen on no event) and
+     * events that are no longer selected are re-armed. */
+    short revent = 0;
+    if(cqe->res < 0) {
+        if(cqe->res != -ECANCELED)
+            revent = UA_FDEVENT_ERR;
+    } else if((cqe->res & POLLIN) && (rfd->listenEvents & UA_FDEVENT_IN)) {
+        revent = UA_FDEVENT_IN;
+    } else if((cqe->res & POLLOUT) && (rfd->listenEvents & UA_FDEVENT_OUT)) {
+        revent = UA_FDEVENT_OUT;
+    } else if(cqe->res & (POLLERR | POLLHUP | POLLNVAL)) {
+        revent = UA_FDEVENT_ERR;
+    }
+
+    if(revent != 0) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                     "Processing event %u on fd %u", (unsigned)revent,
+                     (unsigned)rfd->fd);
+
+        /* Call the EventSource callback. The rfd might be deregistered (and
+         * freed) in the callback. So we don't touch it afterwards. */
+        poll->dispatching = true;
+        rfd->eventSourceCB(rfd->es, rfd, revent);
+        poll->dispatching = false;
+    }
+
+    finishCompletion(el, ring, poll);
+}
+
+static UA_StatusCode
+pollFDs_iouring(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
+    UA_assert(listenTimeout >= 0);
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOURing *ring = (UA_IOURing*)el->iouring;
+
+    /* Submit the queued requests and wait for the first completion. Don't
+     * wait if completions are already pending. */
+    struct __kernel_timespec ts;
+    ts.tv_sec = listenTimeout / UA_DATETIME_SEC;
+    ts.tv_nsec = (listenTimeout % UA_DATETIME_SEC) * 100;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(struct io_uring_getevents_arg));
+    arg.ts = (UA_UInt64)(uintptr_t)&ts;
+    unsigned pendingCompletions =
+        __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE) - *ring->cqHead;
+    unsigned minComplete = (pendingCompletions > 0 || listenTimeout == 0) ? 0 : 1;
+
+    ring->waiting = true;
+    unsigned toSubmit = pendingRequests(ring);
+    UA_UNLOCK(&el->elMutex);
+    int ret = iouringEnter(ring->fd, toSubmit, minComplete,
+                           IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                           &arg, sizeof(struct io_uring_getevents_arg));
+    UA_LOCK(&el->elMutex);
+    ring->waiting = false;
+
+    /* Timeouts and interrupts are expected */
+    if(ret < 0 && errno != ETIME && errno != EINTR && errno != EBUSY) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Error waiting on the io_uring (%s)",
+                          errno_str));
+    }
+
+    /* Process the completions that have arrived so far. The head is advanced
+     * before the processing. So the slot can be reused right away. */
+    unsigned head = *ring->cqHead;
+    unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+    for(; head != tail; head++) {
+        struct io_uring_cqe cqe = ring->cqes[head & ring->cqMask];
+        __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+        processCompletion(el, ring, &cqe);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/***********************/
+/* EventLoop Lifecycle */
+/***********************/
+
+static void
+checkClosedIOURing(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    UA_EventSource *es = el->eventLoop.eventSources;
+    while(es) {
+        if(es->state != UA_EVENTSOURCESTATE_STOPPED)
+            return;
+        es = es->next;
+    }
+
+    /* Not closed until all delayed callbacks are processed */
+    if(el->delayedHead1 != NULL && el->delayedHead2 != NULL)
+        return;
+
+    /* Close the self-pipe and the ring when everything else is done */
+    UA_close(el->selfpipe[0]);
+    UA_close(el->selfpipe[1]);
+    if(el->iouring) {
+        deleteRing((UA_IOURing*)el->iouring);
+        el->iouring = NULL;
+    }
+
+    /* Dirty-write the state that is const "from the outside" */
+    *(UA_EventLoopState*)(uintptr_t)&el->eventLoop.state =
+        UA_EVENTLOOPSTATE_STOPPED;
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "The EventLoop has stopped");
+}
+
+static UA_StatusCode
+UA_EventLoopIOURING_start(UA_EventLoopPOSIX *el) {
+    UA_LOCK(&el->elMutex);
+
+    if(el->eventLoop.state != UA_EVENTLOOPSTATE_FRESH &&
+       el->eventLoop.state != UA_EVENTLOOPSTATE_STOPPED) {
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "Starting the io_uring EventLoop");
+
+    /* Setting a custom clock source, same parameters as UA_EventLoop_new_POSIX */
+    const UA_Int32 *cs = (const UA_Int32*)
+        UA_KeyValueMap_getScalar(&el->eventLoop.params,
+                                 UA_QUALIFIEDNAME(0, "clock-source"),
+                                 &UA_TYPES[UA_TYPES_INT32]);
+    if(cs)
+        el->clockSource = *cs;
+
+    const UA_Int32 *csm = (const UA_Int32*)
+        UA_KeyValueMap_getScalar(&el->eventLoop.params,
+                                 UA_QUALIFIEDNAME(0, "clock-source-monotonic"),
+                                 &UA_TYPES[UA_TYPES_INT32]);
+    if(csm) {
+        if(el->clockSourceMonotonic != *csm && el->timer.idTree.root) {
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                           "Eventloop\t| Setting a different monotonic clock, "
+                           "but existing timers have been registered with a "
+                           "different clock source");
+        }
+        el->clockSourceMonotonic = *csm;
+    }
+
+    /* Create the self-pipe */
+    int err = UA_EventLoopPOSIX_pipe(el->selfpipe);
+    if(err != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                          "Eventloop\t| Could not create the self-pipe (%s)",
+                          errno_str));
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Create the ring. It always polls the self-pipe. */
+    UA_IOURing *ring = newRing(el);
+    if(!ring) {
+        UA_close(el->selfpipe[0]);
+        UA_close(el->selfpipe[1]);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    el->iouring = ring;
+    armPoll(el, ring, el->selfpipe[0], pollEvents(UA_FDEVENT_IN),
+            IOURING_TAG_SELFPIPE);
+
+    /* Start the EventSources */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    UA_EventSource *es = el->eventLoop.eventSources;
+    while(es) {
+        res |= es->start(es);
+        es = es->next;
+    }
+
+    /* Dirty-write the state that is const "from the outside" */
+    *(UA_EventLoopState*)(uintptr_t)&el->eventLoop.state =
+        UA_EVENTLOOPSTATE_STARTED;
+
+    UA_UNLOCK(&el->elMutex);
+    return res;
+}
+
+static void
+UA_EventLoopIOURING_stop(UA_EventLoopPOSIX *el) {
+    UA_LOCK(&el->elMutex);
+
+    if(el->eventLoop.state != UA_EVENTLOOPSTATE_STARTED) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "The EventLoop is not running, cannot be stopped");
+        UA_UNLOCK(&el->elMutex);
+        return;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "Stopping the io_uring EventLoop");
+
+    /* Set to STOPPING to prevent "normal use" */
+    *(UA_EventLoopState*)(uintptr_t)&el->eventLoop.state =
+        UA_EVENTLOOPSTATE_STOPPING;
+
+    /* Stop all event sources (asynchronous) */
+    UA_EventSource *es = el->eventLoop.eventSources;
+    for(; es; es = es->next) {
+        if(es->state == UA_EVENTSOURCESTATE_STARTING ||
+           es->state == UA_EVENTSOURCESTATE_STARTED) {
+            es->stop(es);
+        }
+    }
+
+    /* Set to STOPPED if all EventSources are already STOPPED */
+    checkClosedIOURing(el);
+
+    UA_UNLOCK(&el->elMutex);
+}
+
+static UA_StatusCode
+UA_EventLoopIOURING_run(UA_EventLoopPOSIX *el, UA_UInt32 timeout) {
+    UA_LOCK(&el->elMutex);
+
+    if(el->executing) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                     "Cannot run EventLoop from the run method itself");
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    el->executing = true;
+
+    if(el->eventLoop.state == UA_EVENTLOOPSTATE_FRESH ||
+       el->eventLoop.state == UA_EVENTLOOPSTATE_STOPPED) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Cannot run a stopped EventLoop");
+        el->executing = false;
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    UA_LOG_TRACE(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                 "Iterate the io_uring EventLoop");
+
+    /* Process cyclic callbacks */
+    UA_DateTime dateBefore =
+        el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+    UA_DateTime dateNext = UA_Timer_process(&el->timer, dateBefore);
+
+    /* Process delayed callbacks. See UA_EventLoopPOSIX_run for the details. */
+    UA_EventLoopPOSIX_processDelayed(el);
+    if(el->delayedHead1 != NULL && el->delayedHead2 != NULL)
+        timeout = 0;
+
+    /* Compute the remaining time */
+    UA_DateTime maxDate = dateBefore + (timeout * UA_DATETIME_MSEC);
+    if(dateNext > maxDate)
+        dateNext = maxDate;
+    UA_DateTime listenTimeout =
+        dateNext - el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+    if(listenTimeout < 0)
+        listenTimeout = 0;
+
+    /* Wait for events on the registered fds */
+    UA_StatusCode rv = UA_STATUSCODE_GOOD;
+    if(el->iouring)
+        rv = pollFDs_iouring(el, listenTimeout);
+
+    /* Check if the last EventSource was successfully stopped */
+    if(el->eventLoop.state == UA_EVENTLOOPSTATE_STOPPING)
+        checkClosedIOURing(el);
+
+    el->executing = false;
+    UA_UNLOCK(&el->elMutex);
+    return rv;
+}
+
+static UA_StatusCode
+UA_EventLoopIOURING_free(UA_EventLoopPOSIX *el) {
+    UA_LOCK(&el->elMutex);
+
+    if(el->eventLoop.state != UA_EVENTLOOPSTATE_STOPPED &&
+       el->eventLoop.state != UA_EVENTLOOPSTATE_FRESH) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Cannot delete a running EventLoop");
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Deregister and delete all the EventSources */
+    while(el->eventLoop.eventSources) {
+        UA_EventSource *es = el->eventLoop.eventSources;
+        UA_EventLoopPOSIX_deregisterEventSource(&el->eventLoop, es);
+        es->free(es);
+    }
+
+    /* Remove the repeated timed callbacks */
+    UA_Timer_clear(&el->timer);
+
+    /* Process remaining delayed callbacks */
+    UA_EventLoopPOSIX_processDelayed(el);
+
+    UA_KeyValueMap_clear(&el->eventLoop.params);
+
+    UA_UNLOCK(&el->elMutex);
+    UA_LOCK_DESTROY(&el->elMutex);
+    UA_free(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+/*************************/
+/* Initialize and Delete */
+/*************************/
+
+UA_EventLoop *
+UA_EventLoop_new_IOURING(const UA_Logger *logger) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)
+        UA_calloc(1, sizeof(UA_EventLoopPOSIX));
+    if(!el)
+        return NULL;
+
+    UA_LOCK_INIT(&el->elMutex);
+    UA_Timer_init(&el->timer);
+
+    /* Initialize the delayed-callback queue */
+    el->delayedTail = &el->delayedHead1;
+    el->delayedHead2 = (UA_DelayedCallback*)0x01; /* sentinel value */
+
+    el->eventLoop.logger = logger;
+
+    /* Initialize the clock source to the default */
+    el->clockSource = CLOCK_REALTIME;
+# ifdef CLOCK_MONOTONIC_RAW
+    el->clockSourceMonotonic = CLOCK_MONOTONIC_RAW;
+# else
+    el->clockSourceMonotonic = CLOCK_MONOTONIC;
+# endif
+
+    /* Set the method pointers for the interface */
+    el->eventLoop.start = (UA_StatusCode (*)(UA_EventLoop*))UA_EventLoopIOURING_start;
+    el->eventLoop.stop = (void (*)(UA_EventLoop*))UA_EventLoopIOURING_stop;
+    el->eventLoop.free = (UA_StatusCode (*)(UA_EventLoop*))UA_EventLoopIOURING_free;
+    el->eventLoop.run = (UA_StatusCode (*)(UA_EventLoop*, UA_UInt32))UA_EventLoopIOURING_run;
+    el->eventLoop.cancel = UA_EventLoopPOSIX_cancel;
+
+    el->eventLoop.dateTime_now = UA_EventLoopPOSIX_DateTime_now;
+    el->eventLoop.dateTime_nowMonotonic =
+        UA_EventLoopPOSIX_DateTime_nowMonotonic;
+    el->eventLoop.dateTime_localTimeUtcOffset =
+        UA_EventLoopPOSIX_DateTime_localTimeUtcOffset;
+
+    el->eventLoop.nextTimer = UA_EventLoopPOSIX_nextTimer;
+    el->eventLoop.addTimer = UA_EventLoopPOSIX_addTimer;
+    el->eventLoop.modifyTimer = UA_EventLoopPOSIX_modifyTimer;
+    el->eventLoop.removeTimer = UA_EventLoopPOSIX_removeTimer;
+    el->eventLoop.addDelayedCallback = UA_EventLoopPOSIX_addDelayedCallback;
+    el->eventLoop.removeDelayedCallback = UA_EventLoopPOSIX_removeDelayedCallback;
+
+    el->eventLoop.registerEventSource = UA_EventLoopPOSIX_registerEventSource;
+    el->eventLoop.deregisterEventSource = UA_EventLoopPOSIX_deregisterEventSource;
+
+    el->eventLoop.lock = UA_EventLoopPOSIX_lock;
+    el->eventLoop.unlock = UA_EventLoopPOSIX_unlock;
+
+    /* Select the io_uring FD polling backend */
+    el->registerFD = registerFD_iouring;
+    el->modifyFD = modifyFD_iouring;
+    el->deregisterFD = deregisterFD_iouring;
+
+    return &el->eventLoop;
+}
+
+#endif /* UA_ENABLE_EVENTLOOP_IOURING && UA_ARCHITECTURE_POSIX && !UA_ARCHITECTURE_LWIP */
@@ -642,12 +642,27 @@ UA_EventLoopPOSIX_allocNetworkBuffer(UA_ConnectionManager *cm,
                                      UA_ByteString *buf,
                                      size_t bufSize) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
-    /* Reuse the static tx buffer; fall back to allocation for larger messages. */
-    if(pcm->txBuffer.length < bufSize)
+    /* Reuse a static tx buffer; fall back to allocation for larger messages.
+     * Several buffers are in use when the chunks of a message are collected
+     * for sending in one batch. */
+    size_t txSize = pcm->txBuffers[0].length;
+    if(txSize < bufSize)
         return UA_ByteString_allocBuffer(buf, bufSize);
-    *buf = pcm->txBuffer;
-    buf->length = bufSize;
-    return UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < UA_POSIX_TXBUFFERS; i++) {
+        if(pcm->txBuffersUsed & (1u << i))
+            continue;
+        UA_ByteString *tx = &pcm->txBuffers[i];
+        if(tx->length != txSize) {
+            UA_ByteString_clear(tx);
+            if(UA_ByteString_allocBuffer(tx, txSize) != UA_STATUSCODE_GOOD)
+                break;
+        }
+        *buf = *tx;
+        buf->length = bufSize;
+        pcm->txBuffersUsed |= (1u << i);
+        return UA_STATUSCODE_GOOD;
+    }
+    return UA_ByteString_allocBuffer(buf, bufSize);
 }
 
 void
@@ -655,10 +670,28 @@ UA_EventLoopPOSIX_freeNetworkBuffer(UA_ConnectionManager *cm,
                                     uintptr_t connectionId,
                                     UA_ByteString *buf) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
-    if(pcm->txBuffer.data == buf->data)
-        UA_ByteString_init(buf);
-    else
-        UA_ByteString_clear(buf);
+    if(buf->data) {
+        for(size_t i = 0; i < UA_POSIX_TXBUFFERS; i++) {
+            if(pcm->txBuffers[i].data != buf->data)
+                continue;
+            UA_ByteString_init(buf);
+            pcm->txBuffersUsed &= ~(1u << i);
+            return;
+        }
+    }
+    UA_ByteString_clear(buf);
+}
+
+UA_Boolean
+UA_EventLoopPOSIX_isStaticBuffer(UA_POSIXConnectionManager *pcm,
+                                 const UA_ByteString *buf) {
+    if(!buf->data)
+        return false;
+    for(size_t i = 0; i < UA_POSIX_TXBUFFERS; i++) {
+        if(pcm->txBuffers[i].data == buf->data)
+            return true;
+    }
+    return false;
 }
 
 UA_StatusCode
@@ -675,10 +708,18 @@ UA_EventLoopPOSIX_allocateStaticBuffers(UA_POSIXConnectionManager *pcm) {
     res |= UA_EventLoopCommon_allocStaticBuffer(&pcm->cm.eventSource.params,
                                                 UA_QUALIFIEDNAME(0, "send-bufsize"),
                                                 (UA_UInt32)pcm->rxBuffer.length,
-                                                &pcm->txBuffer);
+                                                &pcm->txBuffers[0]);
     return res;
 }
 
+void
+UA_EventLoopPOSIX_freeStaticBuffers(UA_POSIXConnectionManager *pcm) {
+    UA_ByteString_clear(&pcm->rxBuffer);
+    for(size_t i = 0; i < UA_POSIX_TXBUFFERS; i++)
+        UA_ByteString_clear(&pcm->txBuffers[i]);
+    pcm->txBuffersUsed = 0;
+}
+
 /******************/
 /* Socket Options */
 /******************/
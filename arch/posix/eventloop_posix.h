@@ -42,6 +42,7 @@ _UA_BEGIN_DECLS
 
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -88,6 +89,7 @@ typedef int SOCKET;
     getnameinfo(sa, salen, host, hostlen, serv, servlen, flags)
 #define UA_poll poll
 #define UA_send send
+#define UA_sendmsg sendmsg
 #define UA_recv recv
 #define UA_sendto sendto
 #define UA_close close
@@ -199,6 +201,16 @@ typedef struct UA_RegisteredFD UA_RegisteredFD;
 
 typedef void (*UA_FDCallback)(UA_EventSource *es, UA_RegisteredFD *rfd, short event);
 
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+/* Completion callbacks for backends that accept and receive on behalf of the
+ * EventSource. They get the newly accepted fd or the received data. The
+ * buffer is reused after the callback returns. */
+typedef void (*UA_FDAcceptCallback)(UA_EventSource *es, UA_RegisteredFD *rfd,
+                                    UA_FD newfd);
+typedef void (*UA_FDRecvCallback)(UA_EventSource *es, UA_RegisteredFD *rfd,
+                                  UA_ByteString buf);
+#endif
+
 struct UA_RegisteredFD {
     UA_DelayedCallback dc; /* Used for async closing. Must be the first member
                             * because the rfd is freed by the delayed callback
@@ -223,6 +235,22 @@ struct UA_RegisteredFD {
      * to it. NULL unless the fd is registered in a GLib-backed EventLoop. */
     void *glibPollFD;
 #endif
+
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+    /* Poll request of the io_uring EventLoop backend
+     * (arch/posix/eventloop_iouring.c). The request can outlive the rfd
+     * until its cancellation has completed in the kernel. */
+    void *iouringPoll;
+
+    /* Optional. If set, the io_uring backend accepts (multishot accept) or
+     * receives (multishot recv into provided buffers) for the fd and calls
+     * these instead of eventSourceCB for UA_FDEVENT_IN. eventSourceCB is
+     * still used for the other events, for the end of the stream, for errors
+     * and as a fallback if the kernel does not support multishot requests.
+     * The other backends ignore them. */
+    UA_FDAcceptCallback acceptCB;
+    UA_FDRecvCallback recvCB;
+#endif
 };
 
 enum ZIP_CMP cmpFD(const UA_FD *a, const UA_FD *b);
@@ -236,15 +264,33 @@ typedef struct UA_DeregisteredListenFD {
 
 typedef LIST_HEAD(UA_DeregisteredListenFDList, UA_DeregisteredListenFD) UA_DeregisteredListenFDList;
 
+/* Number of static send buffers. Enough for the chunks of a message that are
+ * collected for one batched send (see UA_MESSAGECONTEXT_MAXPENDINGCHUNKS). */
+#define UA_POSIX_TXBUFFERS 16
+
 /* All ConnectionManager in the POSIX EventLoop can be cast to
  * UA_ConnectionManagerPOSIX. They carry a sorted tree of their open
  * sockets/file-descriptors. */
 typedef struct {
     UA_ConnectionManager cm;
 
-    /* Statically allocated buffers */
+    /* Statically allocated buffers. The first send buffer is allocated when
+     * the ConnectionManager starts. The others when several send buffers are
+     * handed out at the same time. They are kept until the ConnectionManager
+     * is deleted. */
     UA_ByteString rxBuffer;
-    UA_ByteString txBuffer;
+    UA_ByteString txBuffers[UA_POSIX_TXBUFFERS];
+    UA_UInt32 txBuffersUsed; /* Bitmask of the handed out send buffers */
+
+    /* Maximum number of unsent bytes queued per connection (0 -> unbounded).
+     * Only used by the TCP ConnectionManager. */
+    UA_UInt32 sendQueueLimit;
+
+    /* Maximum number of datagrams received/sent with one system call. Only
+     * used by the UDP ConnectionManager. The rxBuffer then has one slot of
+     * rxBuffer.length / recvBatch bytes per datagram. */
+    UA_UInt32 recvBatch;
+    UA_UInt32 sendBatch;
 
     /* Sorted tree of the FDs */
     size_t fdsSize;
@@ -328,6 +374,12 @@ struct UA_EventLoopPOSIX {
     void *glibSource;  /* GSource* */
 #endif
 
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+    /* io_uring backend state. Only used for EventLoop instances created via
+     * UA_EventLoop_new_IOURING (see arch/posix/eventloop_iouring.c). */
+    void *iouring;
+#endif
+
 #if UA_MULTITHREADING >= 100
     UA_Lock elMutex;
 #endif
@@ -412,6 +464,14 @@ UA_EventLoopPOSIX_unlock(UA_EventLoop *public_el);
 UA_StatusCode
 UA_EventLoopPOSIX_allocateStaticBuffers(UA_POSIXConnectionManager *pcm);
 
+void
+UA_EventLoopPOSIX_freeStaticBuffers(UA_POSIXConnectionManager *pcm);
+
+/* Is the buffer one of the static send buffers? */
+UA_Boolean
+UA_EventLoopPOSIX_isStaticBuffer(UA_POSIXConnectionManager *pcm,
+                                 const UA_ByteString *buf);
+
 UA_StatusCode
 UA_EventLoopPOSIX_allocNetworkBuffer(UA_ConnectionManager *cm,
                                      uintptr_t connectionId,
@@ -17,6 +17,7 @@
 #include <net/ethernet.h> /* ETH_P_*/
 #include <linux/if_packet.h>
 #include <linux/net_tstamp.h> /* txtime */
+#include <sys/mman.h> /* PACKET_MMAP rings */
 
 /* Configuration parameters */
 
@@ -27,7 +28,7 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
-#define ETH_PARAMETERSSIZE 15
+#define ETH_PARAMETERSSIZE 19
 #define ETH_PARAMINDEX_ADDR 0
 #define ETH_PARAMINDEX_LISTEN 1
 #define ETH_PARAMINDEX_IFACE 2
@@ -43,6 +44,10 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
 #define ETH_PARAMINDEX_TXTIME_PICO 12
 #define ETH_PARAMINDEX_TXTIME_DROP 13
 #define ETH_PARAMINDEX_VALIDATE 14
+#define ETH_PARAMINDEX_RING_ENABLE 15
+#define ETH_PARAMINDEX_RING_BLOCKSIZE 16
+#define ETH_PARAMINDEX_RING_BLOCKS 17
+#define ETH_PARAMINDEX_RING_TIMEOUT 18
 
 static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, false},
@@ -60,12 +65,24 @@ static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("txtime-pico")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
     {{0, UA_STRING_STATIC("txtime-drop-late")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
     {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("ring-enable")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("ring-blocksize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("ring-blocks")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("ring-timeout")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     /* Duplicated address parameter with a scalar value required. For the send-socket case. */
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], true, true, false},
 };
 
 #define UA_ETH_MAXHEADERLENGTH (2*ETHER_ADDR_LEN)+4+2+2
 
+/* Defaults for the PACKET_MMAP rings. The frames of the tx ring have a fixed
+ * size that fits a full Ethernet frame with the VLAN tag. */
+#define UA_ETH_RING_BLOCKSIZE (1u << 16)
+#define UA_ETH_RING_BLOCKS 16
+#define UA_ETH_RING_TIMEOUT 1 /* ms until a partially filled rx block is retired */
+#define UA_ETH_RING_FRAMESIZE 2048
+#define UA_ETH_RING_DATAOFFSET (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+
 typedef struct {
     UA_RegisteredFD rfd;
 
@@ -85,6 +102,17 @@ typedef struct {
     unsigned char lengthOffset; /* No length field if zero */
 
     UA_Boolean txtimeEnabled;
+
+    /* Optional PACKET_MMAP ring shared with the kernel. Listen connections use
+     * a TPACKET_V3 rx ring of blocks. Send connections use a TPACKET_V2 tx
+     * ring of fixed-size frames. */
+    UA_Byte *ring;
+    size_t ringSize;
+    size_t blockSize;
+    size_t blocksSize;
+    size_t framesSize;  /* tx ring only */
+    size_t ringPos;     /* Next rx block / next tx frame */
+    UA_Boolean *txClaimed; /* tx frames handed out by allocNetworkBuffer */
 } ETH_FD;
 
 /* The format of a Ethernet address is six groups of hexadecimal digits,
@@ -207,6 +235,205 @@ setETHHeader(unsigned char *buf,
     return (unsigned char)pos;
 }
 
+/*****************/
+/* PACKET_MMAP   */
+/*****************/
+
+static UA_StatusCode
+ETH_setupRing(UA_EventLoopPOSIX *el, ETH_FD *conn,
+              const UA_KeyValueMap *params, UA_Boolean listen) {
+    const UA_Boolean *enable = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_ENABLE].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(!enable || !*enable)
+        return UA_STATUSCODE_GOOD;
+
+    /* The frames of the tx ring are sent without control messages */
+    if(conn->txtimeEnabled) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "ETH %u\t| The tx ring cannot be used with txtime",
+                       (unsigned)conn->rfd.fd);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    UA_UInt32 blockSize = UA_ETH_RING_BLOCKSIZE;
+    UA_UInt32 blocks = UA_ETH_RING_BLOCKS;
+    UA_UInt32 timeout = UA_ETH_RING_TIMEOUT;
+    const UA_UInt32 *p = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_BLOCKSIZE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(p)
+        blockSize = *p;
+    p = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_BLOCKS].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(p)
+        blocks = *p;
+    p = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_TIMEOUT].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(p)
+        timeout = *p;
+
+    /* The block size has to be a multiple of the page size and of the frame
+     * size. Otherwise the kernel rejects the ring. */
+    if(blocks == 0 || blockSize % (UA_UInt32)getpagesize() != 0 ||
+       blockSize % UA_ETH_RING_FRAMESIZE != 0) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "ETH %u\t| Invalid ring configuration with %u blocks "
+                     "of %u bytes", (unsigned)conn->rfd.fd,
+                     (unsigned)blocks, (unsigned)blockSize);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    UA_UInt32 frames = (blockSize / UA_ETH_RING_FRAMESIZE) * blocks;
+
+    UA_RESET_ERRNO;
+    int ret;
+    if(listen) {
+        int version = TPACKET_V3;
+        ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_VERSION,
+                            &version, sizeof(version));
+        if(ret == 0) {
+            struct tpacket_req3 req;
+            memset(&req, 0, sizeof(req));
+            req.tp_block_size = blockSize;
+            req.tp_block_nr = blocks;
+            req.tp_frame_size = UA_ETH_RING_FRAMESIZE;
+            req.tp_frame_nr = frames;
+            req.tp_retire_blk_tov = timeout;
+            ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_RX_RING,
+                                &req, sizeof(req));
+        }
+    } else {
+        /* Frames that cannot be sent are skipped instead of blocking the
+         * ring. Also used to discard claimed frames that are not sent. */
+        int version = TPACKET_V2;
+        int loss = 1;
+        ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_VERSION,
+                            &version, sizeof(version));
+        if(ret == 0)
+            ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_LOSS,
+                                &loss, sizeof(loss));
+        if(ret == 0) {
+            struct tpacket_req req;
+            memset(&req, 0, sizeof(req));
+            req.tp_block_size = blockSize;
+            req.tp_block_nr = blocks;
+            req.tp_frame_size = UA_ETH_RING_FRAMESIZE;
+            req.tp_frame_nr = frames;
+            ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_TX_RING,
+                                &req, sizeof(req));
+        }
+    }
+    if(ret != 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not set up the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    size_t ringSize = (size_t)blockSize * blocks;
+    void *ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, conn->rfd.fd, 0);
+    if(ring == MAP_FAILED) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not map the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    if(!listen) {
+        conn->txClaimed = (UA_Boolean*)UA_calloc(frames, sizeof(UA_Boolean));
+        if(!conn->txClaimed) {
+            munmap(ring, ringSize);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+    }
+
+    conn->ring = (UA_Byte*)ring;
+    conn->ringSize = ringSize;
+    conn->blockSize = blockSize;
+    conn->blocksSize = blocks;
+    conn->framesSize = frames;
+    conn->ringPos = 0;
+
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                "ETH %u\t| Mapped a %s ring with %u blocks of %u bytes",
+                (unsigned)conn->rfd.fd, (listen) ? "rx" : "tx",
+                (unsigned)blocks, (unsigned)blockSize);
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+ETH_freeRing(ETH_FD *conn) {
+    if(!conn->ring)
+        return;
+    munmap(conn->ring, conn->ringSize);
+    conn->ring = NULL;
+    conn->ringSize = 0;
+    UA_free(conn->txClaimed);
+    conn->txClaimed = NULL;
+}
+
+static UA_Boolean
+ETH_isRingBuffer(const ETH_FD *conn, const UA_ByteString *buf) {
+    return (conn->ring && buf->data >= conn->ring &&
+            buf->data < conn->ring + conn->ringSize);
+}
+
+static struct tpacket2_hdr *
+ETH_txFrame(const ETH_FD *conn, size_t index) {
+    return (struct tpacket2_hdr*)&conn->ring[index * UA_ETH_RING_FRAMESIZE];
+}
+
+/* Claim the next tx frame if it is neither used by the kernel nor handed out
+ * already. The frames are claimed in the ring order. So they are sent in the
+ * order of the allocation. */
+static UA_Byte *
+ETH_claimTxFrame(ETH_FD *conn) {
+    size_t index = conn->ringPos;
+    struct tpacket2_hdr *hdr = ETH_txFrame(conn, index);
+    if(conn->txClaimed[index] ||
+       __atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE)
+        return NULL;
+    conn->txClaimed[index] = true;
+    conn->ringPos = (index + 1) % conn->framesSize;
+    return (UA_Byte*)hdr;
+}
+
+/* Hand the frame over to the kernel. The buffer includes the Ethernet
+ * header. */
+static void
+ETH_submitTxFrame(ETH_FD *conn, const UA_ByteString *buf) {
+    size_t index = (size_t)(buf->data - conn->ring) / UA_ETH_RING_FRAMESIZE;
+    struct tpacket2_hdr *hdr = ETH_txFrame(conn, index);
+    hdr->tp_len = (__u32)buf->length;
+    conn->txClaimed[index] = false;
+    __atomic_store_n(&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+}
+
+/* Return a claimed frame that is not sent. The last claimed frame is
+ * unclaimed. Earlier frames cannot be skipped by the kernel. They are
+ * submitted with a zero length and dropped by the kernel (PACKET_LOSS). */
+static void
+ETH_releaseTxFrame(ETH_FD *conn, const UA_ByteString *buf) {
+    size_t index = (size_t)(buf->data - conn->ring) / UA_ETH_RING_FRAMESIZE;
+    size_t last = (conn->ringPos + conn->framesSize - 1) % conn->framesSize;
+    if(index == last) {
+        conn->txClaimed[index] = false;
+        conn->ringPos = index;
+        return;
+    }
+    UA_ByteString empty = {0, buf->data};
+    ETH_submitTxFrame(conn, &empty);
+}
+
 static UA_StatusCode
 ETH_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
                        UA_ByteString *buf, size_t bufSize) {
@@ -217,6 +444,18 @@ ETH_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     if(!erfd)
         return UA_STATUSCODE_BADCONNECTIONREJECTED;
 
+    /* Use the next frame of the tx ring. The message is then written in place
+     * and doesn't need to be copied when sending. */
+    if(erfd->txClaimed &&
+       bufSize + erfd->headerSize <= UA_ETH_RING_FRAMESIZE - UA_ETH_RING_DATAOFFSET) {
+        UA_Byte *frame = ETH_claimTxFrame(erfd);
+        if(frame) {
+            buf->data = frame + UA_ETH_RING_DATAOFFSET + erfd->headerSize;
+            buf->length = bufSize;
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
     /* Allocate the buffer with the hidden Ethernet header in front */
     UA_StatusCode res =
         UA_EventLoopPOSIX_allocNetworkBuffer(cm, connectionId, buf,
@@ -241,6 +480,11 @@ ETH_freeNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     /* Unhide the Ethernet header and free */
     buf->data   -= erfd->headerSize;
     buf->length += erfd->headerSize;
+    if(ETH_isRingBuffer(erfd, buf)) {
+        ETH_releaseTxFrame(erfd, buf);
+        UA_ByteString_init(buf);
+        return;
+    }
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
 }
 
@@ -283,7 +527,8 @@ ETH_close(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
                         UA_CONNECTIONSTATE_CLOSING,
                         &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
 
-    /* Close the socket */
+    /* Unmap the ring and close the socket */
+    ETH_freeRing(conn);
     UA_RESET_ERRNO;
     int ret = UA_close(conn->rfd.fd);
     if(ret == 0) {
@@ -318,6 +563,95 @@ ETH_delayedClose(void *application, void *context) {
     UA_free(conn);
 }
 
+/* Parse the Ethernet header and forward the frame to the application. The
+ * VLAN tag can be stripped from the frame and reported separately. */
+static void
+ETH_deliverFrame(UA_ConnectionManager *cm, ETH_FD *conn,
+                 UA_ByteString frame, const UA_UInt16 *vlanTci) {
+    /* Parse the Ethernet header */
+    unsigned char destAddr[ETHER_ADDR_LEN];
+    unsigned char sourceAddr[ETHER_ADDR_LEN];
+    UA_UInt16 etherType = 0;
+    UA_UInt16 vid = 0;
+    UA_Byte pcp = 0;
+    UA_Boolean dei = 0;
+    size_t headerSize = parseETHHeader(&frame, destAddr, sourceAddr,
+                                       &etherType, &vid, &pcp, &dei);
+    if(headerSize == 0)
+        return;
+    if(vlanTci && vid == 0) {
+        pcp = (*vlanTci >> 13) & 0x07;
+        dei = (*vlanTci >> 12) & 0x01;
+        vid = *vlanTci & 0x0FFF;
+    }
+
+    /* Set up the parameter arguments passed to the application */
+    unsigned char destAddrBytes[18];
+    unsigned char sourceAddrBytes[18];
+    setAddrString(destAddrBytes, destAddr);
+    setAddrString(sourceAddrBytes, sourceAddr);
+    UA_String destAddrStr = {17, destAddrBytes};
+    UA_String sourceAddrStr = {17, sourceAddrBytes};
+
+    size_t paramsSize = 2;
+    UA_KeyValuePair params[6];
+    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
+    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
+    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+
+    if(etherType > 0) {
+        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+        UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+        paramsSize++;
+    }
+
+    if(vid > 0) {
+        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
+        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
+        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
+        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
+        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
+        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        paramsSize += 3;
+    }
+
+    /* Callback to the application layer with the Ethernet header hidden */
+    UA_KeyValueMap map = {paramsSize, params};
+    frame.data += headerSize;
+    frame.length -= headerSize;
+    conn->applicationCB(cm, (uintptr_t)conn->rfd.fd, conn->application,
+                        &conn->context, UA_CONNECTIONSTATE_ESTABLISHED,
+                        &map, frame);
+}
+
+/* Forward the frames of all retired blocks directly from the rx ring. Then
+ * return the blocks to the kernel. */
+static void
+ETH_receiveRing(UA_ConnectionManager *cm, ETH_FD *conn) {
+    for(size_t i = 0; i < conn->blocksSize; i++) {
+        struct tpacket_block_desc *bd = (struct tpacket_block_desc*)
+            &conn->ring[conn->ringPos * conn->blockSize];
+        if(!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+             TP_STATUS_USER))
+            return;
+
+        struct tpacket3_hdr *ppd = (struct tpacket3_hdr*)
+            ((UA_Byte*)bd + bd->hdr.bh1.offset_to_first_pkt);
+        for(UA_UInt32 j = 0; j < bd->hdr.bh1.num_pkts; j++) {
+            UA_ByteString frame = {ppd->tp_snaplen, (UA_Byte*)ppd + ppd->tp_mac};
+            UA_UInt16 tci = (UA_UInt16)ppd->hv1.tp_vlan_tci;
+            ETH_deliverFrame(cm, conn, frame,
+                             (ppd->tp_status & TP_STATUS_VLAN_VALID) ? &tci : NULL);
+            ppd = (struct tpacket3_hdr*)((UA_Byte*)ppd + ppd->tp_next_offset);
+        }
+
+        __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+                         __ATOMIC_RELEASE);
+        conn->ringPos = (conn->ringPos + 1) % conn->blocksSize;
+    }
+}
+
 /* Gets called when a socket receives data or closes */
 static void
 ETH_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
@@ -338,6 +672,12 @@ ETH_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
         return;
     }
 
+    /* Receive from the rx ring without a system call */
+    if(conn->ring) {
+        ETH_receiveRing(cm, conn);
+        return;
+    }
+
     /* Use the already allocated receive-buffer */
     UA_ByteString response = pcm->rxBuffer;
 
@@ -368,58 +708,7 @@ ETH_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
                  (unsigned)rfd->fd, (unsigned)ret);
 
     response.length = (size_t)ret;
-
-    /* Parse the Ethernet header */
-    unsigned char destAddr[ETHER_ADDR_LEN];
-    unsigned char sourceAddr[ETHER_ADDR_LEN];
-    UA_UInt16 etherType = 0;
-    UA_UInt16 vid = 0;
-    UA_Byte pcp = 0;
-    UA_Boolean dei = 0;
-    size_t headerSize = parseETHHeader(&response, destAddr, sourceAddr,
-                                       &etherType, &vid, &pcp, &dei);
-    if(headerSize == 0)
-        return;
-
-    /* Set up the parameter arguments passed to the application */
-    unsigned char destAddrBytes[18];
-    unsigned char sourceAddrBytes[18];
-    setAddrString(destAddrBytes, destAddr);
-    setAddrString(sourceAddrBytes, sourceAddr);
-    UA_String destAddrStr = {17, destAddrBytes};
-    UA_String sourceAddrStr = {17, sourceAddrBytes};
-
-    size_t paramsSize = 2;
-    UA_KeyValuePair params[6];
-    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
-    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
-    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-
-    if(etherType > 0) {
-        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
-        UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
-        paramsSize++;
-    }
-
-    if(vid > 0) {
-        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
-        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
-        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
-        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
-        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
-        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
-        paramsSize += 3;
-    }
-
-    /* Callback to the application layer with the Ethernet header hidden */
-    UA_KeyValueMap map = {paramsSize, params};
-    response.data += headerSize;
-    response.length -= headerSize;
-    conn->applicationCB(cm, (uintptr_t)rfd->fd, conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED, &map, response);
-    response.data -= headerSize;
-    response.length += headerSize;
+    ETH_deliverFrame(cm, conn, response, NULL);
 }
 
 static UA_StatusCode
@@ -751,6 +1040,11 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     if(validate || res != UA_STATUSCODE_GOOD)
         goto cleanup;
 
+    /* Map the optional PACKET_MMAP ring */
+    res = ETH_setupRing(el, conn, params, listen && *listen);
+    if(res != UA_STATUSCODE_GOOD)
+        goto cleanup;
+
     /* Register in the EventLoop */
     res = UA_EventLoopPOSIX_registerFD(el, &conn->rfd);
     if(res != UA_STATUSCODE_GOOD)
@@ -768,6 +1062,8 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     return UA_STATUSCODE_GOOD;
 
  cleanup:
+    if(conn)
+        ETH_freeRing(conn);
     UA_close(sockfd);
     UA_free(conn);
     UA_UNLOCK(&el->elMutex);
@@ -891,6 +1187,62 @@ send_txtime(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap *params,
 }
 #endif
 
+/* All frames of a socket with a tx ring are sent from the ring. Buffers that
+ * were not allocated in the ring are copied into the next frame. */
+static UA_StatusCode
+ETH_sendRing(UA_EventLoopPOSIX *el, UA_POSIXConnectionManager *pcm,
+             ETH_FD *conn, const UA_ByteString *buf) {
+    UA_ByteString frameBuf = *buf;
+    if(!ETH_isRingBuffer(conn, buf)) {
+        if(buf->length > UA_ETH_RING_FRAMESIZE - UA_ETH_RING_DATAOFFSET) {
+            UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                         "ETH %u\t| The message of %u bytes exceeds the "
+                         "tx ring frame size", (unsigned)conn->rfd.fd,
+                         (unsigned)buf->length);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+
+        /* Wait for the kernel to release a frame. Fail if all frames are
+         * handed out to the application. */
+        struct pollfd tmp_poll_fd;
+        tmp_poll_fd.fd = conn->rfd.fd;
+        tmp_poll_fd.events = UA_POLLOUT;
+        UA_Byte *frame = ETH_claimTxFrame(conn);
+        for(size_t i = 0; !frame && i < 10; i++) {
+            if(conn->txClaimed[conn->ringPos])
+                break;
+            UA_sendto(conn->rfd.fd, NULL, 0, MSG_DONTWAIT | MSG_NOSIGNAL,
+                      (struct sockaddr*)&conn->sll, sizeof(conn->sll));
+            UA_poll(&tmp_poll_fd, 1, 100);
+            frame = ETH_claimTxFrame(conn);
+        }
+        if(!frame) {
+            UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                         "ETH %u\t| No free frame in the tx ring",
+                         (unsigned)conn->rfd.fd);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+        frameBuf.data = frame + UA_ETH_RING_DATAOFFSET;
+        memcpy(frameBuf.data, buf->data, buf->length);
+    }
+
+    /* Submit the frame and trigger the transmission */
+    ETH_submitTxFrame(conn, &frameBuf);
+    UA_RESET_ERRNO;
+    ssize_t n = UA_sendto(conn->rfd.fd, NULL, 0, MSG_DONTWAIT | MSG_NOSIGNAL,
+                          (struct sockaddr*)&conn->sll, sizeof(conn->sll));
+    if(n < 0 && UA_ERRNO != UA_INTERRUPTED &&
+       UA_ERRNO != UA_WOULDBLOCK && UA_ERRNO != UA_AGAIN) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Send failed with error %s",
+                        (unsigned)conn->rfd.fd, errno_str));
+        ETH_shutdown(pcm, conn);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
@@ -925,11 +1277,25 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                      "ETH %u\t| txtime was not configured for the connection",
                      (unsigned)connectionId);
+        if(ETH_isRingBuffer(conn, buf)) {
+            ETH_releaseTxFrame(conn, buf);
+            UA_ByteString_init(buf);
+        }
         UA_UNLOCK(&el->elMutex);
         UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* Send from the tx ring */
+    if(conn->txClaimed) {
+        UA_StatusCode res = ETH_sendRing(el, pcm, conn, buf);
+        if(ETH_isRingBuffer(conn, buf))
+            UA_ByteString_init(buf);
+        UA_UNLOCK(&el->elMutex);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        return res;
+    }
+
     /* Prevent OS signals when sending to a closed socket */
     int flags = MSG_NOSIGNAL;
 
@@ -1078,8 +1444,7 @@ ETH_eventSourceDelete(UA_EventSource *es) {
     }
 
     UA_KeyValueMap_clear(&cm->eventSource.params);
-    UA_ByteString_clear(&pcm->rxBuffer);
-    UA_ByteString_clear(&pcm->txBuffer);
+    UA_EventLoopPOSIX_freeStaticBuffers(pcm);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
     return UA_STATUSCODE_GOOD;
@@ -12,13 +12,17 @@
 #if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
 
 /* Configuration parameters */
-#define TCP_MANAGERPARAMS 2
+#define TCP_MANAGERPARAMS 3
 
 static UA_KeyValueRestriction tcpManagerParams[TCP_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
-    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-queue-limit")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
+/* Default for the maximum number of unsent bytes queued per connection */
+#define TCP_DEFAULT_SENDQUEUELIMIT (1u << 24) /* 16MB */
+
 #define TCP_PARAMETERSSIZE 5
 #define TCP_PARAMINDEX_ADDR 0
 #define TCP_PARAMINDEX_PORT 1
@@ -34,17 +38,31 @@ static UA_KeyValueRestriction tcpConnectionParams[TCP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("reuse")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
 };
 
+/* Outgoing data that could not be sent right away. The queue is drained when
+ * the socket signals that it is writable again. */
+typedef struct TCP_SendEntry {
+    TAILQ_ENTRY(TCP_SendEntry) pointers;
+    UA_ByteString buf;
+    size_t sent; /* Bytes of the buffer that were already sent */
+} TCP_SendEntry;
+
 typedef struct {
     UA_RegisteredFD rfd;
 
     UA_ConnectionManager_connectionCallback applicationCB;
     void *application;
     void *context;
+
+    TAILQ_HEAD(, TCP_SendEntry) sendQueue;
+    size_t sendQueueSize; /* Unsent bytes in the queue */
 } TCP_FD;
 
 static void
 TCP_shutdown(UA_ConnectionManager *cm, TCP_FD *conn);
 
+static UA_StatusCode
+TCP_flushSendQueue(UA_EventLoopPOSIX *el, TCP_FD *conn);
+
 static UA_StatusCode
 TCP_registerListenSockets(UA_POSIXConnectionManager *pcm, const char *hostname,
                           UA_UInt16 port, void *application, void *context,
@@ -190,6 +208,14 @@ TCP_delayedClose(void *application, void *context) {
         addListenSockets(application);
     }
 
+    /* Drop data that could not be sent before the close */
+    TCP_SendEntry *se, *se_tmp;
+    TAILQ_FOREACH_SAFE(se, &conn->sendQueue, pointers, se_tmp) {
+        TAILQ_REMOVE(&conn->sendQueue, se, pointers);
+        UA_ByteString_clear(&se->buf);
+        UA_free(se);
+    }
+
     UA_String_clear(&conn->rfd.hostname);
     UA_free(conn);
 
@@ -236,6 +262,19 @@ TCP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
      * initiate the connection. So we check manually for error conditions on
      * the socket. */
     if(event == UA_FDEVENT_OUT) {
+        /* Write-Event on an established connection. The socket can take more
+         * of the queued data. */
+        if(conn->rfd.listenEvents & UA_FDEVENT_IN) {
+            if(TCP_flushSendQueue(el, conn) != UA_STATUSCODE_GOOD) {
+                UA_LOG_SOCKET_ERRNO_WRAP(
+                   UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                                "TCP %u\t| Send failed with error %s",
+                                (unsigned)conn->rfd.fd, errno_str));
+                TCP_shutdown(cm, conn);
+            }
+            return;
+        }
+
         int error = getSockError(conn);
         if(error != 0) {
             UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
@@ -261,6 +300,18 @@ TCP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
         return;
     }
 
+    /* Read-events take precedence in the EventLoop. Drain the send queue also
+     * here so that a chatty peer cannot starve the write-events. */
+    if(!TAILQ_EMPTY(&conn->sendQueue) &&
+       TCP_flushSendQueue(el, conn) != UA_STATUSCODE_GOOD) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "TCP %u\t| Send failed with error %s",
+                        (unsigned)conn->rfd.fd, errno_str));
+        TCP_shutdown(cm, conn);
+        return;
+    }
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                  "TCP %u\t| Allocate receive buffer",
                  (unsigned)conn->rfd.fd);
@@ -302,6 +353,41 @@ TCP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
                         &UA_KEYVALUEMAP_NULL, response);
 }
 
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+/* Gets called when the EventLoop backend has received on the connection socket
+ * (io_uring multishot recv). The end of the stream and errors are still
+ * signaled to TCP_connectionSocketCallback. */
+static void
+TCP_connectionSocketReceived(UA_EventSource *es, UA_RegisteredFD *rfd,
+                             UA_ByteString buf) {
+    UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
+    TCP_FD *conn = (TCP_FD*)rfd;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    /* Drain the send queue like for a read-event */
+    if(!TAILQ_EMPTY(&conn->sendQueue) &&
+       TCP_flushSendQueue(el, conn) != UA_STATUSCODE_GOOD) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "TCP %u\t| Send failed with error %s",
+                        (unsigned)conn->rfd.fd, errno_str));
+        TCP_shutdown(cm, conn);
+        return;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Received message of size %u",
+                 (unsigned)conn->rfd.fd, (unsigned)buf.length);
+
+    /* Callback to the application layer */
+    conn->applicationCB(cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &UA_KEYVALUEMAP_NULL, buf);
+}
+#endif
+
 static void *
 removeListenSockets(void *application, UA_RegisteredFD *rfd) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)application;
@@ -366,47 +452,18 @@ removeListenSockets(void *application, UA_RegisteredFD *rfd) {
     return NULL;
 }
 
-/* Gets called when a new connection opens or if the listenSocket is closed */
+/* Set up and register a connection that was accepted on the listen socket */
 static void
-TCP_listenSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd, short event) {
-    /* The event source is a UA_ConnectionManager and the registered FD a
-     * TCP_FD. */
-    UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
-    TCP_FD *conn = (TCP_FD*)rfd;
+TCP_acceptConnection(UA_ConnectionManager *cm, TCP_FD *conn, UA_FD newsockfd,
+                     const struct sockaddr_storage *remote) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
-    UA_LOCK_ASSERT(&el->elMutex);
-
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "TCP %u\t| Callback on server socket",
-                 (unsigned)conn->rfd.fd);
-
-    /* Try to accept a new connection */
-    UA_RESET_ERRNO;
-    struct sockaddr_storage remote;
-    socklen_t remote_size = sizeof(remote);
-    UA_FD newsockfd = UA_accept(conn->rfd.fd, (struct sockaddr*)&remote, &remote_size);
-    if(newsockfd == UA_INVALID_FD) {
-        /* Temporary error -- retry */
-        if(UA_IS_TEMPORARY_ACCEPT_ERROR(UA_ERRNO))
-            return;
-
-        /* Close the listen socket */
-        if(cm->eventSource.state != UA_EVENTSOURCESTATE_STOPPING) {
-            UA_LOG_SOCKET_ERRNO_WRAP(
-                UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                               "TCP %u\t| Error %s, closing the server socket",
-                               (unsigned)conn->rfd.fd, errno_str));
-        }
-
-        TCP_shutdown(cm, conn);
-        return;
-    }
 
     /* Log the name of the remote host */
     UA_RESET_ERRNO;
     char hoststr[UA_MAXHOSTNAME_LENGTH];
-    int get_res = UA_getnameinfo((struct sockaddr *)&remote, sizeof(remote),
+    int get_res = UA_getnameinfo((const struct sockaddr *)remote,
+                                 sizeof(struct sockaddr_storage),
                                  hoststr, sizeof(hoststr),
                                  NULL, 0, NI_NUMERICHOST);
     if(get_res != 0) {
@@ -446,9 +503,13 @@ TCP_listenSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd, short event)
     }
 
     newConn->rfd.fd = newsockfd;
+    TAILQ_INIT(&newConn->sendQueue);
     newConn->rfd.listenEvents = UA_FDEVENT_IN;
     newConn->rfd.es = &cm->eventSource;
     newConn->rfd.eventSourceCB = TCP_connectionSocketCallback;
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+    newConn->rfd.recvCB = TCP_connectionSocketReceived;
+#endif
     newConn->applicationCB = conn->applicationCB;
     newConn->application = conn->application;
     newConn->context = conn->context;
@@ -496,6 +557,64 @@ TCP_listenSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd, short event)
                            &kvm, UA_BYTESTRING_NULL);
 }
 
+/* Gets called when a new connection opens or if the listenSocket is closed */
+static void
+TCP_listenSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd, short event) {
+    /* The event source is a UA_ConnectionManager and the registered FD a
+     * TCP_FD. */
+    UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
+    TCP_FD *conn = (TCP_FD*)rfd;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Callback on server socket",
+                 (unsigned)conn->rfd.fd);
+
+    /* Try to accept a new connection */
+    UA_RESET_ERRNO;
+    struct sockaddr_storage remote;
+    socklen_t remote_size = sizeof(remote);
+    UA_FD newsockfd = UA_accept(conn->rfd.fd, (struct sockaddr*)&remote, &remote_size);
+    if(newsockfd == UA_INVALID_FD) {
+        /* Temporary error -- retry */
+        if(UA_IS_TEMPORARY_ACCEPT_ERROR(UA_ERRNO))
+            return;
+
+        /* Close the listen socket */
+        if(cm->eventSource.state != UA_EVENTSOURCESTATE_STOPPING) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+                UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                               "TCP %u\t| Error %s, closing the server socket",
+                               (unsigned)conn->rfd.fd, errno_str));
+        }
+
+        TCP_shutdown(cm, conn);
+        return;
+    }
+
+    TCP_acceptConnection(cm, conn, newsockfd, &remote);
+}
+
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+/* Gets called when the EventLoop backend has accepted a connection on the
+ * listen socket (io_uring multishot accept) */
+static void
+TCP_listenSocketAccepted(UA_EventSource *es, UA_RegisteredFD *rfd,
+                         UA_FD newsockfd) {
+    UA_ConnectionManager *cm = (UA_ConnectionManager*)es;
+    UA_LOCK_ASSERT(&((UA_EventLoopPOSIX*)cm->eventSource.eventLoop)->elMutex);
+
+    /* The address of the remote side is not part of the completion */
+    struct sockaddr_storage remote;
+    socklen_t remote_size = sizeof(remote);
+    memset(&remote, 0, sizeof(remote));
+    getpeername(newsockfd, (struct sockaddr*)&remote, &remote_size);
+
+    TCP_acceptConnection(cm, (TCP_FD*)rfd, newsockfd, &remote);
+}
+#endif
+
 static UA_StatusCode
 TCP_registerListenSocket(UA_POSIXConnectionManager *pcm, struct addrinfo *ai,
                          const char *hostname, UA_UInt16 port,
@@ -657,9 +776,13 @@ TCP_registerListenSocket(UA_POSIXConnectionManager *pcm, struct addrinfo *ai,
     }
 
     newConn->rfd.fd = listenSocket;
+    TAILQ_INIT(&newConn->sendQueue);
     newConn->rfd.listenEvents = UA_FDEVENT_IN;
     newConn->rfd.es = &pcm->cm.eventSource;
     newConn->rfd.eventSourceCB = TCP_listenSocketCallback;
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+    newConn->rfd.acceptCB = TCP_listenSocketAccepted;
+#endif
     newConn->applicationCB = connectionCallback;
     newConn->application = application;
     newConn->context = context;
@@ -773,6 +896,11 @@ TCP_shutdown(UA_ConnectionManager *cm, TCP_FD *conn) {
         return;
     }
 
+    /* Best-effort sending of the queued data. For example an error message
+     * that is sent right before the connection is closed. */
+    if(!TAILQ_EMPTY(&conn->sendQueue))
+        TCP_flushSendQueue(el, conn);
+
     /* Shutdown the socket to cancel the current select/epoll */
     UA_shutdown(conn->rfd.fd, UA_SHUT_RDWR);
 
@@ -813,64 +941,232 @@ TCP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
-static UA_StatusCode
-TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
-                       const UA_KeyValueMap *params, UA_ByteString *buf) {
-    /* We may not have a lock. But we need not take it. As the connectionId is
-     * the fd, no need to do a lookup and access internal data strucures. */
-
-    /* Prevent OS signals when sending to a closed socket */
-    int flags = MSG_NOSIGNAL;
+/* Maximum number of buffers handed to the kernel in one system call */
+#define TCP_MAXIOV 64
 
-    struct pollfd tmp_poll_fd;
-    tmp_poll_fd.fd = (UA_FD)connectionId;
-    tmp_poll_fd.events = UA_POLLOUT;
+/* Gather-send the buffers as much as possible without blocking. The first
+ * buffer starts at the offset. Returns the number of bytes sent or -1 if the
+ * connection has failed. */
+static ssize_t
+TCP_sendBuffers(UA_FD fd, const UA_ByteString *bufs, size_t bufsSize,
+                size_t offset) {
+    struct iovec iov[TCP_MAXIOV];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(struct msghdr));
+    msg.msg_iov = iov;
 
-    /* Send the full buffer. This may require several calls to send */
     size_t nWritten = 0;
-    do {
-        ssize_t n = 0;
-        do {
-            UA_RESET_ERRNO;
-            UA_LOG_DEBUG(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
-                         "TCP %u\t| Attempting to send", (unsigned)connectionId);
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_send((UA_FD)connectionId,
-                        (const char*)buf->data + nWritten,
-                        bytes_to_send, flags);
-            if(n < 0) {
-                /* An error we cannot recover from? */
-                if(UA_ERRNO != UA_INTERRUPTED && UA_ERRNO != UA_WOULDBLOCK &&
-                   UA_ERRNO != UA_AGAIN)
-                    goto shutdown;
-
-                /* Poll for the socket resources to become available and retry
-                 * (blocking) */
-                int poll_ret;
-                do {
-                    UA_RESET_ERRNO;
-                    poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
-                    if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED)
-                        goto shutdown;
-                } while(poll_ret <= 0);
-            }
-        } while(n < 0);
+    while(bufsSize > 0) {
+        size_t iovSize = 0;
+        size_t iovBytes = 0;
+        for(; iovSize < bufsSize && iovSize < TCP_MAXIOV; iovSize++) {
+            size_t skip = (iovSize == 0) ? offset : 0;
+            iov[iovSize].iov_base = bufs[iovSize].data + skip;
+            iov[iovSize].iov_len = bufs[iovSize].length - skip;
+            iovBytes += iov[iovSize].iov_len;
+        }
+        msg.msg_iovlen = iovSize;
+
+        /* Prevent OS signals when sending to a closed socket */
+        UA_RESET_ERRNO;
+        ssize_t n = UA_sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if(n < 0) {
+            if(UA_ERRNO == UA_INTERRUPTED)
+                continue;
+            if(UA_ERRNO == UA_WOULDBLOCK || UA_ERRNO == UA_AGAIN)
+                break; /* The socket buffer is full */
+            return -1; /* An error we cannot recover from */
+        }
         nWritten += (size_t)n;
-    } while(nWritten < buf->length);
+        if((size_t)n < iovBytes)
+            break; /* Partial send, the socket buffer is full */
+        bufs += iovSize;
+        bufsSize -= iovSize;
+        offset = 0;
+    }
+    return (ssize_t)nWritten;
+}
+
+/* Send out the queued data until the socket is congested. Stop listening for
+ * write-events once the queue is empty. */
+static UA_StatusCode
+TCP_flushSendQueue(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    UA_LOCK_ASSERT(&el->elMutex);
 
-    /* Clean up and return */
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    while(!TAILQ_EMPTY(&conn->sendQueue)) {
+        /* Gather the first entries of the queue */
+        UA_ByteString bufs[TCP_MAXIOV];
+        size_t bufsSize = 0;
+        size_t gathered = 0;
+        TCP_SendEntry *se;
+        TAILQ_FOREACH(se, &conn->sendQueue, pointers) {
+            if(bufsSize == TCP_MAXIOV)
+                break;
+            bufs[bufsSize++] = se->buf;
+            gathered += se->buf.length - se->sent;
+        }
+
+        se = TAILQ_FIRST(&conn->sendQueue);
+        ssize_t n = TCP_sendBuffers(conn->rfd.fd, bufs, bufsSize, se->sent);
+        if(n < 0)
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        conn->sendQueueSize -= (size_t)n;
+
+        /* Remove the entries that were sent completely */
+        size_t remaining = (size_t)n;
+        while(remaining > 0) {
+            se = TAILQ_FIRST(&conn->sendQueue);
+            size_t open = se->buf.length - se->sent;
+            if(remaining < open) {
+                se->sent += remaining;
+                break;
+            }
+            remaining -= open;
+            TAILQ_REMOVE(&conn->sendQueue, se, pointers);
+            UA_ByteString_clear(&se->buf);
+            UA_free(se);
+        }
+
+        /* Wait for the next write-event if not everything could be sent */
+        if((size_t)n < gathered)
+            return UA_STATUSCODE_GOOD;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Send queue drained", (unsigned)conn->rfd.fd);
+
+    if(conn->rfd.listenEvents & UA_FDEVENT_OUT) {
+        conn->rfd.listenEvents = UA_FDEVENT_IN;
+        UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+    }
     return UA_STATUSCODE_GOOD;
+}
+
+/* Queue the unsent remainder of the buffer. Takes ownership of the buffer
+ * unless it is a static tx buffer. Then the remainder is copied. */
+static UA_StatusCode
+TCP_enqueueSend(UA_POSIXConnectionManager *pcm, TCP_FD *conn,
+                UA_ByteString *buf, size_t sent) {
+    TCP_SendEntry *se = (TCP_SendEntry*)UA_malloc(sizeof(TCP_SendEntry));
+    if(!se)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    if(UA_EventLoopPOSIX_isStaticBuffer(pcm, buf)) {
+        UA_StatusCode res = UA_ByteString_allocBuffer(&se->buf, buf->length - sent);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(se);
+            return res;
+        }
+        memcpy(se->buf.data, buf->data + sent, buf->length - sent);
+        se->sent = 0;
+    } else {
+        se->buf = *buf;
+        se->sent = sent;
+        UA_ByteString_init(buf);
+    }
+
+    TAILQ_INSERT_TAIL(&conn->sendQueue, se, pointers);
+    conn->sendQueueSize += se->buf.length - se->sent;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Sending never blocks the EventLoop. What cannot be sent right away is queued
+ * and sent when the socket becomes writable. A peer that does not consume its
+ * data until the send-queue-limit is reached is disconnected. The
+ * BadTcpNotEnoughResources StatusCode is then returned to the SecureChannel.
+ * All buffers of a batch are gathered into as few system calls as possible. */
+static UA_StatusCode
+TCP_sendWithConnectionBatch(UA_ConnectionManager *cm, uintptr_t connectionId,
+                            const UA_KeyValueMap *params,
+                            UA_ByteString *bufs, size_t bufsSize) {
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK(&el->elMutex);
+
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    UA_FD fd = (UA_FD)connectionId;
+    TCP_FD *conn = (TCP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn || conn->rfd.dc.callback) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Cannot send - connection not found or closing",
+                       (unsigned)connectionId);
+        res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+        goto cleanup;
+    }
+
+    /* Send right away if no earlier message is still queued. Find the first
+     * buffer that was not sent completely. */
+    size_t pos = 0;  /* Index of the first unsent buffer */
+    size_t sent = 0; /* Bytes already sent from that buffer */
+    if(TAILQ_EMPTY(&conn->sendQueue)) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Attempting to send %u buffers",
+                     (unsigned)connectionId, (unsigned)bufsSize);
+        ssize_t n = TCP_sendBuffers(fd, bufs, bufsSize, 0);
+        if(n < 0) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)connectionId, errno_str));
+            res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+            goto shutdown;
+        }
+        sent = (size_t)n;
+        while(pos < bufsSize && sent >= bufs[pos].length) {
+            sent -= bufs[pos].length;
+            pos++;
+        }
+        if(pos == bufsSize)
+            goto cleanup;
+    }
+
+    /* The remote side does not keep up. Disconnect instead of buffering
+     * without bounds. A partially sent message cannot be dropped on its own
+     * without breaking the stream. */
+    size_t queued = 0;
+    for(size_t i = pos; i < bufsSize; i++)
+        queued += bufs[i].length;
+    queued -= sent;
+    if(pcm->sendQueueLimit > 0 &&
+       conn->sendQueueSize + queued > pcm->sendQueueLimit) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| The send queue limit of %u bytes is reached. "
+                       "Closing the connection.", (unsigned)connectionId,
+                       (unsigned)pcm->sendQueueLimit);
+        res = UA_STATUSCODE_BADTCPNOTENOUGHRESOURCES;
+        goto shutdown;
+    }
+
+    /* Queue the remainder and wait for the socket to become writable */
+    for(; pos < bufsSize; pos++, sent = 0) {
+        res = TCP_enqueueSend(pcm, conn, &bufs[pos], sent);
+        if(res != UA_STATUSCODE_GOOD)
+            goto shutdown;
+    }
+    if(!(conn->rfd.listenEvents & UA_FDEVENT_OUT)) {
+        conn->rfd.listenEvents |= UA_FDEVENT_OUT;
+        UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+    }
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Queued %u bytes for sending (%u bytes in the queue)",
+                 (unsigned)connectionId, (unsigned)queued,
+                 (unsigned)conn->sendQueueSize);
+    goto cleanup;
 
  shutdown:
-    /* Error -> shutdown the connection  */
-    UA_LOG_SOCKET_ERRNO_WRAP(
-       UA_LOG_ERROR(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
-                    "TCP %u\t| Send failed with error %s",
-                    (unsigned)connectionId, errno_str));
-    TCP_shutdownConnection(cm, connectionId);
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-    return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    TCP_shutdown(cm, conn);
+
+ cleanup:
+    for(size_t i = 0; i < bufsSize; i++)
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, &bufs[i]);
+    UA_UNLOCK(&el->elMutex);
+    return res;
+}
+
+static UA_StatusCode
+TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       const UA_KeyValueMap *params, UA_ByteString *buf) {
+    return TCP_sendWithConnectionBatch(cm, connectionId, params, buf, 1);
 }
 
 /* Create a listen-socket that waits for incoming connections */
@@ -1062,6 +1358,10 @@ TCP_openActiveConnection(UA_POSIXConnectionManager *pcm, const UA_KeyValueMap *p
     newConn->rfd.fd = newSock;
     newConn->rfd.es = &pcm->cm.eventSource;
     newConn->rfd.eventSourceCB = TCP_connectionSocketCallback;
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+    newConn->rfd.recvCB = TCP_connectionSocketReceived;
+#endif
+    TAILQ_INIT(&newConn->sendQueue);
     newConn->rfd.listenEvents = UA_FDEVENT_OUT; /* Switched to _IN once the
                                                  * connection is open */
     newConn->applicationCB = connectionCallback;
@@ -1184,6 +1484,14 @@ TCP_eventSourceStart(UA_EventSource *es) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+    /* Limit for the per-connection send queue */
+    const UA_UInt32 *sendQueueLimit = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 UA_QUALIFIEDNAME(0, "send-queue-limit"),
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    pcm->sendQueueLimit = (sendQueueLimit) ?
+        *sendQueueLimit : TCP_DEFAULT_SENDQUEUELIMIT;
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1235,8 +1543,7 @@ TCP_eventSourceDelete(UA_EventSource *es) {
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
-    UA_ByteString_clear(&pcm->rxBuffer);
-    UA_ByteString_clear(&pcm->txBuffer);
+    UA_EventLoopPOSIX_freeStaticBuffers(pcm);
     UA_KeyValueMap_clear(&cm->eventSource.params);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
@@ -1263,6 +1570,7 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName) {
     cm->cm.allocNetworkBuffer = UA_EventLoopPOSIX_allocNetworkBuffer;
     cm->cm.freeNetworkBuffer = UA_EventLoopPOSIX_freeNetworkBuffer;
     cm->cm.sendWithConnection = TCP_sendWithConnection;
+    cm->cm.sendWithConnectionBatch = TCP_sendWithConnectionBatch;
     cm->cm.closeConnection = TCP_shutdownConnection;
     return &cm->cm;
 }
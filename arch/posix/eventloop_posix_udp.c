@@ -19,13 +19,23 @@
 
 /* Configuration parameters */
 
-#define UDP_MANAGERPARAMS 2
+#define UDP_MANAGERPARAMS 4
 
 static UA_KeyValueRestriction udpManagerParams[UDP_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
-    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("recv-batch")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-batch")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
+/* Batched receiving and sending of datagrams (recvmmsg/sendmmsg) */
+#if defined(__linux__)
+# define UDP_HAVE_MMSG
+#endif
+#define UDP_MAXBATCH 64
+#define UDP_DEFAULT_RECVBATCH 8
+#define UDP_DEFAULT_SENDBATCH 16
+
 #define UDP_PARAMETERSSIZE 9
 #define UDP_PARAMINDEX_LISTEN 0
 #define UDP_PARAMINDEX_ADDR 1
@@ -579,6 +589,51 @@ UDP_delayedClose(void *application, void *context) {
     UA_UNLOCK(&el->elMutex);
 }
 
+/* Forward a received datagram together with its source address and port */
+static void
+UDP_forwardMessage(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
+                   const struct sockaddr_storage *source, UA_ByteString msg) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    /* Extract message source and port */
+    char sourceAddr[64];
+    UA_UInt16 sourcePort;
+    switch(source->ss_family) {
+        case AF_INET:
+            UA_inet_ntop(AF_INET, &((const struct sockaddr_in *)source)->sin_addr,
+                    sourceAddr, 64);
+            sourcePort = htons(((const struct sockaddr_in *)source)->sin_port);
+            break;
+        case AF_INET6:
+            UA_inet_ntop(AF_INET6, &(((const struct sockaddr_in6 *)source)->sin6_addr),
+                    sourceAddr, 64);
+            sourcePort = htons(((const struct sockaddr_in6 *)source)->sin6_port);
+            break;
+        default:
+            sourceAddr[0] = 0;
+            sourcePort = 0;
+    }
+
+    UA_String sourceAddrStr = UA_STRING(sourceAddr);
+    UA_KeyValuePair kvp[2];
+    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
+    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
+    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap kvm = {2, kvp};
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received message of size %u from %s on port %u",
+                 (unsigned)conn->rfd.fd, (unsigned)msg.length,
+                 sourceAddr, sourcePort);
+
+    /* Callback to the application layer */
+    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &kvm, msg);
+}
+
 /* Gets called when a socket receives data or closes */
 static void
 UDP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
@@ -603,18 +658,43 @@ UDP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
         return;
     }
 
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "UDP %u\t| Allocate receive buffer", (unsigned)conn->rfd.fd);
-
-    /* Use the already allocated receive-buffer */
-    UA_ByteString response = pcm->rxBuffer;
-
-    /* Receive */
+    /* Receive. Several datagrams at once with recvmmsg if batching is
+     * enabled. Every datagram gets its own slot in the rx buffer. */
+    UA_UInt32 batch = pcm->recvBatch;
+    if(batch == 0)
+        batch = 1;
+    size_t slotSize = pcm->rxBuffer.length / batch;
+    struct sockaddr_storage sources[UDP_MAXBATCH];
+    size_t lengths[UDP_MAXBATCH];
+    ssize_t ret;
     UA_RESET_ERRNO;
-    struct sockaddr_storage source;
-    socklen_t sourceSize = (socklen_t)sizeof(struct sockaddr_storage);
-    ssize_t ret = UA_recvfrom(conn->rfd.fd, (char*)response.data, response.length,
-                           MSG_DONTWAIT, (struct sockaddr*)&source, &sourceSize);
+#ifdef UDP_HAVE_MMSG
+    if(batch > 1) {
+        struct mmsghdr msgs[UDP_MAXBATCH];
+        struct iovec iovs[UDP_MAXBATCH];
+        memset(msgs, 0, sizeof(struct mmsghdr) * batch);
+        for(size_t i = 0; i < batch; i++) {
+            iovs[i].iov_base = pcm->rxBuffer.data + (i * slotSize);
+            iovs[i].iov_len = slotSize;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &sources[i];
+            msgs[i].msg_hdr.msg_namelen = (socklen_t)sizeof(struct sockaddr_storage);
+        }
+        ret = recvmmsg(conn->rfd.fd, msgs, batch, MSG_DONTWAIT, NULL);
+        for(ssize_t i = 0; i < ret; i++)
+            lengths[i] = msgs[i].msg_len;
+    } else
+#endif
+    {
+        socklen_t sourceSize = (socklen_t)sizeof(struct sockaddr_storage);
+        ret = UA_recvfrom(conn->rfd.fd, (char*)pcm->rxBuffer.data, slotSize,
+                          MSG_DONTWAIT, (struct sockaddr*)&sources[0], &sourceSize);
+        if(ret > 0) {
+            lengths[0] = (size_t)ret;
+            ret = 1;
+        }
+    }
 
     /* Receive has failed */
     if(ret <= 0) {
@@ -632,45 +712,12 @@ UDP_connectionSocketCallback(UA_EventSource *es, UA_RegisteredFD *rfd,
         return;
     }
 
-    response.length = (size_t)ret; /* Set the length of the received buffer */
-
-    /* Extract message source and port */
-    char sourceAddr[64];
-    UA_UInt16 sourcePort;
-    switch(source.ss_family) {
-        case AF_INET:
-            UA_inet_ntop(AF_INET, &((struct sockaddr_in *)&source)->sin_addr,
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in *)&source)->sin_port);
-            break;
-        case AF_INET6:
-            UA_inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)&source)->sin6_addr),
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in6 *)&source)->sin6_port);
-            break;
-        default:
-            sourceAddr[0] = 0;
-            sourcePort = 0;
+    /* Forward the datagrams in the order of reception. Stop if the connection
+     * is closed from within the callback. */
+    for(ssize_t i = 0; i < ret && !conn->rfd.dc.callback; i++) {
+        UA_ByteString response = {lengths[i], pcm->rxBuffer.data + (i * slotSize)};
+        UDP_forwardMessage(pcm, conn, &sources[i], response);
     }
-
-    UA_String sourceAddrStr = UA_STRING(sourceAddr);
-    UA_KeyValuePair kvp[2];
-    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
-    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
-    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
-    UA_KeyValueMap kvm = {2, kvp};
-
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "UDP %u\t| Received message of size %u from %s on port %u",
-                 (unsigned)conn->rfd.fd, (unsigned)ret,
-                 sourceAddr, sourcePort);
-
-    /* Callback to the application layer */
-    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
-                        conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED,
-                        &kvm, response);
 }
 
 static UA_StatusCode
@@ -921,12 +968,51 @@ UDP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Send up to sendBatch datagrams. Returns the number of sent datagrams or -1
+ * with the errno set. */
+static ssize_t
+UDP_sendDatagrams(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
+                  UA_ByteString *bufs, size_t bufsSize) {
+    /* Prevent OS signals when sending to a closed socket */
+    int flags = MSG_NOSIGNAL;
+    UA_RESET_ERRNO;
+#ifdef UDP_HAVE_MMSG
+    size_t batch = (pcm->sendBatch > 0) ? pcm->sendBatch : 1;
+    if(bufsSize > batch)
+        bufsSize = batch;
+    if(bufsSize > 1) {
+        struct mmsghdr msgs[UDP_MAXBATCH];
+        struct iovec iovs[UDP_MAXBATCH];
+        memset(msgs, 0, sizeof(struct mmsghdr) * bufsSize);
+        for(size_t i = 0; i < bufsSize; i++) {
+            iovs[i].iov_base = bufs[i].data;
+            iovs[i].iov_len = bufs[i].length;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &conn->sendAddr;
+            msgs[i].msg_hdr.msg_namelen = conn->sendAddrLength;
+        }
+        return sendmmsg(conn->rfd.fd, msgs, (unsigned)bufsSize, flags);
+    }
+#else
+    (void)pcm;
+    (void)bufsSize;
+#endif
+    ssize_t n = UA_sendto(conn->rfd.fd, (const char*)bufs[0].data,
+                          bufs[0].length, flags, (struct sockaddr*)&conn->sendAddr,
+                          conn->sendAddrLength);
+    return (n < 0) ? n : 1;
+}
+
+/* Every buffer is sent as an individual datagram. If the socket buffer is
+ * full, then we poll (blocking) until the socket can send again. */
 static UA_StatusCode
-UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
-                       const UA_KeyValueMap *params,
-                       UA_ByteString *buf) {
+UDP_sendWithConnectionBatch(UA_ConnectionManager *cm, uintptr_t connectionId,
+                            const UA_KeyValueMap *params,
+                            UA_ByteString *bufs, size_t bufsSize) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
 
     UA_LOCK(&el->elMutex);
 
@@ -934,71 +1020,71 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
     UA_FD fd = (UA_FD)connectionId;
     UDP_FD *conn = (UDP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
     if(!conn) {
-        UA_UNLOCK(&el->elMutex);
-        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-        return UA_STATUSCODE_BADINTERNALERROR;
+        res = UA_STATUSCODE_BADINTERNALERROR;
+        goto cleanup;
     }
 
-    /* Send the full buffer. This may require several calls to send */
-    size_t nWritten = 0;
-    do {
-        ssize_t n = 0;
-        do {
-            UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                         "UDP %u\t| Attempting to send", (unsigned)connectionId);
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Attempting to send %u datagrams",
+                 (unsigned)connectionId, (unsigned)bufsSize);
+
+    size_t pos = 0;
+    while(pos < bufsSize) {
+        ssize_t n = UDP_sendDatagrams(pcm, conn, &bufs[pos], bufsSize - pos);
+        if(n > 0) {
+            pos += (size_t)n;
+            continue;
+        }
 
-            /* Prevent OS signals when sending to a closed socket */
+        /* An error we cannot recover from? */
+        if(UA_ERRNO != UA_INTERRUPTED &&
+           UA_ERRNO != UA_WOULDBLOCK &&
+           UA_ERRNO != UA_AGAIN) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "UDP %u\t| Send failed with error %s",
+                            (unsigned)connectionId, errno_str));
+            res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+            goto shutdown;
+        }
+
+        /* Poll for the socket resources to become available and retry
+         * (blocking) */
+        int poll_ret;
+        struct pollfd tmp_poll_fd;
+        tmp_poll_fd.fd = (UA_FD)connectionId;
+        tmp_poll_fd.events = UA_POLLOUT;
+        do {
             UA_RESET_ERRNO;
-            int flags = MSG_NOSIGNAL;
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_sendto((UA_FD)connectionId, (const char*)buf->data + nWritten,
-                          bytes_to_send, flags, (struct sockaddr*)&conn->sendAddr,
-                          conn->sendAddrLength);
-            if(n < 0) {
-                /* An error we cannot recover from? */
-                if(UA_ERRNO != UA_INTERRUPTED &&
-                   UA_ERRNO != UA_WOULDBLOCK &&
-                   UA_ERRNO != UA_AGAIN) {
-                    UA_LOG_SOCKET_ERRNO_WRAP(
-                       UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                                    "UDP %u\t| Send failed with error %s",
-                                    (unsigned)connectionId, errno_str));
-                    UA_UNLOCK(&el->elMutex);
-                    UDP_shutdownConnection(cm, connectionId);
-                    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-                    return UA_STATUSCODE_BADCONNECTIONCLOSED;
-                }
-
-                /* Poll for the socket resources to become available and retry
-                 * (blocking) */
-                int poll_ret;
-                struct pollfd tmp_poll_fd;
-                tmp_poll_fd.fd = (UA_FD)connectionId;
-                tmp_poll_fd.events = UA_POLLOUT;
-                do {
-                    UA_RESET_ERRNO;
-                    poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
-                    if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
-                        UA_LOG_SOCKET_ERRNO_WRAP(
-                           UA_LOG_ERROR(el->eventLoop.logger,
-                                        UA_LOGCATEGORY_NETWORK,
-                                        "UDP %u\t| Send failed with error %s",
-                                        (unsigned)connectionId, errno_str));
-                        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-                        UDP_shutdown(cm, &conn->rfd);
-                        UA_UNLOCK(&el->elMutex);
-                        return UA_STATUSCODE_BADCONNECTIONCLOSED;
-                    }
-                } while(poll_ret <= 0);
+            poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
+            if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
+                UA_LOG_SOCKET_ERRNO_WRAP(
+                   UA_LOG_ERROR(el->eventLoop.logger,
+                                UA_LOGCATEGORY_NETWORK,
+                                "UDP %u\t| Send failed with error %s",
+                                (unsigned)connectionId, errno_str));
+                res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+                goto shutdown;
             }
-        } while(n < 0);
-        nWritten += (size_t)n;
-    } while(nWritten < buf->length);
+        } while(poll_ret <= 0);
+    }
+    goto cleanup;
+
+ shutdown:
+    UDP_shutdown(cm, &conn->rfd);
 
-    /* Free the buffer */
+ cleanup:
     UA_UNLOCK(&el->elMutex);
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-    return UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < bufsSize; i++)
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, &bufs[i]);
+    return res;
+}
+
+static UA_StatusCode
+UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       const UA_KeyValueMap *params,
+                       UA_ByteString *buf) {
+    return UDP_sendWithConnectionBatch(cm, connectionId, params, buf, 1);
 }
 
 static UA_StatusCode
@@ -1271,11 +1357,47 @@ UDP_eventSourceStart(UA_EventSource *es) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+    /* Get the batch sizes */
+    pcm->recvBatch = UDP_DEFAULT_RECVBATCH;
+    const UA_UInt32 *recvBatch = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 UA_QUALIFIEDNAME(0, "recv-batch"),
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(recvBatch)
+        pcm->recvBatch = *recvBatch;
+    pcm->sendBatch = UDP_DEFAULT_SENDBATCH;
+    const UA_UInt32 *sendBatch = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 UA_QUALIFIEDNAME(0, "send-batch"),
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(sendBatch)
+        pcm->sendBatch = *sendBatch;
+#ifndef UDP_HAVE_MMSG
+    pcm->recvBatch = 1;
+#endif
+    if(pcm->recvBatch == 0)
+        pcm->recvBatch = 1;
+    if(pcm->recvBatch > UDP_MAXBATCH)
+        pcm->recvBatch = UDP_MAXBATCH;
+    if(pcm->sendBatch == 0)
+        pcm->sendBatch = 1;
+    if(pcm->sendBatch > UDP_MAXBATCH)
+        pcm->sendBatch = UDP_MAXBATCH;
+
     /* Allocate the rx buffer */
     res = UA_EventLoopPOSIX_allocateStaticBuffers(pcm);
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+    /* One slot of recv-bufsize per datagram of a receive batch */
+    if(pcm->recvBatch > 1) {
+        size_t slotSize = pcm->rxBuffer.length;
+        UA_ByteString_clear(&pcm->rxBuffer);
+        res = UA_ByteString_allocBuffer(&pcm->rxBuffer, slotSize * pcm->recvBatch);
+        if(res != UA_STATUSCODE_GOOD)
+            goto finish;
+    }
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1327,8 +1449,7 @@ UDP_eventSourceDelete(UA_EventSource *es) {
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
-    UA_ByteString_clear(&pcm->rxBuffer);
-    UA_ByteString_clear(&pcm->txBuffer);
+    UA_EventLoopPOSIX_freeStaticBuffers(pcm);
     UA_KeyValueMap_clear(&cm->eventSource.params);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
@@ -1355,6 +1476,7 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName) {
     cm->cm.allocNetworkBuffer = UA_EventLoopPOSIX_allocNetworkBuffer;
     cm->cm.freeNetworkBuffer = UA_EventLoopPOSIX_freeNetworkBuffer;
     cm->cm.sendWithConnection = UDP_sendWithConnection;
+    cm->cm.sendWithConnectionBatch = UDP_sendWithConnectionBatch;
     cm->cm.closeConnection = UDP_shutdownConnection;
     return &cm->cm;
 }
@@ -442,7 +442,7 @@ UA_Client_Service_queryNext(UA_Client *client,
 
 /* Lookup a datatype by its NodeId. Takes the custom types in the client
  * configuration into account. Return NULL if none found. */
-UA_EXPORT const UA_DataType *
+UA_EXPORT UA_THREADSAFE const UA_DataType *
 UA_Client_findDataType(UA_Client *client, const UA_NodeId *typeId);
 
 /* The string is allocated and needs to be cleared */
@@ -383,6 +383,18 @@ struct UA_ConnectionManager {
     (*sendWithConnection)(UA_ConnectionManager *cm, uintptr_t connectionId,
                           const UA_KeyValueMap *params, UA_ByteString *buf);
 
+    /* Send several messages over a Connection
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * Equivalent to calling sendWithConnection for each buffer in order. But
+     * the ConnectionManager can hand all buffers to the operating system at
+     * once (scatter-gather I/O). Every buffer must have been allocated with
+     * allocNetworkBuffer and is released internally (also if sending fails).
+     * This is optional and can be NULL. */
+    UA_StatusCode
+    (*sendWithConnectionBatch)(UA_ConnectionManager *cm, uintptr_t connectionId,
+                               const UA_KeyValueMap *params,
+                               UA_ByteString *bufs, size_t bufsSize);
+
     /* Close a Connection
      * ~~~~~~~~~~~~~~~~~~
      * When a connection is closed its `connectionCallback` is called with
@@ -515,6 +527,27 @@ UA_EventLoop_new_GLib(const UA_Logger *logger, void *glibMainContext);
 
 #endif /* UA_ENABLE_EVENTLOOP_GLIB */
 
+#ifdef UA_ENABLE_EVENTLOOP_IOURING
+
+/**
+ * io_uring EventLoop Implementation
+ * ---------------------------------
+ * A drop-in alternative to ``UA_EventLoop_new_POSIX`` for Linux (5.11 or
+ * newer) that waits for socket events with io_uring instead of epoll. All
+ * POSIX ConnectionManagers documented below (TCP, UDP, Ethernet, ...) work
+ * unchanged with this EventLoop.
+ *
+ * Every registered socket has a poll request in the io_uring submission
+ * queue. Changes to the registrations and the re-arming of the poll requests
+ * are collected and submitted together with the wait for the next events in
+ * a single system call. This reduces the overhead for servers with many
+ * (mostly idle) connections. The EventLoop parameters are the same as for
+ * ``UA_EventLoop_new_POSIX``. */
+UA_EXPORT UA_EventLoop *
+UA_EventLoop_new_IOURING(const UA_Logger *logger);
+
+#endif /* UA_ENABLE_EVENTLOOP_IOURING */
+
 /**
  * TCP Connection Manager
  * ~~~~~~~~~~~~~~~~~~~~~~
@@ -550,6 +583,13 @@ UA_EventLoop_new_GLib(const UA_Logger *logger, void *glibMainContext);
  *    sending while received data is still being processed is safe. If
  *    undefined, the send buffer defaults to the recv-bufsize.
  *
+ * 0:send-queue-limit [uint32]
+ *    Sending does not block. Data that cannot be sent right away is queued
+ *    and sent once the socket becomes writable. If the unsent data of a
+ *    connection would exceed the limit, then the connection is closed and
+ *    `sendWithConnection` returns BadTcpNotEnoughResources (default 16MB,
+ *    0 -> unbounded).
+ *
  * **Open Connection Parameters:**
  *
  * 0:address [string | array of string]
@@ -616,6 +656,18 @@ UA_ConnectionManager_new_WIN32_TCP(const UA_String eventSourceName);
  *    sending while received data is still being processed is safe. If
  *    undefined, the send buffer defaults to the recv-bufsize.
  *
+ * 0:recv-batch [uint32]
+ *    Maximum number of datagrams that are received with one system call
+ *    (recvmmsg) and forwarded to the connection callback one after the other.
+ *    One buffer of recv-bufsize is allocated per datagram of the batch
+ *    (default: 8, maximum: 64). Only used on Linux. Otherwise one datagram is
+ *    received at a time.
+ *
+ * 0:send-batch [uint32]
+ *    Maximum number of datagrams that `sendWithConnectionBatch` hands to the
+ *    operating system with one system call (sendmmsg) (default: 16, maximum:
+ *    64). Only used on Linux.
+ *
  * **Open Connection Parameters:**
  *
  * 0:listen [boolean]
@@ -740,6 +792,27 @@ UA_ConnectionManager_new_WIN32_UDP(const UA_String eventSourceName);
  *    creating any connection but solely validating the provided parameters
  *    (default: false)
  *
+ * The frames can be exchanged with the kernel through memory-mapped
+ * PACKET_MMAP rings. This avoids a system call and a copy per frame. Listening
+ * connections use a TPACKET_V3 rx ring. The received frames are passed to the
+ * connection callback directly from the ring. Send connections use a tx ring
+ * of 2kB frames. Then `allocNetworkBuffer` returns a frame of the ring. The
+ * tx ring is not used together with txtime.
+ *
+ * 0:ring-enable [bool]
+ *    Use the rx or tx ring for the connection (default: false).
+ *
+ * 0:ring-blocksize [uint32]
+ *    Size of the ring blocks. Must be a multiple of the page size and of 2kB
+ *    (default: 64kB).
+ *
+ * 0:ring-blocks [uint32]
+ *    Number of blocks in the ring (default: 16).
+ *
+ * 0:ring-timeout [uint32]
+ *    Milliseconds after which a partially filled rx block is handed to the
+ *    application (default: 1).
+ *
  * Sending with a txtime (for Time-Sensitive Networking) is possible on recent
  * Linux kernels, If enabled for the socket, then a txtime parameters can be
  * passed to `sendWithConnection`. Note that the clock source for txtime sending
@@ -181,6 +181,16 @@ UA_NodePointer_toExpandedNodeId(UA_NodePointer np);
 UA_NodeId UA_EXPORT
 UA_NodePointer_toNodeId(UA_NodePointer np);
 
+/* Cannot fail. The NodePointer points directly to the node. It remains valid
+ * only as long as the node is retained from the Nodestore. */
+UA_NodePointer UA_EXPORT
+UA_NodePointer_fromNode(const UA_NodeHead *node);
+
+/* Returns the node if the NodePointer points directly to a node. NULL
+ * otherwise. */
+UA_EXPORT const UA_NodeHead *
+UA_NodePointer_getNode(UA_NodePointer np);
+
 /**
  * Base Node Attributes
  * --------------------
@@ -509,7 +519,10 @@ struct UA_Nodestore {
                                UA_BrowseDirection referenceDirections);
 
     /* Similar to the normal _getNode. But it can take advantage of the
-     * NodePointer structure, e.g. if it contains a direct pointer. */
+     * NodePointer structure, e.g. if it contains a direct pointer. A direct
+     * pointer to a node is only used while the node is retained by the caller.
+     * If the node was removed or replaced in the meantime, the current node
+     * with the same NodeId is returned (or NULL). */
     const UA_Node * (*getNodeFromPtr)(UA_Nodestore *ns, UA_NodePointer ptr,
                                       UA_UInt32 attributeMask,
                                       UA_ReferenceTypeSet references,
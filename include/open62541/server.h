@@ -2406,6 +2406,11 @@ struct UA_ServerConfig {
     UA_UInt16 maxSessions;
     UA_Double maxSessionTimeout; /* in ms */
 
+    /* Maximum number of handles from the RegisterNodes service per session.
+     * Beyond the limit, RegisterNodes returns the NodeIds themselves. At most
+     * (and with 0) 65536 handles are possible. The default is 32768. */
+    UA_UInt32 maxRegisteredNodesPerSession;
+
     /* Operation limits */
     UA_UInt32 maxNodesPerRead;
     UA_UInt32 maxNodesPerWrite;
@@ -2434,6 +2439,29 @@ struct UA_ServerConfig {
      * not be touched afterwards. */
     void (*asyncOperationCancelCallback)(UA_Server *server, const void *out);
 
+    /* Service Workers
+     * ~~~~~~~~~~~~~~~
+     * Number of threads for the parallel execution of the read-only services
+     * Read, Browse, BrowseNext and TranslateBrowsePathsToNodeIds. Requests
+     * received in one EventLoop iteration are executed together while the
+     * EventLoop thread holds the server lock. Requires UA_MULTITHREADING >= 100
+     * on a POSIX architecture. Callbacks (e.g. DataSources) executed during
+     * the parallel execution cannot modify the information model or the
+     * Subscriptions. Such calls (e.g. UA_Server_write, UA_Server_addNode,
+     * UA_Server_deleteNode) return BadInvalidState.
+     * 0 => disabled (default), services are executed in the EventLoop. */
+    UA_UInt16 serviceWorkers;
+
+    /* Zero-Copy Read
+     * ~~~~~~~~~~~~~~
+     * Values of variables with an internal value source (and no onRead
+     * callback) that take at least this many bytes in the binary encoding are
+     * not copied into the responses of the Read service. The responses
+     * reference the value in the node until they are sent. If the node is
+     * edited or removed before, the value is copied into the response first.
+     * 0 => disabled (default), the values are always copied. */
+    size_t readZeroCopyThreshold;
+
 #ifdef UA_ENABLE_ENCRYPTION
     /* Limits for TrustList */
     UA_UInt32 maxTrustListSize; /* in bytes, 0 => unlimited */
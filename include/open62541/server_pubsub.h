@@ -548,6 +548,47 @@ UA_Server_getDataSetFieldConfig(UA_Server *server, const UA_NodeId dsfId,
 UA_EXPORT UA_DataSetFieldResult UA_THREADSAFE
 UA_Server_removeDataSetField(UA_Server *server, const UA_NodeId dsfId);
 
+/**
+ * Cycle Statistics
+ * ----------------
+ * The WriterGroups and ReaderGroups record the timing of their publish and
+ * receive cycles. The durations are measured with the monotonic clock of the
+ * EventLoop and collected in histograms with logarithmic buckets. Bucket 0
+ * counts the durations below 1us. Bucket i counts the durations in the range
+ * [2^(i-1), 2^i) us. The last bucket also counts all longer durations. */
+
+#define UA_PUBSUB_HISTOGRAM_BUCKETS 20
+
+typedef struct {
+    UA_UInt64 count;
+    UA_DateTime sum; /* The durations use the 100ns ticks of UA_DateTime */
+    UA_DateTime min;
+    UA_DateTime max;
+    UA_UInt64 buckets[UA_PUBSUB_HISTOGRAM_BUCKETS];
+} UA_PubSubHistogram;
+
+typedef struct {
+    /* Delay of the cyclic publish callback after its scheduled time */
+    UA_PubSubHistogram schedulingLateness;
+    /* Time per publish cycle to sample and encode the NetworkMessages */
+    UA_PubSubHistogram encodeTime;
+    /* Time per publish cycle spent in the ConnectionManager to send */
+    UA_PubSubHistogram sendTime;
+    UA_UInt64 sentNetworkMessages;
+    UA_UInt64 failedNetworkMessages;
+} UA_WriterGroupStatistics;
+
+typedef struct {
+    /* Time to verify, decrypt and decode a received NetworkMessage */
+    UA_PubSubHistogram decodeTime;
+    /* Time to apply the DataSetMessages in the DataSetReaders */
+    UA_PubSubHistogram processTime;
+    UA_UInt64 receivedNetworkMessages;
+    /* Received NetworkMessages that could not be decoded or had no matching
+     * DataSetReader */
+    UA_UInt64 droppedNetworkMessages;
+} UA_ReaderGroupStatistics;
+
 /**
  * WriterGroup
  * -----------
@@ -578,6 +619,37 @@ typedef struct {
      * one NetworkMessage */
     UA_UInt16 maxEncapsulatedDataSetMessageCount;
 
+    /* non std. config parameter. The NetworkMessages of the first publish
+     * cycle are kept as a template together with their offset table. In the
+     * following cycles only the sequence numbers, DataSetMessage timestamps
+     * and field values are encoded in place. The field values are taken
+     * directly from the value source of the VariableNode if possible. The
+     * template is recreated when the encoded size of a field changes or when
+     * the Writers of the WriterGroup change their state. This applies only to
+     * the UADP encoding without message security and promoted fields. The
+     * field encoding has to be Variant or RawData. DeltaFrames have to be
+     * disabled in the PubSub configuration if a PublishedDataSet has more than
+     * one field. Otherwise the normal publish path is used. */
+    UA_Boolean fastPath;
+
+    /* non std. config parameter. Publish when the value of a field in the
+     * PublishedDataSets of the DataSetWriters changes instead of cyclically.
+     * The fields are monitored with local MonitoredItems that have no sampling
+     * interval. A write to a published variable schedules the publish right
+     * away. Further changes until the publish are coalesced. The
+     * publishingInterval is the minimum interval between two publish cycles.
+     * If no value changes for the keepAliveTime (at least the
+     * publishingInterval), a publish cycle is executed nonetheless. So the
+     * Subscribers receive the (delta or key frame) messages as heartbeats.
+     * Only writes to the published variables (the Write service,
+     * UA_Server_write and DataSetReaders writing to their targets) trigger a
+     * publish. Changes of variables with a DataSource or an external value
+     * source, and values computed in the onRead callback, are not detected.
+     * They are only published with the keep-alive cycles. The
+     * MonitoredItems are updated when DataSetWriters or DataSetFields are
+     * added or removed. Requires UA_ENABLE_SUBSCRIPTIONS. */
+    UA_Boolean publishOnValueChange;
+
     /* Security Configuration
      * Message are encrypted if a SecurityPolicy is configured and the
      * securityMode set accordingly. The symmetric key is a runtime information
@@ -618,6 +690,13 @@ UA_Server_getWriterGroupLastPublishTimestamp(UA_Server *server,
                                              const UA_NodeId wgId,
                                              UA_DateTime *timestamp);
 
+UA_EXPORT UA_StatusCode UA_THREADSAFE
+UA_Server_getWriterGroupStatistics(UA_Server *server, const UA_NodeId wgId,
+                                   UA_WriterGroupStatistics *stats);
+
+UA_EXPORT UA_StatusCode UA_THREADSAFE
+UA_Server_resetWriterGroupStatistics(UA_Server *server, const UA_NodeId wgId);
+
 UA_EXPORT UA_StatusCode UA_THREADSAFE
 UA_Server_removeWriterGroup(UA_Server *server, const UA_NodeId wgId);
 
@@ -790,6 +869,17 @@ typedef struct {
     } subscribedDataSet;
     /* non std. fields */
     UA_String linkedStandaloneSubscribedDataSetName;
+
+    /* Write the received fields directly into the value of the target
+     * variables instead of using the Write service. The targets are resolved
+     * and their types checked once when the DataSetReader is enabled. The
+     * MonitoredItems of the targets are sampled after all fields of a
+     * DataSetMessage were written. Targets with a value callback, an index
+     * range, a type that differs from the FieldMetaData or without the Write
+     * bit in the AccessLevel use the Write service instead. The same for
+     * fields with a status or SourceTimestamp that the AccessLevel does not
+     * allow (StatusWrite/TimestampWrite bits). */
+    UA_Boolean directValueWrite;
 } UA_DataSetReaderConfig;
 
 UA_EXPORT UA_StatusCode
@@ -882,6 +972,13 @@ UA_EXPORT UA_StatusCode UA_THREADSAFE
 UA_Server_getReaderGroupState(UA_Server *server, const UA_NodeId rgId,
                               UA_PubSubState *state);
 
+UA_EXPORT UA_StatusCode UA_THREADSAFE
+UA_Server_getReaderGroupStatistics(UA_Server *server, const UA_NodeId rgId,
+                                   UA_ReaderGroupStatistics *stats);
+
+UA_EXPORT UA_StatusCode UA_THREADSAFE
+UA_Server_resetReaderGroupStatistics(UA_Server *server, const UA_NodeId rgId);
+
 UA_EXPORT UA_StatusCode UA_THREADSAFE
 UA_Server_addReaderGroup(UA_Server *server, const UA_NodeId connectionId,
                          const UA_ReaderGroupConfig *config,
@@ -13,19 +13,34 @@
 
 #include "securitypolicy_common.h"
 
+#include <mbedtls/platform_util.h>
+
 #define UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH 32
 #define UA_PUBSUB_AESCTR_KEYNONCE_LENGTH 4
 #define UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH 8
 #define UA_PUBSUB_AESCTR_BLOCK_SIZE 16
+#define UA_PUBSUB_AESCTR_CHUNK_BLOCKS 16
+#define UA_PUBSUB_AESCTR_SHA256_BLOCK_SIZE 64
 
 typedef struct {
     size_t encryptionKeyLength;
 } PubSubAesCtrPolicyContext;
 
+/* The key material of a security token is expanded once when the keys are set
+ * (i.e. on every key rotation) and then reused for every message. The AES key
+ * schedule lives in a long-running ECB operation that produces the CTR
+ * keystream. The HMAC-SHA256 key is kept as the hash states after absorbing
+ * the inner and outer padded key. */
 typedef struct {
-    UA_mbedTLS_PsaKey signingKey;
     UA_mbedTLS_PsaKey encryptingKey;
+    psa_cipher_operation_t aesEcb;
+    psa_hash_operation_t hmacInner;
+    psa_hash_operation_t hmacOuter;
     UA_Byte keyNonce[UA_PUBSUB_AESCTR_KEYNONCE_LENGTH];
+} PubSubAesCtrKeys;
+
+typedef struct {
+    PubSubAesCtrKeys *keys; /* NULL until the keys are set */
     UA_Byte messageNonce[UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH];
 } PubSubAesCtrChannelContext;
 
@@ -36,32 +51,132 @@ encryptionKeyLength(const UA_PubSubSecurityPolicy *policy) {
     return pc->encryptionKeyLength;
 }
 
+static UA_Boolean
+validByteString(const UA_ByteString *value) {
+    return value && (value->length == 0 || value->data);
+}
+
+static void
+deleteKeys(PubSubAesCtrKeys *keys) {
+    if(!keys)
+        return;
+    (void)psa_cipher_abort(&keys->aesEcb);
+    (void)psa_hash_abort(&keys->hmacInner);
+    (void)psa_hash_abort(&keys->hmacOuter);
+    UA_mbedTLS_PsaKey_clear(&keys->encryptingKey);
+    mbedtls_platform_zeroize(keys, sizeof(*keys));
+    UA_free(keys);
+}
+
+static UA_StatusCode
+initHmacState(psa_hash_operation_t *op, const UA_ByteString *signingKey,
+              UA_Byte padByte) {
+    UA_Byte pad[UA_PUBSUB_AESCTR_SHA256_BLOCK_SIZE];
+    memset(pad, padByte, sizeof(pad));
+    for(size_t i = 0; i < signingKey->length; i++)
+        pad[i] ^= signingKey->data[i];
+    psa_status_t status = psa_hash_setup(op, PSA_ALG_SHA_256);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_update(op, pad, sizeof(pad));
+    mbedtls_platform_zeroize(pad, sizeof(pad));
+    return (status == PSA_SUCCESS) ?
+        UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+}
+
+static UA_StatusCode
+newKeys(const UA_ByteString *signingKey, const UA_ByteString *encryptingKey,
+        const UA_ByteString *keyNonce, PubSubAesCtrKeys **out) {
+    PubSubAesCtrKeys *keys = (PubSubAesCtrKeys*)UA_calloc(1, sizeof(*keys));
+    if(!keys)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_mbedTLS_PsaKey_init(&keys->encryptingKey);
+    keys->aesEcb = psa_cipher_operation_init();
+    keys->hmacInner = psa_hash_operation_init();
+    keys->hmacOuter = psa_hash_operation_init();
+
+    /* Expand the AES key schedule */
+    UA_StatusCode res =
+        UA_mbedTLS_PsaKey_import(&keys->encryptingKey, PSA_KEY_TYPE_AES,
+                                 PSA_KEY_USAGE_ENCRYPT, PSA_ALG_ECB_NO_PADDING,
+                                 encryptingKey);
+    if(res == UA_STATUSCODE_GOOD &&
+       psa_cipher_encrypt_setup(&keys->aesEcb, keys->encryptingKey.id,
+                                PSA_ALG_ECB_NO_PADDING) != PSA_SUCCESS)
+        res = UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+
+    /* Pre-hash the padded HMAC keys */
+    if(res == UA_STATUSCODE_GOOD)
+        res = initHmacState(&keys->hmacInner, signingKey, 0x36);
+    if(res == UA_STATUSCODE_GOOD)
+        res = initHmacState(&keys->hmacOuter, signingKey, 0x5c);
+    if(res != UA_STATUSCODE_GOOD) {
+        deleteKeys(keys);
+        return res;
+    }
+
+    memcpy(keys->keyNonce, keyNonce->data, keyNonce->length);
+    *out = keys;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* HMAC-SHA256 continuing from the pre-hashed padded keys */
+static UA_StatusCode
+computeHmac(PubSubAesCtrKeys *keys, const UA_ByteString *message,
+            UA_Byte *mac) {
+    UA_Byte inner[UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH];
+    size_t innerLength = 0;
+    size_t macLength = 0;
+    psa_hash_operation_t op = psa_hash_operation_init();
+    psa_status_t status = psa_hash_clone(&keys->hmacInner, &op);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_update(&op, message->data, message->length);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_finish(&op, inner, sizeof(inner), &innerLength);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_clone(&keys->hmacOuter, &op);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_update(&op, inner, innerLength);
+    if(status == PSA_SUCCESS)
+        status = psa_hash_finish(&op, mac, UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH,
+                                 &macLength);
+    (void)psa_hash_abort(&op);
+    mbedtls_platform_zeroize(inner, sizeof(inner));
+    if(status != PSA_SUCCESS || macLength != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 verify(const UA_PubSubSecurityPolicy *policy, void *gContext,
        const UA_ByteString *message, const UA_ByteString *signature) {
     (void)policy;
-    if(!gContext || !message || !signature)
+    if(!gContext || !validByteString(message) || !validByteString(signature))
         return UA_STATUSCODE_BADINTERNALERROR;
     if(signature->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
         return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
     PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
-    return UA_mbedTLS_PsaMacVerify(cc->signingKey.id,
-                                  PSA_ALG_HMAC(PSA_ALG_SHA_256),
-                                  message, signature);
+    if(!cc->keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    UA_Byte mac[UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH];
+    UA_StatusCode res = computeHmac(cc->keys, message, mac);
+    if(res == UA_STATUSCODE_GOOD &&
+       !UA_constantTimeEqual(mac, signature->data, sizeof(mac)))
+        res = UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return res;
 }
 
 static UA_StatusCode
 sign(const UA_PubSubSecurityPolicy *policy, void *gContext,
      const UA_ByteString *message, UA_ByteString *signature) {
     (void)policy;
-    if(!gContext || !message || !signature)
+    if(!gContext || !validByteString(message) || !validByteString(signature))
         return UA_STATUSCODE_BADINTERNALERROR;
     if(signature->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
         return UA_STATUSCODE_BADINTERNALERROR;
     PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
-    return UA_mbedTLS_PsaMacCompute(cc->signingKey.id,
-                                   PSA_ALG_HMAC(PSA_ALG_SHA_256),
-                                   message, signature);
+    if(!cc->keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return computeHmac(cc->keys, message, signature->data);
 }
 
 static size_t
@@ -86,36 +201,68 @@ getEncryptionKeyLength(const UA_PubSubSecurityPolicy *policy,
     return encryptionKeyLength(policy);
 }
 
+/* AES-CTR is its own inverse. The counter blocks are encrypted with the
+ * pre-expanded key in chunks and the keystream is XOR-ed into the data in
+ * place. The counter starts at 1 behind KeyNonce and MessageNonce. */
 static UA_StatusCode
-pubSubCrypt(void *gContext, UA_ByteString *data, UA_Boolean encrypting) {
-    if(!gContext || !data)
+pubSubCrypt(void *gContext, UA_ByteString *data) {
+    if(!gContext || !validByteString(data))
         return UA_STATUSCODE_BADINTERNALERROR;
     PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
-    UA_Byte counter[UA_PUBSUB_AESCTR_BLOCK_SIZE];
-    memcpy(counter, cc->keyNonce, UA_PUBSUB_AESCTR_KEYNONCE_LENGTH);
-    memcpy(counter + UA_PUBSUB_AESCTR_KEYNONCE_LENGTH, cc->messageNonce,
-           UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH);
-    counter[12] = 0;
-    counter[13] = 0;
-    counter[14] = 0;
-    counter[15] = 1;
-    UA_ByteString counterBlock = {sizeof(counter), counter};
-    return UA_mbedTLS_PsaCipher(cc->encryptingKey.id, PSA_ALG_CTR, encrypting,
-                                &counterBlock, data);
+    PubSubAesCtrKeys *keys = cc->keys;
+    if(!keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+
+    UA_Byte counters[UA_PUBSUB_AESCTR_CHUNK_BLOCKS * UA_PUBSUB_AESCTR_BLOCK_SIZE];
+    UA_Byte stream[UA_PUBSUB_AESCTR_CHUNK_BLOCKS * UA_PUBSUB_AESCTR_BLOCK_SIZE];
+    UA_UInt32 counter = 1;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    for(size_t pos = 0; pos < data->length;) {
+        size_t len = data->length - pos;
+        if(len > sizeof(stream))
+            len = sizeof(stream);
+        size_t blocks = (len + UA_PUBSUB_AESCTR_BLOCK_SIZE - 1) /
+            UA_PUBSUB_AESCTR_BLOCK_SIZE;
+        for(size_t i = 0; i < blocks; i++) {
+            UA_Byte *block = &counters[i * UA_PUBSUB_AESCTR_BLOCK_SIZE];
+            memcpy(block, keys->keyNonce, UA_PUBSUB_AESCTR_KEYNONCE_LENGTH);
+            memcpy(block + UA_PUBSUB_AESCTR_KEYNONCE_LENGTH, cc->messageNonce,
+                   UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH);
+            block[12] = (UA_Byte)(counter >> 24);
+            block[13] = (UA_Byte)(counter >> 16);
+            block[14] = (UA_Byte)(counter >> 8);
+            block[15] = (UA_Byte)counter;
+            counter++;
+        }
+        size_t streamLength = 0;
+        size_t blocksLength = blocks * UA_PUBSUB_AESCTR_BLOCK_SIZE;
+        psa_status_t status =
+            psa_cipher_update(&keys->aesEcb, counters, blocksLength,
+                              stream, sizeof(stream), &streamLength);
+        if(status != PSA_SUCCESS || streamLength != blocksLength) {
+            res = UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+            break;
+        }
+        for(size_t i = 0; i < len; i++)
+            data->data[pos + i] ^= stream[i];
+        pos += len;
+    }
+    mbedtls_platform_zeroize(stream, sizeof(stream));
+    return res;
 }
 
 static UA_StatusCode
 pubSubEncrypt(const UA_PubSubSecurityPolicy *policy, void *gContext,
               UA_ByteString *data) {
     (void)policy;
-    return pubSubCrypt(gContext, data, true);
+    return pubSubCrypt(gContext, data);
 }
 
 static UA_StatusCode
 pubSubDecrypt(const UA_PubSubSecurityPolicy *policy, void *gContext,
               UA_ByteString *data) {
     (void)policy;
-    return pubSubCrypt(gContext, data, false);
+    return pubSubCrypt(gContext, data);
 }
 
 static UA_StatusCode
@@ -143,14 +290,21 @@ deleteGroupContext(UA_PubSubSecurityPolicy *policy, void *gContext) {
     PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
     if(!cc)
         return;
-    UA_mbedTLS_PsaKey_clear(&cc->signingKey);
-    UA_mbedTLS_PsaKey_clear(&cc->encryptingKey);
+    deleteKeys(cc->keys);
     UA_free(cc);
 }
 
-static UA_Boolean
-validByteString(const UA_ByteString *value) {
-    return value && (value->length == 0 || value->data);
+static UA_StatusCode
+checkKeys(UA_PubSubSecurityPolicy *policy, const UA_ByteString *signingKey,
+          const UA_ByteString *encryptingKey, const UA_ByteString *keyNonce) {
+    if(!validByteString(signingKey) || !validByteString(encryptingKey) ||
+       !validByteString(keyNonce))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    if(signingKey->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH ||
+       encryptingKey->length != encryptionKeyLength(policy) ||
+       keyNonce->length != UA_PUBSUB_AESCTR_KEYNONCE_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return UA_STATUSCODE_GOOD;
 }
 
 static UA_StatusCode
@@ -160,41 +314,35 @@ newGroupContext(UA_PubSubSecurityPolicy *policy,
                 const UA_ByteString *keyNonce, void **gContext) {
     if(!policy || !gContext)
         return UA_STATUSCODE_BADINTERNALERROR;
-    if((signingKey && !validByteString(signingKey)) ||
-       (encryptingKey && !validByteString(encryptingKey)) ||
-       (keyNonce && !validByteString(keyNonce)))
-        return UA_STATUSCODE_BADINVALIDARGUMENT;
-    if((signingKey && signingKey->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH) ||
-       (encryptingKey && encryptingKey->length != encryptionKeyLength(policy)) ||
-       (keyNonce && keyNonce->length != UA_PUBSUB_AESCTR_KEYNONCE_LENGTH))
-        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+
+    /* The keys are either set all at once or later on */
+    UA_Boolean withKeys = (signingKey || encryptingKey || keyNonce);
+    if(withKeys) {
+        if(!signingKey || !encryptingKey || !keyNonce)
+            return UA_STATUSCODE_BADINVALIDARGUMENT;
+        UA_StatusCode res = checkKeys(policy, signingKey, encryptingKey, keyNonce);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
 
     PubSubAesCtrChannelContext *cc =
         (PubSubAesCtrChannelContext*)UA_calloc(1, sizeof(*cc));
     if(!cc)
         return UA_STATUSCODE_BADOUTOFMEMORY;
-    UA_mbedTLS_PsaKey_init(&cc->signingKey);
-    UA_mbedTLS_PsaKey_init(&cc->encryptingKey);
 
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
-    if(signingKey)
-        res = UA_mbedTLS_PsaKey_import(&cc->signingKey, PSA_KEY_TYPE_HMAC,
-            PSA_KEY_USAGE_SIGN_MESSAGE | PSA_KEY_USAGE_VERIFY_MESSAGE,
-            PSA_ALG_HMAC(PSA_ALG_SHA_256), signingKey);
-    if(res == UA_STATUSCODE_GOOD && encryptingKey)
-        res = UA_mbedTLS_PsaKey_import(&cc->encryptingKey, PSA_KEY_TYPE_AES,
-            PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT,
-            PSA_ALG_CTR, encryptingKey);
-    if(res != UA_STATUSCODE_GOOD) {
-        deleteGroupContext(policy, cc);
-        return res;
+    if(withKeys) {
+        UA_StatusCode res = newKeys(signingKey, encryptingKey, keyNonce, &cc->keys);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(cc);
+            return res;
+        }
     }
-    if(keyNonce)
-        memcpy(cc->keyNonce, keyNonce->data, keyNonce->length);
     *gContext = cc;
     return UA_STATUSCODE_GOOD;
 }
 
+/* Called on every key rotation. The new keys are expanded before the old
+ * ones are dropped, so a failed rotation leaves the context unchanged. */
 static UA_StatusCode
 setSecurityKeys(UA_PubSubSecurityPolicy *policy, void *gContext,
                 const UA_ByteString *signingKey,
@@ -202,39 +350,19 @@ setSecurityKeys(UA_PubSubSecurityPolicy *policy, void *gContext,
                 const UA_ByteString *keyNonce) {
     if(!policy || !gContext || !signingKey || !encryptingKey || !keyNonce)
         return UA_STATUSCODE_BADINTERNALERROR;
-    if(!validByteString(signingKey) || !validByteString(encryptingKey) ||
-       !validByteString(keyNonce))
-        return UA_STATUSCODE_BADINVALIDARGUMENT;
-    if(signingKey->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH ||
-       encryptingKey->length != encryptionKeyLength(policy) ||
-       keyNonce->length != UA_PUBSUB_AESCTR_KEYNONCE_LENGTH)
-        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    UA_StatusCode res = checkKeys(policy, signingKey, encryptingKey, keyNonce);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    PubSubAesCtrKeys *keys = NULL;
+    res = newKeys(signingKey, encryptingKey, keyNonce, &keys);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
 
     PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
-    UA_mbedTLS_PsaKey newSigningKey;
-    UA_mbedTLS_PsaKey newEncryptingKey;
-    UA_mbedTLS_PsaKey_init(&newSigningKey);
-    UA_mbedTLS_PsaKey_init(&newEncryptingKey);
-    UA_StatusCode res = UA_mbedTLS_PsaKey_import(&newSigningKey,
-        PSA_KEY_TYPE_HMAC,
-        PSA_KEY_USAGE_SIGN_MESSAGE | PSA_KEY_USAGE_VERIFY_MESSAGE,
-        PSA_ALG_HMAC(PSA_ALG_SHA_256), signingKey);
-    if(res == UA_STATUSCODE_GOOD)
-        res = UA_mbedTLS_PsaKey_import(&newEncryptingKey, PSA_KEY_TYPE_AES,
-            PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT,
-            PSA_ALG_CTR, encryptingKey);
-    if(res == UA_STATUSCODE_GOOD) {
-        UA_mbedTLS_PsaKey_clear(&cc->signingKey);
-        cc->signingKey = newSigningKey;
-        UA_mbedTLS_PsaKey_init(&newSigningKey);
-        UA_mbedTLS_PsaKey_clear(&cc->encryptingKey);
-        cc->encryptingKey = newEncryptingKey;
-        UA_mbedTLS_PsaKey_init(&newEncryptingKey);
-        memcpy(cc->keyNonce, keyNonce->data, keyNonce->length);
-    }
-    UA_mbedTLS_PsaKey_clear(&newSigningKey);
-    UA_mbedTLS_PsaKey_clear(&newEncryptingKey);
-    return res;
+    deleteKeys(cc->keys);
+    cc->keys = keys;
+    return UA_STATUSCODE_GOOD;
 }
 
 static UA_StatusCode
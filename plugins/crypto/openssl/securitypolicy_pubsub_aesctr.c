@@ -0,0 +1,416 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/securitypolicy_default.h>
+#include <open62541/util.h>
+
+#if defined(UA_ENABLE_ENCRYPTION_OPENSSL) || defined(UA_ENABLE_ENCRYPTION_LIBRESSL)
+
+#include "securitypolicy_common.h"
+
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+
+#define UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH 32
+#define UA_PUBSUB_AESCTR_KEYNONCE_LENGTH 4
+#define UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH 8
+#define UA_PUBSUB_AESCTR_BLOCK_SIZE 16
+#define UA_PUBSUB_AESCTR_SHA256_BLOCK_SIZE 64
+
+typedef struct {
+    size_t encryptionKeyLength;
+} PubSubAesCtrPolicyContext;
+
+/* The key material of a security token is expanded once when the keys are set
+ * (i.e. on every key rotation) and then reused for every message. The cipher
+ * context keeps the AES key schedule and only the counter block is reset per
+ * message. The HMAC-SHA256 key is kept as the digest states after absorbing
+ * the inner and outer padded key. */
+typedef struct {
+    EVP_CIPHER_CTX *aesCtr;
+    EVP_MD_CTX *hmacInner;
+    EVP_MD_CTX *hmacOuter;
+    EVP_MD_CTX *hmacWork;
+    UA_Byte keyNonce[UA_PUBSUB_AESCTR_KEYNONCE_LENGTH];
+} PubSubAesCtrKeys;
+
+typedef struct {
+    PubSubAesCtrKeys *keys; /* NULL until the keys are set */
+    UA_Byte messageNonce[UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH];
+} PubSubAesCtrChannelContext;
+
+static size_t
+encryptionKeyLength(const UA_PubSubSecurityPolicy *policy) {
+    const PubSubAesCtrPolicyContext *pc =
+        (const PubSubAesCtrPolicyContext*)policy->policyContext;
+    return pc->encryptionKeyLength;
+}
+
+static UA_Boolean
+validByteString(const UA_ByteString *value) {
+    return value && (value->length == 0 || value->data);
+}
+
+static void
+deleteKeys(PubSubAesCtrKeys *keys) {
+    if(!keys)
+        return;
+    EVP_CIPHER_CTX_free(keys->aesCtr);
+    EVP_MD_CTX_free(keys->hmacInner);
+    EVP_MD_CTX_free(keys->hmacOuter);
+    EVP_MD_CTX_free(keys->hmacWork);
+    OPENSSL_cleanse(keys, sizeof(*keys));
+    UA_free(keys);
+}
+
+static UA_StatusCode
+initHmacState(EVP_MD_CTX *md, const UA_ByteString *signingKey,
+              UA_Byte padByte) {
+    UA_Byte pad[UA_PUBSUB_AESCTR_SHA256_BLOCK_SIZE];
+    memset(pad, padByte, sizeof(pad));
+    for(size_t i = 0; i < signingKey->length; i++)
+        pad[i] ^= signingKey->data[i];
+    int ok = EVP_DigestInit_ex(md, EVP_sha256(), NULL) == 1 &&
+        EVP_DigestUpdate(md, pad, sizeof(pad)) == 1;
+    OPENSSL_cleanse(pad, sizeof(pad));
+    return ok ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+}
+
+static UA_StatusCode
+newKeys(const UA_ByteString *signingKey, const UA_ByteString *encryptingKey,
+        const UA_ByteString *keyNonce, PubSubAesCtrKeys **out) {
+    PubSubAesCtrKeys *keys = (PubSubAesCtrKeys*)UA_calloc(1, sizeof(*keys));
+    if(!keys)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    keys->aesCtr = EVP_CIPHER_CTX_new();
+    keys->hmacInner = EVP_MD_CTX_new();
+    keys->hmacOuter = EVP_MD_CTX_new();
+    keys->hmacWork = EVP_MD_CTX_new();
+    if(!keys->aesCtr || !keys->hmacInner || !keys->hmacOuter || !keys->hmacWork) {
+        deleteKeys(keys);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* Expand the AES key schedule. The counter block is set per message. */
+    const EVP_CIPHER *cipher = (encryptingKey->length == 32) ?
+        EVP_aes_256_ctr() : EVP_aes_128_ctr();
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(EVP_EncryptInit_ex(keys->aesCtr, cipher, NULL,
+                          encryptingKey->data, NULL) != 1)
+        res = UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+
+    /* Pre-hash the padded HMAC keys */
+    if(res == UA_STATUSCODE_GOOD)
+        res = initHmacState(keys->hmacInner, signingKey, 0x36);
+    if(res == UA_STATUSCODE_GOOD)
+        res = initHmacState(keys->hmacOuter, signingKey, 0x5c);
+    if(res != UA_STATUSCODE_GOOD) {
+        deleteKeys(keys);
+        return res;
+    }
+
+    memcpy(keys->keyNonce, keyNonce->data, keyNonce->length);
+    *out = keys;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* HMAC-SHA256 continuing from the pre-hashed padded keys */
+static UA_StatusCode
+computeHmac(PubSubAesCtrKeys *keys, const UA_ByteString *message,
+            UA_Byte *mac) {
+    UA_Byte inner[UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH];
+    unsigned int innerLength = 0;
+    unsigned int macLength = 0;
+    EVP_MD_CTX *md = keys->hmacWork;
+    int ok = EVP_MD_CTX_copy_ex(md, keys->hmacInner) == 1 &&
+        EVP_DigestUpdate(md, message->data, message->length) == 1 &&
+        EVP_DigestFinal_ex(md, inner, &innerLength) == 1 &&
+        EVP_MD_CTX_copy_ex(md, keys->hmacOuter) == 1 &&
+        EVP_DigestUpdate(md, inner, innerLength) == 1 &&
+        EVP_DigestFinal_ex(md, mac, &macLength) == 1;
+    OPENSSL_cleanse(inner, sizeof(inner));
+    if(!ok || macLength != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+verify(const UA_PubSubSecurityPolicy *policy, void *gContext,
+       const UA_ByteString *message, const UA_ByteString *signature) {
+    (void)policy;
+    if(!gContext || !validByteString(message) || !validByteString(signature))
+        return UA_STATUSCODE_BADINTERNALERROR;
+    if(signature->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    if(!cc->keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    UA_Byte mac[UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH];
+    UA_StatusCode res = computeHmac(cc->keys, message, mac);
+    if(res == UA_STATUSCODE_GOOD &&
+       !UA_constantTimeEqual(mac, signature->data, sizeof(mac)))
+        res = UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return res;
+}
+
+static UA_StatusCode
+sign(const UA_PubSubSecurityPolicy *policy, void *gContext,
+     const UA_ByteString *message, UA_ByteString *signature) {
+    (void)policy;
+    if(!gContext || !validByteString(message) || !validByteString(signature))
+        return UA_STATUSCODE_BADINTERNALERROR;
+    if(signature->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    if(!cc->keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return computeHmac(cc->keys, message, signature->data);
+}
+
+static size_t
+getSignatureSize(const UA_PubSubSecurityPolicy *policy, const void *gContext) {
+    (void)policy;
+    (void)gContext;
+    return UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH;
+}
+
+static size_t
+getSignatureKeyLength(const UA_PubSubSecurityPolicy *policy,
+                      const void *gContext) {
+    (void)policy;
+    (void)gContext;
+    return UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH;
+}
+
+static size_t
+getEncryptionKeyLength(const UA_PubSubSecurityPolicy *policy,
+                       const void *gContext) {
+    (void)gContext;
+    return encryptionKeyLength(policy);
+}
+
+/* AES-CTR is its own inverse. Only the counter block is reset for the
+ * message, the data is transformed in place. The counter starts at 1 behind
+ * KeyNonce and MessageNonce. */
+static UA_StatusCode
+pubSubCrypt(void *gContext, UA_ByteString *data) {
+    if(!gContext || !validByteString(data))
+        return UA_STATUSCODE_BADINTERNALERROR;
+    if(data->length > INT32_MAX)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    PubSubAesCtrKeys *keys = cc->keys;
+    if(!keys)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+
+    UA_Byte counter[UA_PUBSUB_AESCTR_BLOCK_SIZE];
+    memcpy(counter, keys->keyNonce, UA_PUBSUB_AESCTR_KEYNONCE_LENGTH);
+    memcpy(counter + UA_PUBSUB_AESCTR_KEYNONCE_LENGTH, cc->messageNonce,
+           UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH);
+    counter[12] = 0;
+    counter[13] = 0;
+    counter[14] = 0;
+    counter[15] = 1;
+
+    int outLength = 0;
+    if(EVP_EncryptInit_ex(keys->aesCtr, NULL, NULL, NULL, counter) != 1 ||
+       EVP_EncryptUpdate(keys->aesCtr, data->data, &outLength,
+                         data->data, (int)data->length) != 1 ||
+       (size_t)outLength != data->length)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+pubSubEncrypt(const UA_PubSubSecurityPolicy *policy, void *gContext,
+              UA_ByteString *data) {
+    (void)policy;
+    return pubSubCrypt(gContext, data);
+}
+
+static UA_StatusCode
+pubSubDecrypt(const UA_PubSubSecurityPolicy *policy, void *gContext,
+              UA_ByteString *data) {
+    (void)policy;
+    return pubSubCrypt(gContext, data);
+}
+
+static UA_StatusCode
+generateKey(UA_PubSubSecurityPolicy *policy, void *gContext,
+            const UA_ByteString *secret, const UA_ByteString *seed,
+            UA_ByteString *out) {
+    (void)gContext;
+    if(!policy || !secret || !seed || !out)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    return UA_Openssl_Random_Key_PSHA256_Derive(secret, seed, out);
+}
+
+static UA_StatusCode
+generateNonce(UA_PubSubSecurityPolicy *policy, void *gContext,
+              UA_ByteString *out) {
+    (void)gContext;
+    if(!policy || !validByteString(out) || out->length > INT32_MAX)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    if(RAND_bytes(out->data, (int)out->length) != 1)
+        return UA_STATUSCODE_BADUNEXPECTEDERROR;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+deleteGroupContext(UA_PubSubSecurityPolicy *policy, void *gContext) {
+    (void)policy;
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    if(!cc)
+        return;
+    deleteKeys(cc->keys);
+    UA_free(cc);
+}
+
+static UA_StatusCode
+checkKeys(UA_PubSubSecurityPolicy *policy, const UA_ByteString *signingKey,
+          const UA_ByteString *encryptingKey, const UA_ByteString *keyNonce) {
+    if(!validByteString(signingKey) || !validByteString(encryptingKey) ||
+       !validByteString(keyNonce))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    if(signingKey->length != UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH ||
+       encryptingKey->length != encryptionKeyLength(policy) ||
+       keyNonce->length != UA_PUBSUB_AESCTR_KEYNONCE_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+newGroupContext(UA_PubSubSecurityPolicy *policy,
+                const UA_ByteString *signingKey,
+                const UA_ByteString *encryptingKey,
+                const UA_ByteString *keyNonce, void **gContext) {
+    if(!policy || !gContext)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* The keys are either set all at once or later on */
+    UA_Boolean withKeys = (signingKey || encryptingKey || keyNonce);
+    if(withKeys) {
+        if(!signingKey || !encryptingKey || !keyNonce)
+            return UA_STATUSCODE_BADINVALIDARGUMENT;
+        UA_StatusCode res = checkKeys(policy, signingKey, encryptingKey, keyNonce);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
+
+    PubSubAesCtrChannelContext *cc =
+        (PubSubAesCtrChannelContext*)UA_calloc(1, sizeof(*cc));
+    if(!cc)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    if(withKeys) {
+        UA_StatusCode res = newKeys(signingKey, encryptingKey, keyNonce, &cc->keys);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(cc);
+            return res;
+        }
+    }
+    *gContext = cc;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Called on every key rotation. The new keys are expanded before the old
+ * ones are dropped, so a failed rotation leaves the context unchanged. */
+static UA_StatusCode
+setSecurityKeys(UA_PubSubSecurityPolicy *policy, void *gContext,
+                const UA_ByteString *signingKey,
+                const UA_ByteString *encryptingKey,
+                const UA_ByteString *keyNonce) {
+    if(!policy || !gContext || !signingKey || !encryptingKey || !keyNonce)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_StatusCode res = checkKeys(policy, signingKey, encryptingKey, keyNonce);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    PubSubAesCtrKeys *keys = NULL;
+    res = newKeys(signingKey, encryptingKey, keyNonce, &keys);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    deleteKeys(cc->keys);
+    cc->keys = keys;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+setMessageNonce(UA_PubSubSecurityPolicy *policy, void *gContext,
+                const UA_ByteString *nonce) {
+    (void)policy;
+    if(!gContext || !nonce)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    if(!validByteString(nonce))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    if(nonce->length != UA_PUBSUB_AESCTR_MESSAGENONCE_LENGTH)
+        return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
+    PubSubAesCtrChannelContext *cc = (PubSubAesCtrChannelContext*)gContext;
+    memcpy(cc->messageNonce, nonce->data, nonce->length);
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+clear(UA_PubSubSecurityPolicy *policy) {
+    if(!policy)
+        return;
+    UA_free(policy->policyContext);
+    policy->policyContext = NULL;
+}
+
+static UA_StatusCode
+setup(UA_PubSubSecurityPolicy *sp, const UA_Logger *logger,
+      UA_String policyUri, size_t keyLength) {
+    if(!sp)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    memset(sp, 0, sizeof(*sp));
+    sp->logger = logger;
+    sp->policyUri = policyUri;
+
+    PubSubAesCtrPolicyContext *pc =
+        (PubSubAesCtrPolicyContext*)UA_malloc(sizeof(*pc));
+    if(!pc)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    pc->encryptionKeyLength = keyLength;
+    sp->policyContext = pc;
+    UA_Openssl_Init();
+
+    sp->newGroupContext = newGroupContext;
+    sp->deleteGroupContext = deleteGroupContext;
+    sp->verify = verify;
+    sp->sign = sign;
+    sp->getSignatureSize = getSignatureSize;
+    sp->getSignatureKeyLength = getSignatureKeyLength;
+    sp->getEncryptionKeyLength = getEncryptionKeyLength;
+    sp->encrypt = pubSubEncrypt;
+    sp->decrypt = pubSubDecrypt;
+    sp->setSecurityKeys = setSecurityKeys;
+    sp->generateKey = generateKey;
+    sp->generateNonce = generateNonce;
+    sp->nonceLength = UA_PUBSUB_AESCTR_SIGNING_KEY_LENGTH + keyLength +
+        UA_PUBSUB_AESCTR_KEYNONCE_LENGTH;
+    sp->setMessageNonce = setMessageNonce;
+    sp->clear = clear;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_PubSubSecurityPolicy_Aes128Ctr(UA_PubSubSecurityPolicy *sp,
+                                  const UA_Logger *logger) {
+    return setup(sp, logger,
+        UA_STRING("http://opcfoundation.org/UA/SecurityPolicy#PubSub-Aes128-CTR"),
+        16);
+}
+
+UA_StatusCode
+UA_PubSubSecurityPolicy_Aes256Ctr(UA_PubSubSecurityPolicy *sp,
+                                  const UA_Logger *logger) {
+    return setup(sp, logger,
+        UA_STRING("http://opcfoundation.org/UA/SecurityPolicy#PubSub-Aes256-CTR"),
+        32);
+}
+
+#endif
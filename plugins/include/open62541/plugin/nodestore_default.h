@@ -11,6 +11,15 @@
 
 _UA_BEGIN_DECLS
 
+/* The HashMap Nodestore holds all nodes in RAM in an open-addressing hash table
+ * keyed on the NodeId hash. The lookup time is about O(1). The table is resized
+ * (with linear overhead) when it becomes too full or too empty. This is the
+ * preferred choice for large information models with millions of nodes.
+ *
+ * Set ``config->nodestore = UA_Nodestore_HashMap()`` before calling
+ * ``UA_ServerConfig_setDefault`` to use it instead of the ZipTree Nodestore. */
+UA_EXPORT UA_Nodestore * UA_Nodestore_HashMap(void);
+
 /* The ZipTree Nodestore holds all nodes in RAM in a tree structure. The lookup
  * time is about O(log n). Adding/removing nodes does not require resizing of
  * the underlying array with the linear overhead.
@@ -506,6 +506,7 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
     /* Limits for Sessions */
     conf->maxSessions = 100;
     conf->maxSessionTimeout = 60.0 * 60.0 * 1000.0; /* 1h */
+    conf->maxRegisteredNodesPerSession = 32768;
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* Limits for Subscriptions */
@@ -14,6 +14,8 @@
 #include "open62541/server_config_default.h"
 #include "open62541/client_config_default.h"
 #include "open62541/plugin/securitypolicy_default.h"
+#include "open62541/plugin/nodestore.h"
+#include "open62541/plugin/nodestore_default.h"
 #ifdef UA_ENABLE_ENCRYPTION
 #include "open62541/plugin/certificategroup_default.h"
 #endif
@@ -1044,6 +1046,42 @@ PARSE_JSON(RuleHandlingField) {
     return retval;
 }
 
+/* Replaces the nodestore of the configuration. Must be done before the server
+ * is created from the configuration. */
+PARSE_JSON(NodestoreField) {
+    cj5_token tok = nextToken(ctx);
+    UA_Nodestore **field = (UA_Nodestore**)configField;
+    char *fieldStr = (char*)UA_malloc(tok.size + 1);
+    if(!fieldStr)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    unsigned int strLen = 0;
+    if(cj5_get_str(&ctx->result, (unsigned int)ctx->index,
+                   fieldStr, &strLen) != CJ5_ERROR_NONE) {
+        UA_free(fieldStr);
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    }
+
+    UA_Nodestore *ns = NULL;
+    if(strcmp("ZipTree", fieldStr) == 0) {
+        ns = UA_Nodestore_ZipTree();
+    } else if(strcmp("HashMap", fieldStr) == 0) {
+        ns = UA_Nodestore_HashMap();
+    } else {
+        UA_LOG_ERROR(ctx->logging, UA_LOGCATEGORY_APPLICATION,
+                     "Unknown Nodestore '%s'", fieldStr);
+        UA_free(fieldStr);
+        return UA_STATUSCODE_BADCONFIGURATIONERROR;
+    }
+    UA_free(fieldStr);
+    if(!ns)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    if(*field)
+        (*field)->free(*field);
+    *field = ns;
+    return UA_STATUSCODE_GOOD;
+}
+
 /* Skips unknown item (simple, object or array) in config file.
 * Unknown items may happen if we don't support some features.
 * E.g. if  UA_ENABLE_ENCRYPTION is not defined and config file
@@ -1101,6 +1139,8 @@ parseJSONServerConfig(UA_ServerConfig *config, UA_ByteString json_config) {
                     retval = BuildInfo_parseJson(&ctx, &config->buildInfo, NULL);
                 else if(strcmp(field, "applicationDescription") == 0)
                     retval = GenericApplicationDescriptionField_parseJson(&ctx, &config->applicationDescription, NULL, GENERICAPPLICATIONTYPE_SERVER);
+                else if(strcmp(field, "nodestore") == 0)
+                    retval = NodestoreField_parseJson(&ctx, &config->nodestore, NULL);
                 else if(strcmp(field, "shutdownDelay") == 0)
                     retval = DoubleField_parseJson(&ctx, &config->shutdownDelay, NULL);
                 else if(strcmp(field, "verifyRequestTimestamp") == 0)
@@ -1141,6 +1181,8 @@ parseJSONServerConfig(UA_ServerConfig *config, UA_ByteString json_config) {
                     retval = UInt16Field_parseJson(&ctx, &config->maxSessions, NULL);
                 else if(strcmp(field, "maxSessionTimeout") == 0)
                     retval = DoubleField_parseJson(&ctx, &config->maxSessionTimeout, NULL);
+                else if(strcmp(field, "maxRegisteredNodesPerSession") == 0)
+                    retval = UInt32Field_parseJson(&ctx, &config->maxRegisteredNodesPerSession, NULL);
                 else if(strcmp(field, "maxNodesPerRead") == 0)
                     retval = UInt32Field_parseJson(&ctx, &config->maxNodesPerRead, NULL);
                 else if(strcmp(field, "maxNodesPerWrite") == 0)
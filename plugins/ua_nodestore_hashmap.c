@@ -0,0 +1,646 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+#include <open62541/server.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/nodestore_default.h>
+#include "pcg_basic.h"
+
+#ifndef container_of
+#define container_of(ptr, type, member) \
+    (type *)((uintptr_t)ptr - offsetof(type,member))
+#endif
+
+/* The HashMap Nodestore uses open addressing with double hashing. The table
+ * size is always a prime number from the list below. Every slot caches the
+ * hash of the NodeId so that collisions can be skipped without dereferencing
+ * the (out-of-line) entry. Removed entries leave a tombstone in their slot
+ * until the next resize. */
+
+struct NodeEntry;
+typedef struct NodeEntry NodeEntry;
+
+struct NodeEntry {
+    UA_atomic(uintptr_t) refCount; /* How many consumers have a reference to
+                                    * the node? Atomic for concurrent readers. */
+    UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
+    UA_Boolean edited;  /* Taken with getEditNode. Reorganize the references
+                         * when the last consumer releases the node. */
+    NodeEntry *orig;    /* If a copy is made to replace a node, track that we
+                         * replace only the node from which the copy was made.
+                         * Important for concurrent operations. */
+    UA_NodeId nodeId; /* This is actually a UA_Node that also starts with a NodeId */
+};
+
+#define HASHMAP_MINSIZE 64
+#define HASHMAP_TOMBSTONE ((NodeEntry*)0x01)
+
+typedef struct {
+    NodeEntry *entry;
+    UA_UInt32 nodeIdHash;
+} NodeSlot;
+
+typedef struct {
+    UA_Nodestore ns;
+
+    NodeSlot *slots;
+    UA_UInt32 size;       /* Number of slots */
+    UA_UInt32 count;      /* Number of live entries */
+    UA_UInt32 tombstones; /* Number of slots with a tombstone */
+    UA_UInt32 sizePrimeIndex;
+
+    /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType */
+    UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
+    UA_Byte referenceTypeCounter;
+} HashMapNodestore;
+
+/* The size of the hash-map is always a prime number. They are chosen to be
+ * close to the next power of 2. So the size ca. doubles with each prime. */
+static UA_UInt32 const primes[] = {
+    7,         13,         31,         61,         127,        251,
+    509,       1021,       2039,       4093,       8191,       16381,
+    32749,     65521,      131071,     262139,     524287,     1048573,
+    2097143,   4194301,    8388593,    16777213,   33554393,   67108859,
+    134217689, 268435399,  536870909,  1073741789, 2147483647, 4294967291
+};
+
+static UA_UInt32 mod(UA_UInt32 h, UA_UInt32 size) { return h % size; }
+static UA_UInt32 mod2(UA_UInt32 h, UA_UInt32 size) { return 1 + (h % (size - 2)); }
+
+static UA_UInt16
+higher_prime_index(UA_UInt32 n) {
+    UA_UInt16 low  = 0;
+    UA_UInt16 high = (UA_UInt16)(sizeof(primes) / sizeof(UA_UInt32));
+    while(low != high) {
+        UA_UInt16 mid = (UA_UInt16)(low + ((high - low) / 2));
+        if(n > primes[mid])
+            low = (UA_UInt16)(mid + 1);
+        else
+            high = mid;
+    }
+    return low;
+}
+
+static NodeEntry *
+newEntry(UA_NodeClass nodeClass) {
+    size_t size = sizeof(NodeEntry) - sizeof(UA_NodeId);
+    switch(nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        size += sizeof(UA_ObjectNode);
+        break;
+    case UA_NODECLASS_VARIABLE:
+        size += sizeof(UA_VariableNode);
+        break;
+    case UA_NODECLASS_METHOD:
+        size += sizeof(UA_MethodNode);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        size += sizeof(UA_ObjectTypeNode);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        size += sizeof(UA_VariableTypeNode);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        size += sizeof(UA_ReferenceTypeNode);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        size += sizeof(UA_DataTypeNode);
+        break;
+    case UA_NODECLASS_VIEW:
+        size += sizeof(UA_ViewNode);
+        break;
+    default:
+        return NULL;
+    }
+    NodeEntry *entry = (NodeEntry*)UA_calloc(1, size);
+    if(!entry)
+        return NULL;
+    UA_Node *node = (UA_Node*)&entry->nodeId;
+    node->head.nodeClass = nodeClass;
+#ifdef UA_ENABLE_RBAC
+    node->head.permissionIndex = UA_PERMISSION_INDEX_INVALID;
+#endif
+    return entry;
+}
+
+static void
+deleteEntry(NodeEntry *entry) {
+    UA_Node_clear((UA_Node*)&entry->nodeId);
+    UA_free(entry);
+}
+
+static void
+switchReferences(NodeEntry *entry) {
+    UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree)
+            UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/* Nodes that were only read are not modified during the cleanup. So that they
+ * can be released concurrently by several readers. */
+static void
+cleanupEntry(NodeEntry *entry) {
+    if(UA_atomic_load(&entry->refCount) > 0)
+        return;
+    if(entry->deleted) {
+        deleteEntry(entry);
+        return;
+    }
+    if(entry->edited) {
+        entry->edited = false;
+        switchReferences(entry);
+    }
+}
+
+static void
+retainEntry(NodeEntry *entry) {
+    uintptr_t refCount, expected;
+    do {
+        refCount = UA_atomic_load(&entry->refCount);
+        expected = refCount;
+        UA_atomic_cmpxchg(&entry->refCount, &expected, refCount + 1);
+    } while(expected != refCount);
+}
+
+/* Returns the remaining reference count */
+static uintptr_t
+releaseEntry(NodeEntry *entry) {
+    uintptr_t refCount, expected;
+    do {
+        refCount = UA_atomic_load(&entry->refCount);
+        UA_assert(refCount > 0);
+        expected = refCount;
+        UA_atomic_cmpxchg(&entry->refCount, &expected, refCount - 1);
+    } while(expected != refCount);
+    return refCount - 1;
+}
+
+/**************/
+/* Hash Table */
+/**************/
+
+/* Returns NULL if the NodeId was not found */
+static NodeSlot *
+findOccupiedSlot(const HashMapNodestore *hns, const UA_NodeId *nodeId,
+                 UA_UInt32 h) {
+    UA_UInt32 size = hns->size;
+    UA_UInt64 idx = mod(h, size); /* Use 64bit container to avoid overflow */
+    UA_UInt32 startIdx = (UA_UInt32)idx;
+    UA_UInt32 hash2 = mod2(h, size);
+    do {
+        NodeSlot *slot = &hns->slots[(UA_UInt32)idx];
+        if(slot->entry > HASHMAP_TOMBSTONE) {
+            /* The hash is compared first to avoid dereferencing the entry */
+            if(slot->nodeIdHash == h &&
+               UA_NodeId_equal(&slot->entry->nodeId, nodeId))
+                return slot;
+        } else if(slot->entry == NULL) {
+            return NULL; /* Empty slot terminates the probe sequence */
+        }
+        idx += hash2;
+        if(idx >= size)
+            idx -= size;
+    } while((UA_UInt32)idx != startIdx);
+    return NULL;
+}
+
+/* Returns NULL if the NodeId already exists. Otherwise the first empty or
+ * tombstone slot of the probe sequence. */
+static NodeSlot *
+findFreeSlot(const HashMapNodestore *hns, const UA_NodeId *nodeId,
+             UA_UInt32 h) {
+    UA_UInt32 size = hns->size;
+    UA_UInt64 idx = mod(h, size); /* Use 64bit container to avoid overflow */
+    UA_UInt32 startIdx = (UA_UInt32)idx;
+    UA_UInt32 hash2 = mod2(h, size);
+    NodeSlot *candidate = NULL;
+    do {
+        NodeSlot *slot = &hns->slots[(UA_UInt32)idx];
+        if(slot->entry > HASHMAP_TOMBSTONE) {
+            /* A Node with the NodeId does already exist */
+            if(slot->nodeIdHash == h &&
+               UA_NodeId_equal(&slot->entry->nodeId, nodeId))
+                return NULL;
+        } else {
+            if(!candidate)
+                candidate = slot;
+            /* No matching node can come afterwards */
+            if(slot->entry == NULL)
+                return candidate;
+        }
+        idx += hash2;
+        if(idx >= size)
+            idx -= size;
+    } while((UA_UInt32)idx != startIdx);
+    return candidate;
+}
+
+/* Resize the table so that it is at most half-full with live entries.
+ * Tombstones are dropped in the process. */
+static UA_StatusCode
+resize(HashMapNodestore *hns) {
+    UA_UInt32 nindex = higher_prime_index(hns->count * 2);
+    if(primes[nindex] < HASHMAP_MINSIZE)
+        nindex = higher_prime_index(HASHMAP_MINSIZE);
+    UA_UInt32 nsize = primes[nindex];
+    NodeSlot *nslots = (NodeSlot*)UA_calloc(nsize, sizeof(NodeSlot));
+    if(!nslots)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    NodeSlot *oslots = hns->slots;
+    UA_UInt32 osize = hns->size;
+    hns->slots = nslots;
+    hns->size = nsize;
+    hns->sizePrimeIndex = nindex;
+    hns->tombstones = 0;
+
+    /* Recompute the position of every entry and insert the pointer */
+    for(size_t i = 0; i < osize; i++) {
+        if(oslots[i].entry <= HASHMAP_TOMBSTONE)
+            continue;
+        NodeSlot *s = findFreeSlot(hns, &oslots[i].entry->nodeId,
+                                   oslots[i].nodeIdHash);
+        UA_assert(s);
+        *s = oslots[i];
+    }
+
+    UA_free(oslots);
+    return UA_STATUSCODE_GOOD;
+}
+
+/***********************/
+/* Interface functions */
+/***********************/
+
+/* Not yet inserted into the HashMap */
+static UA_Node *
+hashMapNsNewNode(UA_Nodestore *_, UA_NodeClass nodeClass) {
+    NodeEntry *entry = newEntry(nodeClass);
+    if(!entry)
+        return NULL;
+    return (UA_Node*)&entry->nodeId;
+}
+
+/* Not yet inserted into the HashMap */
+static void
+hashMapNsDeleteNode(UA_Nodestore *_, UA_Node *node) {
+    deleteEntry(container_of(node, NodeEntry, nodeId));
+}
+
+static NodeEntry *
+getNodeEntry(UA_Nodestore *ns, const UA_NodeId *nodeId) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    NodeSlot *slot = findOccupiedSlot(hns, nodeId, UA_NodeId_hash(nodeId));
+    if(!slot)
+        return NULL;
+    retainEntry(slot->entry);
+    return slot->entry;
+}
+
+static const UA_Node *
+hashMapNsGetNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                 UA_UInt32 attributeMask,
+                 UA_ReferenceTypeSet references,
+                 UA_BrowseDirection referenceDirections) {
+    NodeEntry *entry = getNodeEntry(ns, nodeId);
+    if(!entry)
+        return NULL;
+    return (const UA_Node*)&entry->nodeId;
+}
+
+static UA_Node *
+hashMapNsGetEditNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                     UA_UInt32 attributeMask,
+                     UA_ReferenceTypeSet references,
+                     UA_BrowseDirection referenceDirections) {
+    NodeEntry *entry = getNodeEntry(ns, nodeId);
+    if(!entry)
+        return NULL;
+    entry->edited = true;
+    return (UA_Node*)&entry->nodeId;
+}
+
+/* Direct pointers to a node are retained by the caller. Use them as long as
+ * the node was not removed or replaced in the meantime. */
+static NodeEntry *
+getLiveNodeEntry(UA_NodePointer ptr) {
+    const UA_NodeHead *head = UA_NodePointer_getNode(ptr);
+    if(!head)
+        return NULL;
+    NodeEntry *entry = container_of(head, NodeEntry, nodeId);
+    if(entry->deleted)
+        return NULL;
+    retainEntry(entry);
+    return entry;
+}
+
+static const UA_Node *
+hashMapNsGetNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                        UA_UInt32 attributeMask,
+                        UA_ReferenceTypeSet references,
+                        UA_BrowseDirection referenceDirections) {
+    UA_NodeId id;
+    NodeEntry *entry = getLiveNodeEntry(ptr);
+    if(entry)
+        return (const UA_Node*)&entry->nodeId;
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    id = UA_NodePointer_toNodeId(ptr);
+    return hashMapNsGetNode(ns, &id, attributeMask,
+                            references, referenceDirections);
+}
+
+static UA_Node *
+hashMapNsGetEditNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                            UA_UInt32 attributeMask,
+                            UA_ReferenceTypeSet references,
+                            UA_BrowseDirection referenceDirections) {
+    UA_NodeId id;
+    NodeEntry *entry = getLiveNodeEntry(ptr);
+    if(entry) {
+        entry->edited = true;
+        return (UA_Node*)&entry->nodeId;
+    }
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    id = UA_NodePointer_toNodeId(ptr);
+    return hashMapNsGetEditNode(ns, &id, attributeMask,
+                                references, referenceDirections);
+}
+
+static void
+hashMapNsReleaseNode(UA_Nodestore *_, const UA_Node *node) {
+    if(!node)
+        return;
+    NodeEntry *entry = container_of(node, NodeEntry, nodeId);
+    if(releaseEntry(entry) == 0)
+        cleanupEntry(entry);
+}
+
+static UA_StatusCode
+hashMapNsGetNodeCopy(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                     UA_Node **outNode) {
+    /* Get the node (with all attributes and references, the mask and refs are
+       currently noy evaluated within the plugin.) */
+    const UA_Node *node =
+        hashMapNsGetNode(ns, nodeId, UA_NODEATTRIBUTESMASK_ALL,
+                         UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    if(!node)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    /* Create the new entry */
+    NodeEntry *ne = newEntry(node->head.nodeClass);
+    if(!ne) {
+        hashMapNsReleaseNode(ns, node);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* Copy the node content */
+    UA_Node *nnode = (UA_Node*)&ne->nodeId;
+    UA_StatusCode retval = UA_Node_copy(node, nnode);
+    hashMapNsReleaseNode(NULL, node);
+    if(retval != UA_STATUSCODE_GOOD) {
+        deleteEntry(ne);
+        return retval;
+    }
+
+    ne->orig = container_of(node, NodeEntry, nodeId);
+    *outNode = nnode;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsInsertNode(UA_Nodestore *ns, UA_Node *node, UA_NodeId *addedNodeId) {
+    NodeEntry *entry = container_of(node, NodeEntry, nodeId);
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+
+    /* Grow (or purge tombstones) before the table gets more than 3/4 full */
+    if((hns->count + hns->tombstones + 1) * 4 >= hns->size * 3) {
+        UA_StatusCode retval = resize(hns);
+        if(retval != UA_STATUSCODE_GOOD) {
+            deleteEntry(entry);
+            return retval;
+        }
+    }
+
+    /* Ensure that the NodeId is unique by testing their presence. If the NodeId
+     * is ns=xx;i=0, then the numeric identifier is replaced with a random
+     * unused int32. It is ensured that the created identifiers are stable after
+     * a server restart (assuming that Nodes are created in the same order and
+     * with the same BrowseName). */
+    NodeSlot *slot;
+    UA_UInt32 h;
+    if(node->head.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC &&
+       node->head.nodeId.identifier.numeric == 0) {
+        NodeSlot *found;
+        UA_UInt32 mask = 0x2F;
+        pcg32_random_t rng;
+        pcg32_srandom_r(&rng, hns->count, 0);
+        do {
+            /* Generate a random NodeId. Favor "easy" NodeIds.
+             * Always above 50000. */
+            UA_UInt32 numId = (pcg32_random_r(&rng) & mask) + 50000;
+
+#if SIZE_MAX <= UA_UINT32_MAX
+            /* The compressed "immediate" representation of nodes does not
+             * support the full range on 32bit systems. Generate smaller
+             * identifiers as they can be stored more compactly. */
+            if(numId >= (0x01 << 24))
+                numId = numId % (0x01 << 24);
+#endif
+            node->head.nodeId.identifier.numeric = numId;
+
+            /* Look up the current NodeId */
+            h = UA_NodeId_hash(&node->head.nodeId);
+            found = findOccupiedSlot(hns, &node->head.nodeId, h);
+
+            if(found) {
+                /* Reseed the rng using the browseName of the existing node.
+                 * This ensures that different information models end up with
+                 * different NodeId sequences, but still stable after a
+                 * restart. */
+                UA_NodeHead *nh = (UA_NodeHead*)&found->entry->nodeId;
+                pcg32_srandom_r(&rng, rng.state, UA_QualifiedName_hash(&nh->browseName));
+
+                /* Make the mask less strict when the NodeId already exists */
+                mask = (mask << 1) | 0x01;
+            }
+        } while(found);
+        slot = findFreeSlot(hns, &node->head.nodeId, h);
+    } else {
+        h = UA_NodeId_hash(&node->head.nodeId);
+        slot = findFreeSlot(hns, &node->head.nodeId, h);
+        if(!slot) { /* The nodeid exists */
+            deleteEntry(entry);
+            return UA_STATUSCODE_BADNODEIDEXISTS;
+        }
+    }
+    UA_assert(slot);
+
+    /* Copy the NodeId */
+    if(addedNodeId) {
+        UA_StatusCode retval = UA_NodeId_copy(&node->head.nodeId, addedNodeId);
+        if(retval != UA_STATUSCODE_GOOD) {
+            deleteEntry(entry);
+            return retval;
+        }
+    }
+
+    /* For new ReferencetypeNodes add to the index map */
+    if(node->head.nodeClass == UA_NODECLASS_REFERENCETYPE) {
+        UA_ReferenceTypeNode *refNode = &node->referenceTypeNode;
+        if(hns->referenceTypeCounter >= UA_REFERENCETYPESET_MAX) {
+            deleteEntry(entry);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+
+        UA_StatusCode retval =
+            UA_NodeId_copy(&node->head.nodeId,
+                           &hns->referenceTypeIds[hns->referenceTypeCounter]);
+        if(retval != UA_STATUSCODE_GOOD) {
+            deleteEntry(entry);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+
+        /* Assign the ReferenceTypeIndex to the new ReferenceTypeNode */
+        refNode->referenceTypeIndex = hns->referenceTypeCounter;
+        refNode->subTypes = UA_REFTYPESET(hns->referenceTypeCounter);
+        hns->referenceTypeCounter++;
+    }
+
+    /* Insert the node */
+    switchReferences(entry);
+    if(slot->entry == HASHMAP_TOMBSTONE)
+        hns->tombstones--;
+    slot->entry = entry;
+    slot->nodeIdHash = h;
+    hns->count++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsReplaceNode(UA_Nodestore *ns, UA_Node *node) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    NodeEntry *entry = container_of(node, NodeEntry, nodeId);
+
+    /* Find the node */
+    NodeSlot *slot = findOccupiedSlot(hns, &node->head.nodeId,
+                                      UA_NodeId_hash(&node->head.nodeId));
+    if(!slot) {
+        deleteEntry(entry);
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    }
+
+    /* Test if the copy is current */
+    NodeEntry *oldEntry = slot->entry;
+    if(oldEntry != entry->orig) {
+        /* The node was already updated since the copy was made */
+        deleteEntry(entry);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Replace */
+    switchReferences(entry);
+    slot->entry = entry;
+    oldEntry->deleted = true;
+    cleanupEntry(oldEntry);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsRemoveNode(UA_Nodestore *ns, const UA_NodeId *nodeId) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    NodeSlot *slot = findOccupiedSlot(hns, nodeId, UA_NodeId_hash(nodeId));
+    if(!slot)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    NodeEntry *entry = slot->entry;
+    slot->entry = HASHMAP_TOMBSTONE;
+    hns->count--;
+    hns->tombstones++;
+    entry->deleted = true;
+    cleanupEntry(entry);
+
+    /* Downsize the hashmap if it is very empty */
+    if(hns->count * 8 < hns->size && hns->size > HASHMAP_MINSIZE)
+        resize(hns); /* Can fail. Just continue with the bigger hashmap. */
+    return UA_STATUSCODE_GOOD;
+}
+
+static const UA_NodeId *
+hashMapNsGetReferenceTypeId(UA_Nodestore *ns, UA_Byte refTypeIndex) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    if(refTypeIndex >= hns->referenceTypeCounter)
+        return NULL;
+    return &hns->referenceTypeIds[refTypeIndex];
+}
+
+static void
+hashMapNsIterate(UA_Nodestore *ns, UA_NodestoreVisitor visitor,
+                 void *visitorCtx) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    for(UA_UInt32 i = 0; i < hns->size; i++) {
+        NodeEntry *entry = hns->slots[i].entry;
+        if(entry > HASHMAP_TOMBSTONE)
+            visitor(visitorCtx, (UA_Node*)&entry->nodeId);
+    }
+}
+
+/***********************/
+/* Nodestore Lifecycle */
+/***********************/
+
+static void
+hashMapNsFree(UA_Nodestore *ns) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    for(UA_UInt32 i = 0; i < hns->size; i++) {
+        if(hns->slots[i].entry > HASHMAP_TOMBSTONE)
+            deleteEntry(hns->slots[i].entry);
+    }
+    UA_free(hns->slots);
+
+    /* Clean up the ReferenceTypes index array */
+    for(size_t i = 0; i < hns->referenceTypeCounter; i++)
+        UA_NodeId_clear(&hns->referenceTypeIds[i]);
+
+    UA_free(hns);
+}
+
+UA_Nodestore *
+UA_Nodestore_HashMap(void) {
+    /* Allocate and initialize the context */
+    HashMapNodestore *hns = (HashMapNodestore*)
+        UA_calloc(1, sizeof(HashMapNodestore));
+    if(!hns)
+        return NULL;
+
+    hns->sizePrimeIndex = higher_prime_index(HASHMAP_MINSIZE);
+    hns->size = primes[hns->sizePrimeIndex];
+    hns->slots = (NodeSlot*)UA_calloc(hns->size, sizeof(NodeSlot));
+    if(!hns->slots) {
+        UA_free(hns);
+        return NULL;
+    }
+
+    /* Populate the nodestore */
+    hns->ns.free = hashMapNsFree;
+    hns->ns.newNode = hashMapNsNewNode;
+    hns->ns.deleteNode = hashMapNsDeleteNode;
+    hns->ns.getNode = hashMapNsGetNode;
+    hns->ns.getNodeFromPtr = hashMapNsGetNodeFromPtr;
+    hns->ns.releaseNode = hashMapNsReleaseNode;
+    hns->ns.getNodeCopy = hashMapNsGetNodeCopy;
+    hns->ns.insertNode = hashMapNsInsertNode;
+    hns->ns.replaceNode = hashMapNsReplaceNode;
+    hns->ns.removeNode = hashMapNsRemoveNode;
+    hns->ns.getReferenceTypeId = hashMapNsGetReferenceTypeId;
+    hns->ns.iterate = hashMapNsIterate;
+
+    hns->ns.getEditNode = hashMapNsGetEditNode;
+    hns->ns.getEditNodeFromPtr = hashMapNsGetEditNodeFromPtr;
+
+    return &hns->ns;
+}
@@ -23,8 +23,11 @@ typedef struct NodeEntry NodeEntry;
 struct NodeEntry {
     ZIP_ENTRY(NodeEntry) zipfields;
     UA_UInt32 nodeIdHash;
-    UA_UInt16 refCount; /* How many consumers have a reference to the node? */
+    UA_atomic(uintptr_t) refCount; /* How many consumers have a reference to
+                                    * the node? Atomic for concurrent readers. */
     UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
+    UA_Boolean edited;  /* Taken with getEditNode. Reorganize the references
+                         * when the last consumer releases the node. */
     NodeEntry *orig;    /* If a copy is made to replace a node, track that we
                          * replace only the node from which the copy was made.
                          * Important for concurrent operations. */
@@ -111,22 +114,55 @@ deleteEntry(NodeEntry *entry) {
     UA_free(entry);
 }
 
+static void
+switchReferences(NodeEntry *entry) {
+    UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree)
+            UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/* Nodes that were only read are not modified during the cleanup. So that they
+ * can be released concurrently by several readers. */
 static void
 cleanupEntry(NodeEntry *entry) {
-    if(entry->refCount > 0)
+    if(UA_atomic_load(&entry->refCount) > 0)
         return;
     if(entry->deleted) {
         deleteEntry(entry);
         return;
     }
-    UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
-    for(size_t i = 0; i < head->referencesSize; i++) {
-        UA_NodeReferenceKind *rk = &head->references[i];
-        if(rk->targetsSize > 16 && !rk->hasRefTree)
-            UA_NodeReferenceKind_switch(rk);
+    if(entry->edited) {
+        entry->edited = false;
+        switchReferences(entry);
     }
 }
 
+static void
+retainEntry(NodeEntry *entry) {
+    uintptr_t refCount, expected;
+    do {
+        refCount = UA_atomic_load(&entry->refCount);
+        expected = refCount;
+        UA_atomic_cmpxchg(&entry->refCount, &expected, refCount + 1);
+    } while(expected != refCount);
+}
+
+/* Returns the remaining reference count */
+static uintptr_t
+releaseEntry(NodeEntry *entry) {
+    uintptr_t refCount, expected;
+    do {
+        refCount = UA_atomic_load(&entry->refCount);
+        UA_assert(refCount > 0);
+        expected = refCount;
+        UA_atomic_cmpxchg(&entry->refCount, &expected, refCount - 1);
+    } while(expected != refCount);
+    return refCount - 1;
+}
+
 /***********************/
 /* Interface functions */
 /***********************/
@@ -157,7 +193,7 @@ getNodeEntry(UA_Nodestore *ns, const UA_NodeId *nodeId) {
     entry = ZIP_FIND(NodeTree, &zns->root, &dummy);
     if(!entry)
         return NULL;
-    ++entry->refCount;
+    retainEntry(entry);
     return entry;
 }
 
@@ -180,15 +216,33 @@ zipNsGetEditNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
     NodeEntry *entry = getNodeEntry(ns, nodeId);
     if(!entry)
         return NULL;
+    entry->edited = true;
     return (UA_Node*)&entry->nodeId;
 }
 
+/* Direct pointers to a node are retained by the caller. Use them as long as
+ * the node was not removed or replaced in the meantime. */
+static NodeEntry *
+getLiveNodeEntry(UA_NodePointer ptr) {
+    const UA_NodeHead *head = UA_NodePointer_getNode(ptr);
+    if(!head)
+        return NULL;
+    NodeEntry *entry = container_of(head, NodeEntry, nodeId);
+    if(entry->deleted)
+        return NULL;
+    retainEntry(entry);
+    return entry;
+}
+
 static const UA_Node *
 zipNsGetNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
                     UA_UInt32 attributeMask,
                     UA_ReferenceTypeSet references,
                     UA_BrowseDirection referenceDirections) {
     UA_NodeId id;
+    NodeEntry *entry = getLiveNodeEntry(ptr);
+    if(entry)
+        return (const UA_Node*)&entry->nodeId;
     if(!UA_NodePointer_isLocal(ptr))
         return NULL;
     id = UA_NodePointer_toNodeId(ptr);
@@ -202,6 +256,11 @@ zipNsGetEditNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
                         UA_ReferenceTypeSet references,
                         UA_BrowseDirection referenceDirections) {
     UA_NodeId id;
+    NodeEntry *entry = getLiveNodeEntry(ptr);
+    if(entry) {
+        entry->edited = true;
+        return (UA_Node*)&entry->nodeId;
+    }
     if(!UA_NodePointer_isLocal(ptr))
         return NULL;
     id = UA_NodePointer_toNodeId(ptr);
@@ -214,9 +273,8 @@ zipNsReleaseNode(UA_Nodestore *_, const UA_Node *node) {
     if(!node)
         return;
     NodeEntry *entry = container_of(node, NodeEntry, nodeId);
-    UA_assert(entry->refCount > 0);
-    --entry->refCount;
-    cleanupEntry(entry);
+    if(releaseEntry(entry) == 0)
+        cleanupEntry(entry);
 }
 
 static UA_StatusCode
@@ -341,6 +399,7 @@ zipNsInsertNode(UA_Nodestore *ns, UA_Node *node, UA_NodeId *addedNodeId) {
     }
 
     /* Insert the node */
+    switchReferences(entry);
     entry->nodeIdHash = dummy.nodeIdHash;
     ZIP_INSERT(NodeTree, &zns->root, entry);
     zns->size++;
@@ -369,6 +428,7 @@ zipNsReplaceNode(UA_Nodestore *ns, UA_Node *node) {
     }
 
     /* Replace */
+    switchReferences(entry);
     ZipNodestore *zns = (ZipNodestore*)ns;
     ZIP_REMOVE(NodeTree, &zns->root, oldEntry);
     entry->nodeIdHash = oldEntry->nodeIdHash;
@@ -321,6 +321,7 @@ UA_Client_delete(UA_Client* client) {
     UA_Client_disconnect(client);
     UA_Client_clear(client);
     UA_ClientConfig_clear(&client->config);
+    UA_DataTypeIndex_delete(client->customTypesIndex);
     UA_free(client);
 }
 
@@ -528,14 +529,15 @@ __Client_AsyncService_find(UA_Client *client, UA_UInt32 requestId) {
 }
 
 static UA_StatusCode
-decodeBinaryServiceResponse(UA_Client *client, const UA_ByteString *msg,
-                            const UA_DataType *expectedType,
+decodeBinaryServiceResponse(UA_Client *client, const UA_ByteString *segments,
+                            size_t segmentsSize, const UA_DataType *expectedType,
                             UA_Response *response,
                             const UA_DataType **responseType) {
     size_t offset = 0;
     UA_NodeId responseTypeId;
-    UA_NodeId_init(&responseTypeId);
-    UA_StatusCode res = UA_NodeId_decodeBinary(msg, &offset, &responseTypeId);
+    UA_StatusCode res =
+        UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset, &responseTypeId,
+                                        &UA_TYPES[UA_TYPES_NODEID], NULL, NULL);
     if(res != UA_STATUSCODE_GOOD) {
         UA_NodeId_clear(&responseTypeId);
         return res;
@@ -567,8 +569,13 @@ decodeBinaryServiceResponse(UA_Client *client, const UA_ByteString *msg,
     memset(&opt, 0, sizeof(opt));
     opt.customTypes = client->config.customDataTypes;
     opt.namespaceMapping = client->channel.namespaceMapping;
-    res = UA_decodeBinaryInternal(msg, &offset, response, *responseType, &opt);
-    if(res == UA_STATUSCODE_GOOD && offset != msg->length)
+    res = UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset,
+                                          response, *responseType, &opt,
+                                          client->customTypesIndex);
+    size_t length = 0;
+    for(size_t i = 0; i < segmentsSize; i++)
+        length += segments[i].length;
+    if(res == UA_STATUSCODE_GOOD && offset != length)
         res = UA_STATUSCODE_BADDECODINGERROR;
     UA_NodeId_clear(&responseTypeId);
     return res;
@@ -619,18 +626,21 @@ decodeJsonServiceResponse(UA_Client *client, const UA_ByteString *msg,
 #endif
 
 static UA_StatusCode
-decodeServiceResponse(UA_Client *client, const UA_ByteString *msg,
-                      UA_SecureChannelEncoding encoding,
+decodeServiceResponse(UA_Client *client, const UA_ByteString *segments,
+                      size_t segmentsSize, UA_SecureChannelEncoding encoding,
                       const UA_DataType *expectedType, UA_Response *response,
                       const UA_DataType **responseType) {
     switch(encoding) {
     case UA_SECURECHANNEL_ENCODING_BINARY:
-        return decodeBinaryServiceResponse(client, msg, expectedType, response,
-                                           responseType);
+        return decodeBinaryServiceResponse(client, segments, segmentsSize,
+                                           expectedType, response, responseType);
 #ifdef UA_ENABLE_JSON_ENCODING
     case UA_SECURECHANNEL_ENCODING_JSON:
-        return decodeJsonServiceResponse(client, msg, expectedType, response,
-                                         responseType);
+        /* JSON messages are received over HTTP in a contiguous body */
+        if(segmentsSize != 1)
+            return UA_STATUSCODE_BADDECODINGERROR;
+        return decodeJsonServiceResponse(client, &segments[0], expectedType,
+                                         response, responseType);
 #endif
     default:
         return UA_STATUSCODE_BADNOTSUPPORTED;
@@ -640,7 +650,8 @@ decodeServiceResponse(UA_Client *client, const UA_ByteString *msg,
 /* Look for the async callback in the linked list, execute and delete it */
 UA_StatusCode
 __Client_processServiceResponsePayload(UA_Client *client, UA_UInt32 requestId,
-                                       const UA_ByteString *msg,
+                                       const UA_ByteString *segments,
+                                       size_t segmentsSize,
                                        UA_SecureChannelEncoding encoding) {
     UA_ClientConfig *config = &client->config;
 
@@ -675,7 +686,7 @@ __Client_processServiceResponsePayload(UA_Client *client, UA_UInt32 requestId,
 
     /* Decode the response */
     UA_StatusCode retval = decodeServiceResponse(
-        client, msg, encoding, ac->responseType, response,
+        client, segments, segmentsSize, encoding, ac->responseType, response,
         &responseType);
 
     /* Process the received MSG response */
@@ -773,7 +784,7 @@ __Client_processServiceResponsePayload(UA_Client *client, UA_UInt32 requestId,
 UA_StatusCode
 processServiceResponse(UA_Client *client, UA_SecureChannel *channel,
                        UA_MessageType messageType, UA_UInt32 requestId,
-                       UA_ByteString *message) {
+                       const UA_ByteString *segments, size_t segmentsSize) {
     if(!UA_SecureChannel_isConnected(channel)) {
         if(messageType == UA_MESSAGETYPE_MSG) {
             UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Discard MSG message "
@@ -789,25 +800,26 @@ processServiceResponse(UA_Client *client, UA_SecureChannel *channel,
     switch(messageType) {
     case UA_MESSAGETYPE_RHE:
         UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Process RHE message");
-        processRHEMessage(client, message);
+        processRHEMessage(client, &segments[0]);
         return UA_STATUSCODE_GOOD;
     case UA_MESSAGETYPE_ACK:
         UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Process ACK message");
-        processACKResponse(client, message);
+        processACKResponse(client, &segments[0]);
         return UA_STATUSCODE_GOOD;
     case UA_MESSAGETYPE_OPN:
         UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Process OPN message");
-        processOPNResponse(client, message);
+        processOPNResponse(client, &segments[0]);
         return UA_STATUSCODE_GOOD;
     case UA_MESSAGETYPE_ERR:
         UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Process ERR message");
-        processERRResponse(client, message);
+        processERRResponse(client, &segments[0]);
         return UA_STATUSCODE_GOOD;
     case UA_MESSAGETYPE_MSG:
         UA_LOG_DEBUG_CHANNEL(client->config.logging, channel, "Process MSG message "
                              "with RequestId %u", requestId);
         return __Client_processServiceResponsePayload(
-            client, requestId, message, UA_SECURECHANNEL_ENCODING_BINARY);
+            client, requestId, segments, segmentsSize,
+            UA_SECURECHANNEL_ENCODING_BINARY);
     default:
         UA_LOG_TRACE_CHANNEL(client->config.logging, channel,
                              "Invalid message type");
@@ -1413,7 +1425,26 @@ UA_Client_run_iterate(UA_Client *client, UA_UInt32 timeout) {
 
 const UA_DataType *
 UA_Client_findDataType(UA_Client *client, const UA_NodeId *typeId) {
-    return UA_findDataTypeWithCustom(typeId, client->config.customDataTypes);
+    lockClient(client);
+    const UA_DataType *type =
+        UA_findDataTypeIndexed(typeId, client->config.customDataTypes,
+                               client->customTypesIndex);
+    unlockClient(client);
+    return type;
+}
+
+void
+indexClientCustomTypes(UA_Client *client) {
+    UA_LOCK_ASSERT(&client->clientMutex);
+    if(client->customTypesIndex &&
+       UA_DataTypeIndex_isCurrent(client->customTypesIndex,
+                                  client->config.customDataTypes))
+        return;
+    UA_DataTypeIndex_delete(client->customTypesIndex);
+    client->customTypesIndex = NULL;
+    /* Without the index the types are found with a linear search. So we can
+     * ignore errors. */
+    UA_DataTypeIndex_new(client->config.customDataTypes, &client->customTypesIndex);
 }
 
 /*************************/
@@ -2368,16 +2368,14 @@ __Client_networkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     while(UA_LIKELY(res == UA_STATUSCODE_GOOD)) {
         UA_MessageType messageType = UA_MESSAGETYPE_INVALID;
         UA_UInt32 requestId = 0;
-        UA_ByteString payload = UA_BYTESTRING_NULL;
-        UA_Boolean copied = false;
+        UA_MessagePayload payload;
         res = UA_SecureChannel_getCompleteMessage(&client->channel, &messageType, &requestId,
-                                                  &payload, &copied, nowMonotonic);
+                                                  &payload, nowMonotonic);
         if(res != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
-        res = processServiceResponse(client, &client->channel,
-                                     messageType, requestId, &payload);
-        if(copied)
-            UA_ByteString_clear(&payload);
+        res = processServiceResponse(client, &client->channel, messageType, requestId,
+                                     payload.segments, payload.segmentsSize);
+        UA_MessagePayload_clear(&payload);
 
         /* Abort after synchronous processing of a message.
          * Add a delayed callback to process the remaining buffer ASAP. */
@@ -2449,6 +2447,9 @@ initConnect(UA_Client *client) {
         return;
     }
 
+    /* The custom types are set in the config before connecting */
+    indexClientCustomTypes(client);
+
     UA_StatusCode res = UA_STATUSCODE_BADNOTSUPPORTED;
 
     /* An exact endpoint was configured. Use it. */
@@ -2988,6 +2989,8 @@ UA_Client_startListeningForReverseConnect(UA_Client *client,
         return UA_STATUSCODE_BADINVALIDSTATE;
     }
 
+    indexClientCustomTypes(client);
+
     const UA_String tcpString = UA_STRING_STATIC("tcp");
     UA_StatusCode res = UA_STATUSCODE_BADINTERNALERROR;
 
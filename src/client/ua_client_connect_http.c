@@ -152,7 +152,7 @@ completeHttpResponse(UA_Client *client, AsyncServiceCall *ac,
         /* The service processor consumes a known RequestId even if the body is
          * malformed. It owns service completion after this handoff. */
         (void)__Client_processServiceResponsePayload(
-            client, ac->requestId, &ac->httpResponseBody,
+            client, ac->requestId, &ac->httpResponseBody, 1,
             client->channel.encoding);
     }
 }
@@ -160,7 +160,8 @@ __Client_nextRequestId(UA_Client *client);
  * An unknown or already completed RequestId is ignored. */
 UA_StatusCode
 __Client_processServiceResponsePayload(UA_Client *client, UA_UInt32 requestId,
-                                       const UA_ByteString *message,
+                                       const UA_ByteString *segments,
+                                       size_t segmentsSize,
                                        UA_SecureChannelEncoding encoding);
 
 typedef struct CustomCallback {
@@ -257,6 +258,10 @@ struct UA_Client {
     UA_String *namespaces;
     size_t namespacesSize;
 
+    /* Lookup index for the config->customDataTypes list. Rebuilt under the
+     * client lock when connecting. Ignored when the list has changed since. */
+    UA_DataTypeIndex *customTypesIndex;
+
     /* Internal locking for thread-safety. Methods starting with UA_Client_ that
      * are marked with UA_THREADSAFE take the lock. The lock is released before
      * dropping into the EventLoop and before calling user-defined callbacks.
@@ -278,6 +283,10 @@ verifyServerCertificateEku(const UA_ClientConfig *config,
 void lockClient(UA_Client *client);
 void unlockClient(UA_Client *client);
 
+/* (Re)build the lookup index for config->customDataTypes */
+void
+indexClientCustomTypes(UA_Client *client);
+
 UA_StatusCode
 __Client_AsyncService(UA_Client *client, const void *request,
                       const UA_DataType *requestType,
@@ -347,7 +356,7 @@ __Client_renewSecureChannel(UA_Client *client);
 UA_StatusCode
 processServiceResponse(UA_Client *client, UA_SecureChannel *channel,
                        UA_MessageType messageType, UA_UInt32 requestId,
-                       UA_ByteString *message);
+                       const UA_ByteString *segments, size_t segmentsSize);
 
 UA_StatusCode connectInternal(UA_Client *client, UA_Boolean async);
 UA_StatusCode connectSecureChannel(UA_Client *client, const char *endpointUrl);
@@ -245,7 +245,9 @@ UA_PubSubConnection_process(UA_PubSubManager *psm, UA_PubSubConnection *c,
     memset(&nm, 0, sizeof(UA_NetworkMessage));
 
     /* Decode the NetworkMessage with the first matching ReaderGroup */
-    UA_ReaderGroup *rg;
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime now = el->dateTime_nowMonotonic(el), start = now;
+    UA_ReaderGroup *rg, *decodeRg;
     UA_StatusCode res = UA_STATUSCODE_BADNOTFOUND;
     LIST_FOREACH(rg, &c->readerGroups, listEntry) {
         if(rg->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
@@ -265,17 +267,37 @@ UA_PubSubConnection_process(UA_PubSubManager *psm, UA_PubSubConnection *c,
             break;
     }
 
-    if(res != UA_STATUSCODE_GOOD)
+    /* None of the (enabled) ReaderGroups could decode the message */
+    if(res != UA_STATUSCODE_GOOD) {
+        LIST_FOREACH(rg, &c->readerGroups, listEntry) {
+            if(rg->head.state == UA_PUBSUBSTATE_OPERATIONAL ||
+               rg->head.state == UA_PUBSUBSTATE_PREOPERATIONAL)
+                rg->stats.droppedNetworkMessages++;
+        }
         goto finish;
+    }
 
-    /* Process the received message for all ReaderGroups */
+    /* Process the received message for all ReaderGroups. The message memory
+     * belongs to the decoding ReaderGroup. */
+    decodeRg = rg;
+    now = el->dateTime_nowMonotonic(el);
+    UA_PubSubHistogram_add(&decodeRg->stats.decodeTime, now - start);
     LIST_FOREACH(rg, &c->readerGroups, listEntry) {
         if(rg->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
            rg->head.state != UA_PUBSUBSTATE_PREOPERATIONAL)
             continue;
-        processed |= UA_ReaderGroup_process(psm, rg, &nm);
+        UA_Boolean rgProcessed = UA_ReaderGroup_process(psm, rg, &nm);
+        start = now;
+        now = el->dateTime_nowMonotonic(el);
+        if(!rgProcessed)
+            continue;
+        processed = true;
+        rg->stats.receivedNetworkMessages++;
+        UA_PubSubHistogram_add(&rg->stats.processTime, now - start);
     }
-    UA_NetworkMessage_clear(&nm);
+    if(!processed)
+        decodeRg->stats.droppedNetworkMessages++;
+    UA_ReaderGroup_clearNetworkMessage(psm, decodeRg, &nm);
 
  finish:
     if(!processed) {
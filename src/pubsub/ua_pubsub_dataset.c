@@ -224,6 +224,25 @@ generateFieldMetaData(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
     return UA_STATUSCODE_GOOD;
 }
 
+/* The fields can change while the DataSetWriters of the PublishedDataSet are
+ * disabled. But their WriterGroups may be publishing on value change. */
+static void
+updateValueChangeWriterGroups(UA_PubSubManager *psm, UA_PublishedDataSet *pds) {
+    UA_PubSubConnection *conn;
+    TAILQ_FOREACH(conn, &psm->connections, listEntry) {
+        UA_WriterGroup *wg;
+        LIST_FOREACH(wg, &conn->writerGroups, listEntry) {
+            UA_DataSetWriter *dsw;
+            LIST_FOREACH(dsw, &wg->writers, listEntry) {
+                if(dsw->connectedDataSet != pds)
+                    continue;
+                UA_WriterGroup_updateValueChangeMonitoredItems(psm, wg);
+                break;
+            }
+        }
+    }
+}
+
 UA_DataSetFieldResult
 UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
                        const UA_DataSetFieldConfig *fieldConfig,
@@ -307,6 +326,8 @@ UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
     if(newField->config.field.variable.promotedField)
         currDS->promotedFieldsCount++;
 
+    updateValueChangeWriterGroups(psm, currDS);
+
     /* Update major version of parent published data set */
     UA_EventLoop *el = psm->drv.server->config.eventLoop;
     currDS->dataSetMetaData.configurationVersion.majorVersion =
@@ -372,6 +393,7 @@ UA_DataSetField_remove(UA_PubSubManager *psm, UA_DataSetField *currentField) {
     TAILQ_REMOVE(&pds->fields, currentField, listEntry);
     UA_DataSetField_clear(currentField);
     UA_free(currentField);
+    updateValueChangeWriterGroups(psm, pds);
 
     /* Update major version of PublishedDataSet */
     UA_EventLoop *el = psm->drv.server->config.eventLoop;
@@ -444,6 +466,48 @@ UA_PubSubDataSetField_sampleValue(UA_PubSubManager *psm, UA_DataSetField *field,
                              &rvid, UA_TIMESTAMPSTORETURN_BOTH);
 }
 
+const UA_Node *
+UA_PubSubDataSetField_borrowValue(UA_PubSubManager *psm, UA_DataSetField *field,
+                                  UA_DataValue *value) {
+    UA_Server *server = psm->drv.server;
+    UA_PublishedVariableDataType *params = &field->config.field.variable.publishParameters;
+    if(params->attributeId != UA_ATTRIBUTEID_VALUE || params->indexRange.length > 0)
+        goto sample;
+
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, &params->publishedVariable,
+                                   UA_NODEATTRIBUTESMASK_VALUE,
+                                   UA_REFERENCETYPESET_NONE,
+                                   UA_BROWSEDIRECTION_INVALID);
+    if(!node)
+        goto sample;
+
+    /* The onRead notification and the callback value source can update the
+     * value. Go through the Read service for them. */
+    const UA_VariableNode *vn = &node->variableNode;
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        goto release;
+    if(vn->valueSourceType == UA_VALUESOURCETYPE_INTERNAL &&
+       !vn->valueSource.internal.notifications.onRead) {
+        *value = vn->valueSource.internal.value;
+        return node;
+    }
+    if(vn->valueSourceType == UA_VALUESOURCETYPE_EXTERNAL &&
+       !vn->valueSource.external.notifications.onRead) {
+        const UA_DataValue *dv = UA_atomic_load(vn->valueSource.external.value);
+        if(dv) {
+            *value = *dv;
+            return node;
+        }
+    }
+
+ release:
+    UA_NODESTORE_RELEASE(server, node);
+ sample:
+    UA_PubSubDataSetField_sampleValue(psm, field, value);
+    return NULL;
+}
+
 UA_AddPublishedDataSetResult
 UA_PublishedDataSet_create(UA_PubSubManager *psm,
                            const UA_PublishedDataSetConfig *publishedDataSetConfig,
@@ -156,6 +156,60 @@ typedef struct {
 void
 UA_PubSubComponentHead_clear(UA_PubSubComponentHead *psch);
 
+/**********************************************/
+/*               Per-Cycle Arena              */
+/**********************************************/
+
+/* Bump allocator for the transient memory of one publish or receive cycle.
+ * Everything is released at once with _reset at the end of the cycle. When the
+ * block is exhausted, the allocations fall back to the heap. The block is then
+ * grown with the next reset. So the following cycles of the same size do not
+ * need the heap.
+ *
+ * Values borrowed from nodes without a copy are registered together with their
+ * node. The node is released with the reset. Sampled values that own heap
+ * memory are registered to be cleared with the reset. */
+
+typedef struct UA_PubSubArenaOverflow {
+    struct UA_PubSubArenaOverflow *next;
+} UA_PubSubArenaOverflow;
+
+typedef struct UA_PubSubArenaCleanup {
+    struct UA_PubSubArenaCleanup *next;
+    const UA_Node *node; /* Released with the reset */
+    UA_DataValue *value; /* Cleared with the reset */
+} UA_PubSubArenaCleanup;
+
+typedef struct {
+    UA_Byte *block;
+    size_t blockSize;
+    size_t blockUsed;
+    size_t overflowSize; /* Heap allocations in this cycle */
+    UA_PubSubArenaOverflow *overflow;
+    UA_PubSubArenaCleanup *cleanup;
+    UA_UInt64 heapAllocations; /* Statistics */
+} UA_PubSubArena;
+
+/* Has the signature of the calloc in UA_DecodeBinaryOptions */
+void *
+UA_PubSubArena_calloc(void *arena, size_t nelem, size_t elsize);
+
+UA_StatusCode
+UA_PubSubArena_addCleanup(UA_PubSubArena *arena, const UA_Node *node,
+                          UA_DataValue *value);
+
+void
+UA_PubSubArena_reset(UA_PubSubArena *arena, UA_Server *server);
+
+/* Reset and free the block */
+void
+UA_PubSubArena_clear(UA_PubSubArena *arena, UA_Server *server);
+
+/* Add a duration (in UA_DateTime ticks) to the histogram. Negative durations
+ * are counted as zero. */
+void
+UA_PubSubHistogram_add(UA_PubSubHistogram *h, UA_DateTime duration);
+
 /**********************************************/
 /*            PublishedDataSet                */
 /**********************************************/
@@ -220,6 +274,24 @@ UA_SubscribedDataSet_remove(UA_PubSubManager *psm, UA_SubscribedDataSet *sds);
 /*               Connection                   */
 /**********************************************/
 
+/* The DataSetReaders are indexed by the (PublisherId, WriterGroupId,
+ * DataSetWriterId) they expect. The PublisherId hash is compared first. So the
+ * PublisherIds themselves are only compared on a hash collision. Several
+ * readers can have the same key. */
+typedef struct {
+    UA_UInt16 dataSetWriterId;
+    UA_UInt16 writerGroupId;
+    UA_UInt32 publisherIdHash;
+    const UA_PublisherId *publisherId; /* Points into the reader config or the
+                                        * received NetworkMessage */
+} UA_DataSetReaderKey;
+
+void
+UA_DataSetReaderKey_init(UA_DataSetReaderKey *key, const UA_PublisherId *publisherId,
+                         UA_UInt16 writerGroupId, UA_UInt16 dataSetWriterId);
+
+typedef ZIP_HEAD(UA_DataSetReaderIndex, UA_DataSetReader) UA_DataSetReaderIndex;
+
 typedef struct UA_PubSubConnection {
     UA_PubSubComponentHead head;
     TAILQ_ENTRY(UA_PubSubConnection) listEntry;
@@ -247,6 +319,10 @@ typedef struct UA_PubSubConnection {
     size_t readerGroupsSize;
     LIST_HEAD(, UA_ReaderGroup) readerGroups;
 
+    /* Index of the DataSetReaders of all ReaderGroups. Used to route received
+     * DataSetMessages to their readers without a linear search. */
+    UA_DataSetReaderIndex readerIndex;
+
     UA_DateTime silenceErrorUntil; /* Avoid generating too many logs */
 
     UA_Boolean deleteFlag; /* To be deleted - in addition to the PubSubState */
@@ -294,6 +370,12 @@ typedef struct UA_DataSetWriter {
     UA_UInt16 actualDataSetMessageSequenceCount;
     UA_Boolean configurationFrozen;
     UA_UInt64 pubSubStateTimerId;
+
+#ifdef UA_ENABLE_JSON_ENCODING
+    /* Compiled when the DataSetMessages are first encoded in JSON. Reset
+     * together with the templates of the WriterGroup. */
+    UA_DataSetMessageJsonTemplate jsonTemplate;
+#endif
 } UA_DataSetWriter;
 
 UA_StatusCode
@@ -307,10 +389,14 @@ UA_StatusCode
 UA_DataSetWriter_setPubSubState(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
                                 UA_PubSubState targetState);
 
+/* If the arena is set, the message content is allocated in the arena and must
+ * not be cleared. Otherwise the message is cleared with
+ * UA_DataSetMessage_clear. */
 UA_StatusCode
 UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
                                         UA_DataSetWriter *dsw,
-                                        UA_DataSetMessage *dsm);
+                                        UA_DataSetMessage *dsm,
+                                        UA_PubSubArena *arena);
 
 UA_StatusCode
 UA_DataSetWriter_create(UA_PubSubManager *psm,
@@ -325,6 +411,23 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw);
 /*               WriterGroup                  */
 /**********************************************/
 
+/* Position in a pre-encoded NetworkMessage that is updated in every publish
+ * cycle of the fast path */
+typedef struct {
+    UA_PubSubOffsetType offsetType;
+    size_t offset;
+    size_t length;            /* Encoded length of the DataSetField */
+    UA_DataSetWriter *writer; /* Writer of the (current) DataSetMessage */
+    struct UA_DataSetField *field;
+    size_t fieldIndex;        /* Index of the FieldMetaData in the PDS */
+} UA_NetworkMessageTemplateOffset;
+
+typedef struct {
+    UA_ByteString buffer;
+    size_t offsetsSize;
+    UA_NetworkMessageTemplateOffset *offsets;
+} UA_NetworkMessageTemplate;
+
 struct UA_WriterGroup {
     UA_PubSubComponentHead head;
     LIST_ENTRY(UA_WriterGroup) listEntry;
@@ -335,6 +438,12 @@ struct UA_WriterGroup {
     UA_UInt32 writersCount;
 
     UA_UInt64 publishCallbackId; /* registered if != 0 */
+
+    /* Publish on value change. A pending publish is registered as a one-time
+     * timer. The keep-alive timer is the regular publish callback. */
+    UA_UInt64 valueChangeCallbackId; /* registered if != 0 */
+    size_t valueChangeItemsSize;
+    UA_UInt32 *valueChangeItems; /* Ids of the local MonitoredItems */
     UA_UInt16 sequenceNumber; /* Increased after every sent message */
     UA_DateTime lastPublishTimeStamp;
 
@@ -344,6 +453,29 @@ struct UA_WriterGroup {
     uintptr_t sendChannel;
     UA_Boolean deleteFlag;
 
+    /* Fast path: The NetworkMessages of the last regular publish cycle for the
+     * given number of operational Writers */
+    UA_Boolean templatesValid;
+    UA_Boolean templatesFailed; /* Don't retry before the next state change */
+    size_t templatesSize;
+    UA_NetworkMessageTemplate *templates;
+    size_t templatesWriters;
+
+    UA_PubSubArena arena; /* Memory of the DataSetMessages in one cycle */
+
+#ifdef UA_ENABLE_JSON_ENCODING
+    /* Precompiled JSON encoding. The header is compiled together with the
+     * templates of the DataSetWriters. The messages are encoded into the
+     * scratch buffer and copied into the network buffer afterwards. This
+     * avoids the separate pass to compute the message length. */
+    UA_String jsonHeader;
+    UA_ByteString jsonBuffer;
+#endif
+
+    UA_WriterGroupStatistics stats;
+    UA_DateTime nextPublishTime; /* Expected next execution of the timer */
+    UA_DateTime cycleSendTime;   /* Time spent sending in the current cycle */
+
     UA_UInt32 securityTokenId;
     UA_UInt32 nonceSequenceNumber; /* To be part of the MessageNonce */
     void *securityPolicyContext;
@@ -367,6 +499,17 @@ UA_WriterGroup_addPublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg);
 void
 UA_WriterGroup_removePublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg);
 
+/* Recreate the MonitoredItems of a WriterGroup that publishes on value change
+ * after its DataSetWriters or their DataSetFields were added or removed */
+void
+UA_WriterGroup_updateValueChangeMonitoredItems(UA_PubSubManager *psm,
+                                               UA_WriterGroup *wg);
+
+/* Drop the pre-encoded NetworkMessages of the fast path. They are recorded
+ * again in the next publish cycle. */
+void
+UA_WriterGroup_resetTemplates(UA_WriterGroup *wg);
+
 UA_StatusCode
 UA_WriterGroup_setEncryptionKeys(UA_PubSubManager *psm, UA_WriterGroup *wg,
                                  UA_UInt32 securityTokenId,
@@ -423,10 +566,30 @@ UA_PubSubDataSetField_sampleValue(UA_PubSubManager *psm,
                                   UA_DataSetField *field,
                                   UA_DataValue *value);
 
+/* Sample the value without a copy from the value source of the VariableNode.
+ * The returned node has to be released after the value was used. If NULL is
+ * returned, the value was sampled with UA_PubSubDataSetField_sampleValue
+ * instead and has to be cleared. */
+const UA_Node *
+UA_PubSubDataSetField_borrowValue(UA_PubSubManager *psm,
+                                  UA_DataSetField *field,
+                                  UA_DataValue *value);
+
 /**********************************************/
 /*               DataSetReader                */
 /**********************************************/
 
+/* Target variable for the directValueWrite mode of the DataSetReader */
+typedef struct {
+    const UA_DataType *type; /* Type of the received field. NULL if the Write
+                              * service has to be used for the target. */
+    UA_NodeId dataType;      /* DataType and ValueRank of the target node when */
+    UA_Int32 valueRank;      /* it was resolved */
+    UA_Boolean scalar;       /* The ValueRank allows scalars */
+    UA_Boolean array;        /* The ValueRank allows one-dimensional arrays */
+    UA_Node *node;           /* Borrowed while a DataSetMessage is processed */
+} UA_DataSetReaderTarget;
+
 struct UA_DataSetReader {
     UA_PubSubComponentHead head;
     LIST_ENTRY(UA_DataSetReader) listEntry;
@@ -434,10 +597,56 @@ struct UA_DataSetReader {
     UA_DataSetReaderConfig config;
     UA_ReaderGroup *linkedReaderGroup;
 
+    /* Entry in the readerIndex of the PubSubConnection */
+    UA_DataSetReaderKey indexKey;
+    ZIP_ENTRY(UA_DataSetReader) indexEntry;
+
+    /* Resolved targets for the directValueWrite mode. One entry for each
+     * TargetVariable. Resolved when the reader is enabled. */
+    size_t targetsSize;
+    UA_DataSetReaderTarget *targets;
+
+    /* Delta frames are applied on top of the field values from the last key
+     * frame. They are discarded until a key frame was received and after a gap
+     * in the DataSetMessage sequence numbers. */
+    UA_Boolean keyFrameReceived;
+    UA_UInt16 lastSequenceNr;
+
     /* MessageReceiveTimeout handling */
     UA_UInt64 msgRcvTimeoutTimerId;
 };
 
+static UA_INLINE enum ZIP_CMP
+cmpDataSetReaderKey(const UA_DataSetReaderKey *a, const UA_DataSetReaderKey *b) {
+    if(a->dataSetWriterId != b->dataSetWriterId)
+        return (a->dataSetWriterId < b->dataSetWriterId) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    if(a->writerGroupId != b->writerGroupId)
+        return (a->writerGroupId < b->writerGroupId) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    if(a->publisherIdHash != b->publisherIdHash)
+        return (a->publisherIdHash < b->publisherIdHash) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    const UA_PublisherId *pa = a->publisherId;
+    const UA_PublisherId *pb = b->publisherId;
+    if(pa->idType != pb->idType)
+        return (pa->idType < pb->idType) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    UA_UInt64 va, vb;
+    switch(pa->idType) {
+    case UA_PUBLISHERIDTYPE_BYTE:   va = pa->id.byte;   vb = pb->id.byte;   break;
+    case UA_PUBLISHERIDTYPE_UINT16: va = pa->id.uint16; vb = pb->id.uint16; break;
+    case UA_PUBLISHERIDTYPE_UINT32: va = pa->id.uint32; vb = pb->id.uint32; break;
+    case UA_PUBLISHERIDTYPE_UINT64: va = pa->id.uint64; vb = pb->id.uint64; break;
+    case UA_PUBLISHERIDTYPE_STRING:
+        return (enum ZIP_CMP)UA_order(&pa->id.string, &pb->id.string,
+                                      &UA_TYPES[UA_TYPES_STRING]);
+    default: return ZIP_CMP_EQ;
+    }
+    if(va == vb)
+        return ZIP_CMP_EQ;
+    return (va < vb) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+}
+
+ZIP_FUNCTIONS(UA_DataSetReaderIndex, UA_DataSetReader, indexEntry,
+              UA_DataSetReaderKey, indexKey, cmpDataSetReaderKey)
+
 UA_DataSetReader *
 UA_DataSetReader_find(UA_PubSubManager *psm, const UA_NodeId id);
 
@@ -501,6 +710,10 @@ struct UA_ReaderGroup {
 #ifdef UA_ENABLE_PUBSUB_SKS
     UA_PubSubKeyStorage *keyStorage;
 #endif
+
+    UA_PubSubArena arena; /* Memory of the decoded NetworkMessage */
+
+    UA_ReaderGroupStatistics stats;
 };
 
 UA_StatusCode
@@ -550,12 +763,19 @@ verifyAndDecryptNetworkMessage(const UA_Logger *logger, UA_ByteString buffer,
                                Ctx *ctx, UA_NetworkMessage *nm,
                                UA_ReaderGroup *rg);
 
+/* The decoded message is allocated in the arena of the ReaderGroup. Use
+ * UA_ReaderGroup_clearNetworkMessage to release it. */
 UA_StatusCode
 UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
                                     UA_ReaderGroup *rg,
                                     UA_ByteString buffer,
                                     UA_NetworkMessage *nm);
 
+/* Clear a NetworkMessage decoded by the ReaderGroup (binary or JSON) */
+void
+UA_ReaderGroup_clearNetworkMessage(UA_PubSubManager *psm, UA_ReaderGroup *rg,
+                                   UA_NetworkMessage *nm);
+
 #ifdef UA_ENABLE_JSON_ENCODING
 UA_StatusCode
 UA_ReaderGroup_decodeNetworkMessageJSON(UA_PubSubManager *psm,
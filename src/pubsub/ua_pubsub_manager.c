@@ -337,6 +337,132 @@ UA_PubSubManager_reserveIds(UA_PubSubManager *psm, UA_NodeId sessionId, UA_UInt1
     return UA_STATUSCODE_GOOD;
 }
 
+/*******************/
+/* Per-Cycle Arena */
+/*******************/
+
+#define UA_PUBSUBARENA_ALIGN 16
+#define UA_PUBSUBARENA_MINSIZE 1024
+
+static size_t
+arenaAlign(size_t size) {
+    return (size + (UA_PUBSUBARENA_ALIGN - 1)) & ~(size_t)(UA_PUBSUBARENA_ALIGN - 1);
+}
+
+void *
+UA_PubSubArena_calloc(void *arenaContext, size_t nelem, size_t elsize) {
+    UA_PubSubArena *arena = (UA_PubSubArena*)arenaContext;
+    if(elsize > 0 && nelem > SIZE_MAX / elsize)
+        return NULL;
+    size_t size = arenaAlign(nelem * elsize);
+    if(size == 0)
+        size = UA_PUBSUBARENA_ALIGN;
+
+    /* Bump allocation from the block */
+    if(arena->blockSize - arena->blockUsed >= size) {
+        void *p = &arena->block[arena->blockUsed];
+        arena->blockUsed += size;
+        memset(p, 0, size);
+        return p;
+    }
+
+    /* Fall back to the heap. The header keeps the alignment. */
+    size_t header = arenaAlign(sizeof(UA_PubSubArenaOverflow));
+    if(size > SIZE_MAX - header)
+        return NULL;
+    UA_PubSubArenaOverflow *o = (UA_PubSubArenaOverflow*)UA_calloc(1, header + size);
+    if(!o)
+        return NULL;
+    o->next = arena->overflow;
+    arena->overflow = o;
+    arena->overflowSize += size;
+    arena->heapAllocations++;
+    return (UA_Byte*)o + header;
+}
+
+UA_StatusCode
+UA_PubSubArena_addCleanup(UA_PubSubArena *arena, const UA_Node *node,
+                          UA_DataValue *value) {
+    UA_PubSubArenaCleanup *c = (UA_PubSubArenaCleanup*)
+        UA_PubSubArena_calloc(arena, 1, sizeof(UA_PubSubArenaCleanup));
+    if(!c)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    c->node = node;
+    c->value = value;
+    c->next = arena->cleanup;
+    arena->cleanup = c;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+arenaRelease(UA_PubSubArena *arena, UA_Server *server) {
+    /* The cleanup entries may point into the arena memory */
+    for(UA_PubSubArenaCleanup *c = arena->cleanup; c; c = c->next) {
+        if(c->value)
+            UA_DataValue_clear(c->value);
+        if(c->node)
+            UA_NODESTORE_RELEASE(server, c->node);
+    }
+    arena->cleanup = NULL;
+
+    UA_PubSubArenaOverflow *o = arena->overflow;
+    while(o) {
+        UA_PubSubArenaOverflow *next = o->next;
+        UA_free(o);
+        o = next;
+    }
+    arena->overflow = NULL;
+}
+
+void
+UA_PubSubArena_reset(UA_PubSubArena *arena, UA_Server *server) {
+    arenaRelease(arena, server);
+
+    /* Grow the block to fit all allocations of the last cycle. Keep the old
+     * block if the allocation fails. */
+    if(arena->overflowSize > 0) {
+        size_t size = arena->blockUsed + arena->overflowSize;
+        if(size < UA_PUBSUBARENA_MINSIZE)
+            size = UA_PUBSUBARENA_MINSIZE;
+        UA_Byte *block = (UA_Byte*)UA_malloc(size);
+        if(block) {
+            UA_free(arena->block);
+            arena->block = block;
+            arena->blockSize = size;
+        }
+    }
+    arena->blockUsed = 0;
+    arena->overflowSize = 0;
+}
+
+void
+UA_PubSubArena_clear(UA_PubSubArena *arena, UA_Server *server) {
+    arenaRelease(arena, server);
+    UA_free(arena->block);
+    memset(arena, 0, sizeof(UA_PubSubArena));
+}
+
+void
+UA_PubSubHistogram_add(UA_PubSubHistogram *h, UA_DateTime duration) {
+    if(duration < 0)
+        duration = 0;
+    if(h->count == 0 || duration < h->min)
+        h->min = duration;
+    if(duration > h->max)
+        h->max = duration;
+    h->count++;
+    h->sum += duration;
+
+    /* Logarithmic bucket of the duration in microseconds */
+    UA_UInt64 us = (UA_UInt64)(duration / UA_DATETIME_USEC);
+    size_t bucket = 0;
+    while(us > 0 && bucket < UA_PUBSUB_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    h->buckets[bucket]++;
+}
+
 /* Calculate the time difference between current time and UTC (00:00) on January
  * 1, 2000. */
 UA_UInt32
@@ -72,6 +72,13 @@ UA_DataSetMessage_encodeBinary(PubSubEncodeCtx *ctx,
                                const UA_DataSetMessage_EncodingMetaData *emd,
                                const UA_DataSetMessage *src);
 
+/* Encode a single field of a KeyFrame DataSetMessage */
+UA_StatusCode
+UA_DataSetMessage_encodeFieldBinary(PubSubEncodeCtx *ctx,
+                                    UA_FieldEncoding fieldEncoding,
+                                    const UA_FieldMetaData *fmd,
+                                    const UA_DataValue *v);
+
 UA_StatusCode
 UA_DataSetMessage_decodeBinary(PubSubDecodeCtx *ctx,
                                const UA_DataSetMessage_EncodingMetaData *em,
@@ -138,6 +145,37 @@ UA_NetworkMessage_signEncrypt(UA_NetworkMessage *nm,
 UA_StatusCode
 UA_NetworkMessage_encodeJsonInternal(PubSubEncodeJsonCtx *ctx,
                                      const UA_NetworkMessage *src);
+
+/* Precompiled JSON encoding for the DataSetMessages of one DataSetWriter. The
+ * keys and the (escaped) field names are rendered once. Encoding with the
+ * template only appends the value tokens. The output is identical to
+ * UA_NetworkMessage_encodeJsonInternal with the default JSON options. */
+typedef struct {
+    UA_String head;       /* {"DataSetWriterId":<id> */
+    size_t fieldKeysSize;
+    UA_String *fieldKeys; /* "<name>": */
+} UA_DataSetMessageJsonTemplate;
+
+UA_StatusCode
+UA_DataSetMessageJsonTemplate_init(UA_DataSetMessageJsonTemplate *t,
+                                   const UA_DataSetMessage_EncodingMetaData *emd);
+
+void
+UA_DataSetMessageJsonTemplate_clear(UA_DataSetMessageJsonTemplate *t);
+
+/* Render the static NetworkMessage header up to (excluding) the Messages. The
+ * header does not depend on the DataSetMessages of the NetworkMessage. */
+UA_StatusCode
+UA_NetworkMessage_encodeJsonHeaderTemplate(const UA_NetworkMessage *src,
+                                           UA_String *head);
+
+/* Encode with the header and one DataSetMessage template for each
+ * DataSetMessage. Returns UA_STATUSCODE_BADNOTSUPPORTED if a DataSetMessage
+ * does not fit its template. Then the generic encoding has to be used. */
+UA_StatusCode
+UA_NetworkMessage_encodeJsonTemplate(CtxJson *ctx, const UA_String *head,
+                                     UA_DataSetMessageJsonTemplate **templates,
+                                     const UA_NetworkMessage *src);
 #endif
 
 _UA_END_DECLS
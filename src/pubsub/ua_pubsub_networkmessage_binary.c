@@ -762,10 +762,12 @@ UA_NetworkMessage_decodeFooters(PubSubDecodeCtx *ctx,
        nm->securityHeader.securityFooterSize == 0)
         return UA_STATUSCODE_GOOD;
     
-    UA_StatusCode rv = UA_ByteString_allocBuffer(&nm->securityFooter,
-                                                 nm->securityHeader.securityFooterSize);
-    UA_CHECK_STATUS(rv, return rv);
-    
+    nm->securityFooter.data = (UA_Byte*)
+        ctxCalloc(&ctx->ctx, nm->securityHeader.securityFooterSize, sizeof(UA_Byte));
+    UA_CHECK_MEM(nm->securityFooter.data, return UA_STATUSCODE_BADOUTOFMEMORY);
+    nm->securityFooter.length = nm->securityHeader.securityFooterSize;
+
+    UA_StatusCode rv = UA_STATUSCODE_GOOD;
     for(UA_UInt16 i = 0; i < nm->securityHeader.securityFooterSize; i++) {
         rv |= _DECODE_BINARY(&nm->securityFooter.data[i], BYTE);
     }
@@ -1381,6 +1383,23 @@ UA_DataSetMessage_keyFrame_raw_encodeBinary(PubSubEncodeCtx *ctx,
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_DataSetMessage_encodeFieldBinary(PubSubEncodeCtx *ctx,
+                                    UA_FieldEncoding fieldEncoding,
+                                    const UA_FieldMetaData *fmd,
+                                    const UA_DataValue *v) {
+    switch(fieldEncoding) {
+    case UA_FIELDENCODING_VARIANT:
+        return _ENCODE_BINARY(&v->value, VARIANT);
+    case UA_FIELDENCODING_DATAVALUE:
+        return _ENCODE_BINARY(v, DATAVALUE);
+    case UA_FIELDENCODING_RAWDATA:
+        return UA_DataSetMessage_keyFrame_raw_encodeBinary(ctx, fmd, &v->value);
+    default:
+        return UA_STATUSCODE_BADENCODINGERROR;
+    }
+}
+
 static UA_StatusCode
 UA_DataSetMessage_keyFrame_encodeBinary(PubSubEncodeCtx *ctx,
                                         const UA_DataSetMessage_EncodingMetaData *emd,
@@ -1398,17 +1417,9 @@ UA_DataSetMessage_keyFrame_encodeBinary(PubSubEncodeCtx *ctx,
     }
     
     for(UA_UInt16 i = 0; i < src->fieldCount; i++) {
-        const UA_DataValue *v = &src->data.keyFrameFields[i];
-        if(src->header.fieldEncoding == UA_FIELDENCODING_VARIANT) {
-            rv = _ENCODE_BINARY(&v->value, VARIANT);
-        } else if(src->header.fieldEncoding == UA_FIELDENCODING_DATAVALUE) {
-            rv = _ENCODE_BINARY(v, DATAVALUE);
-        } else if(src->header.fieldEncoding == UA_FIELDENCODING_RAWDATA) {
-            const UA_FieldMetaData *fmd = getFieldMetaData(emd, i);
-            rv = UA_DataSetMessage_keyFrame_raw_encodeBinary(ctx, fmd, &v->value);
-        } else {
-            rv = UA_STATUSCODE_BADENCODINGERROR;
-        }
+        const UA_FieldMetaData *fmd = getFieldMetaData(emd, i);
+        rv = UA_DataSetMessage_encodeFieldBinary(ctx, src->header.fieldEncoding, fmd,
+                                                 &src->data.keyFrameFields[i]);
         UA_CHECK_STATUS(rv, return rv);
     }
     return rv;
@@ -28,25 +28,13 @@ static const char * UA_DECODEKEY_DSM_STATUS = "Status";
 static const char * UA_DECODEKEY_PAYLOAD = "Payload";
 
 /* -- json encoding/decoding -- */
-static UA_StatusCode writeJsonKey_UA_String(CtxJson *ctx, const UA_String *in) {
-    UA_STACKARRAY(char, out, in->length + 1);
-    if(in->length)
-        memcpy(out, in->data, in->length);
-    out[in->length] = 0;
-    return writeJsonKey(ctx, out);
-}
 
+/* Encode the DataSetMessage header fields after the DataSetWriterId up to
+ * (including) the MessageType */
 static UA_StatusCode
-UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
-                                      const UA_DataSetMessage_EncodingMetaData *emd,
-                                      const UA_DataSetMessage *src) {
-    status rv = writeJsonObjStart(ctx);
-
-    /* DataSetWriterId */
-    rv |= writeJsonObjElm(ctx, UA_DECODEKEY_DATASETWRITERID,
-                          &emd->dataSetWriterId, &UA_TYPES[UA_TYPES_UINT16]);
-    if(rv != UA_STATUSCODE_GOOD)
-        return rv;
+UA_DataSetMessageHeader_encodeJson_internal(CtxJson *ctx,
+                                            const UA_DataSetMessage *src) {
+    status rv = UA_STATUSCODE_GOOD;
 
     /* TODO: Encode DataSetWriterName */
 
@@ -102,6 +90,24 @@ UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
         /* TODO: Support other message types */
         return UA_STATUSCODE_BADNOTSUPPORTED;
     }
+    return rv;
+}
+
+static UA_StatusCode
+UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
+                                      const UA_DataSetMessage_EncodingMetaData *emd,
+                                      const UA_DataSetMessage *src) {
+    status rv = writeJsonObjStart(ctx);
+
+    /* DataSetWriterId */
+    rv |= writeJsonObjElm(ctx, UA_DECODEKEY_DATASETWRITERID,
+                          &emd->dataSetWriterId, &UA_TYPES[UA_TYPES_UINT16]);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+
+    rv = UA_DataSetMessageHeader_encodeJson_internal(ctx, src);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
 
     rv |= writeJsonKey(ctx, UA_DECODEKEY_PAYLOAD);
     rv |= writeJsonObjStart(ctx);
@@ -111,7 +117,7 @@ UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
         for(UA_UInt16 i = 0; i < src->fieldCount; i++) {
             const UA_FieldMetaData *fmd = getFieldMetaData(emd, i);
             if(fmd)
-                rv |= writeJsonKey_UA_String(ctx, &fmd->name);
+                rv |= writeJsonKeyString(ctx, &fmd->name);
             else
                 rv |= writeJsonKey(ctx, "");
             rv |= encodeJsonJumpTable[UA_DATATYPEKIND_VARIANT]
@@ -124,7 +130,7 @@ UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
         for(UA_UInt16 i = 0; i < src->fieldCount; i++) {
             const UA_FieldMetaData *fmd = getFieldMetaData(emd, i);
             if(fmd)
-                rv |= writeJsonKey_UA_String(ctx, &fmd->name);
+                rv |= writeJsonKeyString(ctx, &fmd->name);
             else
                 rv |= writeJsonKey(ctx, "");
             rv |= encodeJsonJumpTable[UA_DATATYPEKIND_DATAVALUE]
@@ -284,6 +290,195 @@ UA_NetworkMessage_calcSizeJson(const UA_NetworkMessage *src,
     return (size_t)ctx.ctx.pos - 1u;
 }
 
+/* Precompiled templates */
+
+typedef UA_StatusCode
+(*renderJsonCallback)(CtxJson *ctx, const void *data);
+
+/* Render into a newly allocated string. First compute the length. */
+static UA_StatusCode
+renderJson(UA_String *out, renderJsonCallback render, const void *data) {
+    CtxJson ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pos = (UA_Byte*)0x01;
+    ctx.end = (const UA_Byte*)(uintptr_t)SIZE_MAX;
+    ctx.calcOnly = true;
+    UA_StatusCode res = render(&ctx, data);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    size_t length = (size_t)ctx.pos - 1u;
+    res = UA_ByteString_allocBuffer(out, length);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pos = out->data;
+    ctx.end = out->data + length;
+    res = render(&ctx, data);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_String_clear(out);
+    return res;
+}
+
+static UA_StatusCode
+renderDataSetMessageHead(CtxJson *ctx, const void *data) {
+    const UA_DataSetMessage_EncodingMetaData *emd =
+        (const UA_DataSetMessage_EncodingMetaData*)data;
+    status rv = writeJsonObjStart(ctx);
+    rv |= writeJsonObjElm(ctx, UA_DECODEKEY_DATASETWRITERID,
+                          &emd->dataSetWriterId, &UA_TYPES[UA_TYPES_UINT16]);
+    return rv;
+}
+
+static UA_StatusCode
+renderFieldKey(CtxJson *ctx, const void *data) {
+    return writeJsonKeyString(ctx, (const UA_String*)data);
+}
+
+UA_StatusCode
+UA_DataSetMessageJsonTemplate_init(UA_DataSetMessageJsonTemplate *t,
+                                   const UA_DataSetMessage_EncodingMetaData *emd) {
+    memset(t, 0, sizeof(UA_DataSetMessageJsonTemplate));
+    UA_StatusCode res = renderJson(&t->head, renderDataSetMessageHead, emd);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    if(emd->fieldsSize > 0) {
+        t->fieldKeys = (UA_String*)
+            UA_calloc(emd->fieldsSize, sizeof(UA_String));
+        if(!t->fieldKeys) {
+            UA_DataSetMessageJsonTemplate_clear(t);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        t->fieldKeysSize = emd->fieldsSize;
+    }
+
+    for(size_t i = 0; i < emd->fieldsSize; i++) {
+        res = renderJson(&t->fieldKeys[i], renderFieldKey, &emd->fields[i].name);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_DataSetMessageJsonTemplate_clear(t);
+            return res;
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_DataSetMessageJsonTemplate_clear(UA_DataSetMessageJsonTemplate *t) {
+    UA_String_clear(&t->head);
+    UA_Array_delete(t->fieldKeys, t->fieldKeysSize, &UA_TYPES[UA_TYPES_STRING]);
+    t->fieldKeys = NULL;
+    t->fieldKeysSize = 0;
+}
+
+UA_StatusCode
+UA_NetworkMessage_encodeJsonHeaderTemplate(const UA_NetworkMessage *src,
+                                           UA_String *head) {
+    /* Encode without DataSetMessages and remove the closing bracket */
+    UA_NetworkMessage tmp = *src;
+    tmp.messageCount = 0;
+    UA_String_init(head);
+    UA_StatusCode res = UA_NetworkMessage_encodeJson(&tmp, head, NULL, NULL);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_assert(head->length > 0 && head->data[head->length - 1] == '}');
+    head->length--;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+writeJsonRaw(CtxJson *ctx, const UA_String *raw) {
+    if(ctx->pos + raw->length > ctx->end)
+        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    if(!ctx->calcOnly)
+        memcpy(ctx->pos, raw->data, raw->length);
+    ctx->pos += raw->length;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+UA_DataSetMessage_encodeJsonTemplate(CtxJson *ctx,
+                                     const UA_DataSetMessageJsonTemplate *t,
+                                     const UA_DataSetMessage *src) {
+    /* The head was rendered with the ObjStart and the DataSetWriterId key */
+    status rv = writeJsonRaw(ctx, &t->head);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+    ctx->depth++;
+    ctx->commaNeeded[ctx->depth] = true;
+
+    rv = UA_DataSetMessageHeader_encodeJson_internal(ctx, src);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+
+    rv |= writeJsonKey(ctx, UA_DECODEKEY_PAYLOAD);
+    rv |= writeJsonObjStart(ctx);
+
+    /* The keys are rendered without the comma in front */
+    UA_Boolean variant = (src->header.fieldEncoding == UA_FIELDENCODING_VARIANT);
+    for(UA_UInt16 i = 0; i < src->fieldCount; i++) {
+        rv |= writeJsonBeforeElement(ctx, true);
+        rv |= writeJsonRaw(ctx, &t->fieldKeys[i]);
+        ctx->commaNeeded[ctx->depth] = true;
+        if(variant)
+            rv |= encodeJsonJumpTable[UA_DATATYPEKIND_VARIANT]
+                (ctx, &src->data.keyFrameFields[i].value, NULL);
+        else
+            rv |= encodeJsonJumpTable[UA_DATATYPEKIND_DATAVALUE]
+                (ctx, &src->data.keyFrameFields[i], NULL);
+        if(rv != UA_STATUSCODE_GOOD)
+            return rv;
+    }
+
+    rv |= writeJsonObjEnd(ctx); /* Payload */
+    rv |= writeJsonObjEnd(ctx); /* DataSetMessage */
+    return rv;
+}
+
+UA_StatusCode
+UA_NetworkMessage_encodeJsonTemplate(CtxJson *ctx, const UA_String *head,
+                                     UA_DataSetMessageJsonTemplate **templates,
+                                     const UA_NetworkMessage *src) {
+    /* Check upfront that all DataSetMessages fit their template */
+    if(src->networkMessageType != UA_NETWORKMESSAGE_DATASET ||
+       ctx->prettyPrint || ctx->unquotedKeys)
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    const UA_DataSetMessage *dsm = src->payload.dataSetMessages;
+    for(size_t i = 0; i < src->messageCount; i++) {
+        if(!templates[i] || !templates[i]->head.data ||
+           dsm[i].header.dataSetMessageType != UA_DATASETMESSAGE_DATAKEYFRAME ||
+           (dsm[i].header.fieldEncoding != UA_FIELDENCODING_VARIANT &&
+            dsm[i].header.fieldEncoding != UA_FIELDENCODING_DATAVALUE) ||
+           dsm[i].fieldCount != templates[i]->fieldKeysSize)
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+
+    /* The header was rendered with the ObjStart and the MessageId */
+    status rv = writeJsonRaw(ctx, head);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+    ctx->depth++;
+    ctx->commaNeeded[ctx->depth] = true;
+
+    /* Payload: DataSetMessages */
+    if(src->messageCount > 0) {
+        rv |= writeJsonKey(ctx, UA_DECODEKEY_MESSAGES);
+        rv |= writeJsonArrStart(ctx);
+        for(size_t i = 0; i < src->messageCount; i++) {
+            rv |= writeJsonBeforeElement(ctx, true);
+            rv |= UA_DataSetMessage_encodeJsonTemplate(ctx, templates[i], &dsm[i]);
+            if(rv != UA_STATUSCODE_GOOD)
+                return rv;
+            ctx->commaNeeded[ctx->depth] = true;
+        }
+        rv |= writeJsonArrEnd(ctx, NULL);
+    }
+
+    rv |= writeJsonObjEnd(ctx);
+    return rv;
+}
+
 /* decode json */
 static status
 MetaDataVersion_decodeJsonInternal(ParseCtx *ctx, void* cvd, const UA_DataType *_) {
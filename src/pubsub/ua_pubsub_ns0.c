@@ -1600,9 +1600,169 @@ addSubscribedDataSetRepresentation(UA_Server *server,
 }
 
 /**********************************************/
-/*               WriterGroup                  */
+/*               Statistics                   */
 /**********************************************/
 
+/* The node context points directly to the statistics in the WriterGroup or
+ * ReaderGroup. The nodes are removed together with the group. */
+
+static UA_StatusCode
+readStatisticsCounter(UA_Server *server, const UA_NodeId *sessionId,
+                      void *sessionContext, const UA_NodeId *nodeId,
+                      void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                      const UA_NumericRange *range, UA_DataValue *value) {
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, (UA_UInt64*)nodeContext,
+                                    &UA_TYPES[UA_TYPES_UINT64]);
+}
+
+static UA_StatusCode
+readStatisticsDuration(UA_Server *server, const UA_NodeId *sessionId,
+                       void *sessionContext, const UA_NodeId *nodeId,
+                       void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                       const UA_NumericRange *range, UA_DataValue *value) {
+    UA_Duration d = (UA_Double)*(UA_DateTime*)nodeContext / UA_DATETIME_MSEC;
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &d, &UA_TYPES[UA_TYPES_DURATION]);
+}
+
+static UA_StatusCode
+readHistogramMean(UA_Server *server, const UA_NodeId *sessionId,
+                  void *sessionContext, const UA_NodeId *nodeId,
+                  void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                  const UA_NumericRange *range, UA_DataValue *value) {
+    UA_PubSubHistogram *h = (UA_PubSubHistogram*)nodeContext;
+    UA_Duration mean = 0.0;
+    if(h->count > 0)
+        mean = (UA_Double)h->sum / (UA_Double)h->count / UA_DATETIME_MSEC;
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &mean, &UA_TYPES[UA_TYPES_DURATION]);
+}
+
+static UA_StatusCode
+readHistogramBuckets(UA_Server *server, const UA_NodeId *sessionId,
+                     void *sessionContext, const UA_NodeId *nodeId,
+                     void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                     const UA_NumericRange *range, UA_DataValue *value) {
+    UA_PubSubHistogram *h = (UA_PubSubHistogram*)nodeContext;
+    value->hasValue = true;
+    return UA_Variant_setArrayCopy(&value->value, h->buckets,
+                                   UA_PUBSUB_HISTOGRAM_BUCKETS,
+                                   &UA_TYPES[UA_TYPES_UINT64]);
+}
+
+typedef UA_StatusCode
+(*StatisticsReadCallback)(UA_Server *server, const UA_NodeId *sessionId,
+                          void *sessionContext, const UA_NodeId *nodeId,
+                          void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                          const UA_NumericRange *range, UA_DataValue *value);
+
+static UA_StatusCode
+addStatisticsVariable(UA_Server *server, const UA_NodeId parent, char *name,
+                      UA_Boolean property, const UA_DataType *type,
+                      UA_Int32 valueRank, StatisticsReadCallback read,
+                      void *context, UA_NodeId *outId) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("", name);
+    attr.dataType = type->typeId;
+    attr.valueRank = valueRank;
+    UA_UInt32 arrayDims = UA_PUBSUB_HISTOGRAM_BUCKETS;
+    if(valueRank == UA_VALUERANK_ONE_DIMENSION) {
+        attr.arrayDimensions = &arrayDims;
+        attr.arrayDimensionsSize = 1;
+    }
+    UA_NodeId id;
+    UA_StatusCode res =
+        addNode(server, UA_NODECLASS_VARIABLE, UA_NODEID_NUMERIC(1, 0), parent,
+                (property) ? UA_NS0ID(HASPROPERTY) : UA_NS0ID(HASCOMPONENT),
+                UA_QUALIFIEDNAME(1, name),
+                (property) ? UA_NS0ID(PROPERTYTYPE) : UA_NS0ID(BASEDATAVARIABLETYPE),
+                &attr, &UA_TYPES[UA_TYPES_VARIABLEATTRIBUTES], context, &id);
+    UA_CHECK_STATUS(res, return res);
+    UA_CallbackValueSource evs = {read, NULL};
+    res = setVariableNode_callbackValueSource(server, id, evs);
+    if(outId)
+        *outId = id;
+    else
+        UA_NodeId_clear(&id);
+    return res;
+}
+
+/* The histogram variable contains the bucket counts. The other values of the
+ * histogram are properties of the variable. */
+static UA_StatusCode
+addStatisticsHistogram(UA_Server *server, const UA_NodeId parent, char *name,
+                       UA_PubSubHistogram *h) {
+    UA_NodeId id;
+    UA_StatusCode res =
+        addStatisticsVariable(server, parent, name, false,
+                              &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_ONE_DIMENSION,
+                              readHistogramBuckets, h, &id);
+    UA_CHECK_STATUS(res, return res);
+    res |= addStatisticsVariable(server, id, "Count", true,
+                                 &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_SCALAR,
+                                 readStatisticsCounter, &h->count, NULL);
+    res |= addStatisticsVariable(server, id, "Mean", true,
+                                 &UA_TYPES[UA_TYPES_DURATION], UA_VALUERANK_SCALAR,
+                                 readHistogramMean, h, NULL);
+    res |= addStatisticsVariable(server, id, "Min", true,
+                                 &UA_TYPES[UA_TYPES_DURATION], UA_VALUERANK_SCALAR,
+                                 readStatisticsDuration, &h->min, NULL);
+    res |= addStatisticsVariable(server, id, "Max", true,
+                                 &UA_TYPES[UA_TYPES_DURATION], UA_VALUERANK_SCALAR,
+                                 readStatisticsDuration, &h->max, NULL);
+    UA_NodeId_clear(&id);
+    return res;
+}
+
+static UA_StatusCode
+addStatisticsObject(UA_Server *server, const UA_NodeId group, UA_NodeId *outId) {
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("", "Statistics");
+    return addNode(server, UA_NODECLASS_OBJECT, UA_NODEID_NUMERIC(1, 0), group,
+                   UA_NS0ID(HASCOMPONENT), UA_QUALIFIEDNAME(1, "Statistics"),
+                   UA_NS0ID(BASEOBJECTTYPE), &attr,
+                   &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES], NULL, outId);
+}
+
+static UA_StatusCode
+addWriterGroupStatistics(UA_Server *server, UA_WriterGroup *wg) {
+    UA_NodeId id;
+    UA_StatusCode res = addStatisticsObject(server, wg->head.identifier, &id);
+    UA_CHECK_STATUS(res, return res);
+    UA_WriterGroupStatistics *stats = &wg->stats;
+    res |= addStatisticsVariable(server, id, "SentNetworkMessages", false,
+                                 &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_SCALAR,
+                                 readStatisticsCounter, &stats->sentNetworkMessages, NULL);
+    res |= addStatisticsVariable(server, id, "FailedNetworkMessages", false,
+                                 &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_SCALAR,
+                                 readStatisticsCounter, &stats->failedNetworkMessages, NULL);
+    res |= addStatisticsHistogram(server, id, "SchedulingLateness",
+                                  &stats->schedulingLateness);
+    res |= addStatisticsHistogram(server, id, "EncodeTime", &stats->encodeTime);
+    res |= addStatisticsHistogram(server, id, "SendTime", &stats->sendTime);
+    UA_NodeId_clear(&id);
+    return res;
+}
+
+static UA_StatusCode
+addReaderGroupStatistics(UA_Server *server, UA_ReaderGroup *rg) {
+    UA_NodeId id;
+    UA_StatusCode res = addStatisticsObject(server, rg->head.identifier, &id);
+    UA_CHECK_STATUS(res, return res);
+    UA_ReaderGroupStatistics *stats = &rg->stats;
+    res |= addStatisticsVariable(server, id, "ReceivedNetworkMessages", false,
+                                 &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_SCALAR,
+                                 readStatisticsCounter, &stats->receivedNetworkMessages, NULL);
+    res |= addStatisticsVariable(server, id, "DroppedNetworkMessages", false,
+                                 &UA_TYPES[UA_TYPES_UINT64], UA_VALUERANK_SCALAR,
+                                 readStatisticsCounter, &stats->droppedNetworkMessages, NULL);
+    res |= addStatisticsHistogram(server, id, "DecodeTime", &stats->decodeTime);
+    res |= addStatisticsHistogram(server, id, "ProcessTime", &stats->processTime);
+    UA_NodeId_clear(&id);
+    return res;
+}
+
 static UA_StatusCode
 readContentMask(UA_Server *server, const UA_NodeId *sessionId,
                 void *sessionContext, const UA_NodeId *nodeId,
@@ -1794,6 +1954,8 @@ addWriterGroupRepresentation(UA_Server *server, UA_WriterGroup *writerGroup) {
 
     }
 
+    retVal |= addWriterGroupStatistics(server, writerGroup);
+
     /* Add reference to methods */
     if(server->config.pubSubConfig.enableInformationModelMethods) {
         retVal |= addRef(server, writerGroup->head.identifier,
@@ -1951,6 +2113,8 @@ addReaderGroupRepresentation(UA_Server *server, UA_ReaderGroup *readerGroup) {
     stateDataSource.write = NULL;
     retVal |= UA_Server_setVariableNode_dataSource(server, stateIdNode, stateDataSource);
 
+    retVal |= addReaderGroupStatistics(server, readerGroup);
+
     if(server->config.pubSubConfig.enableInformationModelMethods) {
         retVal |= addRef(server, readerGroup->head.identifier, UA_NS0ID(HASCOMPONENT),
                          UA_NS0ID(READERGROUPTYPE_ADDDATASETREADER), true);
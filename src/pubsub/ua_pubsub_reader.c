@@ -48,6 +48,45 @@ printPublisherId(char *out, size_t size, UA_PublisherId *id) {
 }
 #endif
 
+void
+UA_DataSetReaderKey_init(UA_DataSetReaderKey *key, const UA_PublisherId *publisherId,
+                         UA_UInt16 writerGroupId, UA_UInt16 dataSetWriterId) {
+    key->dataSetWriterId = dataSetWriterId;
+    key->writerGroupId = writerGroupId;
+    key->publisherId = publisherId;
+    switch(publisherId->idType) {
+    case UA_PUBLISHERIDTYPE_BYTE:   key->publisherIdHash = publisherId->id.byte; break;
+    case UA_PUBLISHERIDTYPE_UINT16: key->publisherIdHash = publisherId->id.uint16; break;
+    case UA_PUBLISHERIDTYPE_UINT32: key->publisherIdHash = publisherId->id.uint32; break;
+    case UA_PUBLISHERIDTYPE_UINT64:
+        key->publisherIdHash = (UA_UInt32)(publisherId->id.uint64 ^
+                                           (publisherId->id.uint64 >> 32));
+        break;
+    case UA_PUBLISHERIDTYPE_STRING:
+        key->publisherIdHash = UA_ByteString_hash(0, publisherId->id.string.data,
+                                                  publisherId->id.string.length);
+        break;
+    default: key->publisherIdHash = 0; break;
+    }
+}
+
+static void
+addToReaderIndex(UA_DataSetReader *dsr) {
+    UA_DataSetReaderKey_init(&dsr->indexKey, &dsr->config.publisherId,
+                             dsr->config.writerGroupId, dsr->config.dataSetWriterId);
+    UA_PubSubConnection *c = dsr->linkedReaderGroup->linkedConnection;
+    ZIP_INSERT(UA_DataSetReaderIndex, &c->readerIndex, dsr);
+}
+
+static void
+removeFromReaderIndex(UA_DataSetReader *dsr) {
+    if(!dsr->indexKey.publisherId)
+        return; /* Not yet indexed */
+    UA_PubSubConnection *c = dsr->linkedReaderGroup->linkedConnection;
+    ZIP_REMOVE(UA_DataSetReaderIndex, &c->readerIndex, dsr);
+    dsr->indexKey.publisherId = NULL;
+}
+
 UA_StatusCode
 UA_DataSetReader_checkIdentifier(UA_PubSubManager *psm, UA_DataSetReader *dsr,
                                  UA_NetworkMessage *msg) {
@@ -238,6 +277,244 @@ connectDSR2Standalone(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
 #endif
 }
 
+/****************/
+/* Direct Write */
+/****************/
+
+static void
+clearTargets(UA_DataSetReader *dsr) {
+    for(size_t i = 0; i < dsr->targetsSize; i++)
+        UA_NodeId_clear(&dsr->targets[i].dataType);
+    UA_free(dsr->targets);
+    dsr->targets = NULL;
+    dsr->targetsSize = 0;
+}
+
+/* Resolve the targets that can be written directly. The DataType has to match
+ * the FieldMetaData exactly. Otherwise the Write service may need to adjust the
+ * type of the received value. Only writable variables are written directly.
+ * The access checks for the other cases are left to the Write service. */
+static void
+resolveTargets(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
+    clearTargets(dsr);
+    if(!dsr->config.directValueWrite ||
+       dsr->config.subscribedDataSetType != UA_PUBSUB_SDS_TARGET)
+        return;
+
+    UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
+    if(tvs->targetVariablesSize == 0)
+        return;
+    dsr->targets = (UA_DataSetReaderTarget*)
+        UA_calloc(tvs->targetVariablesSize, sizeof(UA_DataSetReaderTarget));
+    if(!dsr->targets) {
+        UA_LOG_WARNING_PUBSUB(psm->logging, dsr, "Could not allocate the targets "
+                              "for the direct write. Using the Write service.");
+        return;
+    }
+    dsr->targetsSize = tvs->targetVariablesSize;
+
+    UA_Server *server = psm->drv.server;
+    const UA_DataSetMetaDataType *md = &dsr->config.dataSetMetaData;
+    size_t resolved = 0;
+    for(size_t i = 0; i < dsr->targetsSize; i++) {
+        const UA_FieldTargetDataType *tv = &tvs->targetVariables[i];
+        if(i >= md->fieldsSize || tv->attributeId != UA_ATTRIBUTEID_VALUE ||
+           tv->receiverIndexRange.length > 0)
+            continue;
+        const UA_DataType *type =
+            UA_findDataTypeWithCustom(&md->fields[i].dataType,
+                                      server->config.customDataTypes);
+        if(!type)
+            continue;
+        const UA_Node *node = UA_NODESTORE_GET(server, &tv->targetNodeId);
+        if(!node)
+            continue;
+        const UA_VariableNode *vn = &node->variableNode;
+        UA_DataSetReaderTarget *t = &dsr->targets[i];
+        if(node->head.nodeClass == UA_NODECLASS_VARIABLE &&
+           (vn->valueSourceType == UA_VALUESOURCETYPE_INTERNAL ||
+            vn->valueSourceType == UA_VALUESOURCETYPE_EXTERNAL) &&
+           (vn->accessLevel & UA_ACCESSLEVELMASK_WRITE) &&
+           !(vn->accessLevel & UA_ACCESSLEVELMASK_SEMANTICCHANGE) &&
+           UA_NodeId_equal(&type->typeId, &vn->dataType) &&
+           UA_NodeId_copy(&vn->dataType, &t->dataType) == UA_STATUSCODE_GOOD) {
+            t->type = type;
+            t->valueRank = vn->valueRank;
+            t->scalar = (vn->valueRank == UA_VALUERANK_SCALAR ||
+                         vn->valueRank == UA_VALUERANK_ANY ||
+                         vn->valueRank == UA_VALUERANK_SCALAR_OR_ONE_DIMENSION);
+            t->array = (vn->arrayDimensionsSize == 0 &&
+                        (vn->valueRank == UA_VALUERANK_ANY ||
+                         vn->valueRank == UA_VALUERANK_SCALAR_OR_ONE_DIMENSION ||
+                         vn->valueRank == UA_VALUERANK_ONE_OR_MORE_DIMENSIONS ||
+                         vn->valueRank == UA_VALUERANK_ONE_DIMENSION));
+            resolved++;
+        }
+        UA_NODESTORE_RELEASE(server, node);
+    }
+
+    UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "Resolved %u of %u targets "
+                        "for the direct write", (unsigned)resolved,
+                        (unsigned)dsr->targetsSize);
+}
+
+/* Returns false if the Write service has to be used instead. The node was
+ * checked when the target was resolved. But it might have changed since. */
+static UA_Boolean
+writeTargetDirect(UA_Server *server, UA_DataSetReaderTarget *t,
+                  UA_Node *node, const UA_DataValue *field) {
+#ifdef UA_ENABLE_AUDITING
+    if(server->config.auditingEnabled && server->config.auditWriteUpdateEnabled)
+        return false;
+#endif
+#ifdef UA_ENABLE_HISTORIZING
+    if(server->config.historyDatabase.setValue)
+        return false;
+#endif
+
+    UA_VariableNode *vn = &node->variableNode;
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE ||
+       (vn->valueSourceType != UA_VALUESOURCETYPE_INTERNAL &&
+        vn->valueSourceType != UA_VALUESOURCETYPE_EXTERNAL) ||
+       !(vn->accessLevel & UA_ACCESSLEVELMASK_WRITE) ||
+       (vn->accessLevel & UA_ACCESSLEVELMASK_SEMANTICCHANGE) ||
+       vn->valueRank != t->valueRank ||
+       !UA_NodeId_equal(&vn->dataType, &t->dataType))
+        return false;
+
+    /* Writing a non-Good status or a SourceTimestamp requires the StatusWrite
+     * and TimestampWrite bits. The Write service handles the field if they are
+     * not set (see the checks in Operation_Write). */
+    if(field->hasStatus && field->status != UA_STATUSCODE_GOOD &&
+       !(vn->accessLevel & UA_ACCESSLEVELMASK_STATUSWRITE))
+        return false;
+    if(field->hasSourceTimestamp && field->sourceTimestamp != 0 &&
+       !(vn->accessLevel & UA_ACCESSLEVELMASK_TIMESTAMPWRITE))
+        return false;
+
+    /* Check the received value against the resolved type */
+    const UA_Variant *v = &field->value;
+    if(v->type != t->type)
+        return false;
+    UA_Boolean scalar = UA_Variant_isScalar(v);
+    if((scalar && !t->scalar) ||
+       (!scalar && (!t->array || v->arrayDimensionsSize > 1)))
+        return false;
+
+    UA_DataValue *dv = (vn->valueSourceType == UA_VALUESOURCETYPE_INTERNAL) ?
+        &vn->valueSource.internal.value : UA_atomic_load(vn->valueSource.external.value);
+
+    /* Update a scalar in place if the memory layout is unchanged. Otherwise
+     * replace the variant. */
+    if(scalar && t->type->pointerFree && dv->hasValue &&
+       dv->value.type == t->type && UA_Variant_isScalar(&dv->value) &&
+       dv->value.storageType == UA_VARIANT_DATA) {
+        memcpy(dv->value.data, v->data, t->type->memSize);
+    } else {
+        UA_Variant tmp;
+        if(UA_Variant_copy(v, &tmp) != UA_STATUSCODE_GOOD)
+            return false;
+        UA_Variant_clear(&dv->value);
+        dv->value = tmp;
+    }
+    dv->hasValue = true;
+
+    /* Status and timestamps as in the Write service */
+    dv->hasStatus = field->hasStatus;
+    dv->status = field->status;
+    dv->hasServerTimestamp = field->hasServerTimestamp;
+    dv->serverTimestamp = field->serverTimestamp;
+    dv->hasServerPicoseconds = field->hasServerPicoseconds;
+    dv->serverPicoseconds = field->serverPicoseconds;
+    dv->hasSourceTimestamp = vn->isDynamic && field->hasSourceTimestamp;
+    dv->sourceTimestamp = field->sourceTimestamp;
+    dv->hasSourcePicoseconds = vn->isDynamic && field->hasSourcePicoseconds;
+    dv->sourcePicoseconds = field->sourcePicoseconds;
+
+    if(vn->valueSource.internal.notifications.onWrite) {
+        UA_Session *session = &server->adminSession;
+        vn->valueSource.internal.notifications.
+            onWrite(server, &session->sessionId, session->context,
+                    &node->head.nodeId, node->head.context, NULL, dv);
+    }
+    return true;
+}
+
+static void
+writeFieldService(UA_PubSubManager *psm, UA_DataSetReader *dsr,
+                  size_t i, const UA_DataValue *field) {
+    UA_FieldTargetDataType *tv = &dsr->config.subscribedDataSet.target.targetVariables[i];
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    UA_WriteValue writeVal;
+    UA_WriteValue_init(&writeVal);
+    writeVal.attributeId = tv->attributeId;
+    writeVal.indexRange = tv->receiverIndexRange;
+    writeVal.nodeId = tv->targetNodeId;
+    writeVal.value = *field;
+    Operation_Write(psm->drv.server, &psm->drv.server->adminSession, &writeVal, &res);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_LOG_INFO_PUBSUB(psm->logging, dsr,
+                           "Error writing KeyFrame field %u: %s",
+                           (unsigned)i, UA_StatusCode_name(res));
+}
+
+/* Get the i-th field of a key or delta frame and its index in the DataSet */
+static UA_DataValue *
+getMessageField(UA_DataSetMessage *msg, size_t i, size_t *index) {
+    if(msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATADELTAFRAME) {
+        *index = msg->data.deltaFrameFields[i].index;
+        return &msg->data.deltaFrameFields[i].value;
+    }
+    *index = i;
+    return &msg->data.keyFrameFields[i];
+}
+
+/* Write all fields first. Then sample the MonitoredItems of the targets. */
+static void
+writeFieldsDirect(UA_PubSubManager *psm, UA_DataSetReader *dsr,
+                  UA_DataSetMessage *msg) {
+    UA_Server *server = psm->drv.server;
+    UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
+    size_t index;
+    for(size_t i = 0; i < msg->fieldCount; i++) {
+        UA_DataValue *field = getMessageField(msg, i, &index);
+        UA_DataSetReaderTarget *t = &dsr->targets[index];
+        if(!field->hasValue)
+            continue;
+        /* The node is already taken if a delta frame repeats the index */
+        if(t->type && !t->node) {
+            t->node = UA_NODESTORE_GET_EDIT_SELECTIVE(server,
+                                                      &tvs->targetVariables[index].targetNodeId,
+                                                      UA_NODEATTRIBUTESMASK_VALUE |
+                                                      UA_NODEATTRIBUTESMASK_DATATYPE |
+                                                      UA_NODEATTRIBUTESMASK_VALUERANK |
+                                                      UA_NODEATTRIBUTESMASK_ACCESSLEVEL,
+                                                      UA_REFERENCETYPESET_NONE,
+                                                      UA_BROWSEDIRECTION_INVALID);
+            if(t->node && writeTargetDirect(server, t, t->node, field))
+                continue;
+            if(t->node) {
+                UA_NODESTORE_RELEASE(server, t->node);
+                t->node = NULL;
+            }
+        }
+        writeFieldService(psm, dsr, index, field);
+    }
+
+    for(size_t i = 0; i < msg->fieldCount; i++) {
+        getMessageField(msg, i, &index);
+        UA_DataSetReaderTarget *t = &dsr->targets[index];
+        if(!t->node)
+            continue;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+        triggerImmediateDataChange(server, &server->adminSession,
+                                   t->node, UA_ATTRIBUTEID_VALUE);
+#endif
+        UA_NODESTORE_RELEASE(server, t->node);
+        t->node = NULL;
+    }
+}
+
 UA_StatusCode
 UA_DataSetReader_create(UA_PubSubManager *psm, UA_NodeId readerGroupIdentifier,
                         const UA_DataSetReaderConfig *dataSetReaderConfig,
@@ -291,6 +568,9 @@ UA_DataSetReader_create(UA_PubSubManager *psm, UA_NodeId readerGroupIdentifier,
         return retVal;
     }
 
+    /* Index the reader in the connection to route received DataSetMessages */
+    addToReaderIndex(dsr);
+
 #ifdef UA_ENABLE_PUBSUB_INFORMATIONMODEL
     retVal = addDataSetReaderRepresentation(psm->drv.server, dsr);
     if(retVal != UA_STATUSCODE_GOOD) {
@@ -400,12 +680,14 @@ UA_DataSetReader_remove(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
     if(sds && sds->connectedReader == dsr)
         sds->connectedReader = NULL;
 
-    /* Remove DataSetReader from group */
+    /* Remove DataSetReader from group and from the index */
     LIST_REMOVE(dsr, listEntry);
     rg->readersCount--;
+    removeFromReaderIndex(dsr);
 
     UA_LOG_INFO_PUBSUB(psm->logging, dsr, "DataSetReader deleted");
 
+    clearTargets(dsr);
     UA_DataSetReaderConfig_clear(&dsr->config);
     UA_PubSubComponentHead_clear(&dsr->head);
     UA_free(dsr);
@@ -523,6 +805,16 @@ UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
     if(dsr->head.state == oldState)
         return res;
 
+    /* Resolve the targets for the direct write once the reader is enabled */
+    if(!UA_PubSubState_isEnabled(dsr->head.state))
+        clearTargets(dsr);
+    else if(!UA_PubSubState_isEnabled(oldState))
+        resolveTargets(psm, dsr);
+
+    /* Wait for a new key frame before delta frames are applied again */
+    if(dsr->head.state != UA_PUBSUBSTATE_OPERATIONAL)
+        dsr->keyFrameReceived = false;
+
     UA_LOG_INFO_PUBSUB(psm->logging, dsr, "%s -> %s",
                        UA_PubSubState_name(oldState),
                        UA_PubSubState_name(dsr->head.state));
@@ -582,6 +874,88 @@ UA_DataSetReader_handleMessageReceiveTimeout(void *application /* UA_PubSubManag
     unlockServer(psm->drv.server);
 }
 
+/* The key frame has a value for every TargetVariable. The fields of a delta
+ * frame refer to a TargetVariable. */
+static UA_Boolean
+checkMessageFields(UA_PubSubManager *psm, UA_DataSetReader *dsr,
+                   const UA_DataSetMessage *msg) {
+    /* Heartbeats have no fields */
+    if(msg->fieldCount == 0)
+        return true;
+
+    UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
+    if(msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME) {
+        if(tvs->targetVariablesSize != msg->fieldCount) {
+            UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
+                                  "Number of fields does not match the "
+                                  "TargetVariables configuration");
+            return false;
+        }
+        return true;
+    }
+
+    for(size_t i = 0; i < msg->fieldCount; i++) {
+        if(msg->data.deltaFrameFields[i].index >= tvs->targetVariablesSize) {
+            UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
+                                  "DeltaFrame field index %u is not in the "
+                                  "TargetVariables configuration",
+                                  (unsigned)msg->data.deltaFrameFields[i].index);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Delta frames only contain the changed fields. They can be applied if all
+ * messages since the last key frame were received. Without sequence numbers,
+ * this can only be checked for the first key frame. Returns whether the
+ * message is applied. */
+static UA_Boolean
+checkMessageSequence(UA_PubSubManager *psm, UA_DataSetReader *dsr,
+                     const UA_DataSetMessage *msg) {
+    UA_Boolean keyFrame =
+        (msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME &&
+         msg->fieldCount > 0);
+    UA_Boolean heartbeat =
+        (msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME &&
+         msg->fieldCount == 0);
+
+    /* A key frame (re-)synchronizes the field values */
+    UA_UInt16 seq = msg->header.dataSetMessageSequenceNr;
+    if(keyFrame) {
+        dsr->keyFrameReceived = true;
+        dsr->lastSequenceNr = seq;
+        return true;
+    }
+
+    if(!dsr->keyFrameReceived) {
+        if(!heartbeat)
+            UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "DeltaFrame is discarded: "
+                                "Waiting for the next KeyFrame");
+        return heartbeat;
+    }
+
+    if(!msg->header.dataSetMessageSequenceNrEnabled)
+        return true;
+
+    /* The difference is computed modulo 2^16. The upper half of the range
+     * denotes an outdated or repeated message. */
+    UA_UInt16 diff = (UA_UInt16)(seq - dsr->lastSequenceNr);
+    if(diff == 0 || diff >= 0x8000) {
+        UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "DataSetMessage is discarded: "
+                            "SequenceNumber %u is outdated", (unsigned)seq);
+        return false;
+    }
+    dsr->lastSequenceNr = seq;
+    if(diff > 1) {
+        UA_LOG_INFO_PUBSUB(psm->logging, dsr, "%u DataSetMessages were lost. "
+                           "Waiting for the next KeyFrame", (unsigned)(diff - 1));
+        dsr->keyFrameReceived = false;
+        return heartbeat;
+    }
+    return true;
+}
+
 void
 UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
                          UA_DataSetMessage *msg) {
@@ -619,9 +993,11 @@ UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
      *     }
      * } */
 
-    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATAKEYFRAME) {
+    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATAKEYFRAME &&
+       msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATADELTAFRAME) {
         UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
-                              "DataSetMessage is discarded: Only keyframes are supported");
+                              "DataSetMessage is discarded: Only key and "
+                              "delta frames are supported");
         return;
     }
 
@@ -640,39 +1016,33 @@ UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
         }
     }
 
+    /* Check whether the fields match the configuration. Before the sequence
+     * is checked, so that a rejected key frame does not resynchronize the
+     * delta frames. */
+    if(!checkMessageFields(psm, dsr, msg))
+        return;
+
+    /* Check the sequence before delta frames are applied */
+    if(!checkMessageSequence(psm, dsr, msg))
+        return;
+
     /* Received a heartbeat with no fields */
     if(msg->fieldCount == 0)
         return;
 
-    /* Check whether the field count matches the configuration */
+    /* Write the message fields directly into the resolved targets */
     UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
-    if(tvs->targetVariablesSize != msg->fieldCount) {
-        UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
-                              "Number of fields does not match the "
-                              "TargetVariables configuration");
+    if(dsr->targetsSize == tvs->targetVariablesSize) {
+        writeFieldsDirect(psm, dsr, msg);
         return;
     }
 
-    /* Write the message fields. RT has the external data value configured. */
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    /* Write the message fields via the Write service */
+    size_t index;
     for(size_t i = 0; i < msg->fieldCount; i++) {
-        UA_FieldTargetDataType *tv = &tvs->targetVariables[i];
-        UA_DataValue *field = &msg->data.keyFrameFields[i];
-        if(!field->hasValue)
-            continue;
-
-        /* Write via the Write-Service */
-        UA_WriteValue writeVal;
-        UA_WriteValue_init(&writeVal);
-        writeVal.attributeId = tv->attributeId;
-        writeVal.indexRange = tv->receiverIndexRange;
-        writeVal.nodeId = tv->targetNodeId;
-        writeVal.value = *field;
-        Operation_Write(psm->drv.server, &psm->drv.server->adminSession, &writeVal, &res);
-        if(res != UA_STATUSCODE_GOOD)
-            UA_LOG_INFO_PUBSUB(psm->logging, dsr,
-                               "Error writing KeyFrame field %u: %s",
-                               (unsigned)i, UA_StatusCode_name(res));
+        UA_DataValue *field = getMessageField(msg, i, &index);
+        if(field->hasValue)
+            writeFieldService(psm, dsr, index, field);
     }
 }
 
@@ -807,8 +1177,9 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
-    /* Store the old config */
+    /* Store the old config. The index key points into the config. */
     UA_DataSetReaderConfig oldConfig = dsr->config;
+    removeFromReaderIndex(dsr);
 
     /* Copy the config into the new dataSetReader */
     UA_StatusCode retVal = UA_DataSetReaderConfig_copy(config, &dsr->config);
@@ -831,6 +1202,7 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
 
     /* Clean up and return */
     UA_DataSetReaderConfig_clear(&oldConfig);
+    addToReaderIndex(dsr);
     unlockServer(server);
     return UA_STATUSCODE_GOOD;
 
@@ -838,6 +1210,7 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
  errout:
     UA_DataSetReaderConfig_clear(&dsr->config);
     dsr->config = oldConfig;
+    addToReaderIndex(dsr);
     unlockServer(server);
     return retVal;
 }
@@ -263,6 +263,7 @@ UA_ReaderGroup_remove(UA_PubSubManager *psm, UA_ReaderGroup *rg) {
 
         UA_ReaderGroupConfig_clear(&rg->config);
         UA_PubSubComponentHead_clear(&rg->head);
+        UA_PubSubArena_clear(&rg->arena, psm->drv.server);
         UA_free(rg);
     }
 
@@ -436,6 +437,41 @@ UA_ReaderGroup_setEncryptionKeys(UA_PubSubManager *psm, UA_ReaderGroup *rg,
                                &encryptingKey, &keyNonce);
 }
 
+/* The readerIndex of the connection can be used if the NetworkMessage
+ * contains the full identifier triple for each DataSetMessage. Otherwise the
+ * missing fields act as a wildcard and all readers need to be checked. */
+static UA_Boolean
+isIndexable(const UA_ReaderGroup *rg, const UA_NetworkMessage *nm) {
+    return (rg->config.encodingMimeType == UA_PUBSUB_ENCODING_UADP &&
+            nm->publisherIdEnabled && nm->groupHeaderEnabled &&
+            nm->groupHeader.writerGroupIdEnabled && nm->payloadHeaderEnabled);
+}
+
+static void *
+findReaderInGroup(void *context, UA_DataSetReader *dsr) {
+    return (dsr->linkedReaderGroup == (UA_ReaderGroup*)context) ? dsr : NULL;
+}
+
+typedef struct {
+    UA_PubSubManager *psm;
+    UA_ReaderGroup *rg;
+    UA_DataSetMessage *dsm;
+    UA_Boolean processed;
+} ProcessIndexedCtx;
+
+static void *
+processIndexed(void *context, UA_DataSetReader *dsr) {
+    ProcessIndexedCtx *ctx = (ProcessIndexedCtx*)context;
+    if(dsr->linkedReaderGroup != ctx->rg)
+        return NULL;
+    if(dsr->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
+       dsr->head.state != UA_PUBSUBSTATE_PREOPERATIONAL)
+        return NULL;
+    ctx->processed = true;
+    UA_DataSetReader_process(ctx->psm, dsr, ctx->dsm);
+    return NULL;
+}
+
 UA_Boolean
 UA_ReaderGroup_process(UA_PubSubManager *psm, UA_ReaderGroup *rg,
                        UA_NetworkMessage *nm) {
@@ -448,6 +484,24 @@ UA_ReaderGroup_process(UA_PubSubManager *psm, UA_ReaderGroup *rg,
     rg->hasReceived = true;
     UA_ReaderGroup_setPubSubState(psm, rg, rg->head.state);
 
+    /* Route every DataSetMessage directly to its readers */
+    if(isIndexable(rg, nm)) {
+        ProcessIndexedCtx ctx = {psm, rg, NULL, false};
+        UA_DataSetReaderKey key;
+        UA_DataSetReaderKey_init(&key, &nm->publisherId,
+                                 nm->groupHeader.writerGroupId, 0);
+        UA_PubSubConnection *c = rg->linkedConnection;
+        for(size_t i = 0; i < nm->messageCount; i++) {
+            key.dataSetWriterId = nm->dataSetWriterIds[i];
+            ctx.dsm = &nm->payload.dataSetMessages[i];
+            ZIP_ITER_KEY(UA_DataSetReaderIndex, &c->readerIndex,
+                         &key, processIndexed, &ctx);
+        }
+        if(ctx.processed)
+            UA_LOG_TRACE_PUBSUB(psm->logging, rg, "Processing a NetworkMessage");
+        return ctx.processed;
+    }
+
     /* Safe iteration. The current Reader might be deleted in the ReaderGroup
      * _setPubSubState callback. */
     UA_Boolean processed = false;
@@ -490,6 +544,32 @@ UA_ReaderGroup_process(UA_PubSubManager *psm, UA_ReaderGroup *rg,
     return processed;
 }
 
+/* Decode the remainder after the headers with the metadata in ctx->eo */
+static UA_StatusCode
+decodeNetworkMessagePayload(UA_PubSubManager *psm, UA_ReaderGroup *rg,
+                            UA_ByteString buffer, PubSubDecodeCtx *ctx,
+                            UA_NetworkMessage *nm) {
+    /* Handle missing payload header and "inject" metadata */
+    UA_StatusCode rv;
+    if(!nm->payloadHeaderEnabled) {
+        rv = UA_NetworkMessage_makeSyntheticPayloadHeader(&ctx->eo, nm);
+        if(rv != UA_STATUSCODE_GOOD)
+            return rv;
+    }
+
+    /* Decrypt */
+    rv = verifyAndDecryptNetworkMessage(psm->logging, buffer, &ctx->ctx, nm, rg);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+
+    /* Decode the payload */
+    rv = UA_NetworkMessage_decodePayload(ctx, nm);
+    if(rv != UA_STATUSCODE_GOOD)
+        return rv;
+
+    return UA_NetworkMessage_decodeFooters(ctx, nm);
+}
+
 UA_StatusCode
 UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
                                     UA_ReaderGroup *rg,
@@ -502,25 +582,63 @@ UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
     ctx.ctx.end = buffer.data + buffer.length;
     ctx.ctx.opts.customTypes = psm->drv.server->config.customDataTypes;
 
+    /* Decode into the arena of the ReaderGroup */
+    ctx.ctx.opts.calloc = UA_PubSubArena_calloc;
+    ctx.ctx.opts.callocContext = &rg->arena;
+
     /* Decode the headers. This sets the number of DataSetMessages and retrieves
      * the DataSetWriterIds. Those get matched to the readers below. */
     UA_StatusCode rv = UA_NetworkMessage_decodeHeaders(&ctx, nm);
     if(rv != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_PUBSUB(psm->logging, rg,
                               "PubSub receive. decoding headers failed");
-        UA_NetworkMessage_clear(nm);
+        UA_ReaderGroup_clearNetworkMessage(psm, rg, nm);
         return rv;
     }
 
-    /* Find a matching reader. Otherwise skip for this ReaderGroup */
+    /* With the full identifiers in the headers, look up the readers in the
+     * index. Then only their metadata is needed to decode the payload. */
     UA_DataSetReader *dsr;
+    if(isIndexable(rg, nm)) {
+        size_t emdSize = 0;
+        UA_DataSetMessage_EncodingMetaData emd[UA_NETWORKMESSAGE_MAXMESSAGECOUNT];
+        UA_DataSetReaderKey key;
+        UA_DataSetReaderKey_init(&key, &nm->publisherId,
+                                 nm->groupHeader.writerGroupId, 0);
+        UA_PubSubConnection *c = rg->linkedConnection;
+        for(size_t i = 0; i < nm->messageCount; i++) {
+            key.dataSetWriterId = nm->dataSetWriterIds[i];
+            dsr = (UA_DataSetReader*)
+                ZIP_ITER_KEY(UA_DataSetReaderIndex, &c->readerIndex,
+                             &key, findReaderInGroup, rg);
+            if(!dsr)
+                continue;
+            memset(&emd[emdSize], 0, sizeof(UA_DataSetMessage_EncodingMetaData));
+            emd[emdSize].dataSetWriterId = dsr->config.dataSetWriterId;
+            emd[emdSize].fields = dsr->config.dataSetMetaData.fields;
+            emd[emdSize].fieldsSize = dsr->config.dataSetMetaData.fieldsSize;
+            emdSize++;
+        }
+        if(emdSize == 0) {
+            UA_ReaderGroup_clearNetworkMessage(psm, rg, nm);
+            return UA_STATUSCODE_BADNOTFOUND;
+        }
+        ctx.eo.metaData = emd;
+        ctx.eo.metaDataSize = emdSize;
+        rv = decodeNetworkMessagePayload(psm, rg, buffer, &ctx, nm);
+        if(rv != UA_STATUSCODE_GOOD)
+            UA_ReaderGroup_clearNetworkMessage(psm, rg, nm);
+        return rv;
+    }
+
+    /* Find a matching reader. Otherwise skip for this ReaderGroup */
     LIST_FOREACH(dsr, &rg->readers, listEntry) {
         rv = UA_DataSetReader_checkIdentifier(psm, dsr, nm);
         if(rv == UA_STATUSCODE_GOOD)
             break;
     }
     if(!dsr) {
-        UA_NetworkMessage_clear(nm);
+        UA_ReaderGroup_clearNetworkMessage(psm, rg, nm);
         return UA_STATUSCODE_BADNOTFOUND;
     }
 
@@ -538,36 +656,21 @@ UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
         i++;
     }
 
-    /* Handle missing payload header and "inject" metadata */
-    if(!nm->payloadHeaderEnabled) {
-        rv = UA_NetworkMessage_makeSyntheticPayloadHeader(&ctx.eo, nm);
-        if(rv != UA_STATUSCODE_GOOD) {
-            UA_NetworkMessage_clear(nm);
-            return rv;
-        }
-    }
-
-    /* Decrypt */
-    rv = verifyAndDecryptNetworkMessage(psm->logging, buffer, &ctx.ctx, nm, rg);
-    if(rv != UA_STATUSCODE_GOOD) {
-        UA_NetworkMessage_clear(nm);
-        return rv;
-    }
-
-    /* Decode the payload */
-    rv = UA_NetworkMessage_decodePayload(&ctx, nm);
-    if(rv != UA_STATUSCODE_GOOD) {
-        UA_NetworkMessage_clear(nm);
-        return rv;
-    }
+    rv = decodeNetworkMessagePayload(psm, rg, buffer, &ctx, nm);
+    if(rv != UA_STATUSCODE_GOOD)
+        UA_ReaderGroup_clearNetworkMessage(psm, rg, nm);
+    return rv;
+}
 
-    rv = UA_NetworkMessage_decodeFooters(&ctx, nm);
-    if(rv != UA_STATUSCODE_GOOD) {
+void
+UA_ReaderGroup_clearNetworkMessage(UA_PubSubManager *psm, UA_ReaderGroup *rg,
+                                   UA_NetworkMessage *nm) {
+    if(rg->config.encodingMimeType == UA_PUBSUB_ENCODING_JSON) {
         UA_NetworkMessage_clear(nm);
-        return rv;
+        return;
     }
-
-    return UA_STATUSCODE_GOOD;
+    UA_PubSubArena_reset(&rg->arena, psm->drv.server);
+    memset(nm, 0, sizeof(UA_NetworkMessage));
 }
 
 #ifdef UA_ENABLE_JSON_ENCODING
@@ -865,6 +968,8 @@ ReaderGroupChannelCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     }
 
     /* Decode message */
+    UA_EventLoop *el = server->config.eventLoop;
+    UA_DateTime start = el->dateTime_nowMonotonic(el);
     UA_NetworkMessage nm;
     memset(&nm, 0, sizeof(UA_NetworkMessage));
     if(rg->config.encodingMimeType == UA_PUBSUB_ENCODING_UADP) {
@@ -879,13 +984,21 @@ ReaderGroupChannelCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     if(res != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_PUBSUB(psm->logging, rg,
                               "Verify, decrypt and decode network message failed");
+        rg->stats.droppedNetworkMessages++;
         unlockServer(server);
         return;
     }
+    UA_DateTime decoded = el->dateTime_nowMonotonic(el);
+    UA_PubSubHistogram_add(&rg->stats.decodeTime, decoded - start);
 
     /* Process the decoded message */
-    UA_ReaderGroup_process(psm, rg, &nm);
-    UA_NetworkMessage_clear(&nm);
+    if(UA_ReaderGroup_process(psm, rg, &nm))
+        rg->stats.receivedNetworkMessages++;
+    else
+        rg->stats.droppedNetworkMessages++;
+    UA_PubSubHistogram_add(&rg->stats.processTime,
+                           el->dateTime_nowMonotonic(el) - decoded);
+    UA_ReaderGroup_clearNetworkMessage(psm, rg, &nm);
     unlockServer(server);
 }
 
@@ -1072,6 +1185,37 @@ UA_Server_getReaderGroupState(UA_Server *server, const UA_NodeId rgId,
     return ret;
 }
 
+UA_StatusCode
+UA_Server_getReaderGroupStatistics(UA_Server *server, const UA_NodeId rgId,
+                                   UA_ReaderGroupStatistics *stats) {
+    if(!server || !stats)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    lockServer(server);
+    UA_StatusCode ret = UA_STATUSCODE_BADNOTFOUND;
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(getPSM(server), rgId);
+    if(rg) {
+        *stats = rg->stats;
+        ret = UA_STATUSCODE_GOOD;
+    }
+    unlockServer(server);
+    return ret;
+}
+
+UA_StatusCode
+UA_Server_resetReaderGroupStatistics(UA_Server *server, const UA_NodeId rgId) {
+    if(!server)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    lockServer(server);
+    UA_StatusCode ret = UA_STATUSCODE_BADNOTFOUND;
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(getPSM(server), rgId);
+    if(rg) {
+        memset(&rg->stats, 0, sizeof(UA_ReaderGroupStatistics));
+        ret = UA_STATUSCODE_GOOD;
+    }
+    unlockServer(server);
+    return ret;
+}
+
 #ifdef UA_ENABLE_PUBSUB_SKS
 UA_StatusCode
 UA_Server_setReaderGroupActivateKey(UA_Server *server,
@@ -143,6 +143,9 @@ UA_DataSetWriter_setPubSubState(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
     if(dsw->head.state == oldState)
         return res;
 
+    /* The pre-encoded NetworkMessages of the WriterGroup are outdated */
+    UA_WriterGroup_resetTemplates(wg);
+
     UA_LOG_INFO_PUBSUB(psm->logging, dsw, "%s -> %s",
                        UA_PubSubState_name(oldState),
                        UA_PubSubState_name(dsw->head.state));
@@ -307,6 +310,9 @@ UA_DataSetWriter_create(UA_PubSubManager *psm,
         }
     }
 
+    /* Monitor the fields if the WriterGroup publishes on value change */
+    UA_WriterGroup_updateValueChangeMonitoredItems(psm, wg);
+
     UA_LOG_INFO_PUBSUB(psm->logging, dsw,
                        "DataSetWriter created (State: %s)",
                        UA_PubSubState_name(dsw->head.state));
@@ -357,6 +363,7 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw) {
     /* Remove DataSetWriter from group */
     LIST_REMOVE(dsw, listEntry);
     wg->writersCount--;
+    UA_WriterGroup_updateValueChangeMonitoredItems(psm, wg);
 
     UA_LOG_INFO_PUBSUB(psm->logging, dsw, "Writer deleted");
 
@@ -370,6 +377,9 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw) {
         dsw->lastSamplesCount = 0;
     }
 
+#ifdef UA_ENABLE_JSON_ENCODING
+    UA_DataSetMessageJsonTemplate_clear(&dsw->jsonTemplate);
+#endif
     UA_DataSetWriterConfig_clear(&dsw->config);
     UA_PubSubComponentHead_clear(&dsw->head);
     UA_free(dsw);
@@ -381,10 +391,72 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw) {
 /*               PublishValues handling                  */
 /*********************************************************/
 
+/* With an arena, the values are borrowed from the nodes where possible. The
+ * nodes are released and the sampled values cleared with the arena reset. */
+static UA_StatusCode
+sampleArenaValue(UA_PubSubManager *psm, UA_PubSubArena *arena,
+                 UA_DataSetField *dsf, UA_DataValue *value) {
+    const UA_Node *node = UA_PubSubDataSetField_borrowValue(psm, dsf, value);
+    if(node) {
+        /* Add the timestamps like the Read service */
+        UA_EventLoop *el = psm->drv.server->config.eventLoop;
+        UA_DateTime now = el->dateTime_now(el);
+        value->serverTimestamp = now;
+        value->hasServerTimestamp = true;
+        value->hasServerPicoseconds = false;
+        if(!value->hasSourceTimestamp) {
+            value->sourceTimestamp = now;
+            value->hasSourceTimestamp = true;
+        }
+    }
+    UA_StatusCode res = (node) ?
+        UA_PubSubArena_addCleanup(arena, node, NULL) :
+        UA_PubSubArena_addCleanup(arena, NULL, value);
+    if(res == UA_STATUSCODE_GOOD)
+        return res;
+    if(node)
+        UA_NODESTORE_RELEASE(psm->drv.server, node);
+    else
+        UA_DataValue_clear(value);
+    UA_DataValue_init(value);
+    return res;
+}
+
+/* Store a sample in the lastSamples of the writer. If the new value has the
+ * same pointer-free type and shape as the stored one, then the content is
+ * overwritten in place without an allocation. Otherwise a copy is made. The
+ * stored sample remains unchanged if the copy fails. */
+static UA_StatusCode
+storeLastSample(UA_DataValue *last, const UA_DataValue *value) {
+    const UA_Variant *lv = &last->value;
+    const UA_Variant *nv = &value->value;
+    if(lv->type && lv->type == nv->type && lv->type->pointerFree &&
+       lv->storageType == UA_VARIANT_DATA &&
+       lv->data > UA_EMPTY_ARRAY_SENTINEL && nv->data > UA_EMPTY_ARRAY_SENTINEL &&
+       lv->arrayLength == nv->arrayLength &&
+       lv->arrayDimensionsSize == 0 && nv->arrayDimensionsSize == 0) {
+        size_t count = (lv->arrayLength > 0) ? lv->arrayLength : 1;
+        memcpy(lv->data, nv->data, count * lv->type->memSize);
+        UA_Variant stored = *lv;
+        *last = *value;
+        last->value = stored;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    UA_DataValue tmp;
+    UA_StatusCode res = UA_DataValue_copy(value, &tmp);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_DataValue_clear(last);
+    *last = tmp;
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
                                                UA_DataSetMessage *dataSetMessage,
-                                               UA_DataSetWriter *dsw) {
+                                               UA_DataSetWriter *dsw,
+                                               UA_PubSubArena *arena) {
     UA_PublishedDataSet *pds = dsw->connectedDataSet;
     if(!pds)
         return UA_STATUSCODE_BADNOTFOUND;
@@ -393,8 +465,13 @@ UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
     dataSetMessage->header.dataSetMessageValid = true;
     dataSetMessage->header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
     dataSetMessage->fieldCount = pds->fieldSize;
-    dataSetMessage->data.keyFrameFields = (UA_DataValue *)
+    if(arena) {
+        dataSetMessage->data.keyFrameFields = (UA_DataValue *)
+            UA_PubSubArena_calloc(arena, pds->fieldSize, sizeof(UA_DataValue));
+    } else {
+        dataSetMessage->data.keyFrameFields = (UA_DataValue *)
             UA_Array_new(pds->fieldSize, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    }
     if(!dataSetMessage->data.keyFrameFields)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
@@ -404,7 +481,13 @@ UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
     TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
         /* Sample the value */
         UA_DataValue *dfv = &dataSetMessage->data.keyFrameFields[counter];
-        UA_PubSubDataSetField_sampleValue(psm, dsf, dfv);
+        if(arena) {
+            UA_StatusCode res = sampleArenaValue(psm, arena, dsf, dfv);
+            if(res != UA_STATUSCODE_GOOD)
+                return res;
+        } else {
+            UA_PubSubDataSetField_sampleValue(psm, dsf, dfv);
+        }
 
         /* Deactivate statuscode? */
         if(((u64)dsw->config.dataSetFieldContentMask &
@@ -427,8 +510,10 @@ UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
 
         if(psm->drv.server->config.pubSubConfig.enableDeltaFrames) {
             /* Update lastValue store */
-            UA_DataValue_clear(&dsw->lastSamples[counter].value);
-            UA_DataValue_copy(dfv, &dsw->lastSamples[counter].value);
+            UA_StatusCode res =
+                storeLastSample(&dsw->lastSamples[counter].value, dfv);
+            if(res != UA_STATUSCODE_GOOD)
+                return res;
         }
         counter++;
     }
@@ -440,7 +525,8 @@ UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
 static UA_StatusCode
 UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
                                                  UA_DataSetMessage *dsm,
-                                                 UA_DataSetWriter *dsw) {
+                                                 UA_DataSetWriter *dsw,
+                                                 UA_PubSubArena *arena) {
     UA_PublishedDataSet *pds = dsw->connectedDataSet;
     if(!pds)
         return UA_STATUSCODE_BADNOTFOUND;
@@ -454,32 +540,44 @@ UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
     UA_DataSetField *dsf;
     UA_UInt16 counter = 0;
     TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
-        /* Sample the value */
+        /* Borrow the value for the comparison. Copy only if it has changed. */
         UA_DataValue value;
         UA_DataValue_init(&value);
-        UA_PubSubDataSetField_sampleValue(psm, dsf, &value);
+        const UA_Node *node = UA_PubSubDataSetField_borrowValue(psm, dsf, &value);
 
-        /* Check if the value has changed */
+        /* Check if the value has changed. Then update the last stored
+         * sample and increase the fieldCount for the current delta
+         * message. */
+        UA_StatusCode res = UA_STATUSCODE_GOOD;
         UA_DataSetWriterSample *ls = &dsw->lastSamples[counter];
-        if(!UA_Variant_equal(&ls->value.value, &value.value)) {
-            /* increase fieldCount for current delta message */
+        ls->valueChanged = !UA_Variant_equal(&ls->value.value, &value.value);
+        if(ls->valueChanged) {
             dsm->fieldCount++;
-            ls->valueChanged = true;
-
-            /* Update last stored sample */
-            UA_DataValue_clear(&ls->value);
-            ls->value = value;
-        } else {
-            UA_DataValue_clear(&value);
-            ls->valueChanged = false;
+            res = storeLastSample(&ls->value, &value);
         }
 
+        if(node)
+            UA_NODESTORE_RELEASE(psm->drv.server, node);
+        else
+            UA_DataValue_clear(&value);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
         counter++;
     }
 
+    if(dsm->fieldCount == 0)
+        return UA_STATUSCODE_GOOD;
+
     /* Allocate DeltaFrameFields */
-    UA_DataSetMessage_DeltaFrameField *deltaFields = (UA_DataSetMessage_DeltaFrameField *)
-        UA_calloc(counter, sizeof(UA_DataSetMessage_DeltaFrameField));
+    UA_DataSetMessage_DeltaFrameField *deltaFields;
+    if(arena) {
+        deltaFields = (UA_DataSetMessage_DeltaFrameField *)
+            UA_PubSubArena_calloc(arena, dsm->fieldCount,
+                                  sizeof(UA_DataSetMessage_DeltaFrameField));
+    } else {
+        deltaFields = (UA_DataSetMessage_DeltaFrameField *)
+            UA_calloc(dsm->fieldCount, sizeof(UA_DataSetMessage_DeltaFrameField));
+    }
     if(!deltaFields)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
@@ -492,8 +590,17 @@ UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
 
         UA_DataSetMessage_DeltaFrameField *dff = &deltaFields[currentDeltaField];
 
+        /* The last samples are stable until the next generation. Use them
+         * without a copy if the message lives in the arena. */
         dff->index = (UA_UInt16)i;
-        UA_DataValue_copy(&dsw->lastSamples[i].value, &dff->value);
+        if(arena) {
+            dff->value = dsw->lastSamples[i].value;
+        } else {
+            UA_StatusCode res =
+                UA_DataValue_copy(&dsw->lastSamples[i].value, &dff->value);
+            if(res != UA_STATUSCODE_GOOD)
+                return res;
+        }
 
         /* Reset the changed flag */
         dsw->lastSamples[i].valueChanged = false;
@@ -526,7 +633,8 @@ UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
 UA_StatusCode
 UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
                                         UA_DataSetWriter *dsw,
-                                        UA_DataSetMessage *dataSetMessage) {
+                                        UA_DataSetMessage *dataSetMessage,
+                                        UA_PubSubArena *arena) {
     UA_EventLoop *el = psm->drv.server->config.eventLoop;
 
     /* Heartbeat message if no pds is connected */
@@ -704,7 +812,7 @@ UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
 
             dsw->connectedDataSetVersion =
                 pds->dataSetMetaData.configurationVersion;
-            UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw);
+            UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw, arena);
             dsw->deltaFrameCounter = 0;
             return UA_STATUSCODE_GOOD;
         }
@@ -714,7 +822,7 @@ UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
          * field. */
         if(pds->fieldSize > 1 && dsw->deltaFrameCounter > 0 &&
            dsw->deltaFrameCounter <= dsw->config.keyFrameCount) {
-            UA_PubSubDataSetWriter_generateDeltaFrameMessage(psm, dataSetMessage, dsw);
+            UA_PubSubDataSetWriter_generateDeltaFrameMessage(psm, dataSetMessage, dsw, arena);
             dsw->deltaFrameCounter++;
             return UA_STATUSCODE_GOOD;
         }
@@ -722,7 +830,7 @@ UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
         dsw->deltaFrameCounter = 1;
     }
 
-    return UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw);
+    return UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw, arena);
 }
 
 /**************/
@@ -54,6 +54,165 @@ UA_WriterGroup_canConnect(UA_WriterGroup *wg) {
     return true;
 }
 
+/* Record the scheduling lateness before the publish cycle. The timer keeps the
+ * interval from the last scheduled time. Or from the current time if the
+ * execution was missed (UA_TIMERPOLICY_CURRENTTIME). The first execution only
+ * sets the base time, as the EventLoop may batch it with other timers. */
+static void
+publishTimerCallback(void *application, void *context) {
+    UA_PubSubManager *psm = (UA_PubSubManager*)application;
+    UA_WriterGroup *wg = (UA_WriterGroup*)context;
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime now = el->dateTime_nowMonotonic(el);
+    lockServer(psm->drv.server);
+    UA_DateTime interval = (UA_DateTime)
+        (wg->config.publishingInterval * (UA_Double)UA_DATETIME_MSEC);
+    if(wg->nextPublishTime != 0) {
+        UA_PubSubHistogram_add(&wg->stats.schedulingLateness,
+                               now - wg->nextPublishTime);
+        wg->nextPublishTime += interval;
+    }
+    if(wg->nextPublishTime < now)
+        wg->nextPublishTime = now + interval;
+    unlockServer(psm->drv.server);
+
+    UA_WriterGroup_publishCallback(psm, wg);
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+/* The keep-alive timer is restarted after every publish on value change */
+static UA_Double
+keepAliveInterval(const UA_WriterGroup *wg) {
+    if(wg->config.keepAliveTime > wg->config.publishingInterval)
+        return wg->config.keepAliveTime;
+    return wg->config.publishingInterval;
+}
+
+static void
+valueChangeTimerCallback(void *application, void *context) {
+    UA_PubSubManager *psm = (UA_PubSubManager*)application;
+    UA_WriterGroup *wg = (UA_WriterGroup*)context;
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    lockServer(psm->drv.server);
+    wg->valueChangeCallbackId = 0; /* Once-timers are removed after execution */
+    UA_PubSubHistogram_add(&wg->stats.schedulingLateness,
+                           el->dateTime_nowMonotonic(el) - wg->nextPublishTime);
+    if(wg->publishCallbackId != 0)
+        el->modifyTimer(el, wg->publishCallbackId, keepAliveInterval(wg),
+                        NULL, UA_TIMERPOLICY_CURRENTTIME);
+    unlockServer(psm->drv.server);
+
+    UA_WriterGroup_publishCallback(psm, wg);
+}
+
+/* Schedule a publish if none is pending. Keep the publishingInterval since the
+ * last publish. Don't publish from within the callback. A failed publish can
+ * remove the MonitoredItems while their notifications are processed. */
+static void
+valueChangeCallback(UA_Server *server, UA_UInt32 monitoredItemId,
+                    void *monitoredItemContext, const UA_NodeId *nodeId,
+                    void *nodeContext, UA_UInt32 attributeId,
+                    const UA_DataValue *value) {
+    UA_PubSubManager *psm = getPSM(server);
+    UA_WriterGroup *wg = (UA_WriterGroup*)monitoredItemContext;
+    if(!psm || wg->valueChangeCallbackId != 0)
+        return;
+
+    UA_EventLoop *el = server->config.eventLoop;
+    UA_DateTime now = el->dateTime_nowMonotonic(el);
+    UA_DateTime next = wg->lastPublishTimeStamp + (UA_DateTime)
+        (wg->config.publishingInterval * (UA_Double)UA_DATETIME_MSEC);
+    if(next < now)
+        next = now;
+    wg->nextPublishTime = next;
+
+    UA_StatusCode res =
+        el->addTimer(el, valueChangeTimerCallback, psm, wg, 0.0, &next,
+                     UA_TIMERPOLICY_ONCE, &wg->valueChangeCallbackId);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_LOG_WARNING_PUBSUB(psm->logging, wg,
+                              "Could not schedule the publish on value change "
+                              "with status code %s", UA_StatusCode_name(res));
+}
+
+/* Monitor the variable fields of all PublishedDataSets in the WriterGroup */
+static UA_StatusCode
+addValueChangeMonitoredItems(UA_PubSubManager *psm, UA_WriterGroup *wg) {
+    UA_DataSetWriter *dsw;
+    LIST_FOREACH(dsw, &wg->writers, listEntry) {
+        UA_PublishedDataSet *pds = dsw->connectedDataSet;
+        if(!pds)
+            continue;
+        UA_DataSetField *field;
+        TAILQ_FOREACH(field, &pds->fields, listEntry) {
+            if(field->config.dataSetFieldType != UA_PUBSUB_DATASETFIELD_VARIABLE)
+                continue;
+            const UA_PublishedVariableDataType *pp =
+                &field->config.field.variable.publishParameters;
+            UA_MonitoredItemCreateRequest item;
+            UA_MonitoredItemCreateRequest_init(&item);
+            item.itemToMonitor.nodeId = pp->publishedVariable;
+            item.itemToMonitor.attributeId = pp->attributeId;
+            item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+            item.requestedParameters.samplingInterval = 0.0;
+            item.requestedParameters.discardOldest = true;
+            item.requestedParameters.queueSize = 1;
+
+            UA_UInt32 *items = (UA_UInt32*)
+                UA_realloc(wg->valueChangeItems, sizeof(UA_UInt32) *
+                           (wg->valueChangeItemsSize + 1));
+            if(!items)
+                return UA_STATUSCODE_BADOUTOFMEMORY;
+            wg->valueChangeItems = items;
+
+            UA_MonitoredItemCreateResult res =
+                createDataChangeMonitoredItem(psm->drv.server,
+                                              UA_TIMESTAMPSTORETURN_NEITHER,
+                                              &item, wg, valueChangeCallback);
+            UA_StatusCode ret = res.statusCode;
+            if(ret == UA_STATUSCODE_GOOD)
+                items[wg->valueChangeItemsSize++] = res.monitoredItemId;
+            UA_MonitoredItemCreateResult_clear(&res);
+            if(ret != UA_STATUSCODE_GOOD) {
+                UA_LOG_ERROR_PUBSUB(psm->logging, wg,
+                                    "Could not monitor the field %N for value "
+                                    "changes with status code %s",
+                                    pp->publishedVariable, UA_StatusCode_name(ret));
+                return ret;
+            }
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+removeValueChangeMonitoredItems(UA_PubSubManager *psm, UA_WriterGroup *wg) {
+    for(size_t i = 0; i < wg->valueChangeItemsSize; i++)
+        deleteMonitoredItem(psm->drv.server, wg->valueChangeItems[i]);
+    UA_free(wg->valueChangeItems);
+    wg->valueChangeItems = NULL;
+    wg->valueChangeItemsSize = 0;
+}
+#endif
+
+void
+UA_WriterGroup_updateValueChangeMonitoredItems(UA_PubSubManager *psm,
+                                               UA_WriterGroup *wg) {
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    UA_LOCK_ASSERT(&psm->drv.server->serviceMutex);
+
+    /* Only if the WriterGroup is publishing on value change right now */
+    if(!wg->config.publishOnValueChange || wg->publishCallbackId == 0)
+        return;
+
+    /* Recreate the MonitoredItems. A pending publish is kept. */
+    removeValueChangeMonitoredItems(psm, wg);
+    UA_StatusCode res = addValueChangeMonitoredItems(psm, wg);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_WriterGroup_setPubSubState(psm, wg, UA_PUBSUBSTATE_ERROR);
+#endif
+}
+
 UA_StatusCode
 UA_WriterGroup_addPublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg) {
     UA_LOCK_ASSERT(&psm->drv.server->serviceMutex);
@@ -63,8 +222,25 @@ UA_WriterGroup_addPublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg) {
         return UA_STATUSCODE_GOOD;
 
     /* Use EventLoop for cyclic callbacks */
+    wg->nextPublishTime = 0;
     UA_EventLoop *el = psm->drv.server->config.eventLoop;
-    return el->addTimer(el, UA_WriterGroup_publishCallback,
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    /* Publish on value change. The cyclic callback is the keep-alive. The
+     * MonitoredItems sample the current values right away. This schedules the
+     * first publish. */
+    if(wg->config.publishOnValueChange) {
+        UA_StatusCode res =
+            el->addTimer(el, UA_WriterGroup_publishCallback, psm, wg,
+                         keepAliveInterval(wg), NULL,
+                         UA_TIMERPOLICY_CURRENTTIME, &wg->publishCallbackId);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        return addValueChangeMonitoredItems(psm, wg);
+    }
+#endif
+
+    return el->addTimer(el, publishTimerCallback,
                         psm, wg, wg->config.publishingInterval,
                         NULL /* TODO: use basetime */,
                         UA_TIMERPOLICY_CURRENTTIME,
@@ -73,9 +249,17 @@ UA_WriterGroup_addPublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg) {
 
 void
 UA_WriterGroup_removePublishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg) {
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    removeValueChangeMonitoredItems(psm, wg);
+    if(wg->valueChangeCallbackId != 0 && UA_LIKELY(el != NULL))
+        el->removeTimer(el, wg->valueChangeCallbackId);
+    wg->valueChangeCallbackId = 0;
+#endif
+
     if(wg->publishCallbackId == 0)
         return;
-    UA_EventLoop *el = psm->drv.server->config.eventLoop;
     if(UA_LIKELY(el != NULL))
         el->removeTimer(el, wg->publishCallbackId);
     wg->publishCallbackId = 0;
@@ -122,6 +306,15 @@ writerGroupAttachSKSKeystorage(UA_PubSubManager *psm, UA_WriterGroup *wg) {
 static UA_StatusCode
 validateWriterGroupConfig(UA_PubSubManager *psm, UA_PubSubComponentHead *logHead,
                           const UA_WriterGroupConfig *config) {
+#ifndef UA_ENABLE_SUBSCRIPTIONS
+    if(config->publishOnValueChange) {
+        UA_LOG_WARNING_PUBSUB(psm->logging, (UA_PubSubConnection*)logHead,
+                              "Publishing on value change requires "
+                              "UA_ENABLE_SUBSCRIPTIONS");
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+#endif
+
     const UA_ExtensionObject *ms = &config->messageSettings;
     if(ms->encoding == UA_EXTENSIONOBJECT_ENCODED_NOBODY)
         return UA_STATUSCODE_GOOD;
@@ -321,6 +514,11 @@ UA_WriterGroup_remove(UA_PubSubManager *psm, UA_WriterGroup *wg) {
 
         UA_WriterGroupConfig_clear(&wg->config);
         UA_PubSubComponentHead_clear(&wg->head);
+        UA_PubSubArena_clear(&wg->arena, server);
+#ifdef UA_ENABLE_JSON_ENCODING
+        UA_String_clear(&wg->jsonHeader);
+        UA_ByteString_clear(&wg->jsonBuffer);
+#endif
         UA_free(wg);
     }
 
@@ -513,6 +711,10 @@ UA_WriterGroup_setPubSubState(UA_PubSubManager *psm, UA_WriterGroup *wg,
 
  finalize_state_machine:
 
+    /* The templates of the fast path are recorded when operational */
+    if(wg->head.state != UA_PUBSUBSTATE_OPERATIONAL)
+        UA_WriterGroup_resetTemplates(wg);
+
     /* Only the top-level state update (if recursive calls are happening)
      * notifies the application and updates Reader and WriterGroups */
     wg->head.transientState = isTransient;
@@ -607,31 +809,145 @@ encodeNetworkMessage(UA_WriterGroup *wg, PubSubEncodeCtx *ctx,
     return encryptAndSign(wg, nm, networkMessageStart, payloadStart, footerEnd);
 }
 
+/* The NetworkMessages of a publish cycle are collected and handed to the
+ * ConnectionManager together if it supports sending in batches */
+typedef struct {
+    UA_ByteString *bufs;
+    size_t bufsSize;
+    size_t bufsMax;
+    uintptr_t connectionId;
+} NetworkMessageBatch;
+
+static void
+sendFailed(UA_PubSubManager *psm, UA_WriterGroup *wg,
+           UA_PubSubConnection *connection) {
+    /* Failure, set the WriterGroup into an error mode */
+    UA_LOG_ERROR_PUBSUB(psm->logging, wg, "Sending NetworkMessage failed");
+    UA_WriterGroup_setPubSubState(psm, wg, UA_PUBSUBSTATE_ERROR);
+    UA_PubSubConnection_setPubSubState(psm, connection, UA_PUBSUBSTATE_ERROR);
+}
+
+static void
+flushNetworkMessageBatch(UA_PubSubManager *psm, UA_WriterGroup *wg,
+                         UA_PubSubConnection *connection,
+                         NetworkMessageBatch *batch) {
+    if(!batch || batch->bufsSize == 0)
+        return;
+    UA_ConnectionManager *cm = connection->cm;
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime start = el->dateTime_nowMonotonic(el);
+    UA_StatusCode res =
+        cm->sendWithConnectionBatch(cm, batch->connectionId, &UA_KEYVALUEMAP_NULL,
+                                    batch->bufs, batch->bufsSize);
+    wg->cycleSendTime += el->dateTime_nowMonotonic(el) - start;
+    if(res != UA_STATUSCODE_GOOD) {
+        wg->stats.failedNetworkMessages += batch->bufsSize;
+        batch->bufsSize = 0;
+        sendFailed(psm, wg, connection);
+        return;
+    }
+    wg->stats.sentNetworkMessages += batch->bufsSize;
+    batch->bufsSize = 0;
+}
+
 static void
-sendNetworkMessageBuffer(UA_PubSubManager *psm, UA_WriterGroup *wg, 
+sendNetworkMessageBuffer(UA_PubSubManager *psm, UA_WriterGroup *wg,
                          UA_PubSubConnection *connection, uintptr_t connectionId,
-                         UA_ByteString *buffer) {
-    UA_StatusCode res = connection->cm->
-        sendWithConnection(connection->cm, connectionId,
-                           &UA_KEYVALUEMAP_NULL, buffer);
+                         UA_ByteString *buffer, NetworkMessageBatch *batch) {
+    /* Add to the batch. The sequence number is increased right away, as the
+     * next NetworkMessage is encoded before the batch is sent. */
+    UA_ConnectionManager *cm = connection->cm;
+    if(batch && batch->bufsMax > 1 && cm->sendWithConnectionBatch) {
+        if(batch->bufsSize > 0 && batch->connectionId != connectionId)
+            flushNetworkMessageBatch(psm, wg, connection, batch);
+        batch->connectionId = connectionId;
+        batch->bufs[batch->bufsSize++] = *buffer;
+        UA_ByteString_init(buffer);
+        wg->sequenceNumber++;
+        if(batch->bufsSize == batch->bufsMax)
+            flushNetworkMessageBatch(psm, wg, connection, batch);
+        return;
+    }
 
-    /* Failure, set the WriterGroup into an error mode */
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime start = el->dateTime_nowMonotonic(el);
+    UA_StatusCode res =
+        cm->sendWithConnection(cm, connectionId, &UA_KEYVALUEMAP_NULL, buffer);
+    wg->cycleSendTime += el->dateTime_nowMonotonic(el) - start;
     if(res != UA_STATUSCODE_GOOD) {
-        UA_LOG_ERROR_PUBSUB(psm->logging, wg,
-                            "Sending NetworkMessage failed");
-        UA_WriterGroup_setPubSubState(psm, wg, UA_PUBSUBSTATE_ERROR);
-        UA_PubSubConnection_setPubSubState(psm, connection, UA_PUBSUBSTATE_ERROR);
+        wg->stats.failedNetworkMessages++;
+        sendFailed(psm, wg, connection);
         return;
     }
 
     /* Sending successful - increase the sequence number */
+    wg->stats.sentNetworkMessages++;
     wg->sequenceNumber++;
 }
 
 #ifdef UA_ENABLE_JSON_ENCODING
+static UA_DataSetWriter *
+findWriterById(UA_WriterGroup *wg, UA_UInt16 writerId);
+
+/* Compile the missing templates. Returns false if the templates cannot be
+ * used. Then the generic encoding is used for this NetworkMessage. */
+static UA_Boolean
+prepareJsonTemplates(UA_WriterGroup *wg, const UA_NetworkMessage *nm,
+                     const UA_NetworkMessage_EncodingOptions *eo,
+                     UA_DataSetMessageJsonTemplate **templates) {
+    /* The templates are reset when the WriterGroup leaves the operational
+     * state. Don't compile them before. */
+    if(wg->head.state != UA_PUBSUBSTATE_OPERATIONAL)
+        return false;
+
+    if(!wg->jsonHeader.data &&
+       UA_NetworkMessage_encodeJsonHeaderTemplate(nm, &wg->jsonHeader) !=
+       UA_STATUSCODE_GOOD)
+        return false;
+
+    for(size_t i = 0; i < nm->messageCount; i++) {
+        UA_DataSetWriter *dsw = findWriterById(wg, nm->dataSetWriterIds[i]);
+        const UA_DataSetMessage_EncodingMetaData *emd =
+            findEncodingMetaData(eo, nm->dataSetWriterIds[i]);
+        if(!dsw || !emd)
+            return false;
+        if(!dsw->jsonTemplate.head.data &&
+           UA_DataSetMessageJsonTemplate_init(&dsw->jsonTemplate, emd) !=
+           UA_STATUSCODE_GOOD)
+            return false;
+        templates[i] = &dsw->jsonTemplate;
+    }
+    return true;
+}
+
+/* Encode into the scratch buffer of the WriterGroup. The buffer is enlarged
+ * until the message fits. */
+static UA_StatusCode
+encodeJsonTemplate(UA_WriterGroup *wg, const UA_NetworkMessage *nm,
+                   UA_DataSetMessageJsonTemplate **templates, size_t *msgSize) {
+    CtxJson ctx;
+    UA_StatusCode res;
+    do {
+        memset(&ctx, 0, sizeof(CtxJson));
+        ctx.pos = wg->jsonBuffer.data;
+        ctx.end = wg->jsonBuffer.data + wg->jsonBuffer.length;
+        res = UA_NetworkMessage_encodeJsonTemplate(&ctx, &wg->jsonHeader,
+                                                   templates, nm);
+        if(res != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED)
+            break;
+        size_t length = (wg->jsonBuffer.length > 0) ?
+            wg->jsonBuffer.length * 2 : 1024;
+        UA_ByteString_clear(&wg->jsonBuffer);
+        res = UA_ByteString_allocBuffer(&wg->jsonBuffer, length);
+    } while(res == UA_STATUSCODE_GOOD);
+    *msgSize = (size_t)(ctx.pos - wg->jsonBuffer.data);
+    return res;
+}
+
 static UA_StatusCode
 sendNetworkMessageJson(UA_PubSubManager *psm, UA_PubSubConnection *connection, UA_WriterGroup *wg,
-                       UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount) {
+                       UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount,
+                       NetworkMessageBatch *batch) {
     /* Prepare the NetworkMessage */
     UA_NetworkMessage nm;
     memset(&nm, 0, sizeof(UA_NetworkMessage));
@@ -666,8 +982,20 @@ sendNetworkMessageJson(UA_PubSubManager *psm, UA_PubSubConnection *connection, U
         i++;
     }
 
-    /* Compute the message length */
-    size_t msgSize = UA_NetworkMessage_calcSizeJson(&nm, &ctx.eo, NULL);
+    /* Encode with the precompiled templates into the scratch buffer.
+     * Otherwise compute the message length for the generic encoding. */
+    size_t msgSize = 0;
+    UA_Boolean precompiled = false;
+    UA_DataSetMessageJsonTemplate *templates[UA_NETWORKMESSAGE_MAXMESSAGECOUNT];
+    if(prepareJsonTemplates(wg, &nm, &ctx.eo, templates)) {
+        UA_StatusCode res = encodeJsonTemplate(wg, &nm, templates, &msgSize);
+        if(res == UA_STATUSCODE_GOOD)
+            precompiled = true;
+        else if(res != UA_STATUSCODE_BADNOTSUPPORTED)
+            return res;
+    }
+    if(!precompiled)
+        msgSize = UA_NetworkMessage_calcSizeJson(&nm, &ctx.eo, NULL);
 
     UA_ConnectionManager *cm = connection->cm;
     if(!cm)
@@ -688,17 +1016,21 @@ sendNetworkMessageJson(UA_PubSubManager *psm, UA_PubSubConnection *connection, U
     UA_CHECK_STATUS(res, return res);
 
     /* Encode the message */
-    ctx.ctx.pos = buf.data;
-    ctx.ctx.end = &buf.data[msgSize];
-    res = UA_NetworkMessage_encodeJsonInternal(&ctx, &nm);
-    if(res != UA_STATUSCODE_GOOD) {
-        cm->freeNetworkBuffer(cm, sendChannel, &buf);
-        return res;
+    if(precompiled) {
+        memcpy(buf.data, wg->jsonBuffer.data, msgSize);
+    } else {
+        ctx.ctx.pos = buf.data;
+        ctx.ctx.end = &buf.data[msgSize];
+        res = UA_NetworkMessage_encodeJsonInternal(&ctx, &nm);
+        if(res != UA_STATUSCODE_GOOD) {
+            cm->freeNetworkBuffer(cm, sendChannel, &buf);
+            return res;
+        }
+        UA_assert(ctx.ctx.pos == ctx.ctx.end);
     }
-    UA_assert(ctx.ctx.pos == ctx.ctx.end);
 
     /* Send the prepared messages */
-    sendNetworkMessageBuffer(psm, wg, connection, sendChannel, &buf);
+    sendNetworkMessageBuffer(psm, wg, connection, sendChannel, &buf, batch);
     return UA_STATUSCODE_GOOD;
 }
 #endif
@@ -800,10 +1132,282 @@ generateNetworkMessage(UA_PubSubConnection *connection, UA_WriterGroup *wg,
     return UA_STATUSCODE_GOOD;
 }
 
+/*************/
+/* Fast Path */
+/*************/
+
+/* The NetworkMessages of a regular publish cycle are recorded as templates
+ * together with their offset table. In the following cycles, only the sequence
+ * numbers, timestamps and field values are encoded in place. */
+
+static void
+clearTemplates(UA_WriterGroup *wg) {
+    for(size_t i = 0; i < wg->templatesSize; i++) {
+        UA_ByteString_clear(&wg->templates[i].buffer);
+        UA_free(wg->templates[i].offsets);
+    }
+    UA_free(wg->templates);
+    wg->templates = NULL;
+    wg->templatesSize = 0;
+    wg->templatesWriters = 0;
+    wg->templatesValid = false;
+}
+
+void
+UA_WriterGroup_resetTemplates(UA_WriterGroup *wg) {
+    clearTemplates(wg);
+    wg->templatesFailed = false;
+#ifdef UA_ENABLE_JSON_ENCODING
+    UA_String_clear(&wg->jsonHeader);
+    UA_ByteString_clear(&wg->jsonBuffer);
+    UA_DataSetWriter *dsw;
+    LIST_FOREACH(dsw, &wg->writers, listEntry) {
+        UA_DataSetMessageJsonTemplate_clear(&dsw->jsonTemplate);
+    }
+#endif
+}
+
+static UA_Boolean
+canRecordTemplates(UA_PubSubManager *psm, UA_WriterGroup *wg,
+                   UA_DataSetWriter **writers, size_t writersSize) {
+    const char *reason = NULL;
+    if(wg->config.encodingMimeType != UA_PUBSUB_ENCODING_UADP)
+        reason = "Only the UADP encoding is supported";
+    else if(wg->config.securityMode > UA_MESSAGESECURITYMODE_NONE)
+        reason = "Message security is not supported";
+    UA_Boolean deltaFrames = psm->drv.server->config.pubSubConfig.enableDeltaFrames;
+    for(size_t i = 0; i < writersSize && !reason; i++) {
+        UA_PublishedDataSet *pds = writers[i]->connectedDataSet;
+        if(!pds)
+            continue; /* Heartbeat */
+        if(pds->promotedFieldsCount > 0)
+            reason = "Promoted fields are not supported";
+        else if(deltaFrames && pds->fieldSize > 1)
+            reason = "DeltaFrames are not supported";
+    }
+    if(!reason)
+        return true;
+    UA_LOG_WARNING_PUBSUB(psm->logging, wg, "Cannot use the fast path: %s", reason);
+    wg->templatesFailed = true;
+    return false;
+}
+
+static UA_DataSetWriter *
+findWriterById(UA_WriterGroup *wg, UA_UInt16 writerId) {
+    UA_DataSetWriter *dsw;
+    LIST_FOREACH(dsw, &wg->writers, listEntry) {
+        if(dsw->config.dataSetWriterId == writerId)
+            return dsw;
+    }
+    return NULL;
+}
+
+/* Record the encoded NetworkMessage as a template. Bind the offsets for the
+ * DataSetMessages and DataSetFields to the Writers and Fields. */
+static UA_StatusCode
+recordTemplate(UA_WriterGroup *wg, const UA_NetworkMessage *nm,
+               const UA_PubSubOffsetTable *ot, const UA_Byte *msg, size_t msgSize) {
+    UA_NetworkMessageTemplate *templates = (UA_NetworkMessageTemplate*)
+        UA_realloc(wg->templates, sizeof(UA_NetworkMessageTemplate) *
+                   (wg->templatesSize + 1));
+    if(!templates)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    wg->templates = templates;
+    UA_NetworkMessageTemplate *t = &templates[wg->templatesSize];
+    memset(t, 0, sizeof(UA_NetworkMessageTemplate));
+    wg->templatesSize++;
+
+    UA_ByteString msgString = {msgSize, (UA_Byte*)(uintptr_t)msg};
+    UA_StatusCode res = UA_ByteString_copy(&msgString, &t->buffer);
+    UA_CHECK_STATUS(res, return res);
+    t->offsets = (UA_NetworkMessageTemplateOffset*)
+        UA_calloc(ot->offsetsSize, sizeof(UA_NetworkMessageTemplateOffset));
+    if(!t->offsets && ot->offsetsSize > 0)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    size_t dsmIndex = 0;
+    const UA_DataSetMessage *dsm = NULL;
+    UA_DataSetWriter *dsw = NULL;
+    UA_DataSetField *dsf = NULL;
+    size_t fieldIndex = 0;
+    for(size_t i = 0; i < ot->offsetsSize; i++) {
+        const UA_PubSubOffset *o = &ot->offsets[i];
+        UA_NetworkMessageTemplateOffset *to = &t->offsets[t->offsetsSize];
+        to->offsetType = o->offsetType;
+        to->offset = o->offset;
+        switch(o->offsetType) {
+        case UA_PUBSUBOFFSETTYPE_NETWORKMESSAGE_SEQUENCENUMBER:
+            break;
+        case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE:
+            if(dsmIndex >= nm->messageCount)
+                return UA_STATUSCODE_BADINTERNALERROR;
+            dsm = &nm->payload.dataSetMessages[dsmIndex];
+            dsw = findWriterById(wg, nm->dataSetWriterIds[dsmIndex]);
+            if(!dsw)
+                return UA_STATUSCODE_BADINTERNALERROR;
+            dsf = (dsw->connectedDataSet) ?
+                TAILQ_FIRST(&dsw->connectedDataSet->fields) : NULL;
+            fieldIndex = 0;
+            dsmIndex++;
+            break;
+        case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE_SEQUENCENUMBER:
+        case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE_TIMESTAMP:
+            if(!dsw)
+                return UA_STATUSCODE_BADINTERNALERROR;
+            break;
+        case UA_PUBSUBOFFSETTYPE_DATASETFIELD_VARIANT:
+        case UA_PUBSUBOFFSETTYPE_DATASETFIELD_RAW: {
+            if(!dsf || fieldIndex >= dsm->fieldCount)
+                return UA_STATUSCODE_BADINTERNALERROR;
+            /* The offset of raw arrays points behind the array dimensions */
+            const UA_DataValue *v = &dsm->data.keyFrameFields[fieldIndex];
+            if(o->offsetType == UA_PUBSUBOFFSETTYPE_DATASETFIELD_RAW &&
+               !UA_Variant_isScalar(&v->value)) {
+                size_t dims = (v->value.arrayDimensionsSize > 0) ?
+                    v->value.arrayDimensionsSize : 1;
+                to->offset -= dims * sizeof(UA_UInt32);
+            }
+            /* Measure the encoded length. This writes the same content. */
+            PubSubEncodeCtx ctx;
+            memset(&ctx, 0, sizeof(PubSubEncodeCtx));
+            ctx.ctx.pos = &t->buffer.data[to->offset];
+            ctx.ctx.end = &t->buffer.data[t->buffer.length];
+            UA_PublishedDataSet *pds = dsw->connectedDataSet;
+            const UA_FieldMetaData *fmd = (fieldIndex < pds->dataSetMetaData.fieldsSize) ?
+                &pds->dataSetMetaData.fields[fieldIndex] : NULL;
+            res = UA_DataSetMessage_encodeFieldBinary(&ctx, dsm->header.fieldEncoding,
+                                                      fmd, v);
+            UA_CHECK_STATUS(res, return res);
+            to->length = (size_t)(ctx.ctx.pos - &t->buffer.data[to->offset]);
+            to->field = dsf;
+            to->fieldIndex = fieldIndex;
+            dsf = TAILQ_NEXT(dsf, listEntry);
+            fieldIndex++;
+            break;
+        }
+        case UA_PUBSUBOFFSETTYPE_DATASETFIELD_DATAVALUE:
+            /* The DataValue encoding uses the Read service with timestamps */
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+        default:
+            continue; /* Not updated in the fast path */
+        }
+        to->writer = dsw;
+        t->offsetsSize++;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Encode the current field values into the templates. The sequence numbers are
+ * not touched. So the regular publish path can take over if the encoded size of
+ * a value has changed. */
+static UA_StatusCode
+updateTemplateFields(UA_PubSubManager *psm, UA_WriterGroup *wg) {
+    for(size_t i = 0; i < wg->templatesSize; i++) {
+        UA_NetworkMessageTemplate *t = &wg->templates[i];
+        for(size_t j = 0; j < t->offsetsSize; j++) {
+            UA_NetworkMessageTemplateOffset *to = &t->offsets[j];
+            UA_FieldEncoding fieldEncoding;
+            if(to->offsetType == UA_PUBSUBOFFSETTYPE_DATASETFIELD_VARIANT)
+                fieldEncoding = UA_FIELDENCODING_VARIANT;
+            else if(to->offsetType == UA_PUBSUBOFFSETTYPE_DATASETFIELD_RAW)
+                fieldEncoding = UA_FIELDENCODING_RAWDATA;
+            else
+                continue;
+
+            UA_PublishedDataSet *pds = to->writer->connectedDataSet;
+            const UA_FieldMetaData *fmd = (to->fieldIndex < pds->dataSetMetaData.fieldsSize) ?
+                &pds->dataSetMetaData.fields[to->fieldIndex] : NULL;
+
+            PubSubEncodeCtx ctx;
+            memset(&ctx, 0, sizeof(PubSubEncodeCtx));
+            ctx.ctx.pos = &t->buffer.data[to->offset];
+            ctx.ctx.end = ctx.ctx.pos + to->length;
+            const UA_Byte *end = ctx.ctx.end;
+
+            UA_DataValue value;
+            const UA_Node *node = UA_PubSubDataSetField_borrowValue(psm, to->field, &value);
+            UA_StatusCode res =
+                UA_DataSetMessage_encodeFieldBinary(&ctx, fieldEncoding, fmd, &value);
+            if(node)
+                UA_NODESTORE_RELEASE(psm->drv.server, node);
+            else
+                UA_DataValue_clear(&value);
+            if(res != UA_STATUSCODE_GOOD || ctx.ctx.pos != end)
+                return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Returns a bad StatusCode if the regular publish path has to be used */
+static UA_StatusCode
+publishTemplates(UA_PubSubManager *psm, UA_WriterGroup *wg,
+                 UA_PubSubConnection *connection) {
+    UA_StatusCode res = updateTemplateFields(psm, wg);
+    UA_CHECK_STATUS(res, return res);
+
+    UA_ConnectionManager *cm = connection->cm;
+    uintptr_t sendChannel = connection->sendChannel;
+    if(wg->sendChannel != 0)
+        sendChannel = wg->sendChannel;
+    if(!cm || sendChannel == 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime now = el->dateTime_now(el);
+    UA_STACKARRAY(UA_ByteString, batchBufs, wg->templatesSize);
+    NetworkMessageBatch batch = {batchBufs, 0, wg->templatesSize, 0};
+
+    /* The templates are removed if sending fails. Hence the check of
+     * templatesSize in every iteration. */
+    for(size_t i = 0; i < wg->templatesSize; i++) {
+        UA_NetworkMessageTemplate *t = &wg->templates[i];
+        const UA_Byte *end = &t->buffer.data[t->buffer.length];
+        UA_UInt16 dsmSequenceNumber = 0;
+        for(size_t j = 0; j < t->offsetsSize; j++) {
+            UA_NetworkMessageTemplateOffset *to = &t->offsets[j];
+            UA_Byte *pos = &t->buffer.data[to->offset];
+            switch(to->offsetType) {
+            case UA_PUBSUBOFFSETTYPE_NETWORKMESSAGE_SEQUENCENUMBER:
+                UA_UInt16_encodeBinary(&wg->sequenceNumber, &pos, end);
+                break;
+            case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE:
+                /* Rolls over to zero */
+                dsmSequenceNumber = to->writer->actualDataSetMessageSequenceCount++;
+                break;
+            case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE_SEQUENCENUMBER:
+                UA_UInt16_encodeBinary(&dsmSequenceNumber, &pos, end);
+                break;
+            case UA_PUBSUBOFFSETTYPE_DATASETMESSAGE_TIMESTAMP:
+                UA_DateTime_encodeBinary(&now, &pos, end);
+                break;
+            default:
+                break;
+            }
+        }
+
+        UA_ByteString buf = UA_BYTESTRING_NULL;
+        res = cm->allocNetworkBuffer(cm, sendChannel, &buf, t->buffer.length);
+        if(res != UA_STATUSCODE_GOOD) {
+            sendFailed(psm, wg, connection);
+            break;
+        }
+        memcpy(buf.data, t->buffer.data, t->buffer.length);
+        wg->lastPublishTimeStamp = el->dateTime_nowMonotonic(el);
+        sendNetworkMessageBuffer(psm, wg, connection, sendChannel, &buf, &batch);
+    }
+
+    flushNetworkMessageBatch(psm, wg, connection, &batch);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* If record is set, the encoded NetworkMessage is added to the templates of
+ * the fast path. The flag is reset if the message cannot be recorded. */
 static UA_StatusCode
 sendNetworkMessageBinary(UA_PubSubManager *psm, UA_PubSubConnection *connection,
                          UA_WriterGroup *wg, UA_DataSetMessage *dsm, UA_UInt16 *writerIds,
-                         UA_Byte dsmCount) {
+                         UA_Byte dsmCount, NetworkMessageBatch *batch,
+                         UA_Boolean *record) {
     UA_NetworkMessage nm;
     memset(&nm, 0, sizeof(UA_NetworkMessage));
 
@@ -835,9 +1439,23 @@ sendNetworkMessageBinary(UA_PubSubManager *psm, UA_PubSubConnection *connection,
         i++;
     }
 
+    /* Compute the offset table for the template. Not all field types can be
+     * located in the offset table. Then compute the size without it. */
+    UA_PubSubOffsetTable ot;
+    memset(&ot, 0, sizeof(UA_PubSubOffsetTable));
+    UA_Boolean recording = (record && *record);
+    if(recording)
+        ctx.ot = &ot;
+
     /* Compute the message size. Add the overhead for the security signature.
      * There is no padding and the encryption incurs no size overhead. */
     size_t msgSize = UA_NetworkMessage_calcSizeBinaryInternal(&ctx, &nm);
+    if(msgSize == 0 && ctx.ot) {
+        UA_PubSubOffsetTable_clear(&ot);
+        ctx.ot = NULL;
+        *record = false;
+        msgSize = UA_NetworkMessage_calcSizeBinaryInternal(&ctx, &nm);
+    }
     if(msgSize == 0)
         return UA_STATUSCODE_BADINTERNALERROR;
 
@@ -858,13 +1476,17 @@ sendNetworkMessageBinary(UA_PubSubManager *psm, UA_PubSubConnection *connection,
         sendChannel = wg->sendChannel;
     if(sendChannel == 0) {
         UA_LOG_ERROR_PUBSUB(psm->logging, wg, "Cannot send, no open connection");
+        UA_PubSubOffsetTable_clear(&ot);
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
     /* Allocate the buffer. Allocate on the stack if the buffer is small. */
     UA_ByteString buf = UA_BYTESTRING_NULL;
     rv = cm->allocNetworkBuffer(cm, sendChannel, &buf, msgSize);
-    UA_CHECK_STATUS(rv, return rv);
+    if(rv != UA_STATUSCODE_GOOD) {
+        UA_PubSubOffsetTable_clear(&ot);
+        return rv;
+    }
 
     /* Encode and encrypt the message */
     ctx.ctx.pos = buf.data;
@@ -872,17 +1494,32 @@ sendNetworkMessageBinary(UA_PubSubManager *psm, UA_PubSubConnection *connection,
     rv = encodeNetworkMessage(wg, &ctx, &nm, &buf);
     if(rv != UA_STATUSCODE_GOOD) {
         cm->freeNetworkBuffer(cm, sendChannel, &buf);
+        UA_PubSubOffsetTable_clear(&ot);
         return rv;
     }
 
+    /* Record the template before sending */
+    if(ctx.ot) {
+        if(recordTemplate(wg, &nm, &ot, buf.data,
+                          (size_t)(ctx.ctx.pos - buf.data)) != UA_STATUSCODE_GOOD)
+            *record = false;
+        UA_PubSubOffsetTable_clear(&ot);
+    }
+    if(recording && !*record) {
+        UA_LOG_WARNING_PUBSUB(psm->logging, wg, "Cannot use the fast path: "
+                              "The NetworkMessage cannot be pre-encoded");
+        wg->templatesFailed = true;
+    }
+
     /* Send out the message */
-    sendNetworkMessageBuffer(psm, wg, connection, sendChannel, &buf);
+    sendNetworkMessageBuffer(psm, wg, connection, sendChannel, &buf, batch);
     return UA_STATUSCODE_GOOD;
 }
 
 static void
 sendNetworkMessage(UA_PubSubManager *psm, UA_WriterGroup *wg, UA_PubSubConnection *connection,
-                   UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount) {
+                   UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount,
+                   NetworkMessageBatch *batch, UA_Boolean *record) {
     if(dsmCount >= UA_NETWORKMESSAGE_MAXMESSAGECOUNT) {
         UA_LOG_ERROR_PUBSUB(psm->logging, wg,
                             "More DataSetMessages than allowed in "
@@ -894,11 +1531,13 @@ sendNetworkMessage(UA_PubSubManager *psm, UA_WriterGroup *wg, UA_PubSubConnectio
     UA_StatusCode res = UA_STATUSCODE_GOOD;
     switch(wg->config.encodingMimeType) {
     case UA_PUBSUB_ENCODING_UADP:
-        res = sendNetworkMessageBinary(psm, connection, wg, dsm, writerIds, dsmCount);
+        res = sendNetworkMessageBinary(psm, connection, wg, dsm, writerIds, dsmCount,
+                                       batch, record);
         break;
 #ifdef UA_ENABLE_JSON_ENCODING
     case UA_PUBSUB_ENCODING_JSON:
-        res = sendNetworkMessageJson(psm, connection, wg, dsm, writerIds, dsmCount);
+        res = sendNetworkMessageJson(psm, connection, wg, dsm, writerIds, dsmCount,
+                                     batch);
         break;
 #endif
     default:
@@ -915,6 +1554,15 @@ sendNetworkMessage(UA_PubSubManager *psm, UA_WriterGroup *wg, UA_PubSubConnectio
     }
 }
 
+/* The time spent sending is accumulated in wg->cycleSendTime. The remainder of
+ * the cycle is accounted as the encoding time. */
+static void
+recordCycleStatistics(UA_EventLoop *el, UA_WriterGroup *wg, UA_DateTime start) {
+    UA_DateTime cycle = el->dateTime_nowMonotonic(el) - start;
+    UA_PubSubHistogram_add(&wg->stats.encodeTime, cycle - wg->cycleSendTime);
+    UA_PubSubHistogram_add(&wg->stats.sendTime, wg->cycleSendTime);
+}
+
 /* This callback triggers the collection and publish of NetworkMessages and the
  * contained DataSetMessages. */
 void
@@ -996,6 +1644,24 @@ UA_WriterGroup_publishCallback(void *application /* UA_PubSubManager */,
         }
     }
 
+    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    UA_DateTime cycleStart = el->dateTime_nowMonotonic(el);
+    wg->cycleSendTime = 0;
+
+    /* Fast path: Publish the templates. Otherwise record new templates in this
+     * publish cycle. */
+    UA_Boolean record = false;
+    if(wg->config.fastPath && !wg->templatesFailed) {
+        if(wg->templatesValid && wg->templatesWriters == enabledWriters &&
+           publishTemplates(psm, wg, connection) == UA_STATUSCODE_GOOD) {
+            recordCycleStatistics(el, wg, cycleStart);
+            unlockServer(psm->drv.server);
+            return;
+        }
+        clearTemplates(wg);
+        record = canRecordTemplates(psm, wg, writers, enabledWriters);
+    }
+
     /* It is possible to put several DataSetMessages into one NetworkMessage.
      * But only if they do not contain promoted fields. NM with promoted fields
      * are sent out right away. The others are kept in a buffer for
@@ -1004,7 +1670,11 @@ UA_WriterGroup_publishCallback(void *application /* UA_PubSubManager */,
     UA_STACKARRAY(UA_UInt16, dsWriterIds, enabledWriters);
     UA_STACKARRAY(UA_DataSetMessage, dsmStore, enabledWriters);
 
-    UA_EventLoop *el = psm->drv.server->config.eventLoop;
+    /* At most one NetworkMessage per enabled writer is sent in this cycle.
+     * They are sent together at the end of the cycle. */
+    UA_STACKARRAY(UA_ByteString, batchBufs, enabledWriters);
+    NetworkMessageBatch batch = {batchBufs, 0, enabledWriters, 0};
+
     for(size_t i = 0; i < enabledWriters; i++) {
         dsw = writers[i];
 
@@ -1014,11 +1684,13 @@ UA_WriterGroup_publishCallback(void *application /* UA_PubSubManager */,
         /* Generate the DSM */
         dsWriterIds[dsmCount] = dsw->config.dataSetWriterId;
         UA_StatusCode res =
-            UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount]);
+            UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount],
+                                                    &wg->arena);
         if(res != UA_STATUSCODE_GOOD) {
             UA_LOG_ERROR_PUBSUB(psm->logging, dsw,
                                 "PubSub Publish: DataSetMessage creation failed");
             UA_DataSetWriter_setPubSubState(psm, dsw, UA_PUBSUBSTATE_ERROR);
+            record = false;
             continue;
         }
 
@@ -1026,9 +1698,7 @@ UA_WriterGroup_publishCallback(void *application /* UA_PubSubManager */,
         if(pds && pds->promotedFieldsCount > 0) {
             wg->lastPublishTimeStamp = el->dateTime_nowMonotonic(el);
             sendNetworkMessage(psm, wg, connection, &dsmStore[dsmCount],
-                               &dsWriterIds[dsmCount], 1);
-
-            UA_DataSetMessage_clear(&dsmStore[dsmCount]);
+                               &dsWriterIds[dsmCount], 1, &batch, NULL);
             continue; /* Don't increase the dsmCount, reuse the slot */
         }
 
@@ -1043,14 +1713,27 @@ UA_WriterGroup_publishCallback(void *application /* UA_PubSubManager */,
         wg->lastPublishTimeStamp = el->dateTime_nowMonotonic(el);
         /* Send the batched messages */
         sendNetworkMessage(psm, wg, connection, &dsmStore[i],
-                           &dsWriterIds[i], nmDsmCount);
+                           &dsWriterIds[i], nmDsmCount, &batch, &record);
     }
 
-    /* Clean up DSM */
-    for(size_t i = 0; i < dsmCount; i++) {
-        UA_DataSetMessage_clear(&dsmStore[i]);
+    /* Send the collected NetworkMessages */
+    flushNetworkMessageBatch(psm, wg, connection, &batch);
+
+    /* Use the recorded templates from the next cycle onwards. Don't try again
+     * (until the next state change) if the recording has failed. */
+    if(wg->config.fastPath && !wg->templatesValid) {
+        if(record && wg->head.state == UA_PUBSUBSTATE_OPERATIONAL) {
+            wg->templatesValid = true;
+            wg->templatesWriters = enabledWriters;
+        } else {
+            clearTemplates(wg);
+        }
     }
 
+    /* Clean up the DSM content in the arena */
+    UA_PubSubArena_reset(&wg->arena, psm->drv.server);
+
+    recordCycleStatistics(el, wg, cycleStart);
     unlockServer(psm->drv.server);
 }
 
@@ -1494,6 +2177,37 @@ UA_Server_getWriterGroupLastPublishTimestamp(UA_Server *server,
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_Server_getWriterGroupStatistics(UA_Server *server, const UA_NodeId wgId,
+                                   UA_WriterGroupStatistics *stats) {
+    if(!server || !stats)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    lockServer(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(getPSM(server), wgId);
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(wg)
+        *stats = wg->stats;
+    else
+        res = UA_STATUSCODE_BADNOTFOUND;
+    unlockServer(server);
+    return res;
+}
+
+UA_StatusCode
+UA_Server_resetWriterGroupStatistics(UA_Server *server, const UA_NodeId wgId) {
+    if(!server)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    lockServer(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(getPSM(server), wgId);
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(wg)
+        memset(&wg->stats, 0, sizeof(UA_WriterGroupStatistics));
+    else
+        res = UA_STATUSCODE_BADNOTFOUND;
+    unlockServer(server);
+    return res;
+}
+
 UA_StatusCode
 UA_Server_setWriterGroupEncryptionKeys(UA_Server *server, const UA_NodeId writerGroup,
                                        UA_UInt32 securityTokenId,
@@ -1643,7 +2357,7 @@ UA_Server_computeWriterGroupOffsetTable(UA_Server *server,
     memset(dsmStore, 0, sizeof(UA_DataSetMessage) * wg->writersCount);
     LIST_FOREACH(dsw, &wg->writers, listEntry) {
         dsWriterIds[dsmCount] = dsw->config.dataSetWriterId;
-        res = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount]);
+        res = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount], NULL);
         dsmCount++;
         if(res != UA_STATUSCODE_GOOD)
             goto cleanup;
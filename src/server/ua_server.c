@@ -321,17 +321,32 @@ UA_Server_delete(UA_Server *server) {
     UA_AsyncManager_clear(&server->asyncManager, server);
 #endif
 
+#ifdef UA_SERVICEWORKERS
+    UA_ServiceWorkers_clear(server);
+#endif
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     UA_assert(server->modelChangeDepth == 0);
     UA_ModelChangeAccumulator_clear(&server->modelChanges);
+    UA_assert(server->eventRoutesBusy == 0);
+    clearEventRoutes(server);
 #endif
 
+    clearSuperTypes(server);
+    UA_assert(server->borrowedValuesSize == 0);
+    UA_free(server->borrowedValues);
+
     /* Clean up the Admin Session */
     UA_Session_clear(&server->adminSession, server);
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     server->adminSubscription = NULL;
     UA_assert(server->monitoredItemsSize == 0);
     UA_assert(server->subscriptionsSize == 0);
+    UA_assert(LIST_EMPTY(&server->samplingGroups));
+    UA_assert(ZIP_ROOT(&server->sharedValues) == NULL);
+#endif
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    UA_assert(server->eventMonitoredItemsSize == 0);
 #endif
 
     /* Remove all drivers (all stopped by now) */
@@ -386,6 +401,7 @@ UA_Server_delete(UA_Server *server) {
         }
         UA_free(server->customTypes_internal);
     }
+    UA_DataTypeIndex_delete(server->customTypesIndex);
 
     /* Delete the server itself and return */
     UA_free(server);
@@ -432,6 +448,9 @@ UA_Server_init(UA_Server *server) {
 #endif
 
     UA_LOCK_INIT(&server->serviceMutex);
+#ifdef UA_SERVICEWORKERS
+    UA_ServiceWorkers_init(server);
+#endif
     lockServer(server);
 
     /* Initialize the adminSession */
@@ -464,6 +483,8 @@ UA_Server_init(UA_Server *server) {
 
     /* Initialize Session Management */
     LIST_INIT(&server->sessions);
+    ZIP_INIT(&server->sessionsByToken);
+    ZIP_INIT(&server->sessionsById);
     server->sessionCount = 0;
 
     /* Initialize SecureChannel */
@@ -1082,6 +1103,9 @@ UA_Server_run_startup(UA_Server *server) {
     /* Take the server lock */
     lockServer(server);
 
+    /* Index the custom DataTypes of the configuration */
+    indexServerCustomTypes(server);
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     /* A restarted server also suppresses changes until startup is complete. */
     if(server->modelChangeSuppressionDepth == 0)
@@ -1096,6 +1120,16 @@ UA_Server_run_startup(UA_Server *server) {
     UA_AsyncManager_start(&server->asyncManager, server);
 #endif
 
+    /* Start the threads for the parallel execution of read-only services */
+#ifdef UA_SERVICEWORKERS
+    UA_ServiceWorkers_start(server);
+#else
+    if(config->serviceWorkers > 0)
+        UA_LOG_WARNING(config->logging, UA_LOGCATEGORY_SERVER,
+                       "Service workers are configured but not supported in "
+                       "this build. Services are executed in the EventLoop.");
+#endif
+
     /* Are there enough SecureChannels possible for the max number of sessions? */
     if(config->maxSecureChannels != 0 &&
        (config->maxSessions == 0 || config->maxSessions > config->maxSecureChannels)) {
@@ -1211,6 +1245,11 @@ UA_Server_run_shutdown(UA_Server *server) {
     /* Set to stopping and notify the application */
     setServerLifecycleState(server, UA_LIFECYCLESTATE_STOPPING);
 
+#ifdef UA_SERVICEWORKERS
+    /* Execute the deferred services and stop the worker threads */
+    UA_ServiceWorkers_stop(server);
+#endif
+
 #if UA_MULTITHREADING >= 100
     /* Stop regular callback for async operation processing */
     UA_AsyncManager_stop(&server->asyncManager, server);
@@ -1280,13 +1319,23 @@ UA_Server_run(UA_Server *server, const volatile UA_Boolean *running) {
     return UA_Server_run_shutdown(server);
 }
 
+/* Callbacks from the service worker threads execute while the EventLoop
+ * thread holds the server lock on their behalf. See ua_services.c. */
 void lockServer(UA_Server *server) {
+#ifdef UA_SERVICEWORKERS
+    if(UA_ServiceWorkers_isWorker(server))
+        return;
+#endif
     if(UA_LIKELY(server->config.eventLoop && server->config.eventLoop->lock))
         server->config.eventLoop->lock(server->config.eventLoop);
     UA_LOCK(&server->serviceMutex);
 }
 
 void unlockServer(UA_Server *server) {
+#ifdef UA_SERVICEWORKERS
+    if(UA_ServiceWorkers_isWorker(server))
+        return;
+#endif
     if(UA_LIKELY(server->config.eventLoop && server->config.eventLoop->unlock))
         server->config.eventLoop->unlock(server->config.eventLoop);
     UA_UNLOCK(&server->serviceMutex);
@@ -443,6 +443,15 @@ persistAsyncResponse(UA_Server *server, UA_Session *session,
     ar->responseToken = am->currentResponseToken;
     ar->uacpRequestId = am->currentUacpRequestId;
     ar->requestHandle = am->currentRequestHandle;
+#ifdef UA_SERVICEWORKERS
+    /* Executed in a parallel batch. Take the context from the job. */
+    UA_ServiceJob *job = UA_ServiceWorkers_getJob(server, response);
+    if(job) {
+        ar->responseToken = job->responseToken;
+        ar->uacpRequestId = job->uacpRequestId;
+        ar->requestHandle = job->request.requestHeader.requestHandle;
+    }
+#endif
     ar->sessionId = session->sessionId;
     ar->timeout = UA_INT64_MAX;
 
@@ -456,7 +465,9 @@ persistAsyncResponse(UA_Server *server, UA_Session *session,
     UA_init(response, ar->responseType);
 
     /* Enqueue the ar */
+    UA_ServiceWorkers_lockAsync(server);
     TAILQ_INSERT_TAIL(&am->waitingResponses, ar, pointers);
+    UA_ServiceWorkers_unlockAsync(server);
 }
 
 static void
@@ -470,8 +481,10 @@ persistAsyncResponseOperation(UA_Server *server, UA_AsyncOperation *op,
 
     /* Not enough resources to store the async operation */
     UA_AsyncManager *am = &server->asyncManager;
+    UA_ServiceWorkers_lockAsync(server);
     if(server->config.maxAsyncOperationQueueSize != 0 &&
        am->opsCount >= server->config.maxAsyncOperationQueueSize) {
+        UA_ServiceWorkers_unlockAsync(server);
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
                        "Cannot create async operation: Queue exceeds limit (%d).",
                        (int unsigned)server->config.maxAsyncOperationQueueSize);
@@ -485,6 +498,7 @@ persistAsyncResponseOperation(UA_Server *server, UA_AsyncOperation *op,
     TAILQ_INSERT_TAIL(&am->waitingOps, op, pointers);
     ar->opCountdown++;
     am->opsCount++;
+    UA_ServiceWorkers_unlockAsync(server);
 }
 
 static UA_StatusCode
@@ -613,6 +627,10 @@ Service_Read(UA_Server *server, UA_Session *session, const void *request_, void
     }
     response->resultsSize = request->nodesToReadSize;
 
+    /* Large values can be borrowed from the nodes until the response is sent */
+    if(server->config.readZeroCopyThreshold > 0)
+        session->readResponse = response;
+
     /* Execute the operations */
     for(size_t i = 0; i < request->nodesToReadSize; i++) {
         UA_Boolean done = Operation_Read(server, session, request->timestampsToReturn,
@@ -622,10 +640,14 @@ Service_Read(UA_Server *server, UA_Session *session, const void *request_, void
                                           UA_ASYNCOPERATIONTYPE_READ_REQUEST,
                                           ar, &response->results[i]);
     }
+    session->readResponse = NULL;
 
     /* If async operations are pending, persist them and signal the service is
-     * not done */
+     * not done. The response is not sent right away. So it cannot borrow
+     * values. */
     if(ar->opCountdown > 0) {
+        if(server->config.readZeroCopyThreshold > 0)
+            copyBorrowedValues(server, response);
         ar->responseType = &UA_TYPES[UA_TYPES_READRESPONSE];
         persistAsyncResponse(server, session, response, ar);
     }
@@ -100,9 +100,26 @@ typedef struct RegisteredServerRecord {
 typedef struct session_list_entry {
     UA_DelayedCallback cleanupCallback;
     LIST_ENTRY(session_list_entry) pointers;
+    ZIP_ENTRY(session_list_entry) tokenTreeEntry;
+    ZIP_ENTRY(session_list_entry) idTreeEntry;
     UA_Session session;
 } session_list_entry;
 
+/* Index of the sessions by AuthenticationToken and by SessionId. Every request
+ * is resolved to its session via the token. */
+typedef ZIP_HEAD(UA_SessionTokenTree, session_list_entry) UA_SessionTokenTree;
+typedef ZIP_HEAD(UA_SessionIdTree, session_list_entry) UA_SessionIdTree;
+
+static UA_INLINE enum ZIP_CMP
+cmpSessionNodeId(const UA_NodeId *a, const UA_NodeId *b) {
+    return (enum ZIP_CMP)UA_NodeId_order(a, b);
+}
+
+ZIP_FUNCTIONS(UA_SessionTokenTree, session_list_entry, tokenTreeEntry,
+              UA_NodeId, session.authenticationToken, cmpSessionNodeId)
+ZIP_FUNCTIONS(UA_SessionIdTree, session_list_entry, idTreeEntry,
+              UA_NodeId, session.sessionId, cmpSessionNodeId)
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
 /* Internal accumulator marker. Reserved ModelChange verb bits must never be
@@ -122,6 +139,91 @@ typedef struct {
     UA_ChangeEntry *changes;
 } UA_ModelChangeAccumulator;
 
+/* The notifier nodes to which the events of a source node propagate. Computed
+ * with an inverse recursive browse over the HasEventSource, HasNotifier,
+ * Organizes and HasComponent references (and their subtypes). */
+typedef struct UA_EventRoute {
+    ZIP_ENTRY(UA_EventRoute) zipfields;
+    UA_NodeId sourceNode;
+    size_t emitNodesSize;
+    UA_NodeId *emitNodes;
+} UA_EventRoute;
+
+typedef ZIP_HEAD(UA_EventRouteTree, UA_EventRoute) UA_EventRouteTree;
+
+/* Maximum number of cached routes. The cache is flushed when it is full. */
+#define UA_EVENTROUTES_MAX 4096
+
+#endif
+
+/* The supertypes of a type node (including the type itself). Computed with an
+ * inverse recursive browse over the HasSubtype references. */
+typedef struct UA_SuperTypes {
+    ZIP_ENTRY(UA_SuperTypes) zipfields;
+    UA_NodeId typeId;
+    size_t superTypesSize;
+    UA_NodeId *superTypes;
+} UA_SuperTypes;
+
+typedef ZIP_HEAD(UA_SuperTypesTree, UA_SuperTypes) UA_SuperTypesTree;
+
+/* Maximum number of cached supertype lists. The cache is flushed when it is
+ * full. */
+#define UA_SUPERTYPES_MAX 4096
+
+/* A value that is referenced by a Read response instead of being copied. The
+ * node is retained until the response is sent. */
+typedef struct {
+    const void *response;
+    const UA_Node *node;
+    UA_DataValue *value; /* Points into the response */
+} UA_BorrowedValue;
+
+/* Read-only services can be executed in parallel by worker threads. This
+ * requires the POSIX threads API. */
+#if UA_MULTITHREADING >= 100 && defined(UA_ARCHITECTURE_POSIX)
+#define UA_SERVICEWORKERS 1
+
+/* A read-only service request that is deferred to the next parallel batch */
+typedef struct UA_ServiceJob {
+    TAILQ_ENTRY(UA_ServiceJob) pointers;
+    struct UA_ServiceJob *sessionNext; /* Jobs of the same session in the batch
+                                        * are executed in order by one thread */
+    UA_ServiceDescription *sd;
+    UA_NodeId sessionId;
+    UA_Session *session; /* Resolved when the batch starts */
+    UA_UInt64 responseToken;
+    UA_UInt32 uacpRequestId;
+    UA_Boolean done;
+    UA_Request request;
+    UA_Response response;
+} UA_ServiceJob;
+
+typedef TAILQ_HEAD(UA_ServiceJobQueue, UA_ServiceJob) UA_ServiceJobQueue;
+
+typedef struct {
+    pthread_t *threads;
+    size_t threadsSize;
+    pthread_key_t workerKey; /* Set to the server in the worker threads */
+    UA_Boolean running;
+
+    /* Requests collected in the current EventLoop iteration */
+    UA_ServiceJobQueue pending;
+    size_t pendingSize;
+    UA_DelayedCallback dc;
+
+    /* The batch that is currently executed. The first job of every session
+     * chain is in the batch array. Protected by the mutex. */
+    pthread_mutex_t mutex;
+    pthread_cond_t wakeup;   /* A new batch is ready */
+    pthread_cond_t finished; /* All jobs of the batch are done */
+    UA_ServiceJob **batch;
+    size_t batchCapacity;
+    size_t batchSize;
+    size_t batchNext;        /* Next job chain to be picked up */
+    size_t batchOpen;        /* Job chains not yet finished */
+    UA_Boolean batchActive;
+} UA_ServiceWorkers;
 #endif
 
 struct UA_Server {
@@ -148,14 +250,25 @@ struct UA_Server {
 
     UA_AsyncManager asyncManager;
 
+#ifdef UA_SERVICEWORKERS
+    UA_ServiceWorkers serviceWorkers;
+#endif
+
     /* Custom datatypes that are internally created and cleaned up at the end of
      * the server lifecycle. The next->pointer points to the server config. So
      * we can use customTypes_internal as the universal entry. */
     UA_DataTypeArray *customTypes_internal;
     size_t customTypes_internalSize;
 
+    /* Lookup index for the list returned by serverCustomTypes. Rebuilt under
+     * the server lock at startup and when a DataType is added. Ignored if the
+     * list in the config has changed since. */
+    UA_DataTypeIndex *customTypesIndex;
+
     /* Session Management */
     LIST_HEAD(session_list, session_list_entry) sessions;
+    UA_SessionTokenTree sessionsByToken;
+    UA_SessionIdTree sessionsById;
     UA_UInt32 sessionCount;
     UA_UInt32 activeSessionCount;
 
@@ -192,8 +305,16 @@ struct UA_Server {
     LIST_HEAD(, UA_Subscription) subscriptions; /* All subscriptions in the
                                                  * server. They may be detached
                                                  * from a session. */
+    UA_ServerSubscriptionTree subscriptionsById;
     UA_UInt32 lastSubscriptionId; /* To generate unique SubscriptionIds */
 
+    /* Cyclic sampling of MonitoredItems with one callback per interval */
+    LIST_HEAD(, UA_SamplingGroup) samplingGroups;
+
+    /* The most recent shared value for each sampled ReadValueId. The entries
+     * are removed when the last reference is released. */
+    UA_SharedValueTree sharedValues;
+
 #endif
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -206,8 +327,33 @@ struct UA_Server {
     size_t modelChangeSuppressionDepth;
     size_t modelChangeDepth;
     UA_ModelChangeAccumulator modelChanges;
+
+    /* Number of registered Event MonitoredItems. Events are not routed
+     * through the information model if nobody listens. */
+    size_t eventMonitoredItemsSize;
+
+    /* Cached event routes for the source nodes. Flushed by the model-change
+     * recording when nodes or references are added or removed. While events
+     * are emitted (eventRoutesBusy > 0), the flush is deferred and the cache
+     * is not used. */
+    UA_EventRouteTree eventRoutes;
+    size_t eventRoutesSize;
+    size_t eventRoutesBusy;
+    UA_Boolean eventRoutesStale;
 #endif
 
+    /* Cached supertypes for the subtype checks of DataTypes and EventTypes.
+     * Flushed when HasSubtype references are added or removed. Type nodes with
+     * subtypes cannot be deleted. */
+    UA_SuperTypesTree superTypes;
+    size_t superTypesSize;
+
+    /* Values borrowed from the nodes by Read responses that are not yet sent.
+     * Protected by UA_ServiceWorkers_lockAsync during a parallel batch. */
+    size_t borrowedValuesSize;
+    size_t borrowedValuesCapacity;
+    UA_BorrowedValue *borrowedValues;
+
 #if UA_MULTITHREADING >= 100
     UA_Lock serviceMutex;
 #endif
@@ -260,6 +406,10 @@ struct UA_Server {
 const UA_DataTypeArray *
 serverCustomTypes(UA_Server *server);
 
+/* (Re)build the lookup index for the custom DataTypes */
+void
+indexServerCustomTypes(UA_Server *server);
+
 /* Add a DiscoveryUrl if it is not already configured. Returns true only if
  * this call added the URL, so temporary transports can remove what they own. */
 UA_Boolean
@@ -527,6 +677,9 @@ void recordModelChangeEvent(UA_Server *server, const UA_NodeId *affected,
 void recordSemanticPropertyChange(UA_Server *server,
                                   const UA_NodeHead *property);
 
+/* Remove all cached event routes (deferred if events are being emitted) */
+void clearEventRoutes(UA_Server *server);
+
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
 
 #ifndef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -555,6 +708,16 @@ UA_Boolean
 isNodeInTree_singleRef(UA_Server *server, const UA_NodeId *leafNode,
                        const UA_NodeId *nodeToFind, const UA_Byte relevantRefTypeIndex);
 
+/* Is the type node a subtype of (or equal to) the supertype? Same as
+ * isNodeInTree_singleRef with the HasSubtype ReferenceType. But the supertypes
+ * are cached in the server. */
+UA_Boolean
+isSubtypeOf(UA_Server *server, const UA_NodeId *type, const UA_NodeId *superType);
+
+/* Flush the supertypes cache */
+void
+clearSuperTypes(UA_Server *server);
+
 /* Returns an array with the hierarchy of nodes. The start nodes can be returned
  * as well. The returned array starts at the leaf and continues "upwards" or
  * "downwards". Duplicate entries are removed. */
@@ -612,6 +775,36 @@ void
 abandonServiceRequest(UA_Server *server, UA_SecureChannel *channel,
                       UA_UInt64 responseToken);
 
+#ifdef UA_SERVICEWORKERS
+void UA_ServiceWorkers_init(UA_Server *server);
+void UA_ServiceWorkers_start(UA_Server *server);
+void UA_ServiceWorkers_stop(UA_Server *server);
+void UA_ServiceWorkers_clear(UA_Server *server);
+
+/* Is the current thread a service worker of the server? */
+UA_Boolean UA_ServiceWorkers_isWorker(UA_Server *server);
+
+/* Callbacks executed in a parallel batch (e.g. DataSources) run concurrently
+ * in the worker threads and in the EventLoop thread. They must not modify the
+ * information model or the Subscriptions. Returns BadInvalidState (and logs an
+ * error) while a batch is executed. */
+UA_StatusCode UA_ServiceWorkers_checkModify(UA_Server *server);
+
+/* Returns the job that owns the response if it is executed in a parallel
+ * batch. Otherwise NULL. */
+UA_ServiceJob *
+UA_ServiceWorkers_getJob(UA_Server *server, void *response);
+
+/* Serialize the access to the AsyncManager while a batch is executed. Outside
+ * of a batch, the server lock is sufficient. */
+void UA_ServiceWorkers_lockAsync(UA_Server *server);
+void UA_ServiceWorkers_unlockAsync(UA_Server *server);
+#else
+#define UA_ServiceWorkers_checkModify(server) UA_STATUSCODE_GOOD
+#define UA_ServiceWorkers_lockAsync(server)
+#define UA_ServiceWorkers_unlockAsync(server)
+#endif
+
 UA_StatusCode
 sendResponse(UA_Server *server, UA_SecureChannel *channel,
              UA_UInt64 responseToken, UA_Response *response,
@@ -716,11 +909,41 @@ UA_WRITEATTRIBUTEFUNCS(AccessLevel, UA_ATTRIBUTEID_ACCESSLEVEL, UA_Byte, BYTE)
 UA_WRITEATTRIBUTEFUNCS(MinimumSamplingInterval, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
                        UA_Double, DOUBLE)
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+UA_MonitoredItemCreateResult
+createDataChangeMonitoredItem(UA_Server *server,
+                              UA_TimestampsToReturn timestampsToReturn,
+                              const UA_MonitoredItemCreateRequest *item,
+                              void *monitoredItemContext,
+                              UA_Server_DataChangeNotificationCallback callback);
+
+UA_StatusCode
+deleteMonitoredItem(UA_Server *server, UA_UInt32 monitoredItemId);
+#endif
+
 UA_DataValue
 readWithSession(UA_Server *server, UA_Session *session,
                 const UA_ReadValueId *item,
                 UA_TimestampsToReturn timestampsToReturn);
 
+/* The access check of the Read service for the value attribute. Used when a
+ * value that was read with the adminSession is handed out to a Session.
+ * Returns BadUserAccessDenied if the Session is NULL. */
+UA_StatusCode
+checkReadValueAccess(UA_Server *server, UA_Session *session,
+                     const UA_NodeId *nodeId);
+
+/* Copy the values borrowed by the response into the response and release the
+ * nodes. If response is NULL, this is done for all responses. Required before
+ * a node is edited or removed while Read responses are not yet sent. */
+void
+copyBorrowedValues(UA_Server *server, const void *response);
+
+/* Release the nodes of the values borrowed by the response after it was
+ * encoded. The borrowed values must no longer be accessed. */
+void
+releaseBorrowedValues(UA_Server *server, const void *response);
+
 /* Execute attribute operations for a node that is already borrowed from the
  * nodestore. These are the pointer-based cores of Operation_Read and
  * Operation_Write. The caller must hold the service mutex and keep the node
@@ -898,7 +1121,7 @@ UA_Driver * UA_ReverseBinaryProtocolManager_new(void);
 UA_StatusCode
 processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
                             UA_MessageType messagetype, UA_UInt32 requestId,
-                            UA_ByteString *message);
+                            const UA_ByteString *segments, size_t segmentsSize);
 
 UA_StatusCode
 createServerSecureChannel(UA_Server *server,
@@ -1163,6 +1386,10 @@ readSessionSecurityDiagnostics(UA_Server *server,
 /* Nodestore Access Macros */
 /***************************/
 
+/* Values borrowed by Read responses are copied before a node is modified */
+#define UA_NODESTORE_BORROWED_COPY(server)                              \
+    ((server)->borrowedValuesSize > 0 ? copyBorrowedValues(server, NULL) : (void)0)
+
 #define UA_NODESTORE_NEW(server, nodeClass)                             \
     server->config.nodestore->newNode(server->config.nodestore, nodeClass)
 
@@ -1180,6 +1407,7 @@ UA_NODESTORE_GET(UA_Server *server, const UA_NodeId *nodeId) {
 /* Get the editable node with all attributes and references */
 static UA_INLINE UA_Node *
 UA_NODESTORE_GET_EDIT(UA_Server *server, const UA_NodeId *nodeId) {
+    UA_NODESTORE_BORROWED_COPY(server);
     return server->config.nodestore->
         getEditNode(server->config.nodestore, nodeId,
                     UA_NODEATTRIBUTESMASK_ALL, UA_REFERENCETYPESET_ALL,
@@ -1200,8 +1428,9 @@ UA_NODESTORE_GETFROMREF(UA_Server *server, UA_NodePointer target) {
                                       nodeid, attrMask, refs, refDirs)
 
 #define UA_NODESTORE_GET_EDIT_SELECTIVE(server, nodeid, attrMask, refs, refDirs) \
-    server->config.nodestore->getEditNode(server->config.nodestore,              \
-                                          nodeid, attrMask, refs, refDirs)
+    (UA_NODESTORE_BORROWED_COPY(server),                                         \
+     server->config.nodestore->getEditNode(server->config.nodestore,             \
+                                           nodeid, attrMask, refs, refDirs))
 
 #define UA_NODESTORE_GETFROMREF_SELECTIVE(server, target, attrMask, refs, refDirs) \
     server->config.nodestore->getNodeFromPtr(server->config.nodestore,             \
@@ -1217,10 +1446,12 @@ UA_NODESTORE_GETFROMREF(UA_Server *server, UA_NodePointer target) {
     server->config.nodestore->insertNode(server->config.nodestore, node, addedNodeId)
 
 #define UA_NODESTORE_REPLACE(server, node)                              \
-    server->config.nodestore->replaceNode(server->config.nodestore, node)
+    (UA_NODESTORE_BORROWED_COPY(server),                                \
+     server->config.nodestore->replaceNode(server->config.nodestore, node))
 
 #define UA_NODESTORE_REMOVE(server, nodeId)                             \
-    server->config.nodestore->removeNode(server->config.nodestore, nodeId)
+    (UA_NODESTORE_BORROWED_COPY(server),                                \
+     server->config.nodestore->removeNode(server->config.nodestore, nodeId))
 
 #define UA_NODESTORE_GETREFERENCETYPEID(server, index)                  \
     server->config.nodestore->getReferenceTypeId(server->config.nodestore, index)
@@ -452,6 +452,15 @@ endModelChange(UA_Server *server) {
 void
 recordModelChangeEvent(UA_Server *server, const UA_NodeId *affected, UA_Byte verb) {
     UA_LOCK_ASSERT(&server->serviceMutex);
+
+    /* Structural changes can alter how events propagate to the notifiers.
+     * This is independent of whether ModelChangeEvents are generated. */
+    if(verb & (UA_MODELCHANGESTRUCTUREVERBMASK_NODEADDED |
+               UA_MODELCHANGESTRUCTUREVERBMASK_NODEDELETED |
+               UA_MODELCHANGESTRUCTUREVERBMASK_REFERENCEADDED |
+               UA_MODELCHANGESTRUCTUREVERBMASK_REFERENCEDELETED))
+        clearEventRoutes(server);
+
     if(server->modelChangeSuppressionDepth > 0 || server->modelChangeDepth == 0)
         return;
     UA_StatusCode res =
@@ -130,11 +130,13 @@ UA_NodePointer_order(UA_NodePointer p1, UA_NodePointer p2) {
     /* Extract the tag and resolve pointers to nodes */
     UA_Byte tag1 = p1.immediate & UA_NODEPOINTER_MASK;
     if(tag1 == UA_NODEPOINTER_TAG_NODE) {
+        p1.immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
         p1 = UA_NodePointer_fromNodeId(&p1.node->nodeId);
         tag1 = p1.immediate & UA_NODEPOINTER_MASK;
     }
     UA_Byte tag2 = p2.immediate & UA_NODEPOINTER_MASK;
     if(tag2 == UA_NODEPOINTER_TAG_NODE) {
+        p2.immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
         p2 = UA_NodePointer_fromNodeId(&p2.node->nodeId);
         tag2 = p2.immediate & UA_NODEPOINTER_MASK;
     }
@@ -213,6 +215,22 @@ UA_NodePointer_toNodeId(UA_NodePointer np) {
     return id;
 }
 
+UA_NodePointer
+UA_NodePointer_fromNode(const UA_NodeHead *node) {
+    UA_NodePointer np;
+    np.node = node;
+    np.immediate |= UA_NODEPOINTER_TAG_NODE;
+    return np;
+}
+
+const UA_NodeHead *
+UA_NodePointer_getNode(UA_NodePointer np) {
+    if((np.immediate & UA_NODEPOINTER_MASK) != UA_NODEPOINTER_TAG_NODE)
+        return NULL;
+    np.immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
+    return np.node;
+}
+
 UA_NodePointer
 UA_NodePointer_fromExpandedNodeId(const UA_ExpandedNodeId *id) {
     if(!UA_ExpandedNodeId_isLocal(id)) {
@@ -229,6 +247,7 @@ UA_NodePointer_toExpandedNodeId(UA_NodePointer np) {
     /* Resolve node pointer to get the NodeId */
     UA_Byte tag = np.immediate & UA_NODEPOINTER_MASK;
     if(tag == UA_NODEPOINTER_TAG_NODE) {
+        np.immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
         np = UA_NodePointer_fromNodeId(&np.node->nodeId);
         tag = np.immediate & UA_NODEPOINTER_MASK;
     }
@@ -98,6 +98,20 @@ serverCustomTypes(UA_Server *server) {
     return server->customTypes_internal;
 }
 
+void
+indexServerCustomTypes(UA_Server *server) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    const UA_DataTypeArray *custom = serverCustomTypes(server);
+    if(server->customTypesIndex &&
+       UA_DataTypeIndex_isCurrent(server->customTypesIndex, custom))
+        return;
+    UA_DataTypeIndex_delete(server->customTypesIndex);
+    server->customTypesIndex = NULL;
+    /* Without the index the types are found with a linear search. So we can
+     * ignore errors. */
+    UA_DataTypeIndex_new(custom, &server->customTypesIndex);
+}
+
 const UA_DataTypeArray *
 UA_Server_getDataTypes(UA_Server *server) {
     lockServer(server);
@@ -108,7 +122,12 @@ UA_Server_getDataTypes(UA_Server *server) {
 
 const UA_DataType *
 UA_Server_findDataType(UA_Server *server, const UA_NodeId *typeId) {
-    return UA_findDataTypeWithCustom(typeId, serverCustomTypes(server));
+    lockServer(server);
+    const UA_DataType *type =
+        UA_findDataTypeIndexed(typeId, serverCustomTypes(server),
+                               server->customTypesIndex);
+    unlockServer(server);
+    return type;
 }
 
 /* DataTypes need a stable pointer. So we allocate an array of 64 datatypes.
@@ -149,44 +168,59 @@ addDataType(UA_Server *server, UA_DataType *dt) {
     /* Move the datatype into the stable location in the server */
     current->types[current->typesSize] = *dt;
     current->typesSize++;
+
+    /* Update the index */
+    indexServerCustomTypes(server);
     return UA_STATUSCODE_GOOD;
 }
 
 UA_StatusCode
 UA_Server_addDataType(UA_Server *server, const UA_NodeId parentNodeId,
                       const UA_DataType *type) {
+    lockServer(server);
+
     /* Check that the type does not already exist. We do not allow changes to
      * DataTypes once they are set. */
-    if(UA_Server_findDataType(server, &type->typeId))
+    if(UA_Server_findDataType(server, &type->typeId)) {
+        unlockServer(server);
         return UA_STATUSCODE_BADNODEIDEXISTS;
+    }
 
     /* Make a copy of the UA_DataType */
     UA_DataType dt2;
     UA_StatusCode res = UA_DataType_copy(type, &dt2);
-    if(res != UA_STATUSCODE_GOOD)
+    if(res != UA_STATUSCODE_GOOD) {
+        unlockServer(server);
         return res;
+    }
 
     /* Add the UA_DataType to the server */
     res = addDataType(server, &dt2);
     if(res != UA_STATUSCODE_GOOD)
         UA_DataType_clear(&dt2);
+    unlockServer(server);
     return res;
 }
 
 UA_StatusCode
 UA_Server_addDataTypeFromDescription(UA_Server *server,
                                      const UA_ExtensionObject *description) {
+    lockServer(server);
+
     /* Translate into a new UA_DataType */
     UA_DataType dt;
     UA_StatusCode res =
         UA_DataType_fromDescription(&dt, description, serverCustomTypes(server));
-    if(res != UA_STATUSCODE_GOOD)
+    if(res != UA_STATUSCODE_GOOD) {
+        unlockServer(server);
         return res;
+    }
 
     /* Check that the type does not already exist. We do not allow changes to
      * DataTypes once they are set. */
     if(UA_Server_findDataType(server, &dt.typeId)) {
         UA_DataType_clear(&dt);
+        unlockServer(server);
         return UA_STATUSCODE_BADNODEIDEXISTS;
     }
 
@@ -194,6 +228,7 @@ UA_Server_addDataTypeFromDescription(UA_Server *server,
     res = addDataType(server, &dt);
     if(res != UA_STATUSCODE_GOOD)
         UA_DataType_clear(&dt);
+    unlockServer(server);
     return res;
 }
 
@@ -609,12 +644,15 @@ editNode(UA_Server *server, UA_Session *session, const UA_NodeId *nodeId,
          UA_UInt32 attributeMask, UA_ReferenceTypeSet references,
          UA_BrowseDirection referenceDirections,
          UA_EditNodeCallback callback, void *data) {
+    UA_StatusCode retval = UA_ServiceWorkers_checkModify(server);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
     UA_Node *node =
         UA_NODESTORE_GET_EDIT_SELECTIVE(server, nodeId, attributeMask,
                                         references, referenceDirections);
     if(!node)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
-    UA_StatusCode retval = callback(server, session, node, data);
+    retval = callback(server, session, node, data);
     UA_NODESTORE_RELEASE(server, node);
     return retval;
 }
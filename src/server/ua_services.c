@@ -170,15 +170,16 @@ getServiceDescription(UA_UInt32 requestTypeId) {
 }
 
 UA_StatusCode
-decodeBinaryServiceRequest(UA_Server *server, const UA_ByteString *message,
-                           UA_ServiceDescription **description,
+decodeBinaryServiceRequest(UA_Server *server, const UA_ByteString *segments,
+                           size_t segmentsSize, UA_ServiceDescription **description,
                            UA_Request *request, size_t *requestOffset,
                            UA_UInt32 *requestTypeId) {
     *description = NULL;
     size_t offset = 0;
     UA_NodeId typeId;
-    UA_NodeId_init(&typeId);
-    UA_StatusCode res = UA_NodeId_decodeBinary(message, &offset, &typeId);
+    UA_StatusCode res =
+        UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset, &typeId,
+                                        &UA_TYPES[UA_TYPES_NODEID], NULL, NULL);
     if(res != UA_STATUSCODE_GOOD)
         return res;
     if(requestOffset)
@@ -201,9 +202,13 @@ decodeBinaryServiceRequest(UA_Server *server, const UA_ByteString *message,
     UA_DecodeBinaryOptions options;
     memset(&options, 0, sizeof(options));
     options.customTypes = serverCustomTypes(server);
-    res = UA_decodeBinaryInternal(message, &offset, request,
-                                  (*description)->requestType, &options);
-    if(res == UA_STATUSCODE_GOOD && offset != message->length)
+    res = UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset, request,
+                                          (*description)->requestType, &options,
+                                          server->customTypesIndex);
+    size_t length = 0;
+    for(size_t i = 0; i < segmentsSize; i++)
+        length += segments[i].length;
+    if(res == UA_STATUSCODE_GOOD && offset != length)
         res = UA_STATUSCODE_BADDECODINGERROR;
     if(res != UA_STATUSCODE_GOOD)
         UA_clear(request, (*description)->requestType);
@@ -249,6 +254,38 @@ getUacpRequestId(const UA_SecureChannel *channel, UA_UInt64 responseToken) {
     return (UA_UInt32)responseToken;
 }
 
+static void
+notifyService(UA_Server *server, UA_ApplicationNotificationType nt,
+              UA_UInt32 channelId, const UA_NodeId *sessionId,
+              UA_UInt32 uacpRequestId, const UA_ServiceDescription *sd) {
+    UA_STATIC_THREAD_LOCAL UA_KeyValuePair notifyPayload[4] = {
+        {{0, UA_STRING_STATIC("securechannel-id")}, {0}},
+        {{0, UA_STRING_STATIC("session-id")}, {0}},
+        {{0, UA_STRING_STATIC("request-id")}, {0}},
+        {{0, UA_STRING_STATIC("service-type")}, {0}}
+    };
+    UA_KeyValueMap notifyPayloadMap = {4, notifyPayload};
+    UA_Variant_setScalar(&notifyPayload[0].value, &channelId,
+                         &UA_TYPES[UA_TYPES_UINT32]);
+    UA_Variant_setScalar(&notifyPayload[1].value, (void*)(uintptr_t)sessionId,
+                         &UA_TYPES[UA_TYPES_NODEID]);
+    UA_Variant_setScalar(&notifyPayload[2].value, &uacpRequestId,
+                         &UA_TYPES[UA_TYPES_UINT32]);
+    UA_Variant_setScalar(&notifyPayload[3].value,
+                         (void *)(uintptr_t)&sd->requestType->typeId,
+                         &UA_TYPES[UA_TYPES_NODEID]);
+    notifyApplication(server, nt, notifyPayloadMap);
+}
+
+#ifdef UA_SERVICEWORKERS
+static UA_Boolean
+enqueueServiceJob(UA_Server *server, UA_SecureChannel *channel,
+                  UA_Session *session, UA_UInt64 responseToken,
+                  UA_ServiceDescription *sd, const UA_Request *request);
+static UA_Boolean isParallelService(const UA_ServiceDescription *sd);
+static void processServiceJobs(UA_Server *server);
+#endif
+
 static UA_Boolean
 processServiceInternal(UA_Server *server, UA_SecureChannel *channel, UA_Session *session,
                        UA_UInt64 responseToken, UA_ServiceDescription *sd,
@@ -341,6 +378,13 @@ processServiceInternal(UA_Server *server, UA_SecureChannel *channel, UA_Session
         getUacpRequestId(channel, responseToken);
     server->asyncManager.currentRequestHandle = request->requestHeader.requestHandle;
 
+#ifdef UA_SERVICEWORKERS
+    /* Defer read-only services to be executed in parallel by the worker
+     * threads. The response is sent when the batch has finished. */
+    if(enqueueServiceJob(server, channel, session, responseToken, sd, request))
+        return false;
+#endif
+
     /* Execute the service */
     return sd->serviceCallback(server, session, request, response);
 }
@@ -351,6 +395,18 @@ processRequest(UA_Server *server, UA_SecureChannel *channel,
                const UA_Request *request, UA_Response *response) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+#ifdef UA_SERVICEWORKERS
+    /* Finish the deferred read-only requests before a service that can modify
+     * the information model or the session state. Publish requests wait for
+     * notifications and don't need to be ordered. */
+    if(!isParallelService(sd)
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+       && sd->requestType != &UA_TYPES[UA_TYPES_PUBLISHREQUEST]
+#endif
+       )
+        processServiceJobs(server);
+#endif
+
     /* Set the authenticationToken from the create session request to help
      * fuzzing cover more lines */
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
@@ -376,24 +432,9 @@ processRequest(UA_Server *server, UA_SecureChannel *channel,
     UA_UInt32 uacpRequestId = getUacpRequestId(channel, responseToken);
 
     /* Notify with UA_APPLICATIONNOTIFICATIONTYPE_SERVICE_BEGIN */
-    UA_STATIC_THREAD_LOCAL UA_KeyValuePair notifyPayload[4] = {
-        {{0, UA_STRING_STATIC("securechannel-id")}, {0}},
-        {{0, UA_STRING_STATIC("session-id")}, {0}},
-        {{0, UA_STRING_STATIC("request-id")}, {0}},
-        {{0, UA_STRING_STATIC("service-type")}, {0}}
-    };
-    UA_KeyValueMap notifyPayloadMap = {4, notifyPayload};
-    UA_Variant_setScalar(&notifyPayload[0].value, &channel->securityToken.channelId,
-                         &UA_TYPES[UA_TYPES_UINT32]);
-    UA_Variant_setScalar(&notifyPayload[1].value, &sessionId,
-                         &UA_TYPES[UA_TYPES_NODEID]);
-    UA_Variant_setScalar(&notifyPayload[2].value, &uacpRequestId,
-                         &UA_TYPES[UA_TYPES_UINT32]);
-    UA_Variant_setScalar(&notifyPayload[3].value,
-                         (void *)(uintptr_t)&sd->requestType->typeId,
-                         &UA_TYPES[UA_TYPES_NODEID]);
     UA_ApplicationNotificationType nt = UA_APPLICATIONNOTIFICATIONTYPE_SERVICE_BEGIN;
-    notifyApplication(server, nt, notifyPayloadMap);
+    notifyService(server, nt, channel->securityToken.channelId, &sessionId,
+                  uacpRequestId, sd);
 
     /* Process the service */
     beginModelChange(server);
@@ -410,7 +451,8 @@ processRequest(UA_Server *server, UA_SecureChannel *channel,
      * called eventually in ua_server_async.c. */
     nt = (done) ? UA_APPLICATIONNOTIFICATIONTYPE_SERVICE_END :
         UA_APPLICATIONNOTIFICATIONTYPE_SERVICE_ASYNC;
-    notifyApplication(server, nt, notifyPayloadMap);
+    notifyService(server, nt, channel->securityToken.channelId, &sessionId,
+                  uacpRequestId, sd);
 
     /* Update the service statistics */
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -474,3 +516,389 @@ abandonServiceRequest(UA_Server *server, UA_SecureChannel *channel,
 #endif
     UA_AsyncManager_abandon(server, channel, responseToken);
 }
+
+/*******************/
+/* Service Workers */
+/*******************/
+
+#ifdef UA_SERVICEWORKERS
+
+/* Read-only requests received in one EventLoop iteration are collected and
+ * executed together in a batch. The EventLoop thread holds the server lock
+ * until the batch is finished. So the worker threads have shared access to
+ * the information model, while mutating services and API calls from other
+ * threads keep their exclusive access. The jobs of one session are executed in
+ * order by the same thread, as they share the continuation points.
+ *
+ * Callbacks from the worker threads (DataSources, value callbacks,
+ * AccessControl) run while the EventLoop thread holds the server lock. Their
+ * calls into the server API don't take the lock again. So they must not modify
+ * the information model. */
+
+static UA_Boolean
+isParallelService(const UA_ServiceDescription *sd) {
+    return (sd->requestType == &UA_TYPES[UA_TYPES_READREQUEST] ||
+            sd->requestType == &UA_TYPES[UA_TYPES_BROWSEREQUEST] ||
+            sd->requestType == &UA_TYPES[UA_TYPES_BROWSENEXTREQUEST] ||
+            sd->requestType ==
+            &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSREQUEST]);
+}
+
+static void
+deleteServiceJob(UA_ServiceJob *job) {
+    UA_clear(&job->request, job->sd->requestType);
+    UA_clear(&job->response, job->sd->responseType);
+    UA_NodeId_clear(&job->sessionId);
+    UA_free(job);
+}
+
+static void
+executeServiceJobs(UA_Server *server, UA_ServiceJob *job) {
+    for(; job; job = job->sessionNext)
+        job->done = job->sd->serviceCallback(server, job->session,
+                                             &job->request, &job->response);
+}
+
+static void *
+serviceWorkerLoop(void *context) {
+    UA_Server *server = (UA_Server*)context;
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    pthread_setspecific(sw->workerKey, server);
+
+    pthread_mutex_lock(&sw->mutex);
+    while(sw->running) {
+        /* Wait for the next batch */
+        if(sw->batchNext == sw->batchSize) {
+            pthread_cond_wait(&sw->wakeup, &sw->mutex);
+            continue;
+        }
+
+        /* Pick up a job chain */
+        UA_ServiceJob *job = sw->batch[sw->batchNext];
+        sw->batchNext++;
+        pthread_mutex_unlock(&sw->mutex);
+        executeServiceJobs(server, job);
+        pthread_mutex_lock(&sw->mutex);
+
+        /* Signal when the batch is done */
+        sw->batchOpen--;
+        if(sw->batchOpen == 0)
+            pthread_cond_signal(&sw->finished);
+    }
+    pthread_mutex_unlock(&sw->mutex);
+    return NULL;
+}
+
+static void
+completeServiceJob(UA_Server *server, UA_ServiceJob *job) {
+    /* The AsyncManager sends the response when the async operations of the
+     * service are done */
+    if(!job->done)
+        return;
+
+    UA_Session *session = job->session;
+    UA_SecureChannel *channel = session->channel;
+    UA_UInt32 channelId = (channel) ? channel->securityToken.channelId : 0;
+    notifyService(server, UA_APPLICATIONNOTIFICATIONTYPE_SERVICE_END,
+                  channelId, &session->sessionId, job->uacpRequestId, job->sd);
+
+    /* The request was counted when it was deferred. Count the error now. */
+#ifdef UA_ENABLE_DIAGNOSTICS
+    if(job->response.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
+        session->diagnostics.totalRequestCount.errorCount++;
+        if(job->sd->counterOffset != 0) {
+            UA_ServiceCounterDataType *serviceCounter = (UA_ServiceCounterDataType*)
+                (((uintptr_t)&session->diagnostics) + job->sd->counterOffset);
+            serviceCounter->errorCount++;
+        }
+    }
+#endif
+
+    if(!channel) {
+        UA_LOG_WARNING_SESSION(server->config.logging, session,
+                               "Service response cannot be sent. "
+                               "No SecureChannel for the session.");
+        releaseBorrowedValues(server, &job->response);
+        return;
+    }
+
+    UA_StatusCode res = sendResponse(server, channel, job->responseToken,
+                                     &job->response, job->sd->responseType);
+    if(res != UA_STATUSCODE_GOOD)
+        UA_LOG_WARNING_SESSION(server->config.logging, session,
+                               "Sending the response for token %" PRIu64
+                               " failed with StatusCode %s", job->responseToken,
+                               UA_StatusCode_name(res));
+}
+
+static void
+processServiceJobs(UA_Server *server) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    if(TAILQ_EMPTY(&sw->pending))
+        return;
+
+    /* Take the pending jobs */
+    UA_ServiceJob *job, *job_tmp;
+    UA_ServiceJobQueue jobs;
+    TAILQ_INIT(&jobs);
+    TAILQ_FOREACH_SAFE(job, &sw->pending, pointers, job_tmp) {
+        TAILQ_REMOVE(&sw->pending, job, pointers);
+        TAILQ_INSERT_TAIL(&jobs, job, pointers);
+    }
+    size_t jobsSize = sw->pendingSize;
+    sw->pendingSize = 0;
+
+    /* Grow the batch array */
+    if(sw->batchCapacity < jobsSize) {
+        UA_ServiceJob **batch = (UA_ServiceJob**)
+            UA_realloc(sw->batch, jobsSize * sizeof(UA_ServiceJob*));
+        if(batch) {
+            sw->batch = batch;
+            sw->batchCapacity = jobsSize;
+        }
+    }
+
+    /* From here on, the async operations created by the jobs are attached to
+     * the AsyncManager with the transport context from the job */
+    pthread_mutex_lock(&sw->mutex);
+    sw->batchActive = true;
+    pthread_mutex_unlock(&sw->mutex);
+
+    /* Resolve the sessions and chain the jobs of the same session */
+    size_t batchSize = 0;
+    TAILQ_FOREACH_SAFE(job, &jobs, pointers, job_tmp) {
+        job->session = getSessionById(server, &job->sessionId);
+        if(!job->session) {
+            UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                           "Service Worker: Session %N no longer exists",
+                           job->sessionId);
+            TAILQ_REMOVE(&jobs, job, pointers);
+            deleteServiceJob(job);
+            continue;
+        }
+
+        /* Not enough memory for the batch. Execute in this thread. */
+        if(sw->batchCapacity < jobsSize) {
+            executeServiceJobs(server, job);
+            continue;
+        }
+
+        size_t i = 0;
+        for(; i < batchSize; i++) {
+            if(sw->batch[i]->session == job->session)
+                break;
+        }
+        if(i == batchSize) {
+            sw->batch[batchSize++] = job;
+            continue;
+        }
+        UA_ServiceJob *last = sw->batch[i];
+        while(last->sessionNext)
+            last = last->sessionNext;
+        last->sessionNext = job;
+    }
+
+    /* Start the batch and take part in its execution */
+    pthread_mutex_lock(&sw->mutex);
+    sw->batchSize = batchSize;
+    sw->batchNext = 0;
+    sw->batchOpen = batchSize;
+    pthread_cond_broadcast(&sw->wakeup);
+    while(sw->batchNext < sw->batchSize) {
+        job = sw->batch[sw->batchNext];
+        sw->batchNext++;
+        pthread_mutex_unlock(&sw->mutex);
+        executeServiceJobs(server, job);
+        pthread_mutex_lock(&sw->mutex);
+        sw->batchOpen--;
+    }
+
+    /* Wait until the worker threads are done */
+    while(sw->batchOpen > 0)
+        pthread_cond_wait(&sw->finished, &sw->mutex);
+    sw->batchActive = false;
+    sw->batchSize = 0;
+    sw->batchNext = 0;
+    pthread_mutex_unlock(&sw->mutex);
+
+    /* Send the responses in the order in which the requests were received */
+    TAILQ_FOREACH_SAFE(job, &jobs, pointers, job_tmp) {
+        TAILQ_REMOVE(&jobs, job, pointers);
+        completeServiceJob(server, job);
+        deleteServiceJob(job);
+    }
+}
+
+/* Called from the EventLoop via a delayed callback */
+static void
+processServiceJobsDelayed(void *application /* UA_Server */,
+                          void *context /* UA_ServiceWorkers */) {
+    UA_Server *server = (UA_Server*)application;
+    UA_ServiceWorkers *sw = (UA_ServiceWorkers*)context;
+    lockServer(server);
+    UA_atomic_store((UA_atomic(void*)*)&sw->dc.callback, NULL);
+    processServiceJobs(server);
+    unlockServer(server);
+}
+
+static UA_Boolean
+enqueueServiceJob(UA_Server *server, UA_SecureChannel *channel,
+                  UA_Session *session, UA_UInt64 responseToken,
+                  UA_ServiceDescription *sd, const UA_Request *request) {
+    /* HTTP requests are answered on the carrier of the request. Keep them
+     * synchronous. */
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    if(sw->threadsSize == 0 || !isParallelService(sd) ||
+       channel->transport != UA_SECURECHANNEL_TRANSPORT_UACP)
+        return false;
+
+    /* Copy the request. The transport frees the original after this call. */
+    UA_ServiceJob *job = (UA_ServiceJob*)UA_calloc(1, sizeof(UA_ServiceJob));
+    if(!job)
+        return false;
+    job->sd = sd;
+    UA_StatusCode res = UA_copy(request, &job->request, sd->requestType);
+    res |= UA_NodeId_copy(&session->sessionId, &job->sessionId);
+    if(res != UA_STATUSCODE_GOOD) {
+        deleteServiceJob(job);
+        return false;
+    }
+    UA_init(&job->response, sd->responseType);
+    job->response.responseHeader.requestHandle = request->requestHeader.requestHandle;
+    job->responseToken = responseToken;
+    job->uacpRequestId = getUacpRequestId(channel, responseToken);
+
+    TAILQ_INSERT_TAIL(&sw->pending, job, pointers);
+    sw->pendingSize++;
+
+    /* Execute the batch after the current EventLoop iteration */
+    if(sw->dc.callback == NULL) {
+        UA_EventLoop *el = server->config.eventLoop;
+        sw->dc.callback = processServiceJobsDelayed;
+        sw->dc.application = server;
+        sw->dc.context = sw;
+        el->addDelayedCallback(el, &sw->dc);
+    }
+    return true;
+}
+
+void
+UA_ServiceWorkers_init(UA_Server *server) {
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    memset(sw, 0, sizeof(UA_ServiceWorkers));
+    TAILQ_INIT(&sw->pending);
+    pthread_key_create(&sw->workerKey, NULL);
+    pthread_mutex_init(&sw->mutex, NULL);
+    pthread_cond_init(&sw->wakeup, NULL);
+    pthread_cond_init(&sw->finished, NULL);
+}
+
+void
+UA_ServiceWorkers_start(UA_Server *server) {
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    UA_UInt16 workers = server->config.serviceWorkers;
+    if(workers == 0 || sw->threadsSize > 0)
+        return;
+
+    sw->threads = (pthread_t*)UA_calloc(workers, sizeof(pthread_t));
+    if(!sw->threads) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Cannot allocate the service workers");
+        return;
+    }
+
+    sw->running = true;
+    for(; sw->threadsSize < workers; sw->threadsSize++) {
+        int err = pthread_create(&sw->threads[sw->threadsSize], NULL,
+                                 serviceWorkerLoop, server);
+        if(err != 0) {
+            UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                           "Cannot start a service worker thread (error %i)", err);
+            break;
+        }
+    }
+
+    UA_LOG_INFO(server->config.logging, UA_LOGCATEGORY_SERVER,
+                "Started %u service worker threads",
+                (unsigned)sw->threadsSize);
+}
+
+void
+UA_ServiceWorkers_stop(UA_Server *server) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+
+    /* Execute the remaining jobs */
+    if(sw->dc.callback) {
+        UA_EventLoop *el = server->config.eventLoop;
+        el->removeDelayedCallback(el, &sw->dc);
+        sw->dc.callback = NULL;
+    }
+    processServiceJobs(server);
+
+    /* Stop the worker threads */
+    pthread_mutex_lock(&sw->mutex);
+    sw->running = false;
+    pthread_cond_broadcast(&sw->wakeup);
+    pthread_mutex_unlock(&sw->mutex);
+    for(size_t i = 0; i < sw->threadsSize; i++)
+        pthread_join(sw->threads[i], NULL);
+    UA_free(sw->threads);
+    sw->threads = NULL;
+    sw->threadsSize = 0;
+}
+
+void
+UA_ServiceWorkers_clear(UA_Server *server) {
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    UA_assert(sw->threadsSize == 0);
+    UA_ServiceJob *job, *job_tmp;
+    TAILQ_FOREACH_SAFE(job, &sw->pending, pointers, job_tmp) {
+        TAILQ_REMOVE(&sw->pending, job, pointers);
+        deleteServiceJob(job);
+    }
+    UA_free(sw->batch);
+    pthread_cond_destroy(&sw->finished);
+    pthread_cond_destroy(&sw->wakeup);
+    pthread_mutex_destroy(&sw->mutex);
+    pthread_key_delete(sw->workerKey);
+}
+
+UA_Boolean
+UA_ServiceWorkers_isWorker(UA_Server *server) {
+    UA_ServiceWorkers *sw = &server->serviceWorkers;
+    return (sw->threadsSize > 0 && pthread_getspecific(sw->workerKey) == server);
+}
+
+UA_StatusCode
+UA_ServiceWorkers_checkModify(UA_Server *server) {
+    if(UA_LIKELY(!server->serviceWorkers.batchActive))
+        return UA_STATUSCODE_GOOD;
+    UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                 "The information model and the Subscriptions cannot be "
+                 "modified from a callback during the parallel execution "
+                 "of services");
+    return UA_STATUSCODE_BADINVALIDSTATE;
+}
+
+UA_ServiceJob *
+UA_ServiceWorkers_getJob(UA_Server *server, void *response) {
+    if(!server->serviceWorkers.batchActive)
+        return NULL;
+    return container_of(response, UA_ServiceJob, response);
+}
+
+void
+UA_ServiceWorkers_lockAsync(UA_Server *server) {
+    if(server->serviceWorkers.batchActive)
+        pthread_mutex_lock(&server->serviceWorkers.mutex);
+}
+
+void
+UA_ServiceWorkers_unlockAsync(UA_Server *server) {
+    if(server->serviceWorkers.batchActive)
+        pthread_mutex_unlock(&server->serviceWorkers.mutex);
+}
+
+#endif /* UA_SERVICEWORKERS */
@@ -43,10 +43,11 @@ typedef struct {
 /* Returns NULL if none found */
 UA_ServiceDescription * getServiceDescription(UA_UInt32 requestTypeId);
 
-/* Decode a complete Binary service request including its type identifier. */
+/* Decode a complete Binary service request including its type identifier. The
+ * message can be split into several segments (the chunks of the message). */
 UA_StatusCode
-decodeBinaryServiceRequest(UA_Server *server, const UA_ByteString *message,
-                           UA_ServiceDescription **description,
+decodeBinaryServiceRequest(UA_Server *server, const UA_ByteString *segments,
+                           size_t segmentsSize, UA_ServiceDescription **description,
                            UA_Request *request, size_t *requestOffset,
                            UA_UInt32 *requestTypeId);
 
@@ -223,12 +223,121 @@ readIsAbstractAttribute(const UA_Node *node, UA_Variant *v) {
     return UA_Variant_setScalarCopy(v, isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
 }
 
+/******************/
+/* Zero-Copy Read */
+/******************/
+
+/* Reference the value of the node in the Read response. The node is retained
+ * until the response is sent. */
+static UA_Boolean
+borrowValue(UA_Server *server, const void *response,
+            const UA_VariableNode *vn, UA_DataValue *v) {
+    /* Is the value large enough? */
+    const UA_DataValue *value = &vn->valueSource.internal.value;
+    const UA_DataType *type = value->value.type;
+    if(!value->hasValue || !type)
+        return false;
+    size_t size = (type->pointerFree) ?
+        type->memSize * (UA_Variant_isScalar(&value->value) ?
+                         1 : value->value.arrayLength) :
+        UA_calcSizeBinary(&value->value, &UA_TYPES[UA_TYPES_VARIANT], NULL);
+    if(size < server->config.readZeroCopyThreshold)
+        return false;
+
+    /* Retain the node. Don't borrow if the Nodestore returns a different node
+     * (e.g. a copy). */
+    const UA_Node *node =
+        UA_NODESTORE_GETFROMREF_SELECTIVE(server, UA_NodePointer_fromNode(&vn->head),
+                                          UA_NODEATTRIBUTESMASK_VALUE,
+                                          UA_REFERENCETYPESET_NONE,
+                                          UA_BROWSEDIRECTION_INVALID);
+    if(!node)
+        return false;
+    if(node != (const UA_Node*)vn) {
+        UA_NODESTORE_RELEASE(server, node);
+        return false;
+    }
+
+    /* Add to the borrowed values */
+    UA_ServiceWorkers_lockAsync(server);
+    if(server->borrowedValuesSize == server->borrowedValuesCapacity) {
+        size_t cap = (server->borrowedValuesCapacity == 0) ?
+            8 : server->borrowedValuesCapacity * 2;
+        UA_BorrowedValue *bv = (UA_BorrowedValue*)
+            UA_realloc(server->borrowedValues, cap * sizeof(UA_BorrowedValue));
+        if(!bv) {
+            UA_ServiceWorkers_unlockAsync(server);
+            UA_NODESTORE_RELEASE(server, node);
+            return false;
+        }
+        server->borrowedValues = bv;
+        server->borrowedValuesCapacity = cap;
+    }
+    UA_BorrowedValue *bv = &server->borrowedValues[server->borrowedValuesSize++];
+    bv->response = response;
+    bv->node = node;
+    bv->value = v;
+    UA_ServiceWorkers_unlockAsync(server);
+
+    /* Shallow copy of the value */
+    *v = *value;
+    v->value.storageType = UA_VARIANT_DATA_NODELETE;
+    return true;
+}
+
+/* Remove the entries of the response (or all entries). Make deep copies of the
+ * values if required. */
+static void
+endBorrow(UA_Server *server, const void *response, UA_Boolean copy) {
+    UA_ServiceWorkers_lockAsync(server);
+    size_t j = 0;
+    for(size_t i = 0; i < server->borrowedValuesSize; i++) {
+        UA_BorrowedValue *bv = &server->borrowedValues[i];
+        if(response && bv->response != response) {
+            server->borrowedValues[j++] = *bv;
+            continue;
+        }
+        if(copy) {
+            UA_Variant tmp = bv->value->value;
+            if(UA_Variant_copy(&tmp, &bv->value->value) != UA_STATUSCODE_GOOD) {
+                UA_Variant_init(&bv->value->value);
+                bv->value->hasValue = false;
+                bv->value->hasStatus = true;
+                bv->value->status = UA_STATUSCODE_BADOUTOFMEMORY;
+            }
+        }
+        UA_NODESTORE_RELEASE(server, bv->node);
+    }
+    server->borrowedValuesSize = j;
+    UA_ServiceWorkers_unlockAsync(server);
+}
+
+void
+copyBorrowedValues(UA_Server *server, const void *response) {
+    endBorrow(server, response, true);
+}
+
+void
+releaseBorrowedValues(UA_Server *server, const void *response) {
+    if(server->borrowedValuesSize == 0)
+        return;
+    endBorrow(server, response, false);
+}
+
 static UA_StatusCode
 readInternalValueAttribute(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
                            UA_NumericRange *rangeptr) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Borrow the value for a result of the Read service. Other reads in the
+     * same session (e.g. sampling triggered by a callback) copy the value. */
+    const UA_ReadResponse *rr = (session) ? session->readResponse : NULL;
+    if(rr && v >= rr->results && v < &rr->results[rr->resultsSize] &&
+       !rangeptr && !vn->valueSource.internal.notifications.onRead &&
+       borrowValue(server, rr, vn, v))
+        return UA_STATUSCODE_GOOD;
+
     /* Update the value by the user callback */
     if(vn->valueSource.internal.notifications.onRead) {
         vn->valueSource.internal.notifications.
@@ -699,7 +808,8 @@ Operation_ReadWithNode(UA_Server *server, UA_Session *session,
 #ifdef UA_ENABLE_TYPEDESCRIPTION
         /* Find the DataType */
         const UA_DataType *type =
-            UA_findDataTypeWithCustom(&node->head.nodeId, serverCustomTypes(server));
+            UA_findDataTypeIndexed(&node->head.nodeId, serverCustomTypes(server),
+                                   server->customTypesIndex);
         if(!type) {
             retval = UA_STATUSCODE_BADATTRIBUTEIDINVALID;
             break;
@@ -820,10 +930,36 @@ Operation_ReadWithNode(UA_Server *server, UA_Session *session,
     return (retval != UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY);
 }
 
+/* Read with a handle from the RegisterNodes service. The node is cached in
+ * the session. So the Nodestore lookup is skipped. */
+static UA_Boolean
+readRegisteredNode(UA_Server *server, UA_Session *session,
+                   UA_TimestampsToReturn ttr,
+                   const UA_ReadValueId *rvi, UA_DataValue *dv) {
+    const UA_Node *node =
+        UA_Session_getRegisteredNode(server, session, &rvi->nodeId);
+    if(!node) {
+        dv->hasStatus = true;
+        dv->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        return true;
+    }
+
+    /* Use the NodeId of the node in the operation (shallow copy) */
+    UA_ReadValueId nodeRvi = *rvi;
+    nodeRvi.nodeId = node->head.nodeId;
+    UA_Boolean done =
+        Operation_ReadWithNode(server, session, node, ttr, &nodeRvi, dv);
+    UA_NODESTORE_RELEASE(server, node);
+    return done;
+}
+
 UA_Boolean
 Operation_Read(UA_Server *server, UA_Session *session,
                UA_TimestampsToReturn ttr,
                const UA_ReadValueId *rvi, UA_DataValue *dv) {
+    if(UA_UNLIKELY(isRegisteredNodeHandle(&rvi->nodeId)))
+        return readRegisteredNode(server, session, ttr, rvi, dv);
+
     /* Get the node (with only the selected attribute if the NodeStore supports that) */
     UA_UInt32 attrMask = attributeId2AttributeMask((UA_AttributeId)rvi->attributeId);
     const UA_Node *node =
@@ -841,6 +977,32 @@ Operation_Read(UA_Server *server, UA_Session *session,
     return done;
 }
 
+UA_StatusCode
+checkReadValueAccess(UA_Server *server, UA_Session *session,
+                     const UA_NodeId *nodeId) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    if(!session)
+        return UA_STATUSCODE_BADUSERACCESSDENIED;
+    if(session == &server->adminSession)
+        return UA_STATUSCODE_GOOD;
+
+    UA_UInt32 attrMask = attributeId2AttributeMask(UA_ATTRIBUTEID_ACCESSLEVEL);
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, nodeId, attrMask,
+                                   UA_REFERENCETYPESET_NONE, UA_BROWSEDIRECTION_INVALID);
+    if(!node)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    /* Same as in Operation_ReadWithNode */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(node->head.nodeClass == UA_NODECLASS_VARIABLE &&
+       !(getUserAccessLevel(server, session, &node->variableNode) &
+         UA_ACCESSLEVELMASK_READ))
+        res = UA_STATUSCODE_BADUSERACCESSDENIED;
+    UA_NODESTORE_RELEASE(server, node);
+    return res;
+}
+
 UA_DataValue
 readWithSession(UA_Server *server, UA_Session *session,
                 const UA_ReadValueId *item,
@@ -1112,8 +1274,7 @@ compatibleValueDataType(UA_Server *server, const UA_DataType *dataType,
      * the Node hierarchy). But we usually do not encounter ExtensionObjects
      * here. Because the values are typically unwrapped from the ExtensionObject
      * during the decoding. */
-    return isNodeInTree_singleRef(server, constraintDataType, &dataType->typeId,
-                                  UA_REFERENCETYPEINDEX_HASSUBTYPE);
+    return isSubtypeOf(server, constraintDataType, &dataType->typeId);
 }
 
 UA_Boolean
@@ -1133,8 +1294,7 @@ compatibleDataTypes(UA_Server *server, const UA_NodeId *dataType,
         return true;
 
     /* Is the DataType a subtype of the constraint type? */
-    if(isNodeInTree_singleRef(server, dataType, constraintDataType,
-                              UA_REFERENCETYPEINDEX_HASSUBTYPE))
+    if(isSubtypeOf(server, dataType, constraintDataType))
         return true;
 
     return false;
@@ -1864,9 +2024,9 @@ updateLocalizedText(const UA_LocalizedText *source, UA_LocalizedText *target) {
  * network Write service, the UA_Server_write APIs and internal writeAttribute
  * calls. Async writes enter here when Operation_Write is resumed. */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
-static void
+void
 triggerImmediateDataChange(UA_Server *server, UA_Session *session,
-                           UA_Node *node, const UA_WriteValue *wvalue) {
+                           UA_Node *node, UA_AttributeId attributeId) {
     UA_MonitoredItem *mon = node->head.monitoredItems;
     for(; mon != NULL; mon = mon->nodeListNext) {
         /* Zero-interval items form the list prefix. Only items with a
@@ -1887,7 +2047,7 @@ triggerImmediateDataChange(UA_Server *server, UA_Session *session,
         case UA_MONITOREDITEMSAMPLINGTYPE_PUBLISH:
             continue;
         }
-        if(mon->itemToMonitor.attributeId != wvalue->attributeId)
+        if(mon->itemToMonitor.attributeId != attributeId)
             continue;
         /* TODO: Allow async read for datachanges */
         UA_DataValue value;
@@ -2144,7 +2304,8 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
 
     /* Trigger MonitoredItems with no SamplingInterval */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
-    triggerImmediateDataChange(server, session, node, wvalue);
+    triggerImmediateDataChange(server, session, node,
+                               (UA_AttributeId)wvalue->attributeId);
 #endif
 
     return UA_STATUSCODE_GOOD;
@@ -2233,9 +2394,36 @@ Operation_WriteWithNode(UA_Server *server, UA_Session *session,
     return done;
 }
 
+/* Write with a handle from the RegisterNodes service */
+static UA_Boolean
+writeRegisteredNode(UA_Server *server, UA_Session *session,
+                    const UA_WriteValue *wv, UA_StatusCode *result) {
+    UA_Node *node =
+        UA_Session_getRegisteredEditNode(server, session, &wv->nodeId);
+    if(!node) {
+        *result = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        return true;
+    }
+
+    /* Use the NodeId of the node in the operation (shallow copy) */
+    UA_WriteValue nodeWv = *wv;
+    nodeWv.nodeId = node->head.nodeId;
+    UA_Boolean done =
+        Operation_WriteWithNode(server, session, node, &nodeWv, result);
+    UA_NODESTORE_RELEASE(server, node);
+    return done;
+}
+
 UA_Boolean
 Operation_Write(UA_Server *server, UA_Session *session,
                 const UA_WriteValue *wv, UA_StatusCode *result) {
+    *result = UA_ServiceWorkers_checkModify(server);
+    if(UA_UNLIKELY(*result != UA_STATUSCODE_GOOD))
+        return true;
+
+    if(UA_UNLIKELY(isRegisteredNodeHandle(&wv->nodeId)))
+        return writeRegisteredNode(server, session, wv, result);
+
     UA_Node *node =
         UA_NODESTORE_GET_EDIT_SELECTIVE(server, &wv->nodeId, wv->attributeId,
                                         UA_REFERENCETYPESET_NONE,
@@ -2521,11 +2709,34 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
         return true;
     }
 
+    /* Resolve handles from the RegisterNodes service. The backend gets a
+     * shallow copy of the nodesToRead if it contains handles. */
+    const UA_HistoryReadValueId *nodesToRead = request->nodesToRead;
+    UA_HistoryReadValueId *resolvedNodes = NULL;
+    for(size_t i = 0; i < request->nodesToReadSize; i++) {
+        const UA_NodeId *id = &request->nodesToRead[i].nodeId;
+        if(!isRegisteredNodeHandle(id))
+            continue;
+        if(!resolvedNodes) {
+            resolvedNodes = (UA_HistoryReadValueId*)
+                UA_malloc(request->nodesToReadSize * sizeof(UA_HistoryReadValueId));
+            if(!resolvedNodes) {
+                response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+                return true;
+            }
+            memcpy(resolvedNodes, request->nodesToRead,
+                   request->nodesToReadSize * sizeof(UA_HistoryReadValueId));
+            nodesToRead = resolvedNodes;
+        }
+        resolvedNodes[i].nodeId = *UA_Session_resolveNodeId(session, id);
+    }
+
     /* Allocate a temporary array to forward the result pointers to the
      * backend */
     void **historyData = (void **)
         UA_calloc(request->nodesToReadSize, sizeof(void*));
     if(!historyData) {
+        UA_free(resolvedNodes);
         response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
         return true;
     }
@@ -2535,6 +2746,7 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
         UA_Array_new(request->nodesToReadSize, &UA_TYPES[UA_TYPES_HISTORYREADRESULT]);
     if(!response->results) {
         UA_free(historyData);
+        UA_free(resolvedNodes);
         response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
         return true;
     }
@@ -2551,7 +2763,7 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
          &session->sessionId, session->context, &request->requestHeader,    \
          (const DETAILS*)request->historyReadDetails.content.decoded.data,  \
          request->timestampsToReturn, request->releaseContinuationPoints,   \
-         request->nodesToReadSize, request->nodesToRead, response,          \
+         request->nodesToReadSize, nodesToRead, response,                   \
          (DATA * const * const)historyData)
 
     switch(readKind) {
@@ -2579,6 +2791,7 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
 
 #undef CALL_HISTORY_READ
     UA_free(historyData);
+    UA_free(resolvedNodes);
 
     return true;
 }
@@ -2611,16 +2824,18 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
             request->historyUpdateDetails[i].content.decoded.type;
         void *updateDetailsData = request->historyUpdateDetails[i].content.decoded.data;
 
+        /* Resolve handles from the RegisterNodes service (shallow copy) */
         if(updateDetailsType == &UA_TYPES[UA_TYPES_UPDATEDATADETAILS]) {
             if(!server->config.historyDatabase.updateData) {
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_UpdateDataDetails details = *(UA_UpdateDataDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 updateData(server, server->config.historyDatabase.context,
                            &session->sessionId, session->context,
-                           &request->requestHeader,
-                           (UA_UpdateDataDetails*)updateDetailsData,
+                           &request->requestHeader, &details,
                            &response->results[i]);
             continue;
         }
@@ -2630,11 +2845,13 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_DeleteRawModifiedDetails details =
+                *(UA_DeleteRawModifiedDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 deleteRawModified(server, server->config.historyDatabase.context,
                                   &session->sessionId, session->context,
-                                  &request->requestHeader,
-                                  (UA_DeleteRawModifiedDetails*)updateDetailsData,
+                                  &request->requestHeader, &details,
                                   &response->results[i]);
             continue;
         }
@@ -2644,11 +2861,12 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_DeleteEventDetails details = *(UA_DeleteEventDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 deleteEvent(server, server->config.historyDatabase.context,
                             &session->sessionId, session->context,
-                            &request->requestHeader,
-                            (UA_DeleteEventDetails*)updateDetailsData,
+                            &request->requestHeader, &details,
                             &response->results[i]);
             continue;
         }
@@ -347,6 +347,12 @@ Operation_CallMethod(UA_Server *server, UA_Session *session,
                      UA_CallMethodResult *result) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Resolve handles from the RegisterNodes service (shallow copy) */
+    UA_CallMethodRequest resolvedRequest = *request;
+    resolvedRequest.objectId = *UA_Session_resolveNodeId(session, &request->objectId);
+    resolvedRequest.methodId = *UA_Session_resolveNodeId(session, &request->methodId);
+    request = &resolvedRequest;
+
     /* Get the method node. We only need the nodeClass and browseName
      * attribute. */
     const UA_Node *method =
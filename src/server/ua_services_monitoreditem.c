@@ -438,6 +438,17 @@ Operation_CreateMonitoredItem(UA_Server *server, UA_Session *session,
     UA_MonitoredItemCreateResult *result = (UA_MonitoredItemCreateResult*)response;
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    result->statusCode = UA_ServiceWorkers_checkModify(server);
+    if(result->statusCode != UA_STATUSCODE_GOOD)
+        return;
+
+    /* Resolve a handle from the RegisterNodes service (shallow copy). The
+     * MonitoredItem keeps the NodeId, as it can outlive the handle. */
+    UA_MonitoredItemCreateRequest resolvedRequest = *request;
+    resolvedRequest.itemToMonitor.nodeId =
+        *UA_Session_resolveNodeId(session, &request->itemToMonitor.nodeId);
+    request = &resolvedRequest;
+
     /* Check available capacity */
     if(!cmc->localMon &&
        (((server->config.maxMonitoredItems != 0) &&
@@ -641,16 +652,18 @@ Service_CreateMonitoredItems(UA_Server *server, UA_Session *session,
 }
 
 UA_MonitoredItemCreateResult
-UA_Server_createDataChangeMonitoredItem(UA_Server *server,
-                                        UA_TimestampsToReturn timestampsToReturn,
-                                        const UA_MonitoredItemCreateRequest item,
-                                        void *monitoredItemContext,
-                                        UA_Server_DataChangeNotificationCallback callback) {
+createDataChangeMonitoredItem(UA_Server *server,
+                              UA_TimestampsToReturn timestampsToReturn,
+                              const UA_MonitoredItemCreateRequest *item,
+                              void *monitoredItemContext,
+                              UA_Server_DataChangeNotificationCallback callback) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
     UA_MonitoredItemCreateResult result;
     UA_MonitoredItemCreateResult_init(&result);
 
     /* Check that we don't use the DataChange callback for events */
-    if(item.itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
+    if(item->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
         UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
                      "DataChange-MonitoredItem cannot be created for the "
                      "EventNotifier attribute");
@@ -673,10 +686,7 @@ UA_Server_createDataChangeMonitoredItem(UA_Server *server,
     cmc.sub = server->adminSubscription;
     cmc.localMon = localMon;
     cmc.timestampsToReturn = timestampsToReturn;
-
-    lockServer(server);
-    Operation_CreateMonitoredItem(server, &server->adminSession, &cmc, &item, &result);
-    unlockServer(server);
+    Operation_CreateMonitoredItem(server, &server->adminSession, &cmc, item, &result);
 
     /* If this failed, clean up the local MonitoredItem structure */
     if(result.statusCode != UA_STATUSCODE_GOOD && cmc.localMon)
@@ -685,6 +695,20 @@ UA_Server_createDataChangeMonitoredItem(UA_Server *server,
     return result;
 }
 
+UA_MonitoredItemCreateResult
+UA_Server_createDataChangeMonitoredItem(UA_Server *server,
+                                        UA_TimestampsToReturn timestampsToReturn,
+                                        const UA_MonitoredItemCreateRequest item,
+                                        void *monitoredItemContext,
+                                        UA_Server_DataChangeNotificationCallback callback) {
+    lockServer(server);
+    UA_MonitoredItemCreateResult result =
+        createDataChangeMonitoredItem(server, timestampsToReturn, &item,
+                                      monitoredItemContext, callback);
+    unlockServer(server);
+    return result;
+}
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 UA_MonitoredItemCreateResult
 UA_Server_createEventMonitoredItemEx(UA_Server *server,
@@ -1037,22 +1061,28 @@ Service_DeleteMonitoredItems(UA_Server *server, UA_Session *session,
 }
 
 UA_StatusCode
-UA_Server_deleteMonitoredItem(UA_Server *server, UA_UInt32 monitoredItemId) {
-    lockServer(server);
+deleteMonitoredItem(UA_Server *server, UA_UInt32 monitoredItemId) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    UA_StatusCode res = UA_ServiceWorkers_checkModify(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
 
     UA_Subscription *sub = server->adminSubscription;
-    UA_MonitoredItem *mon;
-    LIST_FOREACH(mon, &sub->monitoredItems, listEntry) {
-        if(mon->monitoredItemId == monitoredItemId)
-            break;
-    }
+    if(!sub)
+        return UA_STATUSCODE_BADMONITOREDITEMIDINVALID;
+    UA_MonitoredItem *mon = UA_Subscription_getMonitoredItem(sub, monitoredItemId);
+    if(!mon)
+        return UA_STATUSCODE_BADMONITOREDITEMIDINVALID;
 
-    UA_StatusCode res = UA_STATUSCODE_BADMONITOREDITEMIDINVALID;
-    if(mon) {
-        UA_MonitoredItem_delete(server, mon, true);
-        res = UA_STATUSCODE_GOOD;
-    }
+    UA_MonitoredItem_delete(server, mon, true);
+    return UA_STATUSCODE_GOOD;
+}
 
+UA_StatusCode
+UA_Server_deleteMonitoredItem(UA_Server *server, UA_UInt32 monitoredItemId) {
+    lockServer(server);
+    UA_StatusCode res = deleteMonitoredItem(server, monitoredItemId);
     unlockServer(server);
     return res;
 }
@@ -857,6 +857,11 @@ copyChildNode(UA_Server *server, UA_Session *session,
 
     /* Add the node to the nodestore */
     UA_NodeId newNodeId = UA_NODEID_NULL;
+    res = UA_ServiceWorkers_checkModify(server);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_NODESTORE_DELETE(server, node);
+        return res;
+    }
     res = UA_NODESTORE_INSERT(server, node, &newNodeId);
     /* node = NULL; The pointer is no longer valid */
     if(res != UA_STATUSCODE_GOOD)
@@ -1249,6 +1254,10 @@ addNode_raw(UA_Server *server, UA_Session *session, void *nodeContext,
             const UA_AddNodesItem *item, UA_NodeId *outNewNodeId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    UA_StatusCode res = UA_ServiceWorkers_checkModify(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
     /* Do not check access for server */
     if(session != &server->adminSession && server->config.accessControl.allowAddNode) {
         if(!server->config.accessControl.
@@ -1849,10 +1858,20 @@ Operation_addNode(UA_Server *server, UA_Session *session,
                   const void *request /* UA_AddNodesItem */,
                   void *response /* UA_AddNodesResult */) {
     void *nodeContext = (void*)(uintptr_t)context;
-    const UA_AddNodesItem *item = (const UA_AddNodesItem*)request;
     UA_AddNodesResult *result = (UA_AddNodesResult*)response;
+
+    /* Resolve handles from the RegisterNodes service (shallow copy) */
+    UA_AddNodesItem item = *(const UA_AddNodesItem*)request;
+    if(UA_ExpandedNodeId_isLocal(&item.parentNodeId))
+        item.parentNodeId.nodeId =
+            *UA_Session_resolveNodeId(session, &item.parentNodeId.nodeId);
+    item.referenceTypeId = *UA_Session_resolveNodeId(session, &item.referenceTypeId);
+    if(UA_ExpandedNodeId_isLocal(&item.typeDefinition))
+        item.typeDefinition.nodeId =
+            *UA_Session_resolveNodeId(session, &item.typeDefinition.nodeId);
+
     beginModelChange(server);
-    Operation_addNode_inner(server, session, nodeContext, item, result);
+    Operation_addNode_inner(server, session, nodeContext, &item, result);
     endModelChange(server);
 }
 
@@ -2391,11 +2410,19 @@ deleteNodeOperation(UA_Server *server, UA_Session *session,
                     const void *context /* unused */,
                     const void *request /* UA_DeleteNodesItem */,
                     void *response /* UA_StatusCode */) {
-    const UA_DeleteNodesItem *item = (const UA_DeleteNodesItem*)request;
     UA_StatusCode *result = (UA_StatusCode*)response;
     (void)context;
+
+    *result = UA_ServiceWorkers_checkModify(server);
+    if(*result != UA_STATUSCODE_GOOD)
+        return;
+
+    /* Resolve a handle from the RegisterNodes service (shallow copy) */
+    UA_DeleteNodesItem item = *(const UA_DeleteNodesItem*)request;
+    item.nodeId = *UA_Session_resolveNodeId(session, &item.nodeId);
+
     beginModelChange(server);
-    deleteNodeOperation_inner(server, session, item, result);
+    deleteNodeOperation_inner(server, session, &item, result);
     endModelChange(server);
 }
 
@@ -2451,7 +2478,9 @@ deleteNode(UA_Server *server, const UA_NodeId nodeId,
     UA_DeleteNodesItem item;
     item.deleteTargetReferences = deleteReferences;
     item.nodeId = nodeId;
-    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+    UA_StatusCode retval = UA_ServiceWorkers_checkModify(server);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     server->modelChangeSuppressionDepth++;
 #endif
@@ -2607,6 +2636,10 @@ Operation_addReference_inner(UA_Server *server, UA_Session *session, void *conte
 
  cleanup:
     if(*retval == UA_STATUSCODE_GOOD) {
+        /* The subtype relation has changed */
+        if(refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE &&
+           (firstChanged || secondChanged))
+            clearSuperTypes(server);
         if(firstChanged)
             recordModelChangeEvent(server, &item->sourceNodeId,
                               UA_MODELCHANGESTRUCTUREVERBMASK_REFERENCEADDED);
@@ -2625,10 +2658,22 @@ Operation_addReference(UA_Server *server, UA_Session *session,
                        const void *request /* UA_AddReferencesItem */,
                        void *response /* UA_StatusCode */) {
     void *operationContext = (void*)(uintptr_t)context;
-    const UA_AddReferencesItem *item = (const UA_AddReferencesItem*)request;
     UA_StatusCode *retval = (UA_StatusCode*)response;
+
+    *retval = UA_ServiceWorkers_checkModify(server);
+    if(*retval != UA_STATUSCODE_GOOD)
+        return;
+
+    /* Resolve handles from the RegisterNodes service (shallow copy) */
+    UA_AddReferencesItem item = *(const UA_AddReferencesItem*)request;
+    item.sourceNodeId = *UA_Session_resolveNodeId(session, &item.sourceNodeId);
+    item.referenceTypeId = *UA_Session_resolveNodeId(session, &item.referenceTypeId);
+    if(UA_ExpandedNodeId_isLocal(&item.targetNodeId))
+        item.targetNodeId.nodeId =
+            *UA_Session_resolveNodeId(session, &item.targetNodeId.nodeId);
+
     beginModelChange(server);
-    Operation_addReference_inner(server, session, operationContext, item, retval);
+    Operation_addReference_inner(server, session, operationContext, &item, retval);
     endModelChange(server);
 }
 
@@ -2737,6 +2782,8 @@ Operation_deleteReference_inner(UA_Server *server, UA_Session *session, void *co
     UA_NODESTORE_RELEASE(server, firstNode);
     if(*retval != UA_STATUSCODE_GOOD)
         return;
+    if(refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE)
+        clearSuperTypes(server); /* The subtype relation has changed */
     recordModelChangeEvent(server, &item->sourceNodeId,
                       UA_MODELCHANGESTRUCTUREVERBMASK_REFERENCEDELETED);
 
@@ -2769,10 +2816,22 @@ Operation_deleteReference(UA_Server *server, UA_Session *session,
                           const void *request /* UA_DeleteReferencesItem */,
                           void *response /* UA_StatusCode */) {
     void *operationContext = (void*)(uintptr_t)context;
-    const UA_DeleteReferencesItem *item = (const UA_DeleteReferencesItem*)request;
     UA_StatusCode *retval = (UA_StatusCode*)response;
+
+    *retval = UA_ServiceWorkers_checkModify(server);
+    if(*retval != UA_STATUSCODE_GOOD)
+        return;
+
+    /* Resolve handles from the RegisterNodes service (shallow copy) */
+    UA_DeleteReferencesItem item = *(const UA_DeleteReferencesItem*)request;
+    item.sourceNodeId = *UA_Session_resolveNodeId(session, &item.sourceNodeId);
+    item.referenceTypeId = *UA_Session_resolveNodeId(session, &item.referenceTypeId);
+    if(UA_ExpandedNodeId_isLocal(&item.targetNodeId))
+        item.targetNodeId.nodeId =
+            *UA_Session_resolveNodeId(session, &item.targetNodeId.nodeId);
+
     beginModelChange(server);
-    Operation_deleteReference_inner(server, session, operationContext, item, retval);
+    Operation_deleteReference_inner(server, session, operationContext, &item, retval);
     endModelChange(server);
 }
 
@@ -107,6 +107,10 @@ UA_Session_remove(UA_Server *server, UA_Session *session,
     /* Detach the Session from the SecureChannel */
     UA_Session_detachFromSecureChannel(server, session);
 
+    /* Release the registered nodes while the Nodestore is still there. The
+     * Session memory is freed in a delayed callback. */
+    UA_Session_unregisterAllNodes(server, session);
+
     /* Deactivate the session */
     if(session->activated) {
         session->activated = false;
@@ -117,6 +121,8 @@ UA_Session_remove(UA_Server *server, UA_Session *session,
      * available */
     session_list_entry *sentry = container_of(session, session_list_entry, session);
     LIST_REMOVE(sentry, pointers);
+    ZIP_REMOVE(UA_SessionTokenTree, &server->sessionsByToken, sentry);
+    ZIP_REMOVE(UA_SessionIdTree, &server->sessionsById, sentry);
     server->sessionCount--;
 
     switch(shutdownReason) {
@@ -180,12 +186,9 @@ UA_Session *
 findSessionByToken(UA_Server *server, const UA_NodeId *token) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    session_list_entry *current = NULL;
-    LIST_FOREACH(current, &server->sessions, pointers) {
-        if(UA_NodeId_equal(&current->session.authenticationToken, token))
-            return &current->session;
-    }
-    return NULL;
+    session_list_entry *current =
+        ZIP_FIND(UA_SessionTokenTree, &server->sessionsByToken, token);
+    return (current) ? &current->session : NULL;
 }
 
 UA_Session *
@@ -213,12 +216,9 @@ getSessionById(UA_Server *server, const UA_NodeId *sessionId) {
     if(!sessionId)
         return NULL;
 
-    session_list_entry *current = NULL;
-    LIST_FOREACH(current, &server->sessions, pointers) {
-        /* Token does not match */
-        if(!UA_NodeId_equal(&current->session.sessionId, sessionId))
-            continue;
-
+    session_list_entry *current =
+        ZIP_FIND(UA_SessionIdTree, &server->sessionsById, sessionId);
+    if(current) {
         /* Session has timed out */
         UA_EventLoop *el = server->config.eventLoop;
         UA_DateTime now = el->dateTime_nowMonotonic(el);
@@ -227,7 +227,6 @@ getSessionById(UA_Server *server, const UA_NodeId *sessionId) {
                                    "Client tries to use a session that has timed out");
             return NULL;
         }
-
         return &current->session;
     }
 
@@ -462,6 +461,8 @@ UA_Session_create(UA_Server *server, UA_SecureChannel *channel,
 
     /* Add to the server */
     LIST_INSERT_HEAD(&server->sessions, newentry, pointers);
+    ZIP_INSERT(UA_SessionTokenTree, &server->sessionsByToken, newentry);
+    ZIP_INSERT(UA_SessionIdTree, &server->sessionsById, newentry);
     server->sessionCount++;
 
     /* Notify the application */
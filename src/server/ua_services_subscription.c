@@ -135,6 +135,7 @@ Service_CreateSubscription(UA_Server *server, UA_Session *session,
 
     /* Register the subscription in the server */
     LIST_INSERT_HEAD(&server->subscriptions, sub, serverListEntry);
+    ZIP_INSERT(UA_ServerSubscriptionTree, &server->subscriptionsById, sub);
     server->subscriptionsSize++;
 
     /* Update the server statistics */
@@ -628,7 +629,9 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
      * diagnostic counter updates when it is deleted */
     sub->wasTransferred = true;
 
-    /* Move over the MonitoredItems and adjust the backpointers */
+    /* Move over the MonitoredItems and adjust the backpointers. The
+     * MonitoredItemId index was copied with the struct and keeps its keys. */
+    ZIP_INIT(&sub->monitoredItemsById);
     LIST_INIT(&newSub->monitoredItems);
     UA_MonitoredItem *mon, *mon_tmp;
     LIST_FOREACH_SAFE(mon, &sub->monitoredItems, listEntry, mon_tmp) {
@@ -673,6 +676,7 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
     /* Add to the server */
     UA_assert(newSub->subscriptionId == sub->subscriptionId);
     LIST_INSERT_HEAD(&server->subscriptions, newSub, serverListEntry);
+    ZIP_INSERT(UA_ServerSubscriptionTree, &server->subscriptionsById, newSub);
     server->subscriptionsSize++;
 
     /* Attach to the session */
@@ -184,6 +184,120 @@ isNodeInTree_singleRef(UA_Server *server, const UA_NodeId *leafNode,
     return isNodeInTree(server, leafNode, nodeToFind, &reftypes);
 }
 
+/***************************/
+/* Cached Subtype Relation */
+/***************************/
+
+static enum ZIP_CMP
+cmpSuperTypes(const void *a, const void *b) {
+    return (enum ZIP_CMP)UA_NodeId_order((const UA_NodeId*)a,
+                                         (const UA_NodeId*)b);
+}
+
+ZIP_FUNCTIONS(UA_SuperTypesTree, UA_SuperTypes, zipfields,
+              UA_NodeId, typeId, cmpSuperTypes)
+
+static void *
+deleteSuperTypes(void *context, UA_SuperTypes *st) {
+    UA_NodeId_clear(&st->typeId);
+    UA_Array_delete(st->superTypes, st->superTypesSize,
+                    &UA_TYPES[UA_TYPES_NODEID]);
+    UA_free(st);
+    return NULL;
+}
+
+void
+clearSuperTypes(UA_Server *server) {
+    if(server->superTypesSize == 0)
+        return;
+    ZIP_ITER(UA_SuperTypesTree, &server->superTypes, deleteSuperTypes, NULL);
+    ZIP_INIT(&server->superTypes);
+    server->superTypesSize = 0;
+}
+
+static UA_Boolean
+containsSuperType(const UA_SuperTypes *st, const UA_NodeId *superType) {
+    for(size_t i = 0; i < st->superTypesSize; i++) {
+        if(UA_NodeId_equal(&st->superTypes[i], superType))
+            return true;
+    }
+    return false;
+}
+
+/* Compute the supertypes with a recursive browse and add them to the cache */
+static UA_SuperTypes *
+addSuperTypes(UA_Server *server, const UA_NodeId *type) {
+    UA_ReferenceTypeSet reftypes = UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE);
+    UA_ExpandedNodeId *superTypes = NULL;
+    size_t superTypesSize = 0;
+    UA_StatusCode res =
+        browseRecursive(server, 1, type, UA_BROWSEDIRECTION_INVERSE, &reftypes,
+                        UA_NODECLASS_UNSPECIFIED, true, &superTypesSize, &superTypes);
+    if(res != UA_STATUSCODE_GOOD)
+        return NULL;
+
+    UA_SuperTypes *st = (UA_SuperTypes*)UA_calloc(1, sizeof(UA_SuperTypes));
+    if(!st)
+        goto error;
+    if(superTypesSize > 0) {
+        st->superTypes = (UA_NodeId*)
+            UA_Array_new(superTypesSize, &UA_TYPES[UA_TYPES_NODEID]);
+        if(!st->superTypes)
+            goto error;
+    }
+    res = UA_NodeId_copy(type, &st->typeId);
+    if(res != UA_STATUSCODE_GOOD)
+        goto error;
+
+    /* Move the local NodeIds */
+    for(size_t i = 0; i < superTypesSize; i++) {
+        if(!UA_ExpandedNodeId_isLocal(&superTypes[i]))
+            continue;
+        st->superTypes[st->superTypesSize++] = superTypes[i].nodeId;
+        UA_NodeId_init(&superTypes[i].nodeId);
+    }
+    UA_Array_delete(superTypes, superTypesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+
+    if(server->superTypesSize >= UA_SUPERTYPES_MAX)
+        clearSuperTypes(server);
+    ZIP_INSERT(UA_SuperTypesTree, &server->superTypes, st);
+    server->superTypesSize++;
+    return st;
+
+ error:
+    if(st) {
+        UA_free(st->superTypes);
+        UA_free(st);
+    }
+    UA_Array_delete(superTypes, superTypesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    return NULL;
+}
+
+UA_Boolean
+isSubtypeOf(UA_Server *server, const UA_NodeId *type, const UA_NodeId *superType) {
+    if(UA_NodeId_equal(type, superType))
+        return true;
+
+    /* Use the cached supertypes */
+    UA_SuperTypes *st = ZIP_FIND(UA_SuperTypesTree, &server->superTypes, type);
+    if(st)
+        return containsSuperType(st, superType);
+
+    /* The read-only services in the worker threads don't modify the cache */
+#ifdef UA_SERVICEWORKERS
+    if(UA_ServiceWorkers_isWorker(server))
+        return isNodeInTree_singleRef(server, type, superType,
+                                      UA_REFERENCETYPEINDEX_HASSUBTYPE);
+#endif
+
+    /* Compute and cache the supertypes */
+    st = addSuperTypes(server, type);
+    if(!st)
+        return isNodeInTree_singleRef(server, type, superType,
+                                      UA_REFERENCETYPEINDEX_HASSUBTYPE);
+    return containsSuperType(st, superType);
+}
+
 static enum ZIP_CMP
 cmpTarget(const void *a, const void *b) {
     const RefEntry *aa = (const RefEntry*)a;
@@ -910,6 +1024,9 @@ Operation_BrowseWithContextAndNode(UA_Server *server, UA_Session *session,
     memset(&cp, 0, sizeof(ContinuationPoint));
     cp.maxReferences = context->maxReferences;
     cp.browseDescription = *descr; /* Shallow copy. Deep-copy later if we persist the cp. */
+    cp.browseDescription.nodeId = *UA_Session_resolveNodeId(session, &descr->nodeId);
+    cp.browseDescription.referenceTypeId =
+        *UA_Session_resolveNodeId(session, &descr->referenceTypeId);
 
     /* How many references can we return at most? */
     if(cp.maxReferences == 0) {
@@ -1000,7 +1117,7 @@ Operation_BrowseWithContextAndNode(UA_Server *server, UA_Session *session,
     }
 
     /* The BrowseDescription is only a shallow copy so far */
-    retval = UA_BrowseDescription_copy(descr, &cp2->browseDescription);
+    retval = UA_BrowseDescription_copy(&cp.browseDescription, &cp2->browseDescription);
     if(retval != UA_STATUSCODE_GOOD)
         goto cleanup;
     cp2->maxReferences = cp.maxReferences;
@@ -1545,8 +1662,11 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
                                        const void *context /* UA_UInt32 */,
                                        const void *request /* UA_BrowsePath */,
                                        void *response /* UA_BrowsePathResult */) {
+    /* Resolve a handle from the RegisterNodes service (shallow copy) */
+    UA_BrowsePath path = *(const UA_BrowsePath*)request;
+    path.startingNode = *UA_Session_resolveNodeId(session, &path.startingNode);
     Operation_TranslateBrowsePathToNodeIdsWithNode(
-        server, session, NULL, context, request, response);
+        server, session, NULL, context, &path, response);
 }
 
 UA_BrowsePathResult
@@ -1670,7 +1790,6 @@ Service_RegisterNodes(UA_Server *server, UA_Session *session,
                          "Processing RegisterNodesRequest");
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    //TODO: hang the nodeids to the session if really needed
     if(request->nodesToRegisterSize == 0) {
         response->responseHeader.serviceResult = UA_STATUSCODE_BADNOTHINGTODO;
         return true;
@@ -1683,12 +1802,46 @@ Service_RegisterNodes(UA_Server *server, UA_Session *session,
         return true;
     }
 
-    response->responseHeader.serviceResult =
-        UA_Array_copy(request->nodesToRegister, request->nodesToRegisterSize,
-                      (void**)&response->registeredNodeIds, &UA_TYPES[UA_TYPES_NODEID]);
-    if(response->responseHeader.serviceResult == UA_STATUSCODE_GOOD)
-        response->registeredNodeIdsSize = request->nodesToRegisterSize;
+    response->registeredNodeIds = (UA_NodeId*)
+        UA_Array_new(request->nodesToRegisterSize, &UA_TYPES[UA_TYPES_NODEID]);
+    if(!response->registeredNodeIds) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return true;
+    }
+    response->registeredNodeIdsSize = request->nodesToRegisterSize;
+
+    /* Create handles that resolve to the nodes cached in the session */
+    size_t withoutHandle = 0;
+    for(size_t i = 0; i < request->nodesToRegisterSize; i++) {
+        UA_StatusCode res =
+            UA_Session_registerNode(server, session, &request->nodesToRegister[i],
+                                    &response->registeredNodeIds[i]);
+        if(res == UA_STATUSCODE_GOOD) {
+            if(!isRegisteredNodeHandle(&response->registeredNodeIds[i]))
+                withoutHandle++;
+            continue;
+        }
+        /* Roll back */
+        for(size_t j = 0; j < i; j++)
+            UA_Session_unregisterNode(server, session,
+                                      &response->registeredNodeIds[j]);
+        UA_Array_delete(response->registeredNodeIds, response->registeredNodeIdsSize,
+                        &UA_TYPES[UA_TYPES_NODEID]);
+        response->registeredNodeIds = NULL;
+        response->registeredNodeIdsSize = 0;
+        response->responseHeader.serviceResult = res;
+        return true;
+    }
 
+    /* The NodeIds are still usable. But they don't have the fast path. */
+    if(withoutHandle > 0)
+        UA_LOG_WARNING_SESSION(server->config.logging, session,
+                               "RegisterNodes: %lu NodeIds are returned without "
+                               "a handle (registered nodes: %lu, "
+                               "maxRegisteredNodesPerSession: %lu)",
+                               (unsigned long)withoutHandle,
+                               (unsigned long)session->registeredNodesSize,
+                               (unsigned long)UA_Session_maxRegisteredNodes(server));
     return true;
 }
 
@@ -1706,6 +1859,10 @@ Service_UnregisterNodes(UA_Server *server, UA_Session *session,
     } else if(server->config.maxNodesPerRegisterNodes != 0 &&
               request->nodesToUnregisterSize > server->config.maxNodesPerRegisterNodes) {
         response->responseHeader.serviceResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+    } else {
+        for(size_t i = 0; i < request->nodesToUnregisterSize; i++)
+            UA_Session_unregisterNode(server, session,
+                                      &request->nodesToUnregister[i]);
     }
 
     return true;
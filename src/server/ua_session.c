@@ -24,6 +24,7 @@ void UA_Session_init(UA_Session *session) {
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     SIMPLEQ_INIT(&session->responseQueue);
     TAILQ_INIT(&session->subscriptions);
+    ZIP_INIT(&session->subscriptionsById);
 #endif
 }
 
@@ -44,6 +45,7 @@ void UA_Session_clear(UA_Session *session, UA_Server* server) {
 #endif
 
     UA_Session_detachFromSecureChannel(server, session);
+    UA_Session_unregisterAllNodes(server, session);
     UA_ApplicationDescription_clear(&session->clientDescription);
     UA_ByteString_clear(&session->clientCertificate);
     UA_NodeId_clear(&session->authenticationToken);
@@ -190,6 +192,190 @@ UA_Session_updateLifetime(UA_Session *session, UA_DateTime now,
 #endif
 }
 
+/********************/
+/* Registered Nodes */
+/********************/
+
+static UA_RegisteredNode *
+findRegisteredNode(const UA_Session *session, const UA_NodeId *handle) {
+    if(!session || !isRegisteredNodeHandle(handle))
+        return NULL;
+    size_t index = handle->identifier.numeric & 0xFFFF;
+    UA_UInt16 generation = (UA_UInt16)(handle->identifier.numeric >> 16);
+    if(index >= session->registeredNodesSize)
+        return NULL;
+    UA_RegisteredNode *rn = &session->registeredNodes[index];
+    if(!rn->used || rn->generation != generation)
+        return NULL;
+    return rn;
+}
+
+size_t
+UA_Session_maxRegisteredNodes(const UA_Server *server) {
+    UA_UInt32 max = server->config.maxRegisteredNodesPerSession;
+    return (max == 0 || max > UA_MAXREGISTEREDNODES) ? UA_MAXREGISTEREDNODES : max;
+}
+
+static UA_StatusCode
+growRegisteredNodes(UA_Session *session, size_t maxSize) {
+    size_t oldSize = session->registeredNodesSize;
+    size_t newSize = (oldSize > 0) ? oldSize * 2 : 8;
+    if(newSize > maxSize)
+        newSize = maxSize;
+    UA_RegisteredNode *rns = (UA_RegisteredNode*)
+        UA_realloc(session->registeredNodes, newSize * sizeof(UA_RegisteredNode));
+    if(!rns)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    memset(&rns[oldSize], 0, (newSize - oldSize) * sizeof(UA_RegisteredNode));
+
+    /* Add the new entries to the free-list. The lowest index comes first. */
+    for(size_t i = newSize; i > oldSize; i--) {
+        rns[i-1].generation = 1;
+        rns[i-1].nextFree = session->registeredNodesFree;
+        session->registeredNodesFree = i;
+    }
+    session->registeredNodes = rns;
+    session->registeredNodesSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Session_registerNode(UA_Server *server, UA_Session *session,
+                        const UA_NodeId *nodeId, UA_NodeId *outHandle) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    /* Register the original NodeId if a handle is registered again */
+    nodeId = UA_Session_resolveNodeId(session, nodeId);
+
+    /* Without a free entry, return the NodeId itself. Clients must accept
+     * that RegisterNodes returns the original NodeIds. */
+    size_t maxSize = UA_Session_maxRegisteredNodes(server);
+    if(session->registeredNodesFree == 0 &&
+       (session->registeredNodesSize >= maxSize ||
+        growRegisteredNodes(session, maxSize) != UA_STATUSCODE_GOOD))
+        return UA_NodeId_copy(nodeId, outHandle);
+
+    size_t index = session->registeredNodesFree - 1;
+    UA_RegisteredNode *rn = &session->registeredNodes[index];
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &rn->nodeId);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    session->registeredNodesFree = rn->nextFree;
+    rn->nextFree = 0;
+    rn->used = true;
+
+    /* The node is resolved now and kept until it is unregistered. Unknown
+     * NodeIds can still be registered. They are resolved when used. */
+    rn->node = UA_NODESTORE_GET(server, nodeId);
+
+    UA_NodeId_init(outHandle);
+    outHandle->namespaceIndex = UA_REGISTEREDNODES_NS;
+    outHandle->identifier.numeric =
+        ((UA_UInt32)rn->generation << 16) | (UA_UInt32)index;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+releaseRegisteredNode(UA_Server *server, UA_Session *session,
+                      UA_RegisteredNode *rn) {
+    if(rn->node)
+        UA_NODESTORE_RELEASE(server, rn->node);
+    rn->node = NULL;
+    UA_NodeId_clear(&rn->nodeId);
+    rn->used = false;
+
+    /* Invalidate the handle. The generation is never zero. */
+    rn->generation++;
+    if(rn->generation == 0)
+        rn->generation = 1;
+
+    rn->nextFree = session->registeredNodesFree;
+    session->registeredNodesFree = (size_t)(rn - session->registeredNodes) + 1;
+}
+
+void
+UA_Session_unregisterNode(UA_Server *server, UA_Session *session,
+                          const UA_NodeId *handle) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_RegisteredNode *rn = findRegisteredNode(session, handle);
+    if(rn)
+        releaseRegisteredNode(server, session, rn);
+}
+
+void
+UA_Session_unregisterAllNodes(UA_Server *server, UA_Session *session) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    for(size_t i = 0; i < session->registeredNodesSize; i++) {
+        UA_RegisteredNode *rn = &session->registeredNodes[i];
+        if(!rn->used)
+            continue;
+        if(rn->node)
+            UA_NODESTORE_RELEASE(server, rn->node);
+        UA_NodeId_clear(&rn->nodeId);
+    }
+    UA_free(session->registeredNodes);
+    session->registeredNodes = NULL;
+    session->registeredNodesSize = 0;
+    session->registeredNodesFree = 0;
+}
+
+const UA_NodeId *
+UA_Session_resolveNodeId(const UA_Session *session, const UA_NodeId *nodeId) {
+    UA_RegisteredNode *rn = findRegisteredNode(session, nodeId);
+    return (rn) ? &rn->nodeId : nodeId;
+}
+
+static const UA_Node *
+getRegisteredNode(UA_Server *server, UA_Session *session,
+                  const UA_NodeId *handle, UA_Boolean edit) {
+    UA_RegisteredNode *rn = findRegisteredNode(session, handle);
+    if(!rn)
+        return NULL;
+
+    /* The Nodestore returns the cached node directly if it is still current.
+     * Otherwise the registered NodeId is looked up. */
+    UA_Nodestore *ns = server->config.nodestore;
+    if(edit)
+        UA_NODESTORE_BORROWED_COPY(server);
+    UA_NodePointer ptr = (rn->node) ?
+        UA_NodePointer_fromNode(&rn->node->head) :
+        UA_NodePointer_fromNodeId(&rn->nodeId);
+    const UA_Node *node = (edit) ?
+        ns->getEditNodeFromPtr(ns, ptr, UA_NODEATTRIBUTESMASK_ALL,
+                               UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH) :
+        ns->getNodeFromPtr(ns, ptr, UA_NODEATTRIBUTESMASK_ALL,
+                           UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    if(node == rn->node)
+        return node;
+
+    /* The node was removed, replaced or added in the meantime. Cache the
+     * current node instead. In a parallel batch of the service workers, the
+     * jobs of a session are executed by one thread. The update is serialized
+     * with the other threads nonetheless, as releasing the replaced node can
+     * delete it from the Nodestore. Outside of a batch, the server lock is
+     * sufficient. */
+    UA_ServiceWorkers_lockAsync(server);
+    const UA_Node *old = rn->node;
+    rn->node = (node) ?
+        UA_NODESTORE_GETFROMREF(server, UA_NodePointer_fromNode(&node->head)) : NULL;
+    if(old)
+        UA_NODESTORE_RELEASE(server, old);
+    UA_ServiceWorkers_unlockAsync(server);
+    return node;
+}
+
+const UA_Node *
+UA_Session_getRegisteredNode(UA_Server *server, UA_Session *session,
+                             const UA_NodeId *handle) {
+    return getRegisteredNode(server, session, handle, false);
+}
+
+UA_Node *
+UA_Session_getRegisteredEditNode(UA_Server *server, UA_Session *session,
+                                 const UA_NodeId *handle) {
+    return (UA_Node*)(uintptr_t)getRegisteredNode(server, session, handle, true);
+}
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS
 
 void
@@ -203,6 +389,9 @@ UA_Session_attachSubscription(UA_Session *session, UA_Subscription *sub) {
     /* Increase the number of outstanding retransmissions */
     session->totalRetransmissionQueueSize += sub->retransmissionQueueSize;
 
+    /* Index by the SubscriptionId */
+    ZIP_INSERT(UA_SessionSubscriptionTree, &session->subscriptionsById, sub);
+
     /* Insert at the end of the subscriptions of the same priority / just before
      * the subscriptions with the next lower priority. */
     UA_Subscription *after = NULL;
@@ -221,6 +410,7 @@ UA_Session_detachSubscription(UA_Server *server, UA_Session *session,
     /* Detach from the session */
     sub->session = NULL;
     TAILQ_REMOVE(&session->subscriptions, sub, sessionListEntry);
+    ZIP_REMOVE(UA_SessionSubscriptionTree, &session->subscriptionsById, sub);
 
     /* Reduce the count */
     UA_assert(session->subscriptionsSize > 0);
@@ -243,30 +433,24 @@ UA_Session_detachSubscription(UA_Server *server, UA_Session *session,
     }
 }
 
+/* Prevent lookup of subscriptions that are to be deleted with a statuschange */
+static void *
+findLiveSubscription(void *context, UA_Subscription *sub) {
+    return (sub->statusChange == UA_STATUSCODE_GOOD) ? sub : NULL;
+}
+
 UA_Subscription *
 UA_Session_getSubscriptionById(UA_Session *session, UA_UInt32 subscriptionId) {
-    UA_Subscription *sub;
-    TAILQ_FOREACH(sub, &session->subscriptions, sessionListEntry) {
-        /* Prevent lookup of subscriptions that are to be deleted with a statuschange */
-        if(sub->statusChange != UA_STATUSCODE_GOOD)
-            continue;
-        if(sub->subscriptionId == subscriptionId)
-            break;
-    }
-    return sub;
+    return (UA_Subscription*)
+        ZIP_ITER_KEY(UA_SessionSubscriptionTree, &session->subscriptionsById,
+                     &subscriptionId, findLiveSubscription, NULL);
 }
 
 UA_Subscription *
 getSubscriptionById(UA_Server *server, UA_UInt32 subscriptionId) {
-    UA_Subscription *sub;
-    LIST_FOREACH(sub, &server->subscriptions, serverListEntry) {
-        /* Prevent lookup of subscriptions that are to be deleted with a statuschange */
-        if(sub->statusChange != UA_STATUSCODE_GOOD)
-            continue;
-        if(sub->subscriptionId == subscriptionId)
-            break;
-    }
-    return sub;
+    return (UA_Subscription*)
+        ZIP_ITER_KEY(UA_ServerSubscriptionTree, &server->subscriptionsById,
+                     &subscriptionId, findLiveSubscription, NULL);
 }
 
 UA_PublishResponseEntry*
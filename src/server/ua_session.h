@@ -10,15 +10,33 @@
 #ifndef UA_SESSION_H_
 #define UA_SESSION_H_
 
+#include <open62541/plugin/nodestore.h>
 #include <open62541/plugin/securitypolicy.h>
 #include <open62541/util.h>
 
 #include "../ua_securechannel.h"
+#include "ziptree.h"
 
 _UA_BEGIN_DECLS
 
 #define UA_MAXCONTINUATIONPOINTS 32
 
+/* Handles returned by the RegisterNodes service are numeric NodeIds in a
+ * reserved namespace index. The lower 16 bit of the identifier are the index
+ * into the table of registered nodes in the session. The upper 16 bit are a
+ * generation counter, so that stale handles of reused entries are detected. */
+#define UA_REGISTEREDNODES_NS UA_UINT16_MAX
+#define UA_MAXREGISTEREDNODES 65536 /* Limited by the 16 bit index */
+
+typedef struct {
+    UA_NodeId nodeId;     /* The registered NodeId */
+    const UA_Node *node;  /* Cached node, retained from the Nodestore. NULL if
+                           * the node does not (or no longer) exist. */
+    UA_UInt16 generation; /* Part of the handle. Incremented on reuse. */
+    UA_Boolean used;
+    size_t nextFree;      /* Index+1 of the next unused entry */
+} UA_RegisteredNode;
+
 struct ContinuationPoint;
 typedef struct ContinuationPoint ContinuationPoint;
 
@@ -32,6 +50,10 @@ struct UA_Subscription;
 typedef struct UA_Subscription UA_Subscription;
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
+/* Index of the Subscriptions attached to a Session by their SubscriptionId */
+typedef ZIP_HEAD(UA_SessionSubscriptionTree, UA_Subscription)
+    UA_SessionSubscriptionTree;
+
 typedef struct UA_PublishResponseEntry {
     SIMPLEQ_ENTRY(UA_PublishResponseEntry) listEntry;
     UA_UInt64 responseToken;
@@ -84,6 +106,15 @@ struct UA_Session {
     size_t continuationPointsSize;
     ContinuationPointQueue continuationPoints;
 
+    /* Nodes registered with the RegisterNodes service */
+    size_t registeredNodesSize;
+    UA_RegisteredNode *registeredNodes;
+    size_t registeredNodesFree; /* Index+1 of the first unused entry */
+
+    /* The response of the Read service that is currently executed. Its result
+     * values can be borrowed from the nodes (see readZeroCopyThreshold). */
+    const UA_ReadResponse *readResponse;
+
     /* Localization information */
     size_t localeIdsSize;
     UA_String *localeIds;
@@ -95,6 +126,7 @@ struct UA_Session {
      * (round-robin scheduling). */
     size_t subscriptionsSize;
     TAILQ_HEAD(, UA_Subscription) subscriptions;
+    UA_SessionSubscriptionTree subscriptionsById;
 
     size_t responseQueueSize;
     SIMPLEQ_HEAD(, UA_PublishResponseEntry) responseQueue;
@@ -134,6 +166,53 @@ void
 notifySession(UA_Server *server, UA_Session *session,
               UA_ApplicationNotificationType type);
 
+/**
+ * Registered Nodes
+ * ----------------
+ * The handles from the RegisterNodes service resolve to a node that is cached
+ * in the session. The cached node is retained from the Nodestore until it is
+ * unregistered, or until it is removed or replaced in the Nodestore. */
+
+static UA_INLINE UA_Boolean
+isRegisteredNodeHandle(const UA_NodeId *id) {
+    return (id->namespaceIndex == UA_REGISTEREDNODES_NS &&
+            id->identifierType == UA_NODEIDTYPE_NUMERIC);
+}
+
+/* Returns a handle for the NodeId. If no handle can be created (e.g. beyond
+ * the maxRegisteredNodesPerSession limit), a copy of the NodeId is returned
+ * instead. */
+UA_StatusCode
+UA_Session_registerNode(UA_Server *server, UA_Session *session,
+                        const UA_NodeId *nodeId, UA_NodeId *outHandle);
+
+/* The maximum number of handles per session from the server config */
+size_t
+UA_Session_maxRegisteredNodes(const UA_Server *server);
+
+/* Unknown handles are ignored */
+void
+UA_Session_unregisterNode(UA_Server *server, UA_Session *session,
+                          const UA_NodeId *handle);
+
+void
+UA_Session_unregisterAllNodes(UA_Server *server, UA_Session *session);
+
+/* Returns the registered NodeId if the NodeId is a handle of the session.
+ * Otherwise the NodeId itself is returned. */
+const UA_NodeId *
+UA_Session_resolveNodeId(const UA_Session *session, const UA_NodeId *nodeId);
+
+/* Returns the node of a handle. The node has to be released by the caller.
+ * Returns NULL if the handle is unknown or the node no longer exists. */
+const UA_Node *
+UA_Session_getRegisteredNode(UA_Server *server, UA_Session *session,
+                             const UA_NodeId *handle);
+
+UA_Node *
+UA_Session_getRegisteredEditNode(UA_Server *server, UA_Session *session,
+                                 const UA_NodeId *handle);
+
 /**
  * Subscription handling
  * --------------------- */
@@ -36,6 +36,7 @@
 static void UA_Notification_dequeueMon(UA_Notification *n);
 static void UA_Notification_enqueueSub(UA_Notification *n);
 static void UA_Notification_dequeueSub(UA_Notification *n);
+static void UA_NotificationMessageEntry_delete(UA_NotificationMessageEntry *entry);
 
 UA_Notification *
 UA_Notification_new(void) {
@@ -63,6 +64,8 @@ UA_Notification_delete(UA_Notification *n) {
 #endif
     default:
         UA_MonitoredItemNotification_clear(&n->data.dataChange);
+        if(n->sharedValue)
+            UA_SharedValue_release(n->sharedValue);
         break;
     }
     UA_free(n);
@@ -314,6 +317,7 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub, UA_Boolean notif
     /* Remove from the server if not previously registered */
     if(sub->serverListEntry.le_prev) {
         LIST_REMOVE(sub, serverListEntry);
+        ZIP_REMOVE(UA_ServerSubscriptionTree, &server->subscriptionsById, sub);
         UA_assert(server->subscriptionsSize > 0);
         server->subscriptionsSize--;
         /* Only decrement the counter if this subscription was not transferred.
@@ -328,8 +332,7 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub, UA_Boolean notif
     UA_NotificationMessageEntry *nme, *nme_tmp;
     TAILQ_FOREACH_SAFE(nme, &sub->retransmissionQueue, listEntry, nme_tmp) {
         TAILQ_REMOVE(&sub->retransmissionQueue, nme, listEntry);
-        UA_NotificationMessage_clear(&nme->message);
-        UA_free(nme);
+        UA_NotificationMessageEntry_delete(nme);
         if(sub->session)
             --sub->session->totalRetransmissionQueueSize;
         --sub->retransmissionQueueSize;
@@ -359,12 +362,18 @@ Subscription_resetLifetime(UA_Subscription *sub) {
 
 UA_MonitoredItem *
 UA_Subscription_getMonitoredItem(UA_Subscription *sub, UA_UInt32 monitoredItemId) {
-    UA_MonitoredItem *mon;
-    LIST_FOREACH(mon, &sub->monitoredItems, listEntry) {
-        if(mon->monitoredItemId == monitoredItemId)
-            break;
-    }
-    return mon;
+    return ZIP_FIND(UA_MonitoredItemIdTree, &sub->monitoredItemsById,
+                    &monitoredItemId);
+}
+
+/* Also releases the shared values used in the message */
+static void
+UA_NotificationMessageEntry_delete(UA_NotificationMessageEntry *entry) {
+    UA_NotificationMessage_clear(&entry->message);
+    for(size_t i = 0; i < entry->sharedValuesSize; i++)
+        UA_SharedValue_release(entry->sharedValues[i]);
+    UA_free(entry->sharedValues);
+    UA_free(entry);
 }
 
 static void
@@ -372,8 +381,7 @@ removeOldestRetransmissionMessageFromSub(UA_Subscription *sub) {
     UA_NotificationMessageEntry *oldestEntry =
         TAILQ_LAST(&sub->retransmissionQueue, NotificationMessageQueue);
     TAILQ_REMOVE(&sub->retransmissionQueue, oldestEntry, listEntry);
-    UA_NotificationMessage_clear(&oldestEntry->message);
-    UA_free(oldestEntry);
+    UA_NotificationMessageEntry_delete(oldestEntry);
     --sub->retransmissionQueueSize;
     if(sub->session)
         --sub->session->totalRetransmissionQueueSize;
@@ -442,8 +450,7 @@ UA_Subscription_removeRetransmissionMessage(UA_Subscription *sub, UA_UInt32 sequ
     /* Remove the retransmission message */
     TAILQ_REMOVE(&sub->retransmissionQueue, entry, listEntry);
     --sub->retransmissionQueueSize;
-    UA_NotificationMessage_clear(&entry->message);
-    UA_free(entry);
+    UA_NotificationMessageEntry_delete(entry);
 
     if(sub->session)
         --sub->session->totalRetransmissionQueueSize;
@@ -451,11 +458,15 @@ UA_Subscription_removeRetransmissionMessage(UA_Subscription *sub, UA_UInt32 sequ
     return UA_STATUSCODE_GOOD;
 }
 
-/* The output counters are only set when the preparation is successful */
+/* The output counters are only set when the preparation is successful. The
+ * references to the shared values used in the message are moved to the
+ * sharedValues array (with space for maxNotifications entries). */
 static UA_StatusCode
 prepareNotificationMessage(UA_Server *server, UA_Subscription *sub,
                            UA_NotificationMessage *message,
-                           size_t maxNotifications) {
+                           size_t maxNotifications,
+                           UA_SharedValue **sharedValues,
+                           size_t *sharedValuesSize) {
     UA_assert(maxNotifications > 0);
 
     /* Allocate an ExtensionObject for Event- and DataChange-Notifications. Also
@@ -546,6 +557,11 @@ prepareNotificationMessage(UA_Server *server, UA_Subscription *sub,
             UA_assert(dcn != NULL); /* Have at least one change notification */
             dcn->monitoredItems[dcnPos] = n->data.dataChange;
             UA_DataValue_init(&n->data.dataChange.value);
+            if(n->sharedValue) {
+                UA_assert(sharedValues != NULL);
+                sharedValues[(*sharedValuesSize)++] = n->sharedValue;
+                n->sharedValue = NULL;
+            }
             dcnPos++;
             break;
         }
@@ -824,6 +840,8 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     UA_PublishResponse *response = &pre->response;
     UA_NotificationMessage *message = &response->notificationMessage;
     UA_NotificationMessageEntry *retransmission = NULL;
+    UA_SharedValue **sharedValues = NULL;
+    size_t sharedValuesSize = 0;
 #ifdef UA_ENABLE_DIAGNOSTICS
     size_t priorDataChangeNotifications = sub->dataChangeNotifications;
     size_t priorEventNotifications = sub->eventNotifications;
@@ -843,9 +861,16 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
             }
         }
 
+        /* Allocate the array for the shared values used in the message */
+        if(sub->dataChangeNotifications > 0)
+            sharedValues = (UA_SharedValue**)
+                UA_malloc(notifications * sizeof(UA_SharedValue*));
+
         /* Prepare the response */
-        UA_StatusCode retval =
-            prepareNotificationMessage(server, sub, message, notifications);
+        UA_StatusCode retval = (sub->dataChangeNotifications > 0 && !sharedValues) ?
+            UA_STATUSCODE_BADOUTOFMEMORY :
+            prepareNotificationMessage(server, sub, message, notifications,
+                                       sharedValues, &sharedValuesSize);
         if(retval != UA_STATUSCODE_GOOD) {
             UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, sub,
                                         "Could not prepare the notification message. "
@@ -853,10 +878,15 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
             /* If the retransmission queue is enabled a retransmission message is allocated */
             if(retransmission)
                 UA_free(retransmission);
+            UA_free(sharedValues);
             sub->late = true;
             UA_Session_queuePublishReq(sub->session, pre, true); /* Re-enqueue */
             return;
         }
+        if(sharedValuesSize == 0) {
+            UA_free(sharedValues);
+            sharedValues = NULL;
+        }
     }
 
     /* <-- The point of no return --> */
@@ -879,6 +909,8 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
              * needs to be done here, so that the message itself is included in
              * the available sequence numbers for acknowledgement. */
             retransmission->message = response->notificationMessage;
+            retransmission->sharedValues = sharedValues;
+            retransmission->sharedValuesSize = sharedValuesSize;
             UA_Subscription_addRetransmissionMessage(server, sub, retransmission);
         }
         /* Only if a notification was created, the sequence number must be
@@ -930,6 +962,13 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
     UA_PublishResponse_clear(&pre->response);
     UA_free(pre);
 
+    /* Release the shared values if the message is not retained */
+    if(!retransmission) {
+        for(size_t j = 0; j < sharedValuesSize; j++)
+            UA_SharedValue_release(sharedValues[j]);
+        UA_free(sharedValues);
+    }
+
     /* Update the diagnostics statistics */
 #ifdef UA_ENABLE_DIAGNOSTICS
     sub->publishRequestCount++;
@@ -985,7 +1024,8 @@ UA_Subscription_resendData(UA_Server *server, UA_Subscription *sub) {
             continue;
 
         /* Create a notification with the last sampled value */
-        UA_MonitoredItem_createDataChangeNotification(server, mon, &mon->lastValue);
+        UA_MonitoredItem_createDataChangeNotification(server, mon, &mon->lastValue,
+                                                      mon->lastSharedValue);
     }
 }
 
@@ -1298,6 +1338,7 @@ UA_MonitoredItem_register(UA_Server *server, UA_MonitoredItem *mon) {
     mon->monitoredItemId = ++sub->lastMonitoredItemId;
     mon->subscription = sub;
     LIST_INSERT_HEAD(&sub->monitoredItems, mon, listEntry);
+    ZIP_INSERT(UA_MonitoredItemIdTree, &sub->monitoredItemsById, mon);
     sub->monitoredItemsSize++;
     server->monitoredItemsSize++;
 }
@@ -1317,6 +1358,7 @@ unregisterMonitoredItem(UA_Server *server, UA_MonitoredItem *mon) {
     /* Deregister in Subscription and server */
     sub->monitoredItemsSize--;
     LIST_REMOVE(mon, listEntry);
+    ZIP_REMOVE(UA_MonitoredItemIdTree, &sub->monitoredItemsById, mon);
     server->monitoredItemsSize--;
     mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_DELETED;
 }
@@ -1342,7 +1384,7 @@ UA_MonitoredItem_setMonitoringMode(UA_Server *server, UA_MonitoredItem *mon,
         TAILQ_FOREACH_SAFE(notification, &mon->queue, monEntry, notification_tmp) {
             UA_Notification_delete(notification);
         }
-        UA_DataValue_clear(&mon->lastValue);
+        UA_MonitoredItem_clearLastValue(mon);
         return UA_STATUSCODE_GOOD;
     }
 
@@ -1424,7 +1466,7 @@ UA_MonitoredItem_delete(UA_Server *server, UA_MonitoredItem *mon, UA_Boolean not
     UA_MonitoringParameters_clear(&mon->parameters);
 
     /* Remove the last samples */
-    UA_DataValue_clear(&mon->lastValue);
+    UA_MonitoredItem_clearLastValue(mon);
 
     /* If this is a local MonitoredItem, clean up additional values */
     if(mon->subscription == server->adminSubscription) {
@@ -1576,15 +1618,78 @@ UA_MonitoredItem_ensureQueueSpace(UA_Server *server, UA_MonitoredItem *mon) {
     }
 }
 
+/******************/
+/* Sampling Group */
+/******************/
+
 static void
-UA_MonitoredItem_lockAndSample(UA_Server *server,
-                               void *data /* UA_MonitoredItem */) {
-    UA_MonitoredItem *mon = (UA_MonitoredItem*)data;
+UA_SamplingGroup_lockAndSample(UA_Server *server,
+                               void *data /* UA_SamplingGroup */) {
+    UA_SamplingGroup *sg = (UA_SamplingGroup*)data;
     lockServer(server);
-    UA_MonitoredItem_sample(server, mon);
+    UA_SamplingGroup_sample(server, sg);
     unlockServer(server);
 }
 
+static UA_StatusCode
+addToSamplingGroup(UA_Server *server, UA_MonitoredItem *mon) {
+    /* Find the group for the interval */
+    UA_SamplingGroup *sg;
+    LIST_FOREACH(sg, &server->samplingGroups, listEntry) {
+        if(sg->samplingInterval == mon->parameters.samplingInterval)
+            break;
+    }
+
+    /* Create a new group with a repeated callback */
+    if(!sg) {
+        sg = (UA_SamplingGroup*)UA_calloc(1, sizeof(UA_SamplingGroup));
+        if(!sg)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        sg->samplingInterval = mon->parameters.samplingInterval;
+        UA_StatusCode res =
+            addRepeatedCallback(server, UA_SamplingGroup_lockAndSample, sg,
+                                sg->samplingInterval, &sg->callbackId);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(sg);
+            return res;
+        }
+        LIST_INSERT_HEAD(&server->samplingGroups, sg, listEntry);
+    }
+
+    /* Grow the items array */
+    if(sg->itemsSize == sg->itemsCapacity) {
+        size_t newCapacity = (sg->itemsCapacity == 0) ? 8 : sg->itemsCapacity * 2;
+        UA_MonitoredItem **newItems = (UA_MonitoredItem**)
+            UA_realloc(sg->items, newCapacity * sizeof(UA_MonitoredItem*));
+        if(!newItems) {
+            UA_SamplingGroup_removeIfEmpty(server, sg);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        sg->items = newItems;
+        sg->itemsCapacity = newCapacity;
+    }
+
+    /* Append. The array is sorted before the next sampling. */
+    mon->sampling.cyclic.group = sg;
+    mon->sampling.cyclic.index = sg->itemsSize;
+    sg->items[sg->itemsSize++] = mon;
+    sg->liveItems++;
+    sg->unsorted = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+removeFromSamplingGroup(UA_Server *server, UA_MonitoredItem *mon) {
+    UA_SamplingGroup *sg = mon->sampling.cyclic.group;
+    UA_assert(sg->items[mon->sampling.cyclic.index] == mon);
+    sg->items[mon->sampling.cyclic.index] = NULL;
+    mon->sampling.cyclic.group = NULL;
+    sg->liveItems--;
+
+    /* The NULL entry is removed before the next sampling */
+    UA_SamplingGroup_removeIfEmpty(server, sg);
+}
+
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
     UA_LOCK_ASSERT(&server->serviceMutex);
@@ -1629,6 +1734,10 @@ UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
 
     if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER ||
        (mon->parameters.samplingInterval == 0.0 && !extValueSource)) {
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+        if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER)
+            server->eventMonitoredItemsSize++;
+#endif
         mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_EVENT;
         return UA_STATUSCODE_GOOD;
     }
@@ -1642,10 +1751,8 @@ UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
         return res;
     }
 
-    /* Standard sampling with a repeated callback */
-    res = addRepeatedCallback(server, UA_MonitoredItem_lockAndSample,
-                              mon, mon->parameters.samplingInterval,
-                              &mon->sampling.callbackId);
+    /* Standard sampling with the SamplingGroup for the interval */
+    res = addToSamplingGroup(server, mon);
     if(res == UA_STATUSCODE_GOOD) {
         mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC;
     } else {
@@ -1663,8 +1770,8 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
         return;
 
     case UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC:
-        /* Remove repeated callback */
-        removeCallback(server, mon->sampling.callbackId);
+        /* Remove from the SamplingGroup */
+        removeFromSamplingGroup(server, mon);
         break;
 
     case UA_MONITOREDITEMSAMPLINGTYPE_PUBLISH:
@@ -1673,6 +1780,14 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
         break;
 
     case UA_MONITOREDITEMSAMPLINGTYPE_EVENT:
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+        if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
+            UA_assert(server->eventMonitoredItemsSize > 0);
+            server->eventMonitoredItemsSize--;
+        }
+#endif
+        break;
+
     case UA_MONITOREDITEMSAMPLINGTYPE_NONE:
         /* No backend-specific cleanup */
         break;
@@ -40,6 +40,37 @@ _UA_BEGIN_DECLS
  * publication, the notifications are taken out of the Subscription's queue in
  * the order of their creation. */
 
+/*****************/
+/* Shared Values */
+/*****************/
+
+/* The variant of a sampled value is shared between the MonitoredItems that
+ * sample an equal value with the same ReadValueId. For example when many
+ * Sessions monitor the same variable. The lastValue of the MonitoredItems and
+ * their DataChange Notifications point to the shared variant (with
+ * UA_VARIANT_DATA_NODELETE) and hold a reference. The most recent shared value
+ * for each ReadValueId is cached in the server. */
+typedef struct UA_SharedValue {
+    ZIP_ENTRY(UA_SharedValue) zipfields;
+    struct UA_SharedValueTree *cache; /* NULL when no longer cached */
+    UA_ReadValueId key;
+    size_t refCount;
+    UA_Variant value;
+} UA_SharedValue;
+
+typedef ZIP_HEAD(UA_SharedValueTree, UA_SharedValue) UA_SharedValueTree;
+
+/* Move the variant into a shared value. If an equal value is cached for the
+ * ReadValueId, then the variant is cleared and the cached value is returned
+ * instead. The returned value has a reference for the caller. Returns NULL if
+ * the variant is empty or out of memory. The variant is then left untouched. */
+UA_SharedValue *
+UA_SharedValue_share(UA_SharedValueTree *cache, const UA_ReadValueId *key,
+                     UA_Variant *v);
+
+void
+UA_SharedValue_release(UA_SharedValue *sv);
+
 /*****************/
 /* Notifications */
 /*****************/
@@ -58,6 +89,9 @@ typedef struct UA_Notification {
     TAILQ_ENTRY(UA_Notification) monEntry; /* Notification list of the MonitoredItem */
     UA_MonitoredItem *mon; /* Always set */
 
+    /* If set, data.dataChange.value points to the shared variant */
+    UA_SharedValue *sharedValue;
+
     /* The event field is used if mon->attributeId is the EventNotifier */
     union {
         UA_MonitoredItemNotification dataChange;
@@ -87,10 +121,13 @@ void UA_Notification_enqueueAndTrigger(UA_Server *server,
                                        UA_Notification *n);
 
 /* A NotificationMessage contains an array of notifications.
- * Sent NotificationMessages are stored for the republish service. */
+ * Sent NotificationMessages are stored for the republish service. The entry
+ * holds the references to the shared values used in the message. */
 typedef struct UA_NotificationMessageEntry {
     TAILQ_ENTRY(UA_NotificationMessageEntry) listEntry;
     UA_NotificationMessage message;
+    size_t sharedValuesSize;
+    UA_SharedValue **sharedValues;
 } UA_NotificationMessageEntry;
 
 /* Queue Definitions */
@@ -115,9 +152,48 @@ typedef enum {
     UA_MONITOREDITEMSAMPLINGTYPE_PUBLISH /* Sampled before publishing */
 } UA_MonitoredItemSamplingType;
 
+/* MonitoredItems with the same cyclic SamplingInterval are sampled from a
+ * single repeated callback of their SamplingGroup. The items are kept sorted by
+ * their ReadValueId, Session and TimestampsToReturn. Adjacent items with the
+ * same ReadValueId of the Value attribute share a single read across Sessions.
+ * The read is done with the adminSession and both timestamps. Every item then
+ * gets the access check of its Session and the timestamps it requested. For
+ * the other attributes the result depends on the Session (e.g. the
+ * UserAccessLevel). These items only share a read within a Session. */
+typedef struct UA_SamplingGroup {
+    LIST_ENTRY(UA_SamplingGroup) listEntry;
+    UA_Double samplingInterval;
+    UA_UInt64 callbackId;
+
+    /* Removed items leave a NULL entry. New items are appended at the end. The
+     * array is compacted and sorted before the next sampling cycle. */
+    UA_MonitoredItem **items;
+    size_t itemsSize;
+    size_t itemsCapacity;
+    size_t liveItems;
+    UA_Boolean unsorted;
+
+    /* > 0 while the items are being processed. The array is then neither
+     * compacted nor sorted and the group is not freed. */
+    size_t busy;
+} UA_SamplingGroup;
+
+/* Sample all MonitoredItems of the group */
+void
+UA_SamplingGroup_sample(UA_Server *server, UA_SamplingGroup *sg);
+
+/* Remove the group and its repeated callback if it has no more items and is
+ * not being processed right now */
+void
+UA_SamplingGroup_removeIfEmpty(UA_Server *server, UA_SamplingGroup *sg);
+
+/* Index of the MonitoredItems of a Subscription by their MonitoredItemId */
+typedef ZIP_HEAD(UA_MonitoredItemIdTree, UA_MonitoredItem) UA_MonitoredItemIdTree;
+
 struct UA_MonitoredItem {
     UA_DelayedCallback delayedFreePointers;
     LIST_ENTRY(UA_MonitoredItem) listEntry; /* Linked list in the Subscription */
+    ZIP_ENTRY(UA_MonitoredItem) idTreeEntry; /* Index in the Subscription */
     UA_Subscription *subscription;          /* Always non-NULL */
     UA_UInt32 monitoredItemId;
 
@@ -153,11 +229,16 @@ struct UA_MonitoredItem {
                                      * with samplingInterval == 0 form the
                                      * prefix of the list. */
     union {
-        UA_UInt64 callbackId;
+        struct {
+            UA_SamplingGroup *group;
+            size_t index;          /* Position in the items array of the group */
+        } cyclic;
         LIST_ENTRY(UA_MonitoredItem) subscriptionSampling; /* Linked to publish
                                                             * interval */
     } sampling;
     UA_DataValue lastValue;
+    UA_SharedValue *lastSharedValue; /* If set, lastValue points to the
+                                      * shared variant */
     UA_Boolean semanticsChangedPending; /* Add the SemanticsChanged bit to the
                                          * next DataChange notification */
     UA_UInt32 outstandingAsyncReads; /* at most UA_MONITOREDITEM_ASYNC_MAX */
@@ -179,6 +260,12 @@ struct UA_MonitoredItem {
 void
 markSemanticsChanged(UA_Server *server, const UA_NodeId *affected);
 
+/* Sample the MonitoredItems with no SamplingInterval for the attribute. Called
+ * after the attribute was written, also outside of the Write service. */
+void
+triggerImmediateDataChange(UA_Server *server, UA_Session *session,
+                           UA_Node *node, UA_AttributeId attributeId);
+
 void UA_MonitoredItem_init(UA_MonitoredItem *mon);
 void UA_MonitoredItem_delete(UA_Server *server, UA_MonitoredItem *mon, UA_Boolean notify);
 void UA_MonitoredItem_removeOverflowInfoBits(UA_MonitoredItem *mon);
@@ -188,8 +275,9 @@ void
 notifyMonitoredItem(UA_Server *server, UA_MonitoredItem *mon,
                     UA_ApplicationNotificationType type);
 
-/* Register sampling. Either by adding a repeated callback or by adding the
- * MonitoredItem to a linked list in the node. */
+/* Register sampling. Either by adding the MonitoredItem to the SamplingGroup
+ * for its interval or by adding the MonitoredItem to a linked list in the
+ * node. */
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon);
 
@@ -216,9 +304,16 @@ UA_StatusCode
 UA_MonitoredItem_addLink(UA_Subscription *sub, UA_MonitoredItem *mon,
                          UA_UInt32 linkId);
 
+/* If sv is set, then the value points to the shared variant. The Notification
+ * takes an additional reference instead of copying the variant. */
 UA_StatusCode
 UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_MonitoredItem *mon,
-                                              const UA_DataValue *value);
+                                              const UA_DataValue *value,
+                                              UA_SharedValue *sv);
+
+/* Clear the lastValue and release its shared variant */
+void
+UA_MonitoredItem_clearLastValue(UA_MonitoredItem *mon);
 
 /* Remove entries until mon->maxQueueSize is reached. Sets infobits for lost
  * data if required. */
@@ -240,13 +335,24 @@ typedef enum {
  * to a Session, then they are additionaly in the per-Session linked-list. A
  * subscription is always generated for a Session. But the CloseSession Service
  * may keep Subscriptions intact beyond the Session lifetime. They can then be
- * re-bound to a new Session with the TransferSubscription Service. */
+ * re-bound to a new Session with the TransferSubscription Service.
+ *
+ * Both the server-wide and the per-Session list are mirrored by a ZIP tree
+ * keyed on the SubscriptionId for the lookup from the service requests. During
+ * a transfer, the original and the new Subscription briefly share the same
+ * SubscriptionId. The lookup then skips the entry with a pending
+ * statusChange. */
+typedef ZIP_HEAD(UA_ServerSubscriptionTree, UA_Subscription)
+    UA_ServerSubscriptionTree;
+
 struct UA_Subscription {
     UA_DelayedCallback delayedFreePointers;
     LIST_ENTRY(UA_Subscription) serverListEntry;
+    ZIP_ENTRY(UA_Subscription) serverTreeEntry;
     /* Ordered according to the priority byte and round-robin scheduling for
      * late subscriptions. See ua_session.h. Only set if session != NULL. */
     TAILQ_ENTRY(UA_Subscription) sessionListEntry;
+    ZIP_ENTRY(UA_Subscription) sessionTreeEntry;
     UA_Session *session; /* May be NULL if no session is attached. */
     UA_UInt32 subscriptionId;
 
@@ -280,6 +386,7 @@ struct UA_Subscription {
     /* MonitoredItems */
     UA_UInt32 lastMonitoredItemId; /* increase the identifiers */
     LIST_HEAD(, UA_MonitoredItem) monitoredItems;
+    UA_MonitoredItemIdTree monitoredItemsById;
     UA_UInt32 monitoredItemsSize;
 
     /* MonitoredItems that are sampled in every publish callback (with the
@@ -320,6 +427,20 @@ struct UA_Subscription {
 #endif
 };
 
+static UA_INLINE enum ZIP_CMP
+cmpUInt32Id(const UA_UInt32 *a, const UA_UInt32 *b) {
+    if(*a == *b)
+        return ZIP_CMP_EQ;
+    return (*a < *b) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+}
+
+ZIP_FUNCTIONS(UA_ServerSubscriptionTree, UA_Subscription, serverTreeEntry,
+              UA_UInt32, subscriptionId, cmpUInt32Id)
+ZIP_FUNCTIONS(UA_SessionSubscriptionTree, UA_Subscription, sessionTreeEntry,
+              UA_UInt32, subscriptionId, cmpUInt32Id)
+ZIP_FUNCTIONS(UA_MonitoredItemIdTree, UA_MonitoredItem, idTreeEntry,
+              UA_UInt32, monitoredItemId, cmpUInt32Id)
+
 UA_Subscription * UA_Subscription_new(void);
 
 void
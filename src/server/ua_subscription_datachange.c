@@ -13,8 +13,81 @@
 #include "ua_subscription.h"
 #include "../ua_types_encoding_binary.h"
 
+#include <stdlib.h> /* qsort */
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS /* conditional compilation */
 
+/*****************/
+/* Shared Values */
+/*****************/
+
+static enum ZIP_CMP
+cmpSharedValue(const void *a, const void *b) {
+    return (enum ZIP_CMP)UA_order(a, b, &UA_TYPES[UA_TYPES_READVALUEID]);
+}
+
+ZIP_FUNCTIONS(UA_SharedValueTree, UA_SharedValue, zipfields,
+              UA_ReadValueId, key, cmpSharedValue)
+
+UA_SharedValue *
+UA_SharedValue_share(UA_SharedValueTree *cache, const UA_ReadValueId *key,
+                     UA_Variant *v) {
+    if(!v->type)
+        return NULL;
+
+    /* Reuse the cached value if it is equal */
+    UA_SharedValue *old = ZIP_FIND(UA_SharedValueTree, cache, key);
+    if(old && UA_equal(&old->value, v, &UA_TYPES[UA_TYPES_VARIANT])) {
+        UA_Variant_clear(v);
+        old->refCount++;
+        return old;
+    }
+
+    /* Create a new shared value */
+    UA_SharedValue *sv = (UA_SharedValue*)UA_calloc(1, sizeof(UA_SharedValue));
+    if(!sv)
+        return NULL;
+
+    /* Replace the cached value. The key is moved from the old value. */
+    if(old) {
+        ZIP_REMOVE(UA_SharedValueTree, cache, old);
+        old->cache = NULL;
+        sv->key = old->key;
+        UA_ReadValueId_init(&old->key);
+    } else {
+        UA_StatusCode res = UA_ReadValueId_copy(key, &sv->key);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(sv);
+            return NULL;
+        }
+    }
+    ZIP_INSERT(UA_SharedValueTree, cache, sv);
+    sv->cache = cache;
+    sv->refCount = 1;
+    sv->value = *v;
+    UA_Variant_init(v);
+    return sv;
+}
+
+void
+UA_SharedValue_release(UA_SharedValue *sv) {
+    UA_assert(sv->refCount > 0);
+    if(--sv->refCount > 0)
+        return;
+    if(sv->cache)
+        ZIP_REMOVE(UA_SharedValueTree, sv->cache, sv);
+    UA_ReadValueId_clear(&sv->key);
+    UA_Variant_clear(&sv->value);
+    UA_free(sv);
+}
+
+/* Point to the variant of the shared value without taking ownership */
+static void
+setSharedVariant(UA_DataValue *dv, const UA_SharedValue *sv) {
+    dv->value = sv->value;
+    dv->value.storageType = UA_VARIANT_DATA_NODELETE;
+}
+
 void
 markSemanticsChanged(UA_Server *server, const UA_NodeId *affected) {
     UA_LOCK_ASSERT(&server->serviceMutex);
@@ -134,7 +207,8 @@ detectVariantDeadband(const UA_Variant *value, const UA_Variant *oldValue,
 }
 
 static UA_Boolean
-detectValueChange(UA_Server *server, UA_MonitoredItem *mon, const UA_DataValue *dv) {
+detectValueChange(UA_Server *server, UA_MonitoredItem *mon, const UA_DataValue *dv,
+                  const UA_SharedValue *sv) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     /* Status changes are always reported */
@@ -180,6 +254,11 @@ detectValueChange(UA_Server *server, UA_MonitoredItem *mon, const UA_DataValue *
             return true;
     }
 
+    /* The same shared variant is an equal value. The shared value only holds
+     * the variant. So the timestamp has to be compared before. */
+    if(sv && sv == mon->lastSharedValue)
+        return false;
+
     /* Has the value changed? */
     return !UA_equal(&dv->value, &mon->lastValue.value,
                      &UA_TYPES[UA_TYPES_VARIANT]);
@@ -187,12 +266,18 @@ detectValueChange(UA_Server *server, UA_MonitoredItem *mon, const UA_DataValue *
 
 UA_StatusCode
 UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_MonitoredItem *mon,
-                                              const UA_DataValue *dv) {
-    /* Copy the value */
+                                              const UA_DataValue *dv,
+                                              UA_SharedValue *sv) {
+    /* Copy the value. Only the members are copied for a shared variant. */
     UA_DataValue valueCopy;
-    UA_StatusCode retval = UA_DataValue_copy(dv, &valueCopy);
-    if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+    if(sv) {
+        valueCopy = *dv;
+        setSharedVariant(&valueCopy, sv);
+    } else {
+        UA_StatusCode retval = UA_DataValue_copy(dv, &valueCopy);
+        if(retval != UA_STATUSCODE_GOOD)
+            return retval;
+    }
 
     /* SemanticsChanged is a one-shot notification bit. Keep it out of
      * lastValue so it neither affects filtering nor causes a second status
@@ -210,6 +295,10 @@ UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_MonitoredIte
     }
 
     /* Prepare and enqueue the notification */
+    if(sv) {
+        sv->refCount++;
+        n->sharedValue = sv;
+    }
     n->mon = mon;
     n->data.dataChange.value = valueCopy;
     n->data.dataChange.clientHandle = mon->parameters.clientHandle;
@@ -219,38 +308,63 @@ UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_MonitoredIte
 }
 
 void
-UA_MonitoredItem_processSampledValue(UA_Server *server, UA_MonitoredItem *mon,
-                                     UA_DataValue *value) {
+UA_MonitoredItem_clearLastValue(UA_MonitoredItem *mon) {
+    UA_DataValue_clear(&mon->lastValue);
+    if(mon->lastSharedValue) {
+        UA_SharedValue_release(mon->lastSharedValue);
+        mon->lastSharedValue = NULL;
+    }
+}
+
+/* If sv is set, then the value already points to the shared variant. Takes
+ * ownership of the value and of one reference to sv. */
+static void
+processSampledValue(UA_Server *server, UA_MonitoredItem *mon,
+                    UA_DataValue *value, UA_SharedValue *sv) {
     UA_assert(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER);
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     /* Has the value changed (with the filters applied)? */
     UA_Boolean changed = mon->semanticsChangedPending ||
-        detectValueChange(server, mon, value);
+        detectValueChange(server, mon, value, sv);
     if(!changed) {
         UA_LOG_DEBUG_SUBSCRIPTION(server->config.logging, mon->subscription,
                                   "MonitoredItem %" PRIi32 " | "
                                   "The value has not changed", mon->monitoredItemId);
         UA_DataValue_clear(value);
+        if(sv)
+            UA_SharedValue_release(sv);
         return;
     }
 
+    /* Share the variant with the other MonitoredItems that sample an equal
+     * value. Then the value points to the shared variant. */
+    if(!sv) {
+        sv = UA_SharedValue_share(&server->sharedValues, &mon->itemToMonitor,
+                                  &value->value);
+        if(sv)
+            setSharedVariant(value, sv);
+    }
+
     /* Prepare a notification and enqueue it */
     UA_Boolean semanticsChanged = mon->semanticsChangedPending;
     UA_StatusCode res =
-        UA_MonitoredItem_createDataChangeNotification(server, mon, value);
+        UA_MonitoredItem_createDataChangeNotification(server, mon, value, sv);
     if(res != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_SUBSCRIPTION(server->config.logging, mon->subscription,
                                     "MonitoredItem %" PRIi32 " | "
                                     "Processing the sample returned the statuscode %s",
                                     mon->monitoredItemId, UA_StatusCode_name(res));
         UA_DataValue_clear(value);
+        if(sv)
+            UA_SharedValue_release(sv);
         return;
     }
 
     /* Move/store the value for filter comparison and TransferSubscription */
-    UA_DataValue_clear(&mon->lastValue);
+    UA_MonitoredItem_clearLastValue(mon);
     mon->lastValue = *value;
+    mon->lastSharedValue = sv;
 
     /* Call the local callback if the MonitoredItem is not attached to a
      * subscription. Do this at the very end. Because the callback might delete
@@ -270,6 +384,12 @@ UA_MonitoredItem_processSampledValue(UA_Server *server, UA_MonitoredItem *mon,
     }
 }
 
+void
+UA_MonitoredItem_processSampledValue(UA_Server *server, UA_MonitoredItem *mon,
+                                     UA_DataValue *value) {
+    processSampledValue(server, mon, value, NULL);
+}
+
 /* We know the result is a deep-copy. So we can abuse the const result-pointer
  * and take ownership of the value. */
 static void
@@ -317,4 +437,293 @@ UA_MonitoredItem_sample(UA_Server *server, UA_MonitoredItem *mon) {
     }
 }
 
+/******************/
+/* Sampling Group */
+/******************/
+
+void
+UA_SamplingGroup_removeIfEmpty(UA_Server *server, UA_SamplingGroup *sg) {
+    if(sg->liveItems > 0 || sg->busy > 0)
+        return;
+    removeCallback(server, sg->callbackId);
+    LIST_REMOVE(sg, listEntry);
+    UA_free(sg->items);
+    UA_free(sg);
+}
+
+static UA_Session *
+samplingSession(const UA_MonitoredItem *mon) {
+    return (mon->subscription) ? mon->subscription->session : NULL;
+}
+
+/* Values are read once for all Sessions. The other attributes depend on the
+ * Session. */
+static UA_Boolean
+sharedAcrossSessions(const UA_MonitoredItem *mon) {
+    return (mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_VALUE);
+}
+
+/* Total order of the items in the SamplingGroup. Items with the same
+ * ReadValueId are adjacent. */
+static int
+samplingKeyCompare(const UA_MonitoredItem *a, const UA_MonitoredItem *b) {
+    int o = (int)UA_order(&a->itemToMonitor, &b->itemToMonitor,
+                          &UA_TYPES[UA_TYPES_READVALUEID]);
+    if(o != 0)
+        return o;
+    uintptr_t sa = (uintptr_t)samplingSession(a);
+    uintptr_t sb = (uintptr_t)samplingSession(b);
+    if(sa != sb)
+        return (sa < sb) ? -1 : 1;
+    if(a->timestampsToReturn != b->timestampsToReturn)
+        return (a->timestampsToReturn < b->timestampsToReturn) ? -1 : 1;
+    return 0;
+}
+
+/* Can the items share a read? */
+static UA_Boolean
+samplingShared(const UA_MonitoredItem *a, const UA_MonitoredItem *b) {
+    if(sharedAcrossSessions(a))
+        return UA_equal(&a->itemToMonitor, &b->itemToMonitor,
+                        &UA_TYPES[UA_TYPES_READVALUEID]);
+    return (samplingKeyCompare(a, b) == 0);
+}
+
+static int
+samplingKeyCompareQsort(const void *a, const void *b) {
+    return samplingKeyCompare(*(UA_MonitoredItem* const*)a,
+                              *(UA_MonitoredItem* const*)b);
+}
+
+/* Remove the NULL entries of removed items and sort by the sampling key */
+static void
+prepareSamplingGroup(UA_SamplingGroup *sg) {
+    UA_assert(sg->busy == 0);
+    if(sg->liveItems == sg->itemsSize && !sg->unsorted)
+        return;
+
+    size_t j = 0;
+    for(size_t i = 0; i < sg->itemsSize; i++) {
+        if(sg->items[i])
+            sg->items[j++] = sg->items[i];
+    }
+    sg->itemsSize = j;
+
+    if(sg->unsorted)
+        qsort(sg->items, sg->itemsSize, sizeof(UA_MonitoredItem*),
+              samplingKeyCompareQsort);
+    for(size_t i = 0; i < sg->itemsSize; i++)
+        sg->items[i]->sampling.cyclic.index = i;
+    sg->unsorted = false;
+}
+
+/* The result of the access check for the last Session in the fan-out */
+typedef struct {
+    const UA_Session *session;
+    UA_StatusCode res;
+} SampleAccess;
+
+/* Hand out a value that was read with the adminSession to the item. Apply the
+ * access check for the Session of the item and remove the timestamps that were
+ * not requested. Releases the shared value if the access is denied. */
+static void
+adaptSharedSample(UA_Server *server, UA_MonitoredItem *mon,
+                  SampleAccess *access, UA_DataValue *dv,
+                  UA_SharedValue **sv) {
+    UA_Session *session = (mon->subscription) ?
+        mon->subscription->session : &server->adminSession;
+    if(!access->session || access->session != session) {
+        access->res = checkReadValueAccess(server, session,
+                                           &mon->itemToMonitor.nodeId);
+        access->session = session;
+    }
+
+    if(access->res != UA_STATUSCODE_GOOD) {
+        UA_Variant_clear(&dv->value);
+        dv->hasValue = false;
+        dv->hasStatus = true;
+        dv->status = access->res;
+        if(*sv) {
+            UA_SharedValue_release(*sv);
+            *sv = NULL;
+        }
+    }
+
+    UA_TimestampsToReturn ttr = mon->timestampsToReturn;
+    if(ttr == UA_TIMESTAMPSTORETURN_SOURCE ||
+       ttr == UA_TIMESTAMPSTORETURN_NEITHER) {
+        dv->hasServerTimestamp = false;
+        dv->hasServerPicoseconds = false;
+    }
+    if(ttr == UA_TIMESTAMPSTORETURN_SERVER ||
+       ttr == UA_TIMESTAMPSTORETURN_NEITHER) {
+        dv->hasSourceTimestamp = false;
+        dv->hasSourcePicoseconds = false;
+    }
+}
+
+/* Forward the value to the items in the SamplingGroup next to the leader that
+ * share the read. The variant is shared once and every item gets a shallow copy
+ * of the DataValue with a reference to the shared value. The leader takes
+ * ownership of the value last. */
+static void
+fanOutSampledValue(UA_Server *server, UA_MonitoredItem *leader,
+                   UA_DataValue *value) {
+    /* The value was read with the adminSession for all Sessions */
+    UA_Boolean adapt = sharedAcrossSessions(leader);
+    SampleAccess access = {NULL, UA_STATUSCODE_GOOD};
+
+    UA_SamplingGroup *sg = (leader->samplingType == UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC) ?
+        leader->sampling.cyclic.group : NULL;
+    if(!sg) {
+        UA_SharedValue *none = NULL;
+        if(adapt)
+            adaptSharedSample(server, leader, &access, value, &none);
+        UA_MonitoredItem_processSampledValue(server, leader, value);
+        return;
+    }
+
+    /* Find the range of items with the same key. Removed items (NULL) do not
+     * end the range. */
+    size_t pos = leader->sampling.cyclic.index;
+    size_t begin = pos;
+    while(begin > 0 && (!sg->items[begin-1] ||
+                        samplingShared(leader, sg->items[begin-1])))
+        begin--;
+    size_t end = pos + 1;
+    while(end < sg->itemsSize && (!sg->items[end] ||
+                                  samplingShared(leader, sg->items[end])))
+        end++;
+
+    /* The items point to the shared variant. Then the change detection of the
+     * items compares the shared value by its pointer. */
+    UA_SharedValue *sv =
+        UA_SharedValue_share(&server->sharedValues, &leader->itemToMonitor,
+                             &value->value);
+    if(sv)
+        setSharedVariant(value, sv);
+
+    /* The group is not freed or reordered while the items are processed. The
+     * callbacks of local MonitoredItems can remove items (set to NULL) or
+     * append new items (realloc). So always access via sg->items. */
+    sg->busy++;
+    for(size_t i = begin; i < end; i++) {
+        UA_MonitoredItem *mon = sg->items[i];
+        if(!mon || mon == leader)
+            continue;
+        UA_DataValue copy;
+        UA_SharedValue *monSv = sv;
+        if(sv) {
+            copy = *value; /* The variant is not freed with the copy */
+            sv->refCount++;
+        } else {
+            /* Empty variant or out of memory for sharing */
+            UA_StatusCode res = UA_DataValue_copy(value, &copy);
+            if(res != UA_STATUSCODE_GOOD) {
+                UA_DataValue_init(&copy);
+                copy.hasStatus = true;
+                copy.status = res;
+            }
+        }
+        if(adapt)
+            adaptSharedSample(server, mon, &access, &copy, &monSv);
+        processSampledValue(server, mon, &copy, monSv);
+
+        /* The callback of a local MonitoredItem can close Sessions */
+        if(!mon->subscription || mon->subscription == server->adminSubscription)
+            access.session = NULL;
+    }
+    sg->busy--;
+
+    /* The leader might have been removed in the meantime */
+    if(leader->samplingType == UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC &&
+       leader->sampling.cyclic.group == sg) {
+        if(adapt)
+            adaptSharedSample(server, leader, &access, value, &sv);
+        processSampledValue(server, leader, value, sv);
+    } else {
+        UA_DataValue_clear(value);
+        if(sv)
+            UA_SharedValue_release(sv);
+    }
+
+    /* All items might have been removed during the fan-out */
+    UA_SamplingGroup_removeIfEmpty(server, sg);
+}
+
+static void
+processSamplingGroupAsyncRead(UA_Server *server,
+                              void *asyncOpContext /* UA_MonitoredItem */,
+                              const UA_DataValue *result) {
+    UA_MonitoredItem *leader = (UA_MonitoredItem*)asyncOpContext;
+    leader->outstandingAsyncReads--;
+    UA_DataValue *mut_result = (UA_DataValue*)(uintptr_t)result;
+    if(mut_result->status == UA_STATUSCODE_BADREQUESTCANCELLEDBYREQUEST)
+        return; /* Controlled shut-down */
+    fanOutSampledValue(server, leader, mut_result);
+    UA_DataValue_init(mut_result);
+}
+
+void
+UA_SamplingGroup_sample(UA_Server *server, UA_SamplingGroup *sg) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    if(sg->busy == 0)
+        prepareSamplingGroup(sg);
+
+    sg->busy++;
+    for(size_t i = 0; i < sg->itemsSize; i++) {
+        UA_MonitoredItem *mon = sg->items[i];
+        if(!mon)
+            continue;
+
+        /* Skip the following items with the same key. They get the value from
+         * the fan-out. */
+        size_t next = i + 1;
+        while(next < sg->itemsSize && (!sg->items[next] ||
+                                       samplingShared(mon, sg->items[next])))
+            next++;
+        UA_Boolean shared = false;
+        for(size_t j = i + 1; j < next && !shared; j++)
+            shared = (sg->items[j] != NULL);
+
+        /* Sample the single item directly */
+        if(!shared) {
+            UA_MonitoredItem_sample(server, mon);
+            i = next - 1;
+            continue;
+        }
+
+        /* Read once for all items with the same key. Values are read with
+         * the adminSession for all Sessions. */
+        UA_Session *session = samplingSession(mon);
+        UA_TimestampsToReturn ttr = mon->timestampsToReturn;
+        if(sharedAcrossSessions(mon)) {
+            session = &server->adminSession;
+            ttr = UA_TIMESTAMPSTORETURN_BOTH;
+        } else if(!session) {
+            session = &server->adminSession;
+        }
+        UA_StatusCode res = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+        if(UA_LIKELY(mon->outstandingAsyncReads < UA_MONITOREDITEM_ASYNC_MAX)) {
+            res = read_async(server, session, &mon->itemToMonitor, ttr,
+                             processSamplingGroupAsyncRead, mon, 0);
+        }
+        if(res == UA_STATUSCODE_GOOD) {
+            mon->outstandingAsyncReads++;
+        } else {
+            /* Reading failed, process with the StatusCode */
+            UA_DataValue dv;
+            UA_DataValue_init(&dv);
+            dv.hasStatus = true;
+            dv.status = res;
+            fanOutSampledValue(server, mon, &dv);
+        }
+        i = next - 1;
+    }
+    sg->busy--;
+
+    UA_SamplingGroup_removeIfEmpty(server, sg);
+}
+
 #endif /* UA_ENABLE_SUBSCRIPTIONS */
@@ -826,8 +826,7 @@ ofTypeOperator(UA_FilterEvalContext *ctx, size_t index) {
 
     /* Is the /EventType a subtype of the requested type? */
     UA_Boolean ofType =
-        isNodeInTree_singleRef(ctx->server, (UA_NodeId*)eventType.data, operandTypeId,
-                               UA_REFERENCETYPEINDEX_HASSUBTYPE);
+        isSubtypeOf(ctx->server, (UA_NodeId*)eventType.data, operandTypeId);
     ctx->operatorResults[index] = t2v(ofType ? UA_TERNARY_TRUE : UA_TERNARY_FALSE);
     UA_Variant_clear(&eventType);
     return UA_STATUSCODE_GOOD;
@@ -1194,8 +1193,7 @@ UA_SimpleAttributeOperandValidation(UA_Server *server,
 
     /* EventType is a subtype of BaseEventType? */
     UA_NodeId baseEventTypeId = UA_NS0ID(BASEEVENTTYPE);
-    if(!isNodeInTree_singleRef(server, &sao->typeDefinitionId, &baseEventTypeId,
-                               UA_REFERENCETYPEINDEX_HASSUBTYPE))
+    if(!isSubtypeOf(server, &sao->typeDefinitionId, &baseEventTypeId))
         return UA_STATUSCODE_BADTYPEDEFINITIONINVALID;
 
     /* AttributeId is valid ? */
@@ -1368,8 +1366,7 @@ UA_ContentFilterElementValidation(UA_Server *server, size_t operatorIndex,
 
             /* Make sure the operand is a subtype of BaseEventType */
             UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
-            if(!isNodeInTree_singleRef(server, (UA_NodeId *)lo->value.data, &baseEventTypeId,
-                                       UA_REFERENCETYPEINDEX_HASSUBTYPE)) {
+            if(!isSubtypeOf(server, (UA_NodeId *)lo->value.data, &baseEventTypeId)) {
                 er.operandStatusCodes[0] = UA_STATUSCODE_BADFILTEROPERANDINVALID;
                 er.statusCode = UA_STATUSCODE_BADFILTEROPERANDINVALID;
                 break;
@@ -1529,11 +1526,144 @@ static const UA_NodeId emitReferencesRoots[EMIT_REFS_ROOT_COUNT] =
      {0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_HASEVENTSOURCE}},
      {0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_HASNOTIFIER}}};
 
+static enum ZIP_CMP
+cmpEventRoute(const void *a, const void *b) {
+    return (enum ZIP_CMP)UA_NodeId_order((const UA_NodeId*)a,
+                                         (const UA_NodeId*)b);
+}
+
+ZIP_FUNCTIONS(UA_EventRouteTree, UA_EventRoute, zipfields,
+              UA_NodeId, sourceNode, cmpEventRoute)
+
+static void *
+deleteEventRoute(void *context, UA_EventRoute *route) {
+    UA_NodeId_clear(&route->sourceNode);
+    UA_Array_delete(route->emitNodes, route->emitNodesSize,
+                    &UA_TYPES[UA_TYPES_NODEID]);
+    UA_free(route);
+    return NULL;
+}
+
+void
+clearEventRoutes(UA_Server *server) {
+    if(server->eventRoutesBusy > 0) {
+        server->eventRoutesStale = true;
+        return;
+    }
+    server->eventRoutesStale = false;
+    if(server->eventRoutesSize == 0)
+        return;
+    ZIP_ITER(UA_EventRouteTree, &server->eventRoutes, deleteEventRoute, NULL);
+    ZIP_INIT(&server->eventRoutes);
+    server->eventRoutesSize = 0;
+}
+
+/* Compute the route with a recursive browse */
+static UA_StatusCode
+computeEventRoute(UA_Server *server, const UA_NodeId *sourceNode,
+                  UA_EventRoute *route) {
+    /* Get all ReferenceTypes over which the events propagate */
+    UA_ReferenceTypeSet emitRefTypes;
+    UA_ReferenceTypeSet_init(&emitRefTypes);
+    for(size_t i = 0; i < EMIT_REFS_ROOT_COUNT; i++) {
+        UA_ReferenceTypeSet tmpRefTypes;
+        UA_StatusCode res =
+            referenceTypeIndices(server, &emitReferencesRoots[i], &tmpRefTypes, true);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        emitRefTypes = UA_ReferenceTypeSet_union(emitRefTypes, tmpRefTypes);
+    }
+
+    /* Get the list of nodes in the hierarchy that emits the event. Add the
+     * server node to the list of nodes from which the event is emitted. The
+     * server node emits all events.
+     *
+     * Part 3, 7.17: In particular, the root notifier of a Server, the Server
+     * Object defined in Part 5, is always capable of supplying all Events from
+     * a Server and as such has implied HasEventSource References to every event
+     * source in a Server. */
+    UA_NodeId emitStartNodes[2];
+    emitStartNodes[0] = *sourceNode;
+    emitStartNodes[1] = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+
+    UA_ExpandedNodeId *emitNodes = NULL;
+    size_t emitNodesSize = 0;
+    UA_StatusCode res =
+        browseRecursive(server, 2, emitStartNodes, UA_BROWSEDIRECTION_INVERSE,
+                        &emitRefTypes, UA_NODECLASS_UNSPECIFIED, true,
+                        &emitNodesSize, &emitNodes);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* We can only emit on local nodes. Move the local NodeIds. */
+    memset(route, 0, sizeof(UA_EventRoute));
+    if(emitNodesSize > 0) {
+        route->emitNodes = (UA_NodeId*)
+            UA_Array_new(emitNodesSize, &UA_TYPES[UA_TYPES_NODEID]);
+        if(!route->emitNodes) {
+            UA_Array_delete(emitNodes, emitNodesSize,
+                            &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+    }
+    for(size_t i = 0; i < emitNodesSize; i++) {
+        if(!UA_ExpandedNodeId_isLocal(&emitNodes[i]))
+            continue;
+        route->emitNodes[route->emitNodesSize++] = emitNodes[i].nodeId;
+        UA_NodeId_init(&emitNodes[i].nodeId);
+    }
+    UA_Array_delete(emitNodes, emitNodesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Look up the route in the cache or compute and cache it. While events are
+ * emitted the cache is not modified. Then the route is computed into the
+ * provided uncached route (and has to be cleaned up by the caller). */
+static UA_StatusCode
+getEventRoute(UA_Server *server, const UA_NodeId *sourceNode,
+              UA_EventRoute *uncached, UA_EventRoute **outRoute) {
+    /* Use the cached route */
+    UA_EventRoute *route = NULL;
+    if(!server->eventRoutesStale) {
+        route = ZIP_FIND(UA_EventRouteTree, &server->eventRoutes, sourceNode);
+        if(route) {
+            *outRoute = route;
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
+    /* Compute the route */
+    UA_StatusCode res = computeEventRoute(server, sourceNode, uncached);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    *outRoute = uncached;
+    if(server->eventRoutesBusy > 0 || server->eventRoutesStale)
+        return UA_STATUSCODE_GOOD;
+
+    /* Add to the cache. Don't fail if this is not possible. */
+    route = (UA_EventRoute*)UA_malloc(sizeof(UA_EventRoute));
+    if(!route)
+        return UA_STATUSCODE_GOOD;
+    *route = *uncached;
+    if(UA_NodeId_copy(sourceNode, &route->sourceNode) != UA_STATUSCODE_GOOD) {
+        UA_free(route);
+        return UA_STATUSCODE_GOOD;
+    }
+    if(server->eventRoutesSize >= UA_EVENTROUTES_MAX)
+        clearEventRoutes(server);
+    ZIP_INSERT(UA_EventRouteTree, &server->eventRoutes, route);
+    server->eventRoutesSize++;
+    *outRoute = route;
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_StatusCode
 createEvent(UA_Server *server, const UA_EventDescription *ed,
             UA_ByteString *outEventId) {
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
     UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_StatusCode res = UA_ServiceWorkers_checkModify(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
 
     /* MonitoredItem can only be filtered if the Subscription is defined.
      * Subscription can only be filtered if a Session is defined. */
@@ -1576,45 +1706,6 @@ createEvent(UA_Server *server, const UA_EventDescription *ed,
     /*     return UA_STATUSCODE_BADINVALIDARGUMENT; */
     /* } */
 
-    /* Get all ReferenceTypes over which the events propagate */
-    UA_ReferenceTypeSet emitRefTypes;
-    UA_ReferenceTypeSet_init(&emitRefTypes);
-    for(size_t i = 0; i < EMIT_REFS_ROOT_COUNT; i++) {
-        UA_ReferenceTypeSet tmpRefTypes;
-        res = referenceTypeIndices(server, &emitReferencesRoots[i], &tmpRefTypes, true);
-        if(res != UA_STATUSCODE_GOOD) {
-            UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                           "Events: Could not create the list of references for event "
-                           "propagation with StatusCode %s", UA_StatusCode_name(res));
-            return res;
-        }
-        emitRefTypes = UA_ReferenceTypeSet_union(emitRefTypes, tmpRefTypes);
-    }
-
-    /* Get the list of nodes in the hierarchy that emits the event. Add the
-     * server node to the list of nodes from which the event is emitted. The
-     * server node emits all events.
-     *
-     * Part 3, 7.17: In particular, the root notifier of a Server, the Server
-     * Object defined in Part 5, is always capable of supplying all Events from
-     * a Server and as such has implied HasEventSource References to every event
-     * source in a Server. */
-    UA_NodeId emitStartNodes[2];
-    emitStartNodes[0] = ed->sourceNode;
-    emitStartNodes[1] = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
-
-    UA_ExpandedNodeId *emitNodes = NULL;
-    size_t emitNodesSize = 0;
-    res = browseRecursive(server, 2, emitStartNodes, UA_BROWSEDIRECTION_INVERSE,
-                          &emitRefTypes, UA_NODECLASS_UNSPECIFIED, true,
-                          &emitNodesSize, &emitNodes);
-    if(res != UA_STATUSCODE_GOOD) {
-        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                       "Events: Could not create the list of nodes listening on the "
-                       "event with StatusCode %s", UA_StatusCode_name(res));
-        return res;
-    }
-
     /* Set up the eval context. */
     UA_FilterEvalContext ctx;
     UA_FilterEvalContext_init(&ctx);
@@ -1634,14 +1725,34 @@ createEvent(UA_Server *server, const UA_EventDescription *ed,
             return res;
     }
 
-    /* Loop over all nodes that emit this event instance */
-    for(size_t i = 0; i < emitNodesSize; i++) {
-        /* We can only emit on local nodes */
-        if(!UA_ExpandedNodeId_isLocal(&emitNodes[i]))
-            continue;
+    /* Nobody listens. Don't route the event through the information model. */
+    if(server->eventMonitoredItemsSize == 0
+#ifdef UA_ENABLE_HISTORIZING
+       && !server->config.historyDatabase.setEvent
+#endif
+       )
+        return UA_STATUSCODE_GOOD;
+
+    /* Get the list of nodes in the hierarchy that emit the event */
+    UA_EventRoute uncachedRoute;
+    UA_EventRoute *route = NULL;
+    res = getEventRoute(server, &ed->sourceNode, &uncachedRoute, &route);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Events: Could not create the list of nodes listening on the "
+                       "event with StatusCode %s", UA_StatusCode_name(res));
+        if(outEventId)
+            UA_ByteString_clear(outEventId);
+        return res;
+    }
 
+    /* The route is not flushed while the event is emitted */
+    server->eventRoutesBusy++;
+
+    /* Loop over all nodes that emit this event instance */
+    for(size_t i = 0; i < route->emitNodesSize; i++) {
         /* Get the node */
-        const UA_Node *node = UA_NODESTORE_GET(server, &emitNodes[i].nodeId);
+        const UA_Node *node = UA_NODESTORE_GET(server, &route->emitNodes[i]);
         if(!node)
             continue;
 
@@ -1730,14 +1841,19 @@ createEvent(UA_Server *server, const UA_EventDescription *ed,
         /* Add event entry in the historical database */
 #ifdef UA_ENABLE_HISTORIZING
         if(server->config.historyDatabase.setEvent)
-            setHistoricalEvent(server, &emitNodes[i].nodeId, ed);
+            setHistoricalEvent(server, &route->emitNodes[i], ed);
 #endif
     }
 
     /* Clean up and return */
+    server->eventRoutesBusy--;
+    if(route == &uncachedRoute)
+        UA_Array_delete(uncachedRoute.emitNodes, uncachedRoute.emitNodesSize,
+                        &UA_TYPES[UA_TYPES_NODEID]);
+    if(server->eventRoutesBusy == 0 && server->eventRoutesStale)
+        clearEventRoutes(server);
     if(outEventId && res != UA_STATUSCODE_GOOD)
         UA_ByteString_clear(outEventId);
-    UA_Array_delete(emitNodes, emitNodesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
     return res;
 }
 
@@ -537,7 +537,7 @@ processHttpBody(UA_HttpListener *listener, UA_HttpServerSequence *sequence,
         UA_Request request;
         UA_ServiceDescription *sd = NULL;
         UA_StatusCode res = decodeBinaryServiceRequest(
-            server, body, &sd, &request, NULL, NULL);
+            server, body, 1, &sd, &request, NULL, NULL);
         if(res != UA_STATUSCODE_GOOD)
             return res;
         res = processDecodedHttpRequest(
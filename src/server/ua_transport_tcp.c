@@ -140,13 +140,13 @@ sendServiceFault(UA_Server *server, UA_SecureChannel *channel,
 /* This is not an ERR message, the connection is not closed afterwards */
 static UA_StatusCode
 decodeHeaderSendServiceFault(UA_Server *server, UA_SecureChannel *channel,
-                             const UA_ByteString *msg, size_t offset,
-                             const UA_DataType *responseType, UA_UInt32 requestId,
-                             UA_StatusCode error) {
+                             const UA_ByteString *segments, size_t segmentsSize,
+                             size_t offset, const UA_DataType *responseType,
+                             UA_UInt32 requestId, UA_StatusCode error) {
     UA_RequestHeader requestHeader;
     UA_StatusCode retval =
-        UA_decodeBinaryInternal(msg, &offset, &requestHeader,
-                                &UA_TYPES[UA_TYPES_REQUESTHEADER], NULL);
+        UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset, &requestHeader,
+                                        &UA_TYPES[UA_TYPES_REQUESTHEADER], NULL, NULL);
     if(retval != UA_STATUSCODE_GOOD)
         return retval;
     retval = sendServiceFault(server, channel, requestId,
@@ -303,21 +303,24 @@ UA_StatusCode
 sendResponse(UA_Server *server, UA_SecureChannel *channel,
              UA_UInt64 responseToken, UA_Response *response,
              const UA_DataType *responseType) {
-    if(!channel)
-        return UA_STATUSCODE_BADINTERNALERROR;
-
-    /* If the overall service call failed, answer with a ServiceFault */
-    if(response->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
-        return sendServiceFault(server, channel, responseToken,
-                                response->responseHeader.requestHandle,
-                                response->responseHeader.serviceResult);
+    UA_StatusCode res;
+    if(!channel) {
+        res = UA_STATUSCODE_BADINTERNALERROR;
+    } else if(response->responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
+        /* If the overall service call failed, answer with a ServiceFault */
+        res = sendServiceFault(server, channel, responseToken,
+                               response->responseHeader.requestHandle,
+                               response->responseHeader.serviceResult);
+    } else {
+        /* Prepare the ResponseHeader */
+        UA_EventLoop *el = server->config.eventLoop;
+        response->responseHeader.timestamp = el->dateTime_now(el);
+        res = sendServiceMessage(server, channel, responseToken, response,
+                                 responseType);
+    }
 
-    /* Prepare the ResponseHeader */
-    UA_EventLoop *el = server->config.eventLoop;
-    response->responseHeader.timestamp = el->dateTime_now(el);
-    UA_StatusCode res =
-        sendServiceMessage(server, channel, responseToken, response,
-                           responseType);
+    /* The response is encoded. Release the values borrowed from the nodes. */
+    releaseBorrowedValues(server, response);
     return res;
 }
 
@@ -362,8 +365,8 @@ getBoundSession(UA_Server *server, const UA_SecureChannel *channel,
 }
 
 static UA_StatusCode
-processMSG(UA_Server *server, UA_SecureChannel *channel,
-           UA_UInt32 requestId, const UA_ByteString *msg) {
+processMSG(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
+           const UA_ByteString *segments, size_t segmentsSize) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     if(channel->state != UA_SECURECHANNELSTATE_OPEN)
@@ -375,7 +378,7 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     size_t requestOffset = 0;
     UA_UInt32 requestTypeId = 0;
     UA_StatusCode retval = decodeBinaryServiceRequest(
-        server, msg, &sd, &request, &requestOffset, &requestTypeId);
+        server, segments, segmentsSize, &sd, &request, &requestOffset, &requestTypeId);
     if(retval != UA_STATUSCODE_GOOD) {
         if(!sd && requestTypeId ==
            UA_NS0ID_CREATESUBSCRIPTIONREQUEST_ENCODING_DEFAULTBINARY) {
@@ -393,7 +396,7 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
         }
         const UA_DataType *responseType = sd ? sd->responseType :
             &UA_TYPES[UA_TYPES_SERVICEFAULT];
-        return decodeHeaderSendServiceFault(server, channel, msg,
+        return decodeHeaderSendServiceFault(server, channel, segments, segmentsSize,
                                             requestOffset, responseType,
                                             requestId, retval);
     }
@@ -417,26 +420,27 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     return retval;
 }
 
-/* Takes decoded messages starting at the nodeid of the content type. */
+/* Takes decoded messages starting at the nodeid of the content type. Only MSG
+ * and CLO messages can span several segments. */
 UA_StatusCode
 processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
                             UA_MessageType messagetype, UA_UInt32 requestId,
-                            UA_ByteString *message) {
+                            const UA_ByteString *segments, size_t segmentsSize) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
     switch(messagetype) {
     case UA_MESSAGETYPE_HEL:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a HEL message");
-        retval = processHEL(server, channel, message);
+        retval = processHEL(server, channel, &segments[0]);
         break;
     case UA_MESSAGETYPE_OPN:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process an OPN message");
-        retval = processOPN(server, channel, requestId, message);
+        retval = processOPN(server, channel, requestId, &segments[0]);
         break;
     case UA_MESSAGETYPE_MSG:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a MSG");
-        retval = processMSG(server, channel, requestId, message);
+        retval = processMSG(server, channel, requestId, segments, segmentsSize);
         break;
     case UA_MESSAGETYPE_CLO:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a CLO");
@@ -728,16 +732,15 @@ serverNetworkCallbackLocked(UA_ConnectionManager *cm, uintptr_t connectionId,
     while(UA_LIKELY(retval == UA_STATUSCODE_GOOD)) {
         UA_MessageType messageType;
         UA_UInt32 requestId = 0;
-        UA_ByteString payload = UA_BYTESTRING_NULL;
-        UA_Boolean copied = false;
+        UA_MessagePayload payload;
         retval = UA_SecureChannel_getCompleteMessage(channel, &messageType, &requestId,
-                                                     &payload, &copied, nowMonotonic);
+                                                     &payload, nowMonotonic);
         if(retval != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
-        retval = processSecureChannelMessage(bpm->drv.server, channel,
-                                             messageType, requestId, &payload);
-        if(copied)
-            UA_ByteString_clear(&payload);
+        retval = processSecureChannelMessage(bpm->drv.server, channel, messageType,
+                                             requestId, payload.segments,
+                                             payload.segmentsSize);
+        UA_MessagePayload_clear(&payload);
     }
     retval |= UA_SecureChannel_persistBuffer(channel);
 
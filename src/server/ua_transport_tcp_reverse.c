@@ -197,17 +197,15 @@ serverReverseConnectionCallbackLocked(UA_ConnectionManager *cm, uintptr_t connec
     while(UA_LIKELY(res == UA_STATUSCODE_GOOD)) {
         UA_MessageType messageType;
         UA_UInt32 requestId = 0;
-        UA_ByteString payload = UA_BYTESTRING_NULL;
-        UA_Boolean copied = false;
+        UA_MessagePayload payload;
         res = UA_SecureChannel_getCompleteMessage(context->channel, &messageType,
-                                                  &requestId, &payload,
-                                                  &copied, nowMonotonic);
+                                                  &requestId, &payload, nowMonotonic);
         if(res != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
         res = processSecureChannelMessage(rpm->drv.server, context->channel,
-                                          messageType, requestId, &payload);
-        if(copied)
-            UA_ByteString_clear(&payload);
+                                          messageType, requestId, payload.segments,
+                                          payload.segmentsSize);
+        UA_MessagePayload_clear(&payload);
     }
     res |= UA_SecureChannel_persistBuffer(context->channel);
 
@@ -215,6 +215,22 @@ UA_SecureChannel_deleteBuffered(UA_SecureChannel *channel) {
     deleteChunks(channel);
     if(channel->unprocessedCopied)
         UA_ByteString_clear(&channel->unprocessed);
+    channel->unprocessedCapacity = 0;
+}
+
+void
+UA_MessagePayload_clear(UA_MessagePayload *payload) {
+    UA_Chunk *chunk, *chunk_tmp;
+    TAILQ_FOREACH_SAFE(chunk, &payload->chunks, pointers, chunk_tmp) {
+        TAILQ_REMOVE(&payload->chunks, chunk, pointers);
+        UA_Chunk_delete(chunk);
+    }
+    if(payload->segments != &payload->final.bytes)
+        UA_free(payload->segments);
+    if(payload->final.copied)
+        UA_ByteString_clear(&payload->final.bytes);
+    memset(payload, 0, sizeof(UA_MessagePayload));
+    TAILQ_INIT(&payload->chunks);
 }
 
 void
@@ -469,6 +485,14 @@ encodeHeadersSym(UA_MessageContext *mc, size_t totalLength) {
     return res;
 }
 
+static void
+discardPendingChunks(UA_MessageContext *mc) {
+    UA_ConnectionManager *cm = mc->channel->connectionManager;
+    for(size_t i = 0; i < mc->pendingChunksSize; i++)
+        cm->freeNetworkBuffer(cm, mc->channel->connectionId, &mc->pendingChunks[i]);
+    mc->pendingChunksSize = 0;
+}
+
 static UA_StatusCode
 sendSymmetricChunk(UA_MessageContext *mc) {
     UA_SecureChannel *channel = mc->channel;
@@ -533,16 +557,33 @@ sendSymmetricChunk(UA_MessageContext *mc) {
 
     /* Send the chunk. The buffer is freed in the network layer. If sending goes
      * wrong, the connection is removed in the next iteration of the
-     * SecureChannel. Set the SecureChannel to closing already. */
-    res = cm->sendWithConnection(cm, channel->connectionId,
-                                 &UA_KEYVALUEMAP_NULL, &mc->messageBuffer);
+     * SecureChannel. Set the SecureChannel to closing already.
+     *
+     * With batched sending, the chunk is collected and the pending chunks are
+     * sent together once the batch is full or the message is complete. */
+    if(cm->sendWithConnectionBatch) {
+        mc->pendingChunks[mc->pendingChunksSize++] = mc->messageBuffer;
+        mc->messageBuffer = UA_BYTESTRING_NULL;
+        if(!mc->final &&
+           mc->pendingChunksSize < UA_MESSAGECONTEXT_MAXPENDINGCHUNKS)
+            return UA_STATUSCODE_GOOD;
+        res = cm->sendWithConnectionBatch(cm, channel->connectionId,
+                                          &UA_KEYVALUEMAP_NULL,
+                                          mc->pendingChunks,
+                                          mc->pendingChunksSize);
+        mc->pendingChunksSize = 0;
+    } else {
+        res = cm->sendWithConnection(cm, channel->connectionId,
+                                     &UA_KEYVALUEMAP_NULL, &mc->messageBuffer);
+    }
     if(res != UA_STATUSCODE_GOOD && UA_SecureChannel_isConnected(channel))
         channel->state = UA_SECURECHANNELSTATE_CLOSING;
     return res;
 
  error:
-    /* Free the unused message buffer */
+    /* Free the unused message buffer and the chunks not yet sent */
     cm->freeNetworkBuffer(cm, channel->connectionId, &mc->messageBuffer);
+    discardPendingChunks(mc);
     return res;
 }
 
@@ -593,6 +634,7 @@ UA_MessageContext_begin(UA_MessageContext *mc, UA_SecureChannel *channel,
     mc->messageSizeSoFar = 0;
     mc->final = false;
     mc->messageBuffer = UA_BYTESTRING_NULL;
+    mc->pendingChunksSize = 0;
     mc->messageType = messageType;
 
     /* Allocate the message buffer */
@@ -630,6 +672,9 @@ UA_MessageContext_finish(UA_MessageContext *mc) {
 void
 UA_MessageContext_abort(UA_MessageContext *mc) {
     UA_ConnectionManager *cm = mc->channel->connectionManager;
+    /* The pending chunks are released also for a disconnected channel. They
+     * may hold the static send buffer of the ConnectionManager. */
+    discardPendingChunks(mc);
     if(!UA_SecureChannel_isConnected(mc->channel))
         return;
     cm->freeNetworkBuffer(cm, mc->channel->connectionId, &mc->messageBuffer);
@@ -951,16 +996,24 @@ UA_SecureChannel_loadBuffer(UA_SecureChannel *channel, const UA_ByteString buffe
     if(channel->unprocessed.length > 0) {
         UA_assert(channel->unprocessedCopied == true);
 
-        UA_Byte *t = (UA_Byte*)
-            UA_realloc(channel->unprocessed.data,
-                       channel->unprocessed.length + buffer.length);
-        if(!t)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
+        /* Grow the capacity geometrically. A large chunk arriving in many small
+         * network buffers is then not copied again for every buffer. */
+        size_t length = channel->unprocessed.length + buffer.length;
+        if(length > channel->unprocessedCapacity) {
+            size_t capacity = channel->unprocessedCapacity * 2;
+            if(capacity < length)
+                capacity = length;
+            UA_Byte *t = (UA_Byte*)UA_realloc(channel->unprocessed.data, capacity);
+            if(!t)
+                return UA_STATUSCODE_BADOUTOFMEMORY;
+            channel->unprocessed.data = t;
+            channel->unprocessedCapacity = capacity;
+        }
 
         if(buffer.length)
-            memcpy(t + channel->unprocessed.length, buffer.data, buffer.length);
-        channel->unprocessed.data = t;
-        channel->unprocessed.length += buffer.length;
+            memcpy(channel->unprocessed.data + channel->unprocessed.length,
+                   buffer.data, buffer.length);
+        channel->unprocessed.length = length;
         return UA_STATUSCODE_GOOD;
     }
 
@@ -973,10 +1026,12 @@ UA_SecureChannel_loadBuffer(UA_SecureChannel *channel, const UA_ByteString buffe
 UA_StatusCode
 UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
                                     UA_MessageType *messageType, UA_UInt32 *requestId,
-                                    UA_ByteString *payload, UA_Boolean *copied,
+                                    UA_MessagePayload *payload,
                                     UA_DateTime nowMonotonic) {
-    UA_Chunk chunk, *pchunk;
+    UA_Chunk chunk, *pchunk, *next;
     UA_StatusCode res = UA_STATUSCODE_GOOD;
+    memset(payload, 0, sizeof(UA_MessagePayload));
+    TAILQ_INIT(&payload->chunks);
 
  extract_chunk:
     /* Extract+decode the next chunk from the buffer */
@@ -1021,12 +1076,12 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
     case UA_CHUNKTYPE_FINAL:
     default:
         UA_assert(chunk.chunkType == UA_CHUNKTYPE_FINAL); /* Was checked before */
-        break; /* A final chunk was received -- assemble the message */
+        break; /* A final chunk was received -- collect the message */
     }
 
     /* Compute the message size */
     size_t messageSize = chunk.bytes.length;
-    UA_Chunk *first = NULL;
+    size_t segmentsSize = 1;
     TAILQ_FOREACH(pchunk, &channel->chunks, pointers) {
         if(chunk.requestId != pchunk->requestId)
             continue;
@@ -1035,12 +1090,11 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
                 UA_ByteString_clear(&chunk.bytes);
             return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
         }
-        if(!first)
-            first = pchunk;
         messageSize += pchunk->bytes.length;
+        segmentsSize++;
     }
 
-    /* Validate the assembled message size */
+    /* Validate the message size */
     if(channel->config.localMaxMessageSize != 0 &&
        messageSize > channel->config.localMaxMessageSize) {
         if(chunk.copied)
@@ -1048,67 +1102,39 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
         return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
     }
 
-    /* Assemble the full payload and store it in chunk.bytes */
-    if(messageSize > chunk.bytes.length) {
-        UA_assert(first != NULL);
-
-        /* Allocate the full memory and initialize with the first chunk content.
-         * Use realloc to speed up. */
-        UA_ByteString message;
-        if(first->copied) {
-            message.data = (UA_Byte*)UA_realloc(first->bytes.data, messageSize);
-        } else {
-            message.data = (UA_Byte*)UA_malloc(messageSize);
-            if(message.data)
-                memcpy(message.data, first->bytes.data, first->bytes.length);
-        }
-        if(!message.data) {
-            if(chunk.copied)
-                UA_ByteString_clear(&chunk.bytes);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-        message.length = first->bytes.length;
+    /* Single-chunk message */
+    payload->final = chunk;
+    payload->length = messageSize;
+    payload->segmentsSize = segmentsSize;
+    if(segmentsSize == 1) {
+        payload->segments = &payload->final.bytes;
+        goto done;
+    }
 
-        /* Remove the the first chunk */
-        pchunk = TAILQ_NEXT(first, pointers);
-        first->copied = false;
+    /* Move the intermediate chunks of the message into the payload. Their
+     * content is not copied into a contiguous buffer. */
+    payload->segments = (UA_ByteString*)
+        UA_malloc(segmentsSize * sizeof(UA_ByteString));
+    if(!payload->segments) {
+        UA_MessagePayload_clear(payload);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    size_t i = 0;
+    TAILQ_FOREACH_SAFE(pchunk, &channel->chunks, pointers, next) {
+        if(chunk.requestId != pchunk->requestId)
+            continue;
         channel->chunksCount--;
-        channel->chunksLength -= first->bytes.length;
-        TAILQ_REMOVE(&channel->chunks, first, pointers);
-        UA_Chunk_delete(first);
-
-        /* Copy over the content from the remaining intermediate chunks.
-         * And remove them right away. */
-        UA_Chunk *next;
-        for(; pchunk; pchunk = next) {
-            next = TAILQ_NEXT(pchunk, pointers);
-            if(chunk.requestId != pchunk->requestId)
-                continue;
-            memcpy(message.data + message.length, pchunk->bytes.data, pchunk->bytes.length);
-            message.length += pchunk->bytes.length;
-            channel->chunksCount--;
-            channel->chunksLength -= pchunk->bytes.length;
-            TAILQ_REMOVE(&channel->chunks, pchunk, pointers);
-            UA_Chunk_delete(pchunk);
-        }
-
-        /* Copy over the content from the final chunk */
-        memcpy(message.data + message.length, chunk.bytes.data, chunk.bytes.length);
-        message.length += chunk.bytes.length;
-        UA_assert(message.length == messageSize);
-
-        /* Set assembled message as the content of the final chunk */
-        if(chunk.copied)
-            UA_ByteString_clear(&chunk.bytes);
-        chunk.bytes = message;
-        chunk.copied = true;
+        channel->chunksLength -= pchunk->bytes.length;
+        TAILQ_REMOVE(&channel->chunks, pchunk, pointers);
+        TAILQ_INSERT_TAIL(&payload->chunks, pchunk, pointers);
+        payload->segments[i++] = pchunk->bytes;
     }
+    payload->segments[i] = chunk.bytes;
+    UA_assert(i + 1 == segmentsSize);
 
-    /* Return the assembled message */
+ done:
     *requestId = chunk.requestId;
     *messageType = chunk.messageType;
-    *payload = chunk.bytes;
-    *copied = chunk.copied;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -1135,6 +1161,19 @@ UA_SecureChannel_persistBuffer(UA_SecureChannel *channel) {
         else
             UA_ByteString_init(&channel->unprocessed);
         channel->unprocessedOffset = 0;
+        channel->unprocessedCapacity = 0;
+        return res;
+    }
+
+    /* Move the remaining bytes to the front of the copied buffer. This retains
+     * the capacity for the next loadBuffer. */
+    if(channel->unprocessedCopied) {
+        size_t remaining = channel->unprocessed.length - channel->unprocessedOffset;
+        if(channel->unprocessedOffset > 0)
+            memmove(channel->unprocessed.data,
+                    channel->unprocessed.data + channel->unprocessedOffset, remaining);
+        channel->unprocessed.length = remaining;
+        channel->unprocessedOffset = 0;
         return res;
     }
 
@@ -1145,10 +1184,9 @@ UA_SecureChannel_persistBuffer(UA_SecureChannel *channel) {
     remaining.data += channel->unprocessedOffset;
     remaining.length -= channel->unprocessedOffset;
     res |= UA_ByteString_copy(&remaining, &tmp);
-    if(channel->unprocessedCopied)
-        UA_ByteString_clear(&channel->unprocessed);
     channel->unprocessed = tmp;
     channel->unprocessedOffset = 0;
+    channel->unprocessedCapacity = tmp.length;
     channel->unprocessedCopied = true;
     return res;
 }
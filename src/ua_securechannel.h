@@ -101,6 +101,22 @@ typedef struct UA_Chunk {
 
 typedef TAILQ_HEAD(UA_ChunkQueue, UA_Chunk) UA_ChunkQueue;
 
+/* Payload of a received message. The chunks of a message are not assembled
+ * into a contiguous buffer. Instead, the payload of each chunk is a segment of
+ * the message that is decoded with UA_decodeBinarySegmentsInternal. Messages
+ * received in a single chunk have one segment. The segments can point into the
+ * network buffer and the struct must not be moved in memory. */
+typedef struct {
+    UA_ByteString *segments;
+    size_t segmentsSize;
+    size_t length;         /* Summed over all segments */
+    UA_Chunk final;        /* The final chunk of the message */
+    UA_ChunkQueue chunks;  /* The intermediate chunks of the message */
+} UA_MessagePayload;
+
+void
+UA_MessagePayload_clear(UA_MessagePayload *payload);
+
 typedef enum {
     UA_SECURECHANNELRENEWSTATE_NORMAL,
 
@@ -237,6 +253,7 @@ struct UA_SecureChannel {
     /* Received buffer from which no chunks have been extracted so far */
     UA_ByteString unprocessed;
     size_t unprocessedOffset;
+    size_t unprocessedCapacity; /* Allocated length if unprocessedCopied */
     UA_Boolean unprocessedCopied;
     UA_DelayedCallback unprocessedDelayed;
 
@@ -422,9 +439,14 @@ extern const UA_String UA_HTTP_PROFILE_HTTPS_JSON;
 extern const UA_String UA_HTTP_PROFILE_HTTP_JSON;
 #endif
 
+/* Maximum number of finished chunks that are collected before they are handed
+ * to the ConnectionManager in one batch */
+#define UA_MESSAGECONTEXT_MAXPENDINGCHUNKS 16
+
 /* The MessageContext is forwarded into the encoding layer so that we can send
  * chunks before continuing to encode. This lets us reuse a fixed chunk-sized
- * messages buffer. */
+ * messages buffer. If the ConnectionManager supports batched sending, then the
+ * finished chunks are collected and sent together. */
 typedef struct {
     UA_SecureChannel *channel;
     UA_UInt32 requestId;
@@ -437,6 +459,9 @@ typedef struct {
     UA_Byte *buf_pos;
     const UA_Byte *buf_end;
 
+    UA_ByteString pendingChunks[UA_MESSAGECONTEXT_MAXPENDINGCHUNKS];
+    size_t pendingChunksSize;
+
     UA_Boolean final;
 } UA_MessageContext;
 
@@ -471,8 +496,9 @@ UA_MessageContext_abort(UA_MessageContext *mc);
  *
  * 1. loadBuffer: The chunks in the SecureChannel are cut into chunks.
  *    The chunks can still point to the buffer.
- * 2. getCompleteMessage: Assemble chunks into a complete message. This is
- *    repeated until an error occours or an empty message is returned.
+ * 2. getCompleteMessage: Collect the chunks of a complete message. This is
+ *    repeated until an error occours or an empty message is returned. The
+ *    payload has to be cleared after it was processed.
  * 3. persistBuffer: Make a copy of the remaining unpprocessed bytestring. So
  *    that the NetworkManager can reuse or free the packet memory.
  *
@@ -484,7 +510,7 @@ UA_SecureChannel_loadBuffer(UA_SecureChannel *channel, const UA_ByteString buffe
 UA_StatusCode
 UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
                                     UA_MessageType *messageType, UA_UInt32 *requestId,
-                                    UA_ByteString *payload, UA_Boolean *copied,
+                                    UA_MessagePayload *payload,
                                     UA_DateTime nowMonotonic);
 
 UA_StatusCode
@@ -61,26 +61,238 @@ expandedNodeIdOrder(const void *p1_, const void *p2_, const UA_DataType *_);
 static UA_Order
 guidOrder(const void *p1_, const void *p2_, const UA_DataType *_);
 
+/* Perfect-hash lookup in UA_TYPES with the tables generated by
+ * tools/generate_datatypes.py. The hash functions must be identical to the
+ * generator. Returns UA_UINT16_MAX if the slot is empty. The caller has to
+ * verify that the type at the returned index matches the key. */
+static UA_UInt16
+builtinTypesHashLookup(const UA_UInt16 *disp, UA_Byte bucketBits,
+                       const UA_UInt16 *slots, UA_Byte slotBits,
+                       UA_UInt32 key) {
+    UA_UInt32 bucket = (UA_UInt32)(key * 0x9E3779B1u) >> (32 - bucketBits);
+    UA_UInt32 d = (UA_UInt32)disp[bucket] * 0x9E3779B1u;
+    UA_UInt32 slot = (UA_UInt32)((key ^ d) * 0x85EBCA6Bu) >> (32 - slotBits);
+    return slots[slot];
+}
+
+/* All types in UA_TYPES have a numeric NodeId in namespace zero. This is
+ * ensured by the generator. */
+static const UA_DataType *
+findBuiltinType(const UA_NodeId *typeId) {
+    if(typeId->namespaceIndex != 0 ||
+       typeId->identifierType != UA_NODEIDTYPE_NUMERIC)
+        return NULL;
+    UA_UInt16 index =
+        builtinTypesHashLookup(UA_TYPES_TYPEID_HASH_DISP,
+                               UA_TYPES_TYPEID_HASH_BUCKETBITS,
+                               UA_TYPES_TYPEID_HASH_SLOTS,
+                               UA_TYPES_TYPEID_HASH_SLOTBITS,
+                               typeId->identifier.numeric);
+    if(index >= UA_TYPES_COUNT ||
+       UA_TYPES[index].typeId.identifier.numeric != typeId->identifier.numeric)
+        return NULL;
+    return &UA_TYPES[index];
+}
+
+static const UA_DataType *
+findBuiltinTypeByBinary(const UA_NodeId *binaryEncodingId) {
+    if(binaryEncodingId->namespaceIndex != 0 ||
+       binaryEncodingId->identifierType != UA_NODEIDTYPE_NUMERIC)
+        return NULL;
+    UA_UInt16 index =
+        builtinTypesHashLookup(UA_TYPES_BINARYID_HASH_DISP,
+                               UA_TYPES_BINARYID_HASH_BUCKETBITS,
+                               UA_TYPES_BINARYID_HASH_SLOTS,
+                               UA_TYPES_BINARYID_HASH_SLOTBITS,
+                               binaryEncodingId->identifier.numeric);
+    if(index >= UA_TYPES_COUNT ||
+       UA_TYPES[index].binaryEncodingId.identifier.numeric !=
+       binaryEncodingId->identifier.numeric)
+        return NULL;
+    return &UA_TYPES[index];
+}
+
+/* The index of the custom types is an open-addressing hash table with linear
+ * probing for both the typeId and the binaryEncodingId. It covers the entire
+ * linked list of DataTypeArrays. The index is not part of the (public)
+ * DataTypeArray. It is owned by the server/client that configures the custom
+ * types. The layout of the indexed list is remembered to detect changes. */
+typedef struct {
+    UA_UInt32 hash;
+    const UA_DataType *type; /* NULL denotes an empty slot */
+} DataTypeIndexSlot;
+
+typedef struct {
+    const UA_DataTypeArray *array;
+    const UA_DataType *types;
+    size_t typesSize;
+} DataTypeIndexArray;
+
+struct UA_DataTypeIndex {
+    size_t arraysSize;
+    DataTypeIndexArray *arrays;
+
+    size_t mask; /* Number of slots minus one (power of two) */
+    DataTypeIndexSlot *typeIdSlots;
+    DataTypeIndexSlot *binarySlots;
+};
+
+static void
+indexInsert(DataTypeIndexSlot *slots, size_t mask,
+            const UA_DataType *type, size_t nodeIdOffset) {
+    const UA_NodeId *id = (const UA_NodeId*)((uintptr_t)type + nodeIdOffset);
+    UA_UInt32 h = UA_NodeId_hash(id);
+    for(size_t i = h & mask; ; i = (i + 1) & mask) {
+        if(!slots[i].type) {
+            slots[i].hash = h;
+            slots[i].type = type;
+            return;
+        }
+        /* Keep only the first occurrence (same as a linear search) */
+        const UA_NodeId *other = (const UA_NodeId*)
+            ((uintptr_t)slots[i].type + nodeIdOffset);
+        if(slots[i].hash == h && UA_NodeId_equal(id, other))
+            return;
+    }
+}
+
+static const UA_DataType *
+indexLookup(const UA_DataTypeIndex *index, const DataTypeIndexSlot *slots,
+            const UA_NodeId *id, size_t nodeIdOffset) {
+    UA_UInt32 h = UA_NodeId_hash(id);
+    for(size_t i = h & index->mask; slots[i].type; i = (i + 1) & index->mask) {
+        if(slots[i].hash != h)
+            continue;
+        const UA_NodeId *other = (const UA_NodeId*)
+            ((uintptr_t)slots[i].type + nodeIdOffset);
+        if(UA_NodeId_equal(id, other))
+            return slots[i].type;
+    }
+    return NULL;
+}
+
+UA_StatusCode
+UA_DataTypeIndex_new(const UA_DataTypeArray *customTypes,
+                     UA_DataTypeIndex **index) {
+    *index = NULL;
+    size_t arraysSize = 0;
+    size_t typesSize = 0;
+    for(const UA_DataTypeArray *a = customTypes; a; a = a->next) {
+        arraysSize++;
+        typesSize += a->typesSize;
+    }
+    if(arraysSize == 0)
+        return UA_STATUSCODE_GOOD;
+
+    /* At most half-full */
+    size_t slotsSize = 8;
+    while(slotsSize < typesSize * 2)
+        slotsSize <<= 1;
+
+    /* Allocate the index, the arrays and the slots in a single block */
+    UA_DataTypeIndex *idx = (UA_DataTypeIndex*)
+        UA_calloc(1, sizeof(UA_DataTypeIndex) +
+                  (arraysSize * sizeof(DataTypeIndexArray)) +
+                  (2 * slotsSize * sizeof(DataTypeIndexSlot)));
+    if(!idx)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    idx->typeIdSlots = (DataTypeIndexSlot*)&idx[1];
+    idx->binarySlots = &idx->typeIdSlots[slotsSize];
+    idx->arrays = (DataTypeIndexArray*)&idx->binarySlots[slotsSize];
+    idx->arraysSize = arraysSize;
+    idx->mask = slotsSize - 1;
+
+    /* Insert in the order of the linear search */
+    size_t i = 0;
+    for(const UA_DataTypeArray *a = customTypes; a; a = a->next, i++) {
+        idx->arrays[i].array = a;
+        idx->arrays[i].types = a->types;
+        idx->arrays[i].typesSize = a->typesSize;
+        for(size_t j = 0; j < a->typesSize; j++) {
+            indexInsert(idx->typeIdSlots, idx->mask, &a->types[j],
+                        offsetof(UA_DataType, typeId));
+            indexInsert(idx->binarySlots, idx->mask, &a->types[j],
+                        offsetof(UA_DataType, binaryEncodingId));
+        }
+    }
+
+    *index = idx;
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_DataTypeIndex_delete(UA_DataTypeIndex *index) {
+    UA_free(index);
+}
+
+UA_Boolean
+UA_DataTypeIndex_isCurrent(const UA_DataTypeIndex *index,
+                           const UA_DataTypeArray *customTypes) {
+    if(!index)
+        return (customTypes == NULL);
+    size_t i = 0;
+    for(; customTypes; customTypes = customTypes->next, i++) {
+        if(i == index->arraysSize ||
+           index->arrays[i].array != customTypes ||
+           index->arrays[i].types != customTypes->types ||
+           index->arrays[i].typesSize != customTypes->typesSize)
+            return false;
+    }
+    return (i == index->arraysSize);
+}
+
 const UA_DataType *
 UA_findDataTypeWithCustom(const UA_NodeId *typeId,
                           const UA_DataTypeArray *customTypes) {
-    /* Always look in built-in types first (may contain data types from all
-     * namespaces).
-     *
-     * TODO: The standard-defined types are ordered. See if binary search is
-     * more efficient. */
-    for(size_t i = 0; i < UA_TYPES_COUNT; ++i) {
-        if(nodeIdOrder(&UA_TYPES[i].typeId, typeId, NULL) == UA_ORDER_EQ)
-            return &UA_TYPES[i];
-    }
+    /* Always look in built-in types first */
+    const UA_DataType *type = findBuiltinType(typeId);
+    if(type)
+        return type;
 
     /* Search in the customTypes */
-    while(customTypes) {
+    for(; customTypes; customTypes = customTypes->next) {
         for(size_t i = 0; i < customTypes->typesSize; ++i) {
             if(nodeIdOrder(&customTypes->types[i].typeId, typeId, NULL) == UA_ORDER_EQ)
                 return &customTypes->types[i];
         }
-        customTypes = customTypes->next;
+    }
+
+    return NULL;
+}
+
+const UA_DataType *
+UA_findDataTypeIndexed(const UA_NodeId *typeId,
+                       const UA_DataTypeArray *customTypes,
+                       const UA_DataTypeIndex *index) {
+    if(!index || !UA_DataTypeIndex_isCurrent(index, customTypes))
+        return UA_findDataTypeWithCustom(typeId, customTypes);
+    const UA_DataType *type = findBuiltinType(typeId);
+    if(type)
+        return type;
+    return indexLookup(index, index->typeIdSlots, typeId,
+                       offsetof(UA_DataType, typeId));
+}
+
+const UA_DataType *
+UA_findDataTypeByBinaryIndexed(const UA_NodeId *binaryEncodingId,
+                               const UA_DataTypeArray *customTypes,
+                               const UA_DataTypeIndex *index) {
+    /* Always look in built-in types first */
+    const UA_DataType *type = findBuiltinTypeByBinary(binaryEncodingId);
+    if(type)
+        return type;
+
+    /* Search in the index if it matches the customTypes */
+    if(index && UA_DataTypeIndex_isCurrent(index, customTypes))
+        return indexLookup(index, index->binarySlots, binaryEncodingId,
+                           offsetof(UA_DataType, binaryEncodingId));
+
+    /* Linear search in the customTypes */
+    for(; customTypes; customTypes = customTypes->next) {
+        for(size_t i = 0; i < customTypes->typesSize; ++i) {
+            if(UA_NodeId_equal(binaryEncodingId, &customTypes->types[i].binaryEncodingId))
+                return &customTypes->types[i];
+        }
     }
 
     return NULL;
@@ -121,6 +121,111 @@ encodeWithExchangeBuffer(Ctx *ctx, const void *ptr, const UA_DataType *type) {
     return ret;
 }
 
+/* Decoding can read from a buffer that is split into segments (e.g. the chunks
+ * of a SecureChannel message). The decoders read between ctx->pos and ctx->end
+ * as for a contiguous buffer. Only when a value crosses the end of the current
+ * segment, the slow path continues in the next segment. */
+
+/* Move to the next non-empty segment */
+static UA_Boolean
+nextSegment(Ctx *ctx) {
+    while(ctx->segment + 1 < ctx->segmentsSize) {
+        const UA_ByteString *seg = &ctx->segments[++ctx->segment];
+        if(seg->length == 0)
+            continue;
+        ctx->tailLength -= seg->length;
+        ctx->pos = seg->data;
+        ctx->end = seg->data + seg->length;
+        return true;
+    }
+    return false;
+}
+
+static UA_INLINE size_t
+remainingBytes(const Ctx *ctx) {
+    return (size_t)(ctx->end - ctx->pos) + ctx->tailLength;
+}
+
+/* Copy n bytes and advance the position. The remaining length was checked
+ * before. */
+static void
+copyBytes(Ctx *ctx, u8 *dst, size_t n) {
+    while(n > 0) {
+        size_t avail = (size_t)(ctx->end - ctx->pos);
+        if(avail == 0) {
+            UA_Boolean next = nextSegment(ctx);
+            UA_assert(next);
+            (void)next;
+            continue;
+        }
+        if(avail > n)
+            avail = n;
+        memcpy(dst, ctx->pos, avail);
+        ctx->pos += avail;
+        dst += avail;
+        n -= avail;
+    }
+}
+
+static const u8 *
+readBytesSegmented(Ctx *ctx, u8 *buf, size_t n) {
+    if(n > remainingBytes(ctx))
+        return NULL;
+    copyBytes(ctx, buf, n);
+    return buf;
+}
+
+/* Returns a pointer to the next n bytes and advances the position. Bytes that
+ * cross a segment boundary are copied into buf (of length n). Returns NULL if
+ * the input ends before. */
+static UA_INLINE const u8 *
+readBytes(Ctx *ctx, u8 *buf, size_t n) {
+    if(UA_LIKELY(ctx->pos + n <= ctx->end)) {
+        const u8 *p = ctx->pos;
+        ctx->pos += n;
+        return p;
+    }
+    return readBytesSegmented(ctx, buf, n);
+}
+
+static status
+skipBytes(Ctx *ctx, size_t n) {
+    UA_CHECK(n <= remainingBytes(ctx), return UA_STATUSCODE_BADDECODINGERROR);
+    while(n > (size_t)(ctx->end - ctx->pos)) {
+        n -= (size_t)(ctx->end - ctx->pos);
+        ctx->pos = (u8*)(uintptr_t)ctx->end;
+        UA_Boolean next = nextSegment(ctx);
+        UA_assert(next);
+        (void)next;
+    }
+    ctx->pos += n;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Saved decoding position to backtrack */
+typedef struct {
+    u8 *pos;
+    const u8 *end;
+    size_t segment;
+    size_t tailLength;
+} DecodePos;
+
+static UA_INLINE void
+savePos(const Ctx *ctx, DecodePos *p) {
+    p->pos = ctx->pos;
+    p->end = ctx->end;
+    p->segment = ctx->segment;
+    p->tailLength = ctx->tailLength;
+}
+
+static UA_INLINE void
+restorePos(Ctx *ctx, const DecodePos *p) {
+    ctx->pos = p->pos;
+    ctx->end = p->end;
+    ctx->segment = p->segment;
+    ctx->tailLength = p->tailLength;
+}
+
 /*****************/
 /* Integer Types */
 /*****************/
@@ -191,9 +296,10 @@ FUNC_ENCODE_BINARY(Boolean) {
 
 FUNC_DECODE_BINARY(Boolean) {
     UA_Boolean *dst = (UA_Boolean*)_dst;
-    UA_CHECK(ctx->pos + 1 <= ctx->end, return UA_STATUSCODE_BADDECODINGERROR);
-    *dst = (*ctx->pos > 0) ? true : false;
-    ++ctx->pos;
+    u8 buf[1];
+    const u8 *p = readBytes(ctx, buf, 1);
+    UA_CHECK(p != NULL, return UA_STATUSCODE_BADDECODINGERROR);
+    *dst = (*p > 0) ? true : false;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -209,10 +315,10 @@ FUNC_ENCODE_BINARY(Byte) {
 
 FUNC_DECODE_BINARY(Byte) {
     UA_Byte *dst = (UA_Byte*)_dst;
-    UA_CHECK(ctx->pos + sizeof(u8) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
-    *dst = *ctx->pos;
-    ++ctx->pos;
+    u8 buf[sizeof(u8)];
+    const u8 *p = readBytes(ctx, buf, sizeof(u8));
+    UA_CHECK(p != NULL, return UA_STATUSCODE_BADDECODINGERROR);
+    *dst = *p;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -232,14 +338,14 @@ FUNC_ENCODE_BINARY(UInt16) {
 
 FUNC_DECODE_BINARY(UInt16) {
     UA_UInt16 *dst = (UA_UInt16*)_dst;
-    UA_CHECK(ctx->pos + sizeof(u16) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    u8 buf[sizeof(u16)];
+    const u8 *p = readBytes(ctx, buf, sizeof(u16));
+    UA_CHECK(p != NULL, return UA_STATUSCODE_BADDECODINGERROR);
 #if UA_BINARY_OVERLAYABLE_INTEGER
-    memcpy(dst, ctx->pos, sizeof(u16));
+    memcpy(dst, p, sizeof(u16));
 #else
-    UA_decode16(ctx->pos, dst);
+    UA_decode16(p, dst);
 #endif
-    ctx->pos += 2;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -259,14 +365,14 @@ FUNC_ENCODE_BINARY(UInt32) {
 
 FUNC_DECODE_BINARY(UInt32) {
     UA_UInt32 *dst = (UA_UInt32*)_dst;
-    UA_CHECK(ctx->pos + sizeof(u32) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    u8 buf[sizeof(u32)];
+    const u8 *p = readBytes(ctx, buf, sizeof(u32));
+    UA_CHECK(p != NULL, return UA_STATUSCODE_BADDECODINGERROR);
 #if UA_BINARY_OVERLAYABLE_INTEGER
-    memcpy(dst, ctx->pos, sizeof(u32));
+    memcpy(dst, p, sizeof(u32));
 #else
-    UA_decode32(ctx->pos, dst);
+    UA_decode32(p, dst);
 #endif
-    ctx->pos += 4;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -286,14 +392,14 @@ FUNC_ENCODE_BINARY(UInt64) {
 
 FUNC_DECODE_BINARY(UInt64) {
     UA_UInt64 *dst = (UA_UInt64*)_dst;
-    UA_CHECK(ctx->pos + sizeof(u64) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    u8 buf[sizeof(u64)];
+    const u8 *p = readBytes(ctx, buf, sizeof(u64));
+    UA_CHECK(p != NULL, return UA_STATUSCODE_BADDECODINGERROR);
 #if UA_BINARY_OVERLAYABLE_INTEGER
-    memcpy(dst, ctx->pos, sizeof(u64));
+    memcpy(dst, p, sizeof(u64));
 #else
-    UA_decode64(ctx->pos, dst);
+    UA_decode64(p, dst);
 #endif
-    ctx->pos += 8;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -528,7 +634,7 @@ Array_decodeBinary(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
      * sizeof(UA_DataValue) == 80 and an empty DataValue is encoded with just
      * one byte. We use 128 as the smallest power of 2 larger than 80. */
     size_t length = (size_t)signed_length;
-    size_t remaining = (size_t)(ctx->end - ctx->pos);
+    size_t remaining = remainingBytes(ctx);
     UA_CHECK(length / 128 <= remaining / type->memSize,
              return UA_STATUSCODE_BADDECODINGERROR);
 
@@ -538,13 +644,12 @@ Array_decodeBinary(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
 
     if(type->overlayable) {
         /* memcpy overlayable array */
-        if(ctx->pos + (type->memSize * length) > ctx->end){
+        if(type->memSize * length > remaining) {
             ctxFree(ctx, *dst);
             *dst = NULL;
             return UA_STATUSCODE_BADDECODINGERROR;
         }
-        memcpy(*dst, ctx->pos, type->memSize * length);
-        ctx->pos += type->memSize * length;
+        copyBytes(ctx, (u8*)*dst, type->memSize * length);
     } else {
         /* Decode array members */
         uintptr_t ptr = (uintptr_t)*dst;
@@ -599,10 +704,9 @@ FUNC_DECODE_BINARY(Guid) {
     ret |= DECODE_DIRECT(&dst->data1, UInt32);
     ret |= DECODE_DIRECT(&dst->data2, UInt16);
     ret |= DECODE_DIRECT(&dst->data3, UInt16);
-    UA_CHECK(ctx->pos + (8*sizeof(u8)) <= ctx->end,
+    UA_CHECK(8*sizeof(u8) <= remainingBytes(ctx),
              return UA_STATUSCODE_BADDECODINGERROR);
-    memcpy(dst->data4, ctx->pos, 8*sizeof(u8));
-    ctx->pos += 8;
+    copyBytes(ctx, dst->data4, 8*sizeof(u8));
     return ret;
 }
 
@@ -776,8 +880,9 @@ FUNC_ENCODE_BINARY(ExpandedNodeId) {
 
 FUNC_DECODE_BINARY(ExpandedNodeId) {
     UA_ExpandedNodeId *dst = (UA_ExpandedNodeId*)_dst;
-    /* Decode the encoding mask */
-    UA_CHECK(ctx->pos + 1 <= ctx->end, return UA_STATUSCODE_BADDECODINGERROR);
+    /* Peek the encoding mask. It can be at the start of the next segment. */
+    if(ctx->pos >= ctx->end && !nextSegment(ctx))
+        return UA_STATUSCODE_BADDECODINGERROR;
     u8 encoding = *ctx->pos;
 
     /* Decode the NodeId */
@@ -867,33 +972,15 @@ FUNC_DECODE_BINARY(LocalizedText) {
  * possible to reuse UA_findDataType */
 static const UA_DataType *
 UA_findDataTypeByBinaryInternal(Ctx *ctx, const UA_NodeId *typeId) {
-    /* Always look in the built-in types first. Assume that only numeric
-     * identifiers are used for the builtin types. (They may contain data types
-     * from all namespaces though.) */
-    if(typeId->identifierType == UA_NODEIDTYPE_NUMERIC) {
-        for(size_t i = 0; i < UA_TYPES_COUNT; ++i) {
-            if(UA_TYPES[i].binaryEncodingId.identifier.numeric == typeId->identifier.numeric &&
-               UA_TYPES[i].binaryEncodingId.namespaceIndex == typeId->namespaceIndex)
-                return &UA_TYPES[i];
-        }
-    }
-
-    const UA_DataTypeArray *customTypes = ctx->opts.customTypes;
-    while(customTypes) {
-        for(size_t i = 0; i < customTypes->typesSize; ++i) {
-            if(UA_NodeId_equal(typeId, &customTypes->types[i].binaryEncodingId))
-                return &customTypes->types[i];
-        }
-        customTypes = customTypes->next;
-    }
-
-    return NULL;
+    return UA_findDataTypeByBinaryIndexed(typeId, ctx->opts.customTypes,
+                                          ctx->typesIndex);
 }
 
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId) {
     Ctx ctx;
     ctx.opts.customTypes = NULL;
+    ctx.typesIndex = NULL;
     return UA_findDataTypeByBinaryInternal(&ctx, typeId);
 }
 
@@ -992,13 +1079,13 @@ ExtensionObject_decodeBinaryContent(Ctx *ctx, UA_ExtensionObject *dst,
     u32 member_length = 0;
     status ret = DECODE_DIRECT(&member_length, UInt32);
     UA_CHECK_STATUS(ret, return ret);
-    UA_CHECK(member_length <= (size_t)(ctx->end - ctx->pos),
-             return UA_STATUSCODE_BADDECODINGERROR);
-    const u8 *expected_end = ctx->pos + member_length;
+    size_t remaining = remainingBytes(ctx);
+    UA_CHECK(member_length <= remaining, return UA_STATUSCODE_BADDECODINGERROR);
+    size_t expected_remaining = remaining - member_length;
 
     /* Decode */
     ret = decodeBinaryJumpTable[type->typeKind](ctx, dst->content.decoded.data, type);
-    if(ret == UA_STATUSCODE_GOOD && ctx->pos != expected_end)
+    if(ret == UA_STATUSCODE_GOOD && remainingBytes(ctx) != expected_remaining)
         return UA_STATUSCODE_BADDECODINGERROR;
     return ret;
 }
@@ -1148,7 +1235,8 @@ static status
 Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
     /* Save the position in the ByteString. If unwrapping is not possible, start
      * from here to decode a normal ExtensionObject. */
-    u8 *old_pos = ctx->pos;
+    DecodePos old_pos;
+    savePos(ctx, &old_pos);
 
     /* Decode the DataType */
     UA_NodeId typeId;
@@ -1162,7 +1250,8 @@ Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
     UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &typeId); return ret);
 
     /* Search for the datatype. Default to ExtensionObject. */
-    const u8 *expected_end = NULL;
+    UA_Boolean checkLength = false;
+    size_t expected_remaining = 0;
     if(encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING &&
        (dst->type = UA_findDataTypeByBinaryInternal(ctx, &typeId)) != NULL) {
         /* Read the length field and validate that the inner decoder consumes
@@ -1170,13 +1259,15 @@ Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
         u32 member_length = 0;
         ret = DECODE_DIRECT(&member_length, UInt32);
         UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &typeId); return ret);
-        UA_CHECK(member_length <= (size_t)(ctx->end - ctx->pos),
+        size_t remaining = remainingBytes(ctx);
+        UA_CHECK(member_length <= remaining,
                  ctxClearNodeId(ctx, &typeId); return UA_STATUSCODE_BADDECODINGERROR);
-        expected_end = ctx->pos + member_length;
+        expected_remaining = remaining - member_length;
+        checkLength = true;
     } else {
         /* Reset and decode as ExtensionObject */
         dst->type = &UA_TYPES[UA_TYPES_EXTENSIONOBJECT];
-        ctx->pos = old_pos;
+        restorePos(ctx, &old_pos);
     }
     ctxClearNodeId(ctx, &typeId);
 
@@ -1186,7 +1277,8 @@ Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
 
     /* Decode the content */
     ret = decodeBinaryJumpTable[dst->type->typeKind](ctx, dst->data, dst->type);
-    if(ret == UA_STATUSCODE_GOOD && expected_end != NULL && ctx->pos != expected_end)
+    if(ret == UA_STATUSCODE_GOOD && checkLength &&
+       remainingBytes(ctx) != expected_remaining)
         return UA_STATUSCODE_BADDECODINGERROR;
     return ret;
 }
@@ -1196,7 +1288,8 @@ Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
 static status
 Variant_decodeBinaryUnwrapExtensionObjectArray(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
                                                size_t *out_length, const UA_DataType **type) {
-    u8 *orig_pos = ctx->pos;
+    DecodePos orig_pos;
+    savePos(ctx, &orig_pos);
 
     /* Decode the length */
     i32 signed_length;
@@ -1219,10 +1312,13 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(Ctx *ctx, void *UA_RESTRICT *UA_R
      * ExtensionObject is at least 4 byte long (3 byte NodeId + 1 Byte encoding
      * field). */
     size_t length = (size_t)signed_length;
-    UA_CHECK(ctx->pos + ((4 * length) / 32) <= ctx->end,
+    UA_CHECK((4 * length) / 32 <= remainingBytes(ctx),
              return UA_STATUSCODE_BADDECODINGERROR);
 
     /* Decode the type NodeId of the first member */
+    DecodePos members_pos;
+    savePos(ctx, &members_pos);
+    size_t members_remaining = remainingBytes(ctx);
     UA_NodeId binTypeId;
     UA_NodeId_init(&binTypeId);
     ret |= DECODE_DIRECT(&binTypeId, NodeId);
@@ -1233,7 +1329,7 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(Ctx *ctx, void *UA_RESTRICT *UA_R
     ctxClearNodeId(ctx, &binTypeId);
     if(!contentType) {
         /* DataType unknown, decode as ExtensionObject array */
-        ctx->pos = orig_pos;
+        restorePos(ctx, &orig_pos);
         return Array_decodeBinary(ctx, dst, out_length, *type);
     }
 
@@ -1244,33 +1340,42 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(Ctx *ctx, void *UA_RESTRICT *UA_R
     if(encoding != UA_EXTENSIONOBJECT_ENCODED_BYTESTRING) {
         /* Encoding format is not automatically decoded, decode as
          * ExtensionObject array */
-        ctx->pos = orig_pos;
+        restorePos(ctx, &orig_pos);
         return Array_decodeBinary(ctx, dst, out_length, *type);
     }
 
-    /* Compare the header of all array members if the array can be unwrapped */
-    UA_ByteString header = {(uintptr_t)ctx->pos - (uintptr_t)orig_pos - 4, &orig_pos[4]};
-    UA_ByteString compare_header = header;
-    ctx->pos = &orig_pos[4];
+    /* Get the header of the first member. A header that crosses a segment
+     * boundary is copied into headerBuf. Headers too long for that are
+     * decoded as an ExtensionObject array. */
+    u8 headerBuf[64];
+    u8 compareBuf[sizeof(headerBuf)];
+    size_t headerLength = members_remaining - remainingBytes(ctx);
+    if(ctx->segmentsSize > 1 && headerLength > sizeof(headerBuf)) {
+        restorePos(ctx, &orig_pos);
+        return Array_decodeBinary(ctx, dst, out_length, *type);
+    }
+    restorePos(ctx, &members_pos);
+    const u8 *header = readBytes(ctx, headerBuf, headerLength);
+    UA_assert(header != NULL);
+    restorePos(ctx, &members_pos);
 
+    /* Compare the header of all array members if the array can be unwrapped */
     for(size_t i = 0; i < length; i++) {
-        compare_header.data = ctx->pos;
-        UA_CHECK(compare_header.data + compare_header.length <= ctx->end,
+        const u8 *compare_header = readBytes(ctx, compareBuf, headerLength);
+        UA_CHECK(compare_header != NULL,
                  return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
-        if(!UA_ByteString_equal(&header, &compare_header)) {
+        if(memcmp(header, compare_header, headerLength) != 0) {
             /* Different member types, decode as ExtensionObject array */
-            ctx->pos = orig_pos;
+            restorePos(ctx, &orig_pos);
             return Array_decodeBinary(ctx, dst, out_length, *type);
         }
 
         /* Decode the length field and jump to the next element */
-        ctx->pos += header.length;
         u32 member_length = 0;
         ret = DECODE_DIRECT(&member_length, UInt32);
         UA_CHECK_STATUS(ret, return ret);
-        UA_CHECK(member_length <= (size_t)(ctx->end - ctx->pos),
-                 return UA_STATUSCODE_BADDECODINGERROR);
-        ctx->pos += member_length;
+        ret = skipBytes(ctx, member_length);
+        UA_CHECK_STATUS(ret, return ret);
     }
 
     /* Allocate memory for the unwrapped members */
@@ -1281,21 +1386,23 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(Ctx *ctx, void *UA_RESTRICT *UA_R
 
     /* Decode unwrapped members */
     uintptr_t array_pos = (uintptr_t)*dst;
-    ctx->pos = &orig_pos[4];
+    restorePos(ctx, &members_pos);
     for(size_t i = 0; i < length && ret == UA_STATUSCODE_GOOD; i++) {
-        ctx->pos += header.length; /* Jump over the header */
+        ret = skipBytes(ctx, headerLength); /* Jump over the header */
+        UA_CHECK_STATUS(ret, return ret);
         /* Read the per-element length and validate that the inner decoder
          * consumes exactly that many bytes, closing a decoder-vs-IDS
          * split-view channel. */
         u32 member_length = 0;
         ret = DECODE_DIRECT(&member_length, UInt32);
         UA_CHECK_STATUS(ret, return ret);
-        UA_CHECK(member_length <= (size_t)(ctx->end - ctx->pos),
+        size_t remaining = remainingBytes(ctx);
+        UA_CHECK(member_length <= remaining,
                  return UA_STATUSCODE_BADDECODINGERROR);
-        const u8 *expected_end = ctx->pos + member_length;
+        size_t expected_remaining = remaining - member_length;
         ret = decodeBinaryJumpTable[contentType->typeKind]
             (ctx, (void*)array_pos, contentType);
-        if(ret == UA_STATUSCODE_GOOD && ctx->pos != expected_end)
+        if(ret == UA_STATUSCODE_GOOD && remainingBytes(ctx) != expected_remaining)
             return UA_STATUSCODE_BADDECODINGERROR;
         array_pos += contentType->memSize;
     }
@@ -1995,6 +2102,11 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
     ctx.pos = &src->data[*offset];
     ctx.end = &src->data[src->length];
     ctx.depth = 0;
+    ctx.segments = NULL;
+    ctx.segmentsSize = 0;
+    ctx.segment = 0;
+    ctx.tailLength = 0;
+    ctx.typesIndex = NULL;
     if(options)
         ctx.opts = *options;
     else
@@ -2017,6 +2129,52 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
     return ret;
 }
 
+status
+UA_decodeBinarySegmentsInternal(const UA_ByteString *segments, size_t segmentsSize,
+                                size_t *offset, void *dst, const UA_DataType *type,
+                                UA_DecodeBinaryOptions *options,
+                                const struct UA_DataTypeIndex *typesIndex) {
+    UA_CHECK(segmentsSize > 0, return UA_STATUSCODE_BADDECODINGERROR);
+
+    /* Set up the context at the beginning of the first segment */
+    Ctx ctx;
+    memset(&ctx, 0, sizeof(Ctx));
+    ctx.segments = segments;
+    ctx.segmentsSize = segmentsSize;
+    ctx.pos = segments[0].data;
+    ctx.end = segments[0].data + segments[0].length;
+    size_t total = segments[0].length;
+    for(size_t i = 1; i < segmentsSize; i++)
+        ctx.tailLength += segments[i].length;
+    total += ctx.tailLength;
+    if(options)
+        ctx.opts = *options;
+
+    /* Check the index once. Then it is used for all lookups. */
+    if(typesIndex && UA_DataTypeIndex_isCurrent(typesIndex, ctx.opts.customTypes))
+        ctx.typesIndex = typesIndex;
+
+    /* Move to the offset */
+    memset(dst, 0, type->memSize); /* Initialize the value */
+    status ret = skipBytes(&ctx, *offset);
+    UA_CHECK_STATUS(ret, return ret);
+
+    /* Decode */
+    ret = decodeBinaryJumpTable[type->typeKind](&ctx, dst, type);
+
+    if(UA_LIKELY(ret == UA_STATUSCODE_GOOD)) {
+        /* Set the new offset */
+        *offset = total - remainingBytes(&ctx);
+        if(options)
+            options->decodedLength = *offset;
+    } else {
+        /* Clean up */
+        ctxClear(&ctx, dst, type);
+    }
+
+    return ret;
+}
+
 UA_StatusCode
 UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
@@ -16,6 +16,8 @@
 
 _UA_BEGIN_DECLS
 
+struct UA_DataTypeIndex;
+
 typedef UA_StatusCode (*UA_exchangeEncodeBuffer)(void *handle, UA_Byte **bufPos,
                                                  const UA_Byte **bufEnd);
 
@@ -29,8 +31,20 @@ typedef struct {
 
     UA_DecodeBinaryOptions opts;
 
+    /* Optional lookup index for opts.customTypes. Only set if it is current
+     * for the custom types list. */
+    const struct UA_DataTypeIndex *typesIndex;
+
     UA_exchangeEncodeBuffer exchangeBufferCallback;
     void *exchangeBufferCallbackHandle;
+
+    /* Decoding from a buffer that is split into segments. pos and end point
+     * into the current segment. The segments after the current one hold
+     * another tailLength bytes. Unused (zero) for contiguous buffers. */
+    const UA_ByteString *segments;
+    size_t segmentsSize;
+    size_t segment;
+    size_t tailLength;
 } Ctx;
 
 void * ctxCalloc(Ctx *ctx, size_t nelem, size_t elsize);
@@ -104,6 +118,19 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
                         UA_DecodeBinaryOptions *options)
     UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
 
+/* Decodes from a buffer that is split into several segments, for example the
+ * chunks of a SecureChannel message. The segments are read as if they were
+ * concatenated, but without copying them into a contiguous buffer first. The
+ * offset counts the bytes from the beginning of the first segment. The
+ * optional typesIndex of the server/client speeds up the lookup of the
+ * options->customTypes. It is ignored if it does not match the list. */
+UA_StatusCode
+UA_decodeBinarySegmentsInternal(const UA_ByteString *segments, size_t segmentsSize,
+                                size_t *offset, void *dst, const UA_DataType *type,
+                                UA_DecodeBinaryOptions *options,
+                                const struct UA_DataTypeIndex *typesIndex)
+    UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
+
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId);
 
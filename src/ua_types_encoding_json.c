@@ -236,6 +236,22 @@ writeJsonKey(CtxJson *ctx, const char* key) {
     return ret;
 }
 
+/* Same as writeJsonKey, but the key is escaped like a String value */
+status UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT
+writeJsonKeyString(CtxJson *ctx, const UA_String *key) {
+    status ret = writeJsonBeforeElement(ctx, true);
+    ctx->commaNeeded[ctx->depth] = true;
+    if(!ctx->unquotedKeys)
+        ret |= writeChar(ctx, '\"');
+    ret |= writeJsonStringContent(ctx, key);
+    if(!ctx->unquotedKeys)
+        ret |= writeChar(ctx, '\"');
+    ret |= writeChar(ctx, ':');
+    if(ctx->prettyPrint)
+        ret |= writeChar(ctx, ' ');
+    return ret;
+}
+
 static UA_Boolean
 isJsonNullable(const UA_DataType *type) {
     return (type->typeKind >= UA_DATATYPEKIND_STRING &&
@@ -51,6 +51,9 @@ UA_StatusCode writeJsonArrEnd(CtxJson *ctx, const UA_DataType *type);
 
 UA_StatusCode writeJsonKey(CtxJson *ctx, const char* key);
 
+/* Keys that are not a fixed ascii string are escaped like a String value */
+UA_StatusCode writeJsonKeyString(CtxJson *ctx, const UA_String *key);
+
 /* Adds a comma if needed. Distinct elements go on a new line if pretty-printing
  * is enabled. */
 UA_StatusCode writeJsonBeforeElement(CtxJson *ctx, UA_Boolean distinct);
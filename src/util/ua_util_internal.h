@@ -278,6 +278,41 @@ isTrue(uint8_t expr) {
 void
 UA_cleanupDataTypeWithCustom(UA_DataTypeArray *customTypes);
 
+/* Hash index for the lookup of custom types by their typeId and
+ * binaryEncodingId. The index covers the entire linked list of DataTypeArrays.
+ * It is kept by the server/client next to its configuration and (re)built
+ * under their lock when the custom types are set. The DataTypes are not
+ * copied. The index is ignored (and the lookup falls back to the linear
+ * search) once the list has changed. Modifying the NodeIds of the types
+ * in-place requires to rebuild the index as well. */
+struct UA_DataTypeIndex;
+typedef struct UA_DataTypeIndex UA_DataTypeIndex;
+
+/* Returns NULL in *index for an empty list */
+UA_StatusCode
+UA_DataTypeIndex_new(const UA_DataTypeArray *customTypes,
+                     UA_DataTypeIndex **index);
+
+void
+UA_DataTypeIndex_delete(UA_DataTypeIndex *index);
+
+/* Does the index match the (unchanged) list of custom types? */
+UA_Boolean
+UA_DataTypeIndex_isCurrent(const UA_DataTypeIndex *index,
+                           const UA_DataTypeArray *customTypes);
+
+/* Lookup in UA_TYPES (generated perfect hash) and the custom types. The index
+ * is used if it is current for the customTypes. Can be NULL. */
+const UA_DataType *
+UA_findDataTypeIndexed(const UA_NodeId *typeId,
+                       const UA_DataTypeArray *customTypes,
+                       const UA_DataTypeIndex *index);
+
+const UA_DataType *
+UA_findDataTypeByBinaryIndexed(const UA_NodeId *binaryEncodingId,
+                               const UA_DataTypeArray *customTypes,
+                               const UA_DataTypeIndex *index);
+
 /* Get the number of optional fields contained in an structure type */
 size_t UA_EXPORT
 getCountOfOptionalFields(const UA_DataType *type);
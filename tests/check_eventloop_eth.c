@@ -16,10 +16,19 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 #define ETHERNET_INTERFACE "lo" /* use the loopback interface for testing */
 #define MULTICAST_MAC_ADDRESS "00-00-00-00-00-00"
 
+/* The ring test requires an explicitly configured interface (like the PubSub
+ * Ethernet tests). It sends on ETHERNET_INTERFACE and receives on
+ * ETHERNET_PEER_INTERFACE, e.g. the two ends of a veth pair. The peer defaults
+ * to the same interface. */
+#define RING_INTERFACE getenv("ETHERNET_INTERFACE")
+#define RING_PEER_INTERFACE getenv("ETHERNET_PEER_INTERFACE")
+#define SKIP_ETHERNET getenv("SKIP_ETHERNET")
+
 typedef struct TestContext {
     unsigned connCount;
 } TestContext;
@@ -63,6 +72,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -215,11 +225,128 @@ START_TEST(connectETH) {
     el = NULL;
 } END_TEST
 
+/* Send and receive through the PACKET_MMAP rings */
+START_TEST(connectETHRing) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("ethCM"));
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    char *peer = RING_PEER_INTERFACE;
+    UA_String interface = UA_STRING(RING_INTERFACE);
+    UA_String peerInterface = (peer && strlen(peer) > 0) ? UA_STRING(peer) : interface;
+    UA_String address = UA_STRING(MULTICAST_MAC_ADDRESS);
+    UA_Boolean listen = true;
+    UA_Boolean ring = true;
+    UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
+
+    UA_KeyValuePair params[5];
+    params[0].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[0].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "interface");
+    UA_Variant_setScalar(&params[1].value, &interface, &UA_TYPES[UA_TYPES_STRING]);
+    params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+    UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+    params[3].key = UA_QUALIFIEDNAME(0, "ring-enable");
+    UA_Variant_setScalar(&params[3].value, &ring, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[4].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[4].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    TestContext testContext;
+    testContext.connCount = 0;
+
+    /* Listen with the rx ring on the peer interface. The interface is
+     * configured explicitly, so opening the raw socket has to succeed. */
+    UA_Variant_setScalar(&params[1].value, &peerInterface, &UA_TYPES[UA_TYPES_STRING]);
+    UA_KeyValueMap kvm = {4, &params[1]};
+    UA_StatusCode retval =
+        cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    size_t listenSockets = testContext.connCount;
+
+    /* Open a send connection with the tx ring */
+    UA_Variant_setScalar(&params[1].value, &interface, &UA_TYPES[UA_TYPES_STRING]);
+    kvm.map = params;
+    clientId = 0;
+    retval = cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(clientId != 0);
+
+    /* Several buffers from the ring can be in use at the same time */
+    size_t msgSize = strlen(testMsg);
+    UA_ByteString snd1, snd2, unused;
+    retval = cm->allocNetworkBuffer(cm, clientId, &snd1, msgSize);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = cm->allocNetworkBuffer(cm, clientId, &snd2, msgSize);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_ne(snd1.data, snd2.data);
+    memcpy(snd1.data, testMsg, msgSize);
+    memcpy(snd2.data, testMsg, msgSize);
+
+    /* A buffer that is not sent is returned to the ring */
+    retval = cm->allocNetworkBuffer(cm, clientId, &unused, msgSize);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    cm->freeNetworkBuffer(cm, clientId, &unused);
+
+    receivedCount = 0;
+    retval = cm->sendWithConnection(cm, clientId, NULL, &snd1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = cm->sendWithConnection(cm, clientId, NULL, &snd2);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Send more frames than fit into one ring block */
+    for(size_t i = 0; i < 100; i++) {
+        UA_ByteString snd;
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd, msgSize);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, msgSize);
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    for(size_t i = 0; i < 100 && receivedCount < 102; i++) {
+        UA_DateTime next = el->run(el, 10);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_ge(receivedCount, 102);
+
+    /* Close the connection */
+    retval = cm->closeConnection(cm, clientId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(testContext.connCount, listenSockets);
+
+    /* Stop the EventLoop */
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test ETH EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenETH);
     tcase_add_test(tc, connectETH);
+    char *ringInterface = RING_INTERFACE;
+    char *skipEth = SKIP_ETHERNET;
+    if(ringInterface && strlen(ringInterface) > 0 && !(skipEth && strlen(skipEth) > 0))
+        tcase_add_test(tc, connectETHRing);
+    else
+        UA_LOG_WARNING(UA_Log_Stdout, UA_LOGCATEGORY_APPLICATION,
+                       "Skipping the test connectETHRing. Set ETHERNET_INTERFACE "
+                       "(and optionally ETHERNET_PEER_INTERFACE) to run it.");
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -15,6 +15,9 @@
 #ifdef UA_ARCHITECTURE_WIN32
 # define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_WIN32
 # define UA_TEST_TCP_MANAGER_NEW UA_ConnectionManager_new_WIN32_TCP
+#elif defined(UA_TEST_EVENTLOOP_IOURING)
+# define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_IOURING
+# define UA_TEST_TCP_MANAGER_NEW UA_ConnectionManager_new_POSIX_TCP
 #else
 # define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_POSIX
 # define UA_TEST_TCP_MANAGER_NEW UA_ConnectionManager_new_POSIX_TCP
@@ -315,12 +318,199 @@ START_TEST(staticSendBuffer) {
     el = NULL;
 } END_TEST
 
+#if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
+
+#define QUEUE_LIMIT (1u << 23) /* 8MB */
+#define QUEUE_PATTERN(offset) ((UA_Byte)((offset) / 997))
+
+static size_t queueRcvBytes;
+static size_t queueSndBytes;
+static UA_Boolean queueClientClosed;
+
+static void
+queueConnectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                        void *application, void **connectionContext,
+                        UA_ConnectionState status,
+                        const UA_KeyValueMap *params,
+                        UA_ByteString msg) {
+    if(*connectionContext != NULL) {
+        clientId = connectionId;
+        if(status == UA_CONNECTIONSTATE_CLOSING)
+            queueClientClosed = true;
+        return;
+    }
+
+    /* The data arrives completely and in order */
+    for(size_t i = 0; i < msg.length; i++)
+        ck_assert_uint_eq(msg.data[i], QUEUE_PATTERN(queueRcvBytes + i));
+    queueRcvBytes += msg.length;
+}
+
+static UA_StatusCode
+queueSend(size_t length) {
+    UA_ByteString snd;
+    UA_StatusCode retval = cm->allocNetworkBuffer(cm, clientId, &snd, length);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < length; i++)
+        snd.data[i] = QUEUE_PATTERN(queueSndBytes + i);
+    queueSndBytes += length;
+    return cm->sendWithConnection(cm, clientId, NULL, &snd);
+}
+
+/* Open a listen socket and a client connection to it. Both report to the
+ * queueConnectionCallback. */
+static void
+connectQueueClient(void) {
+    UA_UInt16 port = 4840;
+    UA_Boolean listen = true;
+    UA_String host = UA_STRING("localhost");
+    UA_Boolean reuseaddr = true;
+
+    UA_KeyValuePair params[4];
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &host, &UA_TYPES[UA_TYPES_STRING]);
+    params[3].key = UA_QUALIFIEDNAME(0, "reuse");
+    UA_Variant_setScalar(&params[3].value, &reuseaddr, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    UA_KeyValueMap paramsMap;
+    paramsMap.map = params;
+    paramsMap.mapSize = 4;
+
+    UA_StatusCode retval =
+        cm->openConnection(cm, &paramsMap, NULL, NULL, queueConnectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    clientId = 0;
+    queueRcvBytes = 0;
+    queueSndBytes = 0;
+    queueClientClosed = false;
+    listen = false;
+    retval = cm->openConnection(cm, &paramsMap, NULL, (void*)0x01,
+                                queueConnectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert(clientId != 0);
+}
+
+static void
+stopEL(void) {
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED && iteration < 100) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+}
+
+/* Sending does not block when the remote side does not read. The unsent data is
+ * queued and sent once the remote side reads again. A connection that exceeds
+ * the send-queue-limit is closed. */
+START_TEST(sendQueueBackpressure) {
+    setupEL();
+    UA_UInt32 queueLimit = QUEUE_LIMIT;
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-queue-limit"),
+                             &queueLimit, &UA_TYPES[UA_TYPES_UINT32]);
+    el->start(el);
+    connectQueueClient();
+
+    /* Send more than the socket buffers can hold without running the EventLoop.
+     * Alternate between the static send buffer and heap-allocated buffers. */
+    UA_StatusCode retval;
+    for(size_t i = 0; i < 64; i++) {
+        retval = queueSend((i % 2 == 0) ? (1u << 16) : 70000);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* Everything arrives once the EventLoop runs */
+    for(size_t i = 0; i < 1000 && queueRcvBytes < queueSndBytes; i++)
+        el->run(el, 10);
+    ck_assert_uint_eq(queueRcvBytes, queueSndBytes);
+
+    /* Exceed the send queue limit. The connection gets closed. */
+    for(size_t i = 0; i < 4096; i++) {
+        retval = queueSend(1u << 16);
+        if(retval != UA_STATUSCODE_GOOD)
+            break;
+    }
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADTCPNOTENOUGHRESOURCES);
+    for(size_t i = 0; i < 100 && !queueClientClosed; i++)
+        el->run(el, 10);
+    ck_assert(queueClientClosed);
+
+    stopEL();
+} END_TEST
+
+/* The number of static send buffers of the POSIX ConnectionManagers */
+#define STATIC_SEND_BUFFERS 16
+
+/* A batch of buffers is sent in order with scatter-gather I/O. The buffers of
+ * a batch are taken from the pool of static send buffers. Only when the pool
+ * is exhausted, further buffers are allocated separately. */
+START_TEST(sendBatch) {
+    setupEL();
+    el->start(el);
+    connectQueueClient();
+
+    /* More buffers than fit into a single system call */
+    ck_assert(cm->sendWithConnectionBatch != NULL);
+    UA_ByteString bufs[200];
+    UA_Byte *staticBufs[STATIC_SEND_BUFFERS];
+    for(size_t i = 0; i < 200; i++) {
+        size_t length = 1000 + i * 37;
+        UA_StatusCode retval = cm->allocNetworkBuffer(cm, clientId, &bufs[i], length);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        for(size_t j = 0; j < length; j++)
+            bufs[i].data[j] = QUEUE_PATTERN(queueSndBytes + j);
+        queueSndBytes += length;
+        if(i < STATIC_SEND_BUFFERS)
+            staticBufs[i] = bufs[i].data;
+    }
+    ck_assert_ptr_ne(bufs[0].data, bufs[1].data);
+    UA_StatusCode retval = cm->sendWithConnectionBatch(cm, clientId, NULL, bufs, 200);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    for(size_t i = 0; i < 1000 && queueRcvBytes < queueSndBytes; i++)
+        el->run(el, 10);
+    ck_assert_uint_eq(queueRcvBytes, queueSndBytes);
+    ck_assert(!queueClientClosed);
+
+    /* The static send buffers are available again. The next batch gets the
+     * same buffers and no new allocation. */
+    for(size_t i = 0; i < STATIC_SEND_BUFFERS; i++) {
+        retval = cm->allocNetworkBuffer(cm, clientId, &bufs[i], 16);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert_ptr_eq(bufs[i].data, staticBufs[i]);
+    }
+    for(size_t i = 0; i < STATIC_SEND_BUFFERS; i++)
+        cm->freeNetworkBuffer(cm, clientId, &bufs[i]);
+
+    stopEL();
+} END_TEST
+
+#endif
+
 int main(void) {
     Suite *s  = suite_create("Test TCP EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenTCP);
     tcase_add_test(tc, connectTCP);
     tcase_add_test(tc, staticSendBuffer);
+#if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
+    tcase_add_test(tc, sendQueueBackpressure);
+    tcase_add_test(tc, sendBatch);
+#endif
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -0,0 +1,10 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Runs the tests of check_eventloop_tcp.c with the io_uring EventLoop
+ * (UA_EventLoop_new_IOURING). It shares the TCP ConnectionManager with the
+ * POSIX EventLoop, so only the EventLoop constructor differs. */
+
+#define UA_TEST_EVENTLOOP_IOURING
+#include "check_eventloop_tcp.c"
@@ -15,6 +15,9 @@
 #ifdef UA_ARCHITECTURE_WIN32
 # define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_WIN32
 # define UA_TEST_UDP_MANAGER_NEW UA_ConnectionManager_new_WIN32_UDP
+#elif defined(UA_TEST_EVENTLOOP_IOURING)
+# define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_IOURING
+# define UA_TEST_UDP_MANAGER_NEW UA_ConnectionManager_new_POSIX_UDP
 #else
 # define UA_TEST_EVENTLOOP_NEW UA_EventLoop_new_POSIX
 # define UA_TEST_UDP_MANAGER_NEW UA_ConnectionManager_new_POSIX_UDP
@@ -29,6 +32,7 @@ static UA_ConnectionManager *cmTalker;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 typedef struct TestContext {
     unsigned connCount;
@@ -111,6 +115,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -546,6 +551,106 @@ START_TEST(udpTalkerAndListenerDifferentDestination) {
     ck_assert_uint_eq(testContext.connCount, 0);
 } END_TEST
 
+#if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
+#define BATCH_MESSAGES 10
+#define BATCH_RECV 4
+
+START_TEST(udpBatchedSendAndReceive) {
+    setupELTalkerAndListener();
+
+    /* Receive up to four datagrams per system call. Send three. */
+    UA_UInt32 recvBatch = BATCH_RECV;
+    UA_KeyValueMap_setScalar(&cmListener->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "recv-batch"),
+                             &recvBatch, &UA_TYPES[UA_TYPES_UINT32]);
+    UA_UInt32 sendBatch = 3;
+    UA_KeyValueMap_setScalar(&cmTalker->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-batch"),
+                             &sendBatch, &UA_TYPES[UA_TYPES_UINT32]);
+    elListener->start(elListener);
+    elTalker->start(elTalker);
+
+    /* Open a listener connection */
+    UA_UInt16 port = 30002;
+    UA_Boolean listen = true;
+    UA_KeyValuePair params[3];
+    UA_KeyValueMap paramsMap = {2, params}; /* Hide some parameters */
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    TestContext testContext;
+    testContext.connCount = 0;
+    UA_StatusCode retval =
+        cmListener->openConnection(cmListener, &paramsMap, NULL, &testContext,
+                                   connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    size_t listenSockets = testContext.connCount;
+
+    /* Open a talker connection */
+    clientId = 0;
+    listen = false;
+    UA_String targetHost = UA_STRING("localhost");
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &targetHost, &UA_TYPES[UA_TYPES_STRING]);
+    paramsMap.mapSize = 3;
+    retval = cmTalker->openConnection(cmTalker, &paramsMap, NULL, &testContext,
+                                      connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = elTalker->run(elTalker, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_ne(clientId, 0);
+    ck_assert_uint_eq(testContext.connCount, listenSockets + 1);
+
+    /* Send the messages in one batch */
+    UA_ByteString snd[BATCH_MESSAGES];
+    for(size_t i = 0; i < BATCH_MESSAGES; i++) {
+        retval = cmTalker->allocNetworkBuffer(cmTalker, clientId, &snd[i],
+                                              strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd[i].data, testMsg, strlen(testMsg));
+    }
+    ck_assert(cmTalker->sendWithConnectionBatch != NULL);
+    retval = cmTalker->sendWithConnectionBatch(cmTalker, clientId, &UA_KEYVALUEMAP_NULL,
+                                               snd, BATCH_MESSAGES);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Every datagram is received as an individual message */
+    receivedCount = 0;
+    elListener->run(elListener, 1);
+#if defined(__linux__)
+    ck_assert_uint_eq(receivedCount, BATCH_RECV);
+#endif
+    for(size_t i = 0; i < BATCH_MESSAGES && receivedCount < BATCH_MESSAGES; i++)
+        elListener->run(elListener, 1);
+    ck_assert_uint_eq(receivedCount, BATCH_MESSAGES);
+
+    /* Close the connection */
+    retval = cmTalker->closeConnection(cmTalker, clientId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Stop the EventLoops */
+    elTalker->stop(elTalker);
+    for(size_t i = 0; i < 10 && elTalker->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elTalker->run(elTalker, 1);
+    ck_assert_int_eq(elTalker->state, UA_EVENTLOOPSTATE_STOPPED);
+    elTalker->free(elTalker);
+    elTalker = NULL;
+
+    elListener->stop(elListener);
+    for(size_t i = 0; i < 10 && elListener->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elListener->run(elListener, 1);
+    ck_assert_int_eq(elListener->state, UA_EVENTLOOPSTATE_STOPPED);
+    elListener->free(elListener);
+    elListener = NULL;
+
+    ck_assert_uint_eq(testContext.connCount, 0);
+} END_TEST
+#endif
+
 int main(void) {
     Suite *s  = suite_create("Test UDP EventLoop");
     TCase *tc = tcase_create("test cases");
@@ -555,6 +660,9 @@ int main(void) {
     tcase_add_test(tc, connectUDPValidationSucceeds);
     tcase_add_test(tc, udpTalkerAndListener);
     tcase_add_test(tc, udpTalkerAndListenerDifferentDestination);
+#if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP)
+    tcase_add_test(tc, udpBatchedSendAndReceive);
+#endif
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -436,17 +436,16 @@ UA_SecureChannel_processBuffer(UA_SecureChannel *channel, int *chunks_processed,
     while(UA_LIKELY(res == UA_STATUSCODE_GOOD)) {
         UA_MessageType messageType;
         UA_UInt32 requestId = 0;
-        UA_ByteString payload = UA_BYTESTRING_NULL;
-        UA_Boolean copied = false;
+        UA_MessagePayload payload;
         res = UA_SecureChannel_getCompleteMessage(channel, &messageType, &requestId,
-                                                  &payload, &copied, UA_DateTime_nowMonotonic());
+                                                  &payload, UA_DateTime_nowMonotonic());
         if(res != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
         ck_assert_uint_ne(payload.length, 0);
-        ck_assert_ptr_ne(payload.data, NULL);
+        ck_assert_uint_eq(payload.segmentsSize, 1);
+        ck_assert_ptr_ne(payload.segments[0].data, NULL);
         ++*chunks_processed;
-        if(copied)
-            UA_ByteString_clear(&payload);
+        UA_MessagePayload_clear(&payload);
     }
     res |= UA_SecureChannel_persistBuffer(channel);
     return res;
@@ -502,6 +501,111 @@ START_TEST(SecureChannel_assemblePartialChunks) {
     ck_assert_int_eq(chunks_processed, 5);
 } END_TEST
 
+/* Collects all chunks sent over the test ConnectionManager */
+static UA_ByteString sentChunks;
+
+static UA_StatusCode
+collectSentChunks(UA_ConnectionManager *cm, uintptr_t connectionId,
+                  const UA_KeyValueMap *params, UA_ByteString *buf) {
+    (void)cm;
+    (void)connectionId;
+    (void)params;
+    UA_Byte *data = (UA_Byte*)UA_realloc(sentChunks.data, sentChunks.length + buf->length);
+    ck_assert_ptr_ne(data, NULL);
+    memcpy(data + sentChunks.length, buf->data, buf->length);
+    sentChunks.data = data;
+    sentChunks.length += buf->length;
+    UA_ByteString_clear(buf);
+    return UA_STATUSCODE_GOOD;
+}
+
+START_TEST(SecureChannel_receiveMultiChunkMessageAsSegments) {
+    /* Send a message over several chunks */
+    TestConnectionManager_CallbackOverloads overloads;
+    memset(&overloads, 0, sizeof(overloads));
+    overloads.sendWithConnection = collectSentChunks;
+    UA_ConnectionManager *cm = TestConnectionManager_new("tcp", &overloads);
+    testChannel.connectionManager = cm;
+    testChannel.config.sendBufferSize = 1024;
+    testChannel.config.remoteMaxChunkCount = 0;
+    testChannel.config.remoteMaxMessageSize = 0;
+    testChannel.securityToken.createdAt = UA_DateTime_nowMonotonic();
+    testChannel.securityToken.revisedLifetime = 600000;
+
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToReadSize = 100;
+    request.nodesToRead = (UA_ReadValueId*)
+        UA_Array_new(request.nodesToReadSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+    char name[32];
+    for(size_t i = 0; i < request.nodesToReadSize; i++) {
+        snprintf(name, sizeof(name), "segmented.node.%u", (unsigned)i);
+        request.nodesToRead[i].nodeId = UA_NODEID_STRING_ALLOC(1, name);
+        request.nodesToRead[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+
+    sentChunks = UA_BYTESTRING_NULL;
+    UA_StatusCode res = UA_SecureChannel_sendMSG(&testChannel, 42, &request,
+                                                 &UA_TYPES[UA_TYPES_READREQUEST]);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(sentChunks.length, 3 * 1024);
+
+    /* Receive the chunks in small network buffers */
+    size_t received = 0;
+    for(size_t pos = 0; pos < sentChunks.length; pos += 100) {
+        UA_ByteString buf = {sentChunks.length - pos, sentChunks.data + pos};
+        if(buf.length > 100)
+            buf.length = 100;
+        res = UA_SecureChannel_loadBuffer(&testChannel, buf);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        while(res == UA_STATUSCODE_GOOD) {
+            UA_MessageType messageType;
+            UA_UInt32 requestId = 0;
+            UA_MessagePayload payload;
+            res = UA_SecureChannel_getCompleteMessage(&testChannel, &messageType,
+                                                      &requestId, &payload,
+                                                      UA_DateTime_nowMonotonic());
+            ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+            if(payload.length == 0)
+                break;
+            ck_assert_uint_eq(messageType, UA_MESSAGETYPE_MSG);
+            ck_assert_uint_eq(requestId, 42);
+            ck_assert_uint_gt(payload.segmentsSize, 3);
+
+            /* Decode across the segments */
+            size_t offset = 0;
+            UA_NodeId typeId;
+            res = UA_decodeBinarySegmentsInternal(payload.segments, payload.segmentsSize,
+                                                  &offset, &typeId,
+                                                  &UA_TYPES[UA_TYPES_NODEID], NULL, NULL);
+            ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+            ck_assert(UA_NodeId_equal(&typeId,
+                                      &UA_TYPES[UA_TYPES_READREQUEST].binaryEncodingId));
+            UA_ReadRequest decoded;
+            res = UA_decodeBinarySegmentsInternal(payload.segments, payload.segmentsSize,
+                                                  &offset, &decoded,
+                                                  &UA_TYPES[UA_TYPES_READREQUEST], NULL, NULL);
+            ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+            ck_assert_uint_eq(offset, payload.length);
+            ck_assert(UA_order(&decoded, &request, &UA_TYPES[UA_TYPES_READREQUEST]) ==
+                      UA_ORDER_EQ);
+            UA_ReadRequest_clear(&decoded);
+            UA_MessagePayload_clear(&payload);
+            received++;
+        }
+        res = UA_SecureChannel_persistBuffer(&testChannel);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_uint_eq(received, 1);
+    ck_assert_uint_eq(testChannel.chunksCount, 0);
+    ck_assert_uint_eq(testChannel.unprocessed.length, 0);
+
+    UA_ReadRequest_clear(&request);
+    UA_ByteString_clear(&sentChunks);
+    testChannel.connectionManager = testCM;
+    cm->eventSource.free(&cm->eventSource);
+} END_TEST
+
 #if defined(UA_ENABLE_ENCRYPTION_OPENSSL) && !defined(LIBRESSL_VERSION_NUMBER)
 /* OPC UA Part 6 v1.05.07 §6.8.1 step 2 "Extract" — IKM chaining on
  * SecureChannel renewal. This exercises the OpenSSL helper directly
@@ -685,6 +789,7 @@ testSuite_SecureChannel(void) {
     tcase_add_checked_fixture(tc_processBuffer, setup_key_sizes, teardown_key_sizes);
     tcase_add_checked_fixture(tc_processBuffer, setup_secureChannel, teardown_secureChannel);
     tcase_add_test(tc_processBuffer, SecureChannel_assemblePartialChunks);
+    tcase_add_test(tc_processBuffer, SecureChannel_receiveMultiChunkMessageAsSegments);
     suite_add_tcase(s, tc_processBuffer);
 
 #if defined(UA_ENABLE_ENCRYPTION_OPENSSL) && !defined(LIBRESSL_VERSION_NUMBER)
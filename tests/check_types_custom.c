@@ -6,6 +6,7 @@
 #include <open62541/util.h>
 
 #include "util/ua_util_internal.h"
+#include "ua_types_encoding_binary.h"
 
 #include <stdlib.h>
 #include <check.h>
@@ -831,6 +832,104 @@ START_TEST(ns0TypeStructureDefinitionPadding) {
     }
 } END_TEST
 
+START_TEST(ns0TypesLookup) {
+    /* Every type in UA_TYPES is found by its TypeId and its BinaryEncodingId */
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        const UA_DataType *type = &UA_TYPES[i];
+        ck_assert(UA_findDataType(&type->typeId) == type);
+        if(UA_NodeId_isNull(&type->binaryEncodingId))
+            continue;
+        ck_assert(UA_findDataTypeByBinaryIndexed(&type->binaryEncodingId,
+                                                 NULL, NULL) == type);
+    }
+
+    /* Unknown NodeIds are not found */
+    UA_NodeId unknown = UA_NODEID_NUMERIC(0, 999999);
+    ck_assert_ptr_eq(UA_findDataType(&unknown), NULL);
+    ck_assert_ptr_eq(UA_findDataTypeByBinaryIndexed(&unknown, NULL, NULL), NULL);
+    unknown = UA_NODEID_STRING(0, "Int32");
+    ck_assert_ptr_eq(UA_findDataType(&unknown), NULL);
+} END_TEST
+
+START_TEST(customTypesIndex) {
+    UA_DataType types[5] = {PointType, OptType, ArrayOptType,
+                            UniType, selfContainingUnionType};
+    UA_DataTypeArray list = {&customDataTypes, 5, types, UA_FALSE};
+    UA_DataTypeIndex *index = NULL;
+    UA_StatusCode retval = UA_DataTypeIndex_new(&list, &index);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_ne(index, NULL);
+    ck_assert(UA_DataTypeIndex_isCurrent(index, &list));
+
+    /* The first occurrence in the list is found. The types are not copied. */
+    for(size_t i = 0; i < 5; i++) {
+        ck_assert(UA_findDataTypeIndexed(&types[i].typeId, &list, index) == &types[i]);
+        ck_assert(UA_findDataTypeByBinaryIndexed(&types[i].binaryEncodingId,
+                                                 &list, index) == &types[i]);
+    }
+
+    /* Unknown types are not found */
+    UA_NodeId unknown = UA_NODEID_NUMERIC(1, 999999);
+    ck_assert_ptr_eq(UA_findDataTypeIndexed(&unknown, &list, index), NULL);
+    ck_assert_ptr_eq(UA_findDataTypeByBinaryIndexed(&unknown, &list, index), NULL);
+
+    /* The index is no longer used when the list has changed. The lookup
+     * falls back to the linear search. */
+    UA_DataType moreTypes[1] = {PointType};
+    moreTypes[0].typeId = UA_NODEID_NUMERIC(1, 4711);
+    list.types = moreTypes;
+    list.typesSize = 1;
+    ck_assert(!UA_DataTypeIndex_isCurrent(index, &list));
+    ck_assert(UA_findDataTypeIndexed(&moreTypes[0].typeId, &list, index) == &moreTypes[0]);
+    ck_assert_ptr_eq(UA_findDataTypeIndexed(&types[1].typeId, &list, index), NULL);
+    list.types = types;
+    list.typesSize = 5;
+    ck_assert(UA_DataTypeIndex_isCurrent(index, &list));
+    list.next = NULL;
+    ck_assert(!UA_DataTypeIndex_isCurrent(index, &list));
+
+    UA_DataTypeIndex_delete(index);
+
+    /* No index for an empty list */
+    retval = UA_DataTypeIndex_new(NULL, &index);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(index, NULL);
+    ck_assert(UA_DataTypeIndex_isCurrent(NULL, NULL));
+} END_TEST
+
+START_TEST(customTypesIndexDecode) {
+    /* Decode an ExtensionObject with a custom type via the index */
+    UA_DataTypeIndex *index = NULL;
+    UA_StatusCode retval = UA_DataTypeIndex_new(&customDataTypesUnion, &index);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    Point p = {1.0f, 2.0f, 3.0f};
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_setValue(&eo, &p, &PointType);
+    UA_EncodeBinaryOptions eopts;
+    memset(&eopts, 0, sizeof(eopts));
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    retval = UA_encodeBinary(&eo, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT], &buf, &eopts);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DecodeBinaryOptions dopts;
+    memset(&dopts, 0, sizeof(dopts));
+    dopts.customTypes = &customDataTypesUnion;
+    size_t offset = 0;
+    UA_ExtensionObject eo2;
+    retval = UA_decodeBinarySegmentsInternal(&buf, 1, &offset, &eo2,
+                                             &UA_TYPES[UA_TYPES_EXTENSIONOBJECT],
+                                             &dopts, index);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(eo2.encoding, UA_EXTENSIONOBJECT_DECODED);
+    ck_assert(eo2.content.decoded.type == &PointType);
+    ck_assert(((Point*)eo2.content.decoded.data)->z == 3.0f);
+    UA_ExtensionObject_clear(&eo2);
+
+    UA_ByteString_clear(&buf);
+    UA_DataTypeIndex_delete(index);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test Custom DataType Encoding");
     TCase *tc = tcase_create("test cases");
@@ -848,6 +947,9 @@ int main(void) {
     tcase_add_test(tc, parseCustomStructureWithOptionalFieldsWithArrayContained);
     tcase_add_test(tc, customTypeStructureDefinitionPadding);
     tcase_add_test(tc, ns0TypeStructureDefinitionPadding);
+    tcase_add_test(tc, ns0TypesLookup);
+    tcase_add_test(tc, customTypesIndex);
+    tcase_add_test(tc, customTypesIndexDecode);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -242,6 +242,118 @@ START_TEST(decodeShallFailWithTruncatedBufferButSurvive) {
 }
 END_TEST
 
+/* A CallMethodRequest with ExtensionObject arrays and scalars that are
+ * unwrapped during decoding, and values that are read byte by byte */
+static void
+fillSegmentedTestRequest(UA_CallMethodRequest *req) {
+    UA_CallMethodRequest_init(req);
+    req->objectId = UA_NODEID_STRING_ALLOC(1, "segmented.object");
+    req->methodId = UA_NODEID_GUID(2, UA_GUID("12345678-9ABC-DEF0-1234-56789ABCDEF0"));
+    req->inputArguments = (UA_Variant*)UA_Array_new(5, &UA_TYPES[UA_TYPES_VARIANT]);
+    req->inputArgumentsSize = 5;
+
+    UA_Range ranges[3] = {{1.0, 2.0}, {3.0, 4.0}, {-5.5, 5.5}};
+    UA_Variant_setArrayCopy(&req->inputArguments[0], ranges, 3, &UA_TYPES[UA_TYPES_RANGE]);
+    UA_Variant_setScalarCopy(&req->inputArguments[1], &ranges[2], &UA_TYPES[UA_TYPES_RANGE]);
+
+    UA_ExpandedNodeId ids[2];
+    ids[0] = UA_EXPANDEDNODEID_NUMERIC(0, 85);
+    ids[1] = UA_EXPANDEDNODEID_STRING_ALLOC(3, "remote");
+    ids[1].namespaceUri = UA_STRING_ALLOC("urn:segmented");
+    ids[1].nodeId.namespaceIndex = 0;
+    ids[1].serverIndex = 7;
+    UA_Variant_setArrayCopy(&req->inputArguments[2], ids, 2,
+                            &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    UA_ExpandedNodeId_clear(&ids[1]);
+
+    UA_Guid guid = UA_GUID("0FEDCBA9-8765-4321-0FED-CBA987654321");
+    UA_Variant_setScalarCopy(&req->inputArguments[3], &guid, &UA_TYPES[UA_TYPES_GUID]);
+    UA_Double doubles[4] = {0.5, 1.5, 2.5, 3.5};
+    UA_Variant_setArrayCopy(&req->inputArguments[4], doubles, 4, &UA_TYPES[UA_TYPES_DOUBLE]);
+}
+
+static void
+decodeSegmentsAndCompare(const UA_ByteString *segments, size_t segmentsSize,
+                         size_t length, const UA_CallMethodRequest *expected) {
+    UA_CallMethodRequest decoded;
+    size_t offset = 0;
+    UA_StatusCode retval =
+        UA_decodeBinarySegmentsInternal(segments, segmentsSize, &offset, &decoded,
+                                        &UA_TYPES[UA_TYPES_CALLMETHODREQUEST], NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(offset, length);
+    ck_assert(UA_order(&decoded, expected, &UA_TYPES[UA_TYPES_CALLMETHODREQUEST]) ==
+              UA_ORDER_EQ);
+    ck_assert_ptr_eq(decoded.inputArguments[0].type, &UA_TYPES[UA_TYPES_RANGE]);
+    ck_assert_ptr_eq(decoded.inputArguments[1].type, &UA_TYPES[UA_TYPES_RANGE]);
+    UA_CallMethodRequest_clear(&decoded);
+}
+
+START_TEST(decodeSegmentsShallYieldDecode) {
+    UA_CallMethodRequest req;
+    fillSegmentedTestRequest(&req);
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    UA_StatusCode retval =
+        UA_encodeBinary(&req, &UA_TYPES[UA_TYPES_CALLMETHODREQUEST], &msg, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Split in two segments at every position */
+    UA_ByteString segments[3];
+    for(size_t split = 0; split <= msg.length; split++) {
+        segments[0].data = msg.data;
+        segments[0].length = split;
+        segments[1].data = msg.data + split;
+        segments[1].length = msg.length - split;
+        decodeSegmentsAndCompare(segments, 2, msg.length, &req);
+    }
+
+    /* Empty segment in the middle */
+    segments[0].data = msg.data;
+    segments[0].length = msg.length / 2;
+    segments[1] = UA_BYTESTRING_NULL;
+    segments[2].data = msg.data + segments[0].length;
+    segments[2].length = msg.length - segments[0].length;
+    decodeSegmentsAndCompare(segments, 3, msg.length, &req);
+
+    /* One segment per byte */
+    UA_ByteString *bytes = (UA_ByteString*)
+        UA_malloc(msg.length * sizeof(UA_ByteString));
+    ck_assert_ptr_ne(bytes, NULL);
+    for(size_t i = 0; i < msg.length; i++) {
+        bytes[i].data = &msg.data[i];
+        bytes[i].length = 1;
+    }
+    decodeSegmentsAndCompare(bytes, msg.length, msg.length, &req);
+
+    /* Truncated message */
+    UA_CallMethodRequest decoded;
+    size_t offset = 0;
+    retval = UA_decodeBinarySegmentsInternal(bytes, msg.length - 1, &offset, &decoded,
+                                             &UA_TYPES[UA_TYPES_CALLMETHODREQUEST],
+                                             NULL, NULL);
+    ck_assert_uint_ne(retval, UA_STATUSCODE_GOOD);
+
+    /* Start at an offset in a later segment */
+    UA_UInt32 prefix = 42;
+    UA_ByteString prefixed = UA_BYTESTRING_NULL;
+    retval = UA_encodeBinary(&prefix, &UA_TYPES[UA_TYPES_UINT32], &prefixed, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    segments[0] = prefixed;
+    segments[1] = msg;
+    offset = prefixed.length;
+    retval = UA_decodeBinarySegmentsInternal(segments, 2, &offset, &decoded,
+                                             &UA_TYPES[UA_TYPES_CALLMETHODREQUEST],
+                                             NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(offset, prefixed.length + msg.length);
+    UA_CallMethodRequest_clear(&decoded);
+
+    UA_free(bytes);
+    UA_ByteString_clear(&prefixed);
+    UA_ByteString_clear(&msg);
+    UA_CallMethodRequest_clear(&req);
+} END_TEST
+
 #define RANDOM_TESTS 1000
 
 START_TEST(decodeScalarBasicTypeFromRandomBufferShallSucceed) {
@@ -460,6 +572,10 @@ int main(void) {
                         UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("Segmented Buffers");
+    tcase_add_test(tc, decodeSegmentsShallYieldDecode);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("Fuzzing with Random Buffers");
     tcase_add_loop_test(tc, decodeScalarBasicTypeFromRandomBufferShallSucceed,
                         UA_TYPES_BOOLEAN, UA_TYPES_DOUBLE);
@@ -515,6 +515,149 @@ START_TEST(hl_clientState) {
     disconnectClient(client);
 } END_TEST
 
+/* === Zero-copy read of large values === */
+#define ZEROCOPY_LENGTH 10000
+static UA_Boolean overwriteEnabled;
+
+static UA_StatusCode
+overwriteLargeValue(UA_Server *s, const UA_NodeId *sessionId,
+                    void *sessionContext, const UA_NodeId *nodeId,
+                    void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                    const UA_NumericRange *range, UA_DataValue *value) {
+    /* Overwrite the large value while the Read response is not yet sent.
+     * Disabled while the node is added (the value is read for type checks). */
+    UA_Int32 one = 1;
+    UA_Variant_setScalarCopy(&value->value, &one, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    if(!overwriteEnabled)
+        return UA_STATUSCODE_GOOD;
+    UA_Double *arr = (UA_Double*)
+        UA_Array_new(ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    for(size_t i = 0; i < ZEROCOPY_LENGTH; i++)
+        arr[i] = -1.0;
+    UA_Variant v;
+    UA_Variant_setArray(&v, arr, ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    UA_StatusCode res = UA_Server_writeValue(s, UA_NODEID_NUMERIC(1, 62100), v);
+    UA_Array_delete(arr, ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    return res;
+}
+
+static void setupZeroCopy(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert_ptr_ne(server, NULL);
+    UA_Server_getConfig(server)->readZeroCopyThreshold = 1024;
+    overwriteEnabled = false;
+
+    /* Large array variable */
+    UA_Double *arr = (UA_Double*)
+        UA_Array_new(ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    for(size_t i = 0; i < ZEROCOPY_LENGTH; i++)
+        arr[i] = (UA_Double)i;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_Variant_setArray(&vattr.value, arr, ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    vattr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    vattr.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, 62100),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "ZeroCopyLarge"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  vattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Array_delete(arr, ZEROCOPY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+
+    /* DataSource that overwrites the large array when it is read */
+    UA_VariableAttributes dsattr = UA_VariableAttributes_default;
+    dsattr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    dsattr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    UA_CallbackValueSource ds = {overwriteLargeValue, NULL};
+    res = UA_Server_addCallbackValueSourceVariableNode(
+        server, UA_NODEID_NUMERIC(1, 62101),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+        UA_QUALIFIEDNAME(1, "ZeroCopyOverwrite"),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+        dsattr, ds, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Server_run_startup(server);
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+static void
+checkLargeValue(const UA_Variant *v, UA_Double offset, UA_Double factor) {
+    ck_assert(UA_Variant_hasArrayType(v, &UA_TYPES[UA_TYPES_DOUBLE]));
+    ck_assert_uint_eq(v->arrayLength, ZEROCOPY_LENGTH);
+    const UA_Double *arr = (const UA_Double*)v->data;
+    for(size_t i = 0; i < ZEROCOPY_LENGTH; i++)
+        ck_assert(arr[i] == offset + factor * (UA_Double)i);
+}
+
+START_TEST(zc_readLargeValue) {
+    UA_Client *client = connectClient();
+    for(size_t i = 0; i < 3; i++) {
+        UA_Variant v;
+        UA_StatusCode res =
+            UA_Client_readValueAttribute(client, UA_NODEID_NUMERIC(1, 62100), &v);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        checkLargeValue(&v, 0.0, 1.0);
+        UA_Variant_clear(&v);
+    }
+    disconnectClient(client);
+} END_TEST
+
+START_TEST(zc_readLargeValueWithRange) {
+    UA_Client *client = connectClient();
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_NUMERIC(1, 62100);
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    rvi.indexRange = UA_STRING("10:12");
+
+    UA_ReadRequest req;
+    UA_ReadRequest_init(&req);
+    req.nodesToRead = &rvi;
+    req.nodesToReadSize = 1;
+    UA_ReadResponse resp = UA_Client_Service_read(client, req);
+    ck_assert_uint_eq(resp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(resp.resultsSize, 1);
+    ck_assert(UA_Variant_hasArrayType(&resp.results[0].value,
+                                      &UA_TYPES[UA_TYPES_DOUBLE]));
+    ck_assert_uint_eq(resp.results[0].value.arrayLength, 3);
+    ck_assert(((UA_Double*)resp.results[0].value.data)[0] == 10.0);
+    UA_ReadResponse_clear(&resp);
+    disconnectClient(client);
+} END_TEST
+
+/* The large value is overwritten by a DataSource in the same request. The
+ * response contains the value from before the write. */
+START_TEST(zc_writeBeforeResponseIsSent) {
+    UA_Client *client = connectClient();
+    UA_ReadValueId ids[3];
+    for(size_t i = 0; i < 3; i++) {
+        UA_ReadValueId_init(&ids[i]);
+        ids[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    ids[0].nodeId = UA_NODEID_NUMERIC(1, 62100);
+    ids[1].nodeId = UA_NODEID_NUMERIC(1, 62101);
+    ids[2].nodeId = UA_NODEID_NUMERIC(1, 62100);
+    overwriteEnabled = true;
+
+    UA_ReadRequest req;
+    UA_ReadRequest_init(&req);
+    req.nodesToRead = ids;
+    req.nodesToReadSize = 3;
+    UA_ReadResponse resp = UA_Client_Service_read(client, req);
+    ck_assert_uint_eq(resp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(resp.resultsSize, 3);
+    checkLargeValue(&resp.results[0].value, 0.0, 1.0);
+    checkLargeValue(&resp.results[2].value, -1.0, 0.0);
+    UA_ReadResponse_clear(&resp);
+    disconnectClient(client);
+} END_TEST
+
 /* === Suite definition === */
 static Suite *testSuite_clientHL(void) {
     TCase *tc_read = tcase_create("HL_Read");
@@ -558,11 +701,19 @@ static Suite *testSuite_clientHL(void) {
     tcase_add_test(tc_batch, hl_writeMultiple);
     tcase_add_test(tc_batch, hl_clientState);
 
+    TCase *tc_zerocopy = tcase_create("HL_ZeroCopyRead");
+    tcase_add_checked_fixture(tc_zerocopy, setupZeroCopy, teardown);
+    tcase_set_timeout(tc_zerocopy, 30);
+    tcase_add_test(tc_zerocopy, zc_readLargeValue);
+    tcase_add_test(tc_zerocopy, zc_readLargeValueWithRange);
+    tcase_add_test(tc_zerocopy, zc_writeBeforeResponseIsSent);
+
     Suite *s = suite_create("Client HighLevel Extended");
     suite_add_tcase(s, tc_read);
     suite_add_tcase(s, tc_write);
     suite_add_tcase(s, tc_nodes);
     suite_add_tcase(s, tc_batch);
+    suite_add_tcase(s, tc_zerocopy);
     return s;
 }
 
@@ -9,6 +9,7 @@
 #include <check.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 typedef UA_StatusCode (*PubSubPolicyInit)(UA_PubSubSecurityPolicy *policy,
                                           const UA_Logger *logger);
@@ -154,6 +155,153 @@ START_TEST(pubsub_policy_aes256ctr) {
     exercisePubSubPolicy(UA_PubSubSecurityPolicy_Aes256Ctr);
 } END_TEST
 
+/* Create a group context with the key material used in the tests below */
+static void *
+newKeyedContext(UA_PubSubSecurityPolicy *policy) {
+    UA_Byte signKeyData[32];
+    UA_Byte encKeyData[32];
+    UA_Byte keyNonceData[KEYNONCE_LENGTH];
+    UA_Byte msgNonceData[MESSAGENONCE_LENGTH];
+    for(size_t i = 0; i < sizeof(signKeyData); i++) signKeyData[i] = (UA_Byte)(i + 1);
+    for(size_t i = 0; i < sizeof(encKeyData); i++) encKeyData[i] = (UA_Byte)(i + 9);
+    for(size_t i = 0; i < KEYNONCE_LENGTH; i++) keyNonceData[i] = (UA_Byte)(i + 5);
+    for(size_t i = 0; i < MESSAGENONCE_LENGTH; i++) msgNonceData[i] = (UA_Byte)(i + 2);
+
+    UA_ByteString signKey = {policy->getSignatureKeyLength(policy, NULL), signKeyData};
+    UA_ByteString encKey = {policy->getEncryptionKeyLength(policy, NULL), encKeyData};
+    UA_ByteString keyNonce = {KEYNONCE_LENGTH, keyNonceData};
+    UA_ByteString msgNonce = {MESSAGENONCE_LENGTH, msgNonceData};
+
+    void *ctx = NULL;
+    UA_StatusCode rv =
+        policy->newGroupContext(policy, &signKey, &encKey, &keyNonce, &ctx);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    rv = policy->setMessageNonce(policy, ctx, &msgNonce);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    return ctx;
+}
+
+/* Known answers computed with an independent AES-CTR / HMAC-SHA256
+ * implementation. The message is longer than the chunk of counter blocks
+ * encrypted at once and ends with a partial block. */
+static void
+knownAnswerPubSubPolicy(PubSubPolicyInit init, const UA_Byte *head,
+                        const UA_Byte *tail) {
+    static const UA_Byte expectedSig[32] = {
+        0x9c, 0xd4, 0xe7, 0xc8, 0x17, 0xcb, 0x16, 0x7c, 0x04, 0x67, 0x41,
+        0x6d, 0xa6, 0x44, 0x81, 0xc9, 0x2c, 0xca, 0x63, 0xfe, 0x42, 0x60,
+        0x1d, 0x10, 0xbc, 0x87, 0x30, 0x3e, 0x1b, 0x3a, 0x4e, 0x19};
+
+    UA_PubSubSecurityPolicy policy;
+    UA_StatusCode rv = init(&policy, UA_Log_Stdout);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    void *ctx = newKeyedContext(&policy);
+
+    UA_ByteString msg = UA_BYTESTRING("PubSub network message payload bytes");
+    UA_Byte sigData[32];
+    UA_ByteString sig = {sizeof(sigData), sigData};
+    rv = policy.sign(&policy, ctx, &msg, &sig);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    ck_assert(memcmp(sigData, expectedSig, sizeof(expectedSig)) == 0);
+
+    UA_Byte buf[300];
+    for(size_t i = 0; i < sizeof(buf); i++) buf[i] = (UA_Byte)(i & 0xFF);
+    UA_ByteString data = {sizeof(buf), buf};
+    rv = policy.encrypt(&policy, ctx, &data);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    ck_assert(memcmp(buf, head, 16) == 0);
+    ck_assert(memcmp(buf + 288, tail, 12) == 0);
+
+    policy.deleteGroupContext(&policy, ctx);
+    policy.clear(&policy);
+}
+
+START_TEST(pubsub_policy_aes128ctr_knownAnswer) {
+    static const UA_Byte head[16] = {
+        0x79, 0xc0, 0x4a, 0x4a, 0xeb, 0xd3, 0x35, 0xd9,
+        0x88, 0x3a, 0x16, 0xe0, 0x0b, 0xdc, 0xf8, 0xe2};
+    static const UA_Byte tail[12] = {
+        0x08, 0xc9, 0x5f, 0x50, 0xd1, 0xd4, 0x64, 0x72, 0x32, 0xff, 0xf8, 0x7a};
+    knownAnswerPubSubPolicy(UA_PubSubSecurityPolicy_Aes128Ctr, head, tail);
+} END_TEST
+
+START_TEST(pubsub_policy_aes256ctr_knownAnswer) {
+    static const UA_Byte head[16] = {
+        0xbd, 0x38, 0x07, 0x18, 0xc9, 0x77, 0x76, 0xd9,
+        0x8c, 0x2a, 0x0b, 0x47, 0xfa, 0x46, 0xa5, 0x88};
+    static const UA_Byte tail[12] = {
+        0x98, 0xe3, 0x3f, 0xfd, 0xc9, 0xfe, 0x98, 0x2b, 0xe4, 0xf1, 0x3f, 0x44};
+    knownAnswerPubSubPolicy(UA_PubSubSecurityPolicy_Aes256Ctr, head, tail);
+} END_TEST
+
+/* Time the per-message work of a publisher (encrypt and sign) and a subscriber
+ * (verify and decrypt) for a typical NetworkMessage. The keys are set once.
+ * For comparison, the keys are re-set before every message. */
+static void
+benchmarkPubSubPolicy(PubSubPolicyInit init, const char *name) {
+    UA_PubSubSecurityPolicy policy;
+    UA_StatusCode rv = init(&policy, UA_Log_Stdout);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    void *ctx = newKeyedContext(&policy);
+
+    UA_Byte keyData[96];
+    for(size_t i = 0; i < sizeof(keyData); i++) keyData[i] = (UA_Byte)(i * 7);
+    UA_ByteString signKey = {policy.getSignatureKeyLength(&policy, ctx), keyData};
+    UA_ByteString encKey = {policy.getEncryptionKeyLength(&policy, ctx), keyData + 32};
+    UA_ByteString keyNonce = {KEYNONCE_LENGTH, keyData + 64};
+
+    UA_Byte nonceData[MESSAGENONCE_LENGTH] = {0};
+    UA_ByteString nonce = {sizeof(nonceData), nonceData};
+    UA_Byte buf[256 + 32];
+    memset(buf, 0x5a, sizeof(buf));
+    UA_ByteString payload = {256, buf};
+    UA_ByteString sig = {32, buf + 256};
+
+    size_t iterations = 20000;
+    clock_t begin = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        nonceData[0] = (UA_Byte)i;
+        rv = policy.setMessageNonce(&policy, ctx, &nonce);
+        rv |= policy.encrypt(&policy, ctx, &payload);
+        rv |= policy.sign(&policy, ctx, &payload, &sig);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+    clock_t middle = clock();
+    UA_Byte received[sizeof(buf)];
+    memcpy(received, buf, sizeof(buf));
+    for(size_t i = 0; i < iterations; i++) {
+        memcpy(buf, received, sizeof(buf));
+        rv = policy.verify(&policy, ctx, &payload, &sig);
+        rv |= policy.setMessageNonce(&policy, ctx, &nonce);
+        rv |= policy.decrypt(&policy, ctx, &payload);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+    clock_t finish = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        nonceData[0] = (UA_Byte)i;
+        rv = policy.setSecurityKeys(&policy, ctx, &signKey, &encKey, &keyNonce);
+        rv |= policy.setMessageNonce(&policy, ctx, &nonce);
+        rv |= policy.encrypt(&policy, ctx, &payload);
+        rv |= policy.sign(&policy, ctx, &payload, &sig);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+    clock_t rekeyed = clock();
+    printf("%s (%lu messages of %lu bytes): encrypt and sign %f s, "
+           "verify and decrypt %f s, with keys set per message %f s\n", name,
+           (unsigned long)iterations, (unsigned long)payload.length,
+           (double)(middle - begin) / CLOCKS_PER_SEC,
+           (double)(finish - middle) / CLOCKS_PER_SEC,
+           (double)(rekeyed - finish) / CLOCKS_PER_SEC);
+
+    policy.deleteGroupContext(&policy, ctx);
+    policy.clear(&policy);
+}
+
+START_TEST(pubsub_policy_benchmark) {
+    benchmarkPubSubPolicy(UA_PubSubSecurityPolicy_Aes128Ctr, "PubSub-Aes128-CTR");
+    benchmarkPubSubPolicy(UA_PubSubSecurityPolicy_Aes256Ctr, "PubSub-Aes256-CTR");
+} END_TEST
+
 /* A context created with keys passed directly to newGroupContext */
 START_TEST(pubsub_policy_newGroupContext_withKeys) {
     UA_PubSubSecurityPolicy policy;
@@ -201,7 +349,12 @@ testSuite_PubSubSecurityPolicy(void) {
     tcase_add_test(tc, pubsub_policy_aes128ctr);
     tcase_add_test(tc, pubsub_policy_aes256ctr);
     tcase_add_test(tc, pubsub_policy_newGroupContext_withKeys);
+    tcase_add_test(tc, pubsub_policy_aes128ctr_knownAnswer);
+    tcase_add_test(tc, pubsub_policy_aes256ctr_knownAnswer);
     suite_add_tcase(s, tc);
+    TCase *tc_bench = tcase_create("benchmark");
+    tcase_add_test(tc_bench, pubsub_policy_benchmark);
+    suite_add_tcase(s, tc_bench);
     return s;
 }
 
@@ -44,7 +44,7 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     ac->syncResponse = NULL;
     LIST_INSERT_HEAD(&client->asyncServiceCalls, ac, pointers);
 
-    processServiceResponse(client, &client->channel, messageType, requestId, &message);
+    processServiceResponse(client, &client->channel, messageType, requestId, &message, 1);
 
     // Cleanup
     // processServiceResponse might have removed 'ac' if it matched
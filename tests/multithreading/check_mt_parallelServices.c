@@ -0,0 +1,624 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/client_highlevel_async.h>
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "test_helpers.h"
+#include "thread_wrapper.h"
+#include "mt_testing.h"
+
+#define NUMBER_OF_WORKERS 4
+#define ITERATIONS_PER_WORKER 50
+#define NUMBER_OF_CLIENTS 8
+#define ITERATIONS_PER_CLIENT 50
+#define NUMBER_OF_VARIABLES 32
+
+static UA_UInt16 serviceWorkers;
+static UA_DateTime startTime;
+
+static void
+addVariableNodes(void) {
+    for(UA_UInt32 i = 0; i < NUMBER_OF_VARIABLES; i++) {
+        UA_VariableAttributes attr = UA_VariableAttributes_default;
+        UA_Int32 value = (UA_Int32)i;
+        UA_Variant_setScalar(&attr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+        attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+        char name[32];
+        snprintf(name, sizeof(name), "Variable%u", (unsigned)i);
+        attr.displayName = UA_LOCALIZEDTEXT("en-US", name);
+        UA_StatusCode res =
+            UA_Server_addVariableNode(tc.server, UA_NODEID_NUMERIC(1, 1000 + i),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, name),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                      attr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+}
+
+static void
+setup(void) {
+    tc.running = true;
+    tc.server = UA_Server_newForUnitTest();
+    ck_assert(tc.server != NULL);
+    UA_Server_getConfig(tc.server)->serviceWorkers = serviceWorkers;
+    addVariableNodes();
+    UA_Server_run_startup(tc.server);
+    THREAD_CREATE(server_thread, serverloop);
+    startTime = UA_DateTime_nowMonotonic();
+}
+
+static void
+setupSerial(void) {
+    serviceWorkers = 0;
+    setup();
+}
+
+static void
+setupParallel(void) {
+    serviceWorkers = 4;
+    setup();
+}
+
+static void
+teardownLog(void) {
+    teardown();
+    UA_DateTime duration = UA_DateTime_nowMonotonic() - startTime;
+    UA_LOG_INFO(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND,
+                "%u service workers: %u client requests in %.1f ms",
+                (unsigned)serviceWorkers,
+                (unsigned)(NUMBER_OF_CLIENTS * ITERATIONS_PER_CLIENT * 3),
+                (double)duration / UA_DATETIME_MSEC);
+}
+
+/* The server threads write to the first variables while the clients read */
+static void
+server_writeValue(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+    UA_Variant var;
+    UA_Int32 v = (UA_Int32)(NUMBER_OF_VARIABLES + tmp.counter);
+    UA_Variant_setScalar(&var, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res =
+        UA_Server_writeValue(tc.server, UA_NODEID_NUMERIC(1, 1000 + (UA_UInt32)tmp.index),
+                             var);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void
+client_readBrowseWrite(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+    UA_Client *client = tc.clients[tmp.index];
+
+    /* Read all variables in one request */
+    UA_ReadValueId rvi[NUMBER_OF_VARIABLES];
+    for(UA_UInt32 i = 0; i < NUMBER_OF_VARIABLES; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = UA_NODEID_NUMERIC(1, 1000 + i);
+        rvi[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest rReq;
+    UA_ReadRequest_init(&rReq);
+    rReq.nodesToRead = rvi;
+    rReq.nodesToReadSize = NUMBER_OF_VARIABLES;
+    UA_ReadResponse rResp = UA_Client_Service_read(client, rReq);
+    ck_assert_uint_eq(rResp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(rResp.resultsSize, NUMBER_OF_VARIABLES);
+    for(size_t i = 0; i < rResp.resultsSize; i++) {
+        ck_assert_uint_eq(rResp.results[i].status, UA_STATUSCODE_GOOD);
+        ck_assert(rResp.results[i].value.type == &UA_TYPES[UA_TYPES_INT32]);
+    }
+    /* The variables above the server threads are only written by the client */
+    for(size_t i = NUMBER_OF_WORKERS + NUMBER_OF_CLIENTS; i < NUMBER_OF_VARIABLES; i++)
+        ck_assert_int_eq(*(UA_Int32*)rResp.results[i].value.data, (UA_Int32)i);
+    UA_ReadResponse_clear(&rResp);
+
+    /* Browse the variables */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_BROWSENAME;
+    UA_BrowseRequest bReq;
+    UA_BrowseRequest_init(&bReq);
+    bReq.nodesToBrowse = &bd;
+    bReq.nodesToBrowseSize = 1;
+    UA_BrowseResponse bResp = UA_Client_Service_browse(client, bReq);
+    ck_assert_uint_eq(bResp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bResp.resultsSize, 1);
+    ck_assert_uint_ge(bResp.results[0].referencesSize, NUMBER_OF_VARIABLES);
+    UA_BrowseResponse_clear(&bResp);
+
+    /* Write and read back. The write flushes the deferred reads. */
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 1000 + NUMBER_OF_WORKERS +
+                                     (UA_UInt32)tmp.index);
+    UA_Variant var;
+    UA_Int32 v = (UA_Int32)tmp.counter;
+    UA_Variant_setScalar(&var, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res = UA_Client_writeValueAttribute(client, id, &var);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Client_readValueAttribute(client, id, &var);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)var.data, v);
+    UA_Variant_clear(&var);
+}
+
+static void
+initTest(void) {
+    for(size_t i = 0; i < tc.numberOfWorkers; i++)
+        setThreadContext(&tc.workerContext[i], i, ITERATIONS_PER_WORKER,
+                         server_writeValue);
+    for(size_t i = 0; i < tc.numberofClients; i++)
+        setThreadContext(&tc.clientContext[i], i, ITERATIONS_PER_CLIENT,
+                         client_readBrowseWrite);
+}
+
+START_TEST(parallelServices) {
+    startMultithreading();
+} END_TEST
+
+#ifndef _WIN32
+/* Batches of requests from several sessions. The server is iterated manually,
+ * so that all requests are executed in one batch. A DataSource blocks until a
+ * second thread reads it at the same time. This shows that more than one
+ * thread executes the batch. The responses are compared with the serial
+ * execution of the same operations via the local API. */
+
+#define BATCH_ROUNDS 10
+#define BARRIER_NODE 2000
+#define BARRIER_TIMEOUT_SEC 2
+
+static UA_Client *batchClients[NUMBER_OF_CLIENTS];
+
+static pthread_mutex_t barrierMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t barrierCond = PTHREAD_COND_INITIALIZER;
+static size_t barrierInside;
+static size_t barrierReads;
+static size_t barrierTimeouts;
+static UA_Boolean barrierMet;
+static UA_Boolean barrierActive;
+
+static UA_StatusCode
+readBarrier(UA_Server *server, const UA_NodeId *sessionId,
+            void *sessionContext, const UA_NodeId *nodeId,
+            void *nodeContext, UA_Boolean includeSourceTimeStamp,
+            const UA_NumericRange *range, UA_DataValue *value) {
+    pthread_mutex_lock(&barrierMutex);
+    if(barrierActive) {
+        barrierReads++;
+        barrierInside++;
+        if(barrierInside >= 2) {
+            barrierMet = true;
+            pthread_cond_broadcast(&barrierCond);
+        }
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += BARRIER_TIMEOUT_SEC;
+        while(!barrierMet) {
+            if(pthread_cond_timedwait(&barrierCond, &barrierMutex, &deadline) != 0) {
+                barrierTimeouts++;
+                break;
+            }
+        }
+        barrierInside--;
+    }
+    pthread_mutex_unlock(&barrierMutex);
+
+    UA_Int32 v = BARRIER_NODE;
+    UA_Variant_setScalarCopy(&value->value, &v, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* A DataSource that tries to modify the information model when it is read */
+#define MODIFY_NODE 2001
+#define MODIFY_ADDED_NODE 2002
+#define MODIFY_DELETED_NODE 2003
+
+static UA_Boolean modifyEnabled;
+static size_t modifyCalls;
+static size_t modifyRejected;
+static UA_StatusCode modifyResults[3];
+
+static UA_StatusCode
+readModify(UA_Server *server, const UA_NodeId *sessionId,
+           void *sessionContext, const UA_NodeId *nodeId,
+           void *nodeContext, UA_Boolean includeSourceTimeStamp,
+           const UA_NumericRange *range, UA_DataValue *value) {
+    /* Also read when the node is added */
+    UA_Int32 out = MODIFY_NODE;
+    UA_Variant_setScalarCopy(&value->value, &out, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    if(!modifyEnabled)
+        return UA_STATUSCODE_GOOD;
+
+    UA_Variant var;
+    UA_Int32 v = -1;
+    UA_Variant_setScalar(&var, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode writeRes =
+        UA_Server_writeValue(server, UA_NODEID_NUMERIC(1, 1000), var);
+
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    UA_StatusCode addRes =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, MODIFY_ADDED_NODE),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Added"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oAttr, NULL, NULL);
+
+    UA_StatusCode deleteRes =
+        UA_Server_deleteNode(server, UA_NODEID_NUMERIC(1, MODIFY_DELETED_NODE), true);
+
+    pthread_mutex_lock(&barrierMutex);
+    modifyCalls++;
+    if(writeRes == UA_STATUSCODE_BADINVALIDSTATE &&
+       addRes == UA_STATUSCODE_BADINVALIDSTATE &&
+       deleteRes == UA_STATUSCODE_BADINVALIDSTATE)
+        modifyRejected++;
+    modifyResults[0] = writeRes;
+    modifyResults[1] = addRes;
+    modifyResults[2] = deleteRes;
+    pthread_mutex_unlock(&barrierMutex);
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+setupBatches(void) {
+    serviceWorkers = 4;
+    tc.running = true;
+    tc.server = UA_Server_newForUnitTest();
+    ck_assert(tc.server != NULL);
+    UA_Server_getConfig(tc.server)->serviceWorkers = serviceWorkers;
+    addVariableNodes();
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    attr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", "Barrier");
+    UA_CallbackValueSource ds = {readBarrier, NULL};
+    UA_StatusCode res =
+        UA_Server_addCallbackValueSourceVariableNode(
+            tc.server, UA_NODEID_NUMERIC(1, BARRIER_NODE),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+            UA_QUALIFIEDNAME(1, "Barrier"),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+            attr, ds, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", "Modify");
+    UA_CallbackValueSource modifyDs = {readModify, NULL};
+    res = UA_Server_addCallbackValueSourceVariableNode(
+            tc.server, UA_NODEID_NUMERIC(1, MODIFY_NODE),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+            UA_QUALIFIEDNAME(1, "Modify"),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+            attr, modifyDs, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    res = UA_Server_addObjectNode(tc.server, UA_NODEID_NUMERIC(1, MODIFY_DELETED_NODE),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Deleted"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                  oAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Connect the clients while the server runs in its thread */
+    UA_Server_run_startup(tc.server);
+    THREAD_CREATE(server_thread, serverloop);
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        batchClients[i] = UA_Client_newForUnitTest();
+        res = UA_Client_connect(batchClients[i], "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    /* Iterate the server manually from here on */
+    tc.running = false;
+    THREAD_JOIN(server_thread);
+}
+
+static void
+teardownBatches(void) {
+    tc.running = true;
+    THREAD_CREATE(server_thread, serverloop);
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        UA_Client_disconnect(batchClients[i]);
+        UA_Client_delete(batchClients[i]);
+    }
+    tc.running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(tc.server);
+    UA_Server_delete(tc.server);
+}
+
+typedef struct {
+    UA_ReadValueId rvi[NUMBER_OF_VARIABLES + 1];
+    UA_ReadRequest readRequest;
+    UA_BrowseDescription bd;
+    UA_BrowseRequest browseRequest;
+    char name[32];
+    UA_RelativePathElement rpe;
+    UA_BrowsePath bp;
+    UA_TranslateBrowsePathsToNodeIdsRequest translateRequest;
+
+    UA_ReadResponse readResponse;
+    UA_BrowseResponse browseResponse;
+    UA_TranslateBrowsePathsToNodeIdsResponse translateResponse;
+    size_t received;
+} BatchClientContext;
+
+static BatchClientContext batchContexts[NUMBER_OF_CLIENTS];
+
+static void
+copyResponse(UA_Client *client, void *userdata,
+             UA_UInt32 requestId, void *response) {
+    BatchClientContext *ctx = (BatchClientContext*)userdata;
+    const UA_ResponseHeader *rh = (const UA_ResponseHeader*)response;
+    UA_StatusCode res = UA_STATUSCODE_BADINTERNALERROR;
+    if(rh->requestHandle == 1)
+        res = UA_ReadResponse_copy((UA_ReadResponse*)response, &ctx->readResponse);
+    else if(rh->requestHandle == 2)
+        res = UA_BrowseResponse_copy((UA_BrowseResponse*)response,
+                                     &ctx->browseResponse);
+    else if(rh->requestHandle == 3)
+        res = UA_TranslateBrowsePathsToNodeIdsResponse_copy(
+            (UA_TranslateBrowsePathsToNodeIdsResponse*)response,
+            &ctx->translateResponse);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ctx->received++;
+}
+
+/* Every client reads different attributes of the variables and the barrier,
+ * browses the ObjectsFolder and translates the path to a different variable */
+static void
+sendBatchRequests(size_t client, size_t round) {
+    BatchClientContext *ctx = &batchContexts[client];
+    memset(ctx, 0, sizeof(BatchClientContext));
+    static const UA_AttributeId attributes[4] = {
+        UA_ATTRIBUTEID_VALUE, UA_ATTRIBUTEID_BROWSENAME,
+        UA_ATTRIBUTEID_DATATYPE, UA_ATTRIBUTEID_ACCESSLEVEL};
+    for(UA_UInt32 i = 0; i < NUMBER_OF_VARIABLES; i++) {
+        ctx->rvi[i].nodeId = UA_NODEID_NUMERIC(1, 1000 + i);
+        ctx->rvi[i].attributeId = attributes[(i + client + round) % 4];
+    }
+    ctx->rvi[NUMBER_OF_VARIABLES].nodeId = UA_NODEID_NUMERIC(1, BARRIER_NODE);
+    ctx->rvi[NUMBER_OF_VARIABLES].attributeId = UA_ATTRIBUTEID_VALUE;
+    ctx->readRequest.requestHeader.requestHandle = 1;
+    ctx->readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_NEITHER;
+    ctx->readRequest.nodesToRead = ctx->rvi;
+    ctx->readRequest.nodesToReadSize = NUMBER_OF_VARIABLES + 1;
+
+    ctx->bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    ctx->bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    ctx->bd.includeSubtypes = true;
+    ctx->bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    ctx->bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    ctx->browseRequest.requestHeader.requestHandle = 2;
+    ctx->browseRequest.nodesToBrowse = &ctx->bd;
+    ctx->browseRequest.nodesToBrowseSize = 1;
+
+    snprintf(ctx->name, sizeof(ctx->name), "Variable%u",
+             (unsigned)((client + round) % NUMBER_OF_VARIABLES));
+    ctx->rpe.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    ctx->rpe.targetName = UA_QUALIFIEDNAME(1, ctx->name);
+    ctx->bp.startingNode = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    ctx->bp.relativePath.elements = &ctx->rpe;
+    ctx->bp.relativePath.elementsSize = 1;
+    ctx->translateRequest.requestHeader.requestHandle = 3;
+    ctx->translateRequest.browsePaths = &ctx->bp;
+    ctx->translateRequest.browsePathsSize = 1;
+
+    UA_Client *c = batchClients[client];
+    UA_StatusCode res =
+        __UA_Client_AsyncService(c, &ctx->readRequest, &UA_TYPES[UA_TYPES_READREQUEST],
+                                 copyResponse, &UA_TYPES[UA_TYPES_READRESPONSE],
+                                 ctx, NULL);
+    res |= __UA_Client_AsyncService(c, &ctx->browseRequest,
+                                    &UA_TYPES[UA_TYPES_BROWSEREQUEST], copyResponse,
+                                    &UA_TYPES[UA_TYPES_BROWSERESPONSE], ctx, NULL);
+    res |= __UA_Client_AsyncService(c, &ctx->translateRequest,
+                                    &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSREQUEST],
+                                    copyResponse,
+                                    &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSRESPONSE],
+                                    ctx, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void
+checkSerialResults(BatchClientContext *ctx) {
+    ck_assert_uint_eq(ctx->readResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx->readResponse.resultsSize, NUMBER_OF_VARIABLES + 1);
+    for(size_t i = 0; i < ctx->readResponse.resultsSize; i++) {
+        UA_DataValue serial =
+            UA_Server_read(tc.server, &ctx->rvi[i], UA_TIMESTAMPSTORETURN_NEITHER);
+        ck_assert_uint_eq(serial.status, UA_STATUSCODE_GOOD);
+        ck_assert(UA_equal(&ctx->readResponse.results[i], &serial,
+                           &UA_TYPES[UA_TYPES_DATAVALUE]));
+        UA_DataValue_clear(&serial);
+    }
+
+    ck_assert_uint_eq(ctx->browseResponse.responseHeader.serviceResult,
+                      UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx->browseResponse.resultsSize, 1);
+    UA_BrowseResult serialBrowse = UA_Server_browse(tc.server, 0, &ctx->bd);
+    ck_assert_uint_ge(serialBrowse.referencesSize, NUMBER_OF_VARIABLES + 1);
+    ck_assert(UA_equal(&ctx->browseResponse.results[0], &serialBrowse,
+                       &UA_TYPES[UA_TYPES_BROWSERESULT]));
+    UA_BrowseResult_clear(&serialBrowse);
+
+    ck_assert_uint_eq(ctx->translateResponse.responseHeader.serviceResult,
+                      UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx->translateResponse.resultsSize, 1);
+    UA_BrowsePathResult serialPath =
+        UA_Server_translateBrowsePathToNodeIds(tc.server, &ctx->bp);
+    ck_assert_uint_eq(serialPath.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert(UA_equal(&ctx->translateResponse.results[0], &serialPath,
+                       &UA_TYPES[UA_TYPES_BROWSEPATHRESULT]));
+    UA_BrowsePathResult_clear(&serialPath);
+
+    UA_ReadResponse_clear(&ctx->readResponse);
+    UA_BrowseResponse_clear(&ctx->browseResponse);
+    UA_TranslateBrowsePathsToNodeIdsResponse_clear(&ctx->translateResponse);
+}
+
+START_TEST(parallelBatches) {
+    for(size_t round = 0; round < BATCH_ROUNDS; round++) {
+        pthread_mutex_lock(&barrierMutex);
+        barrierReads = 0;
+        barrierTimeouts = 0;
+        barrierMet = false;
+        barrierActive = true;
+        pthread_mutex_unlock(&barrierMutex);
+
+        /* All requests are sent before the server iterates */
+        for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++)
+            sendBatchRequests(i, round);
+        struct timespec ts = {0, 50000000}; /* 50ms */
+        nanosleep(&ts, NULL);
+
+        /* The first iteration receives the requests and defers them. The
+         * batch is executed in the delayed callback of the next iteration. */
+        UA_Server_run_iterate(tc.server, false);
+        ck_assert_uint_eq(barrierReads, 0);
+        UA_Server_run_iterate(tc.server, false);
+
+        /* All sessions were in the batch and at least two threads executed
+         * the reads at the same time */
+        pthread_mutex_lock(&barrierMutex);
+        barrierActive = false;
+        ck_assert_uint_eq(barrierReads, NUMBER_OF_CLIENTS);
+        ck_assert_uint_eq(barrierTimeouts, 0);
+        ck_assert(barrierMet);
+        pthread_mutex_unlock(&barrierMutex);
+
+        /* Receive the responses */
+        for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+            for(size_t j = 0; j < 100 && batchContexts[i].received < 3; j++)
+                UA_Client_run_iterate(batchClients[i], 10);
+            ck_assert_uint_eq(batchContexts[i].received, 3);
+            checkSerialResults(&batchContexts[i]);
+        }
+    }
+} END_TEST
+
+/* Callbacks during the parallel execution cannot modify the information
+ * model. Outside of a batch they can. */
+START_TEST(modifyInBatch) {
+    modifyEnabled = true;
+    modifyCalls = 0;
+    modifyRejected = 0;
+
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_NUMERIC(1, MODIFY_NODE);
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        BatchClientContext *ctx = &batchContexts[i];
+        memset(ctx, 0, sizeof(BatchClientContext));
+        ctx->rvi[0] = rvi;
+        ctx->readRequest.requestHeader.requestHandle = 1;
+        ctx->readRequest.nodesToRead = ctx->rvi;
+        ctx->readRequest.nodesToReadSize = 1;
+        UA_StatusCode res =
+            __UA_Client_AsyncService(batchClients[i], &ctx->readRequest,
+                                     &UA_TYPES[UA_TYPES_READREQUEST], copyResponse,
+                                     &UA_TYPES[UA_TYPES_READRESPONSE], ctx, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    struct timespec ts = {0, 50000000}; /* 50ms */
+    nanosleep(&ts, NULL);
+    UA_Server_run_iterate(tc.server, false);
+    UA_Server_run_iterate(tc.server, false);
+
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        BatchClientContext *ctx = &batchContexts[i];
+        for(size_t j = 0; j < 100 && ctx->received < 1; j++)
+            UA_Client_run_iterate(batchClients[i], 10);
+        ck_assert_uint_eq(ctx->received, 1);
+        ck_assert_uint_eq(ctx->readResponse.resultsSize, 1);
+        ck_assert_uint_eq(ctx->readResponse.results[0].status, UA_STATUSCODE_GOOD);
+        UA_ReadResponse_clear(&ctx->readResponse);
+    }
+
+    /* Every modification was rejected */
+    ck_assert_uint_eq(modifyCalls, NUMBER_OF_CLIENTS);
+    ck_assert_uint_eq(modifyRejected, NUMBER_OF_CLIENTS);
+    UA_Variant var;
+    UA_StatusCode res =
+        UA_Server_readValue(tc.server, UA_NODEID_NUMERIC(1, 1000), &var);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)var.data, 0);
+    UA_Variant_clear(&var);
+    UA_NodeClass nc;
+    res = UA_Server_readNodeClass(tc.server, UA_NODEID_NUMERIC(1, MODIFY_ADDED_NODE), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    res = UA_Server_readNodeClass(tc.server, UA_NODEID_NUMERIC(1, MODIFY_DELETED_NODE), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* The local read is not executed in a batch */
+    modifyCalls = 0;
+    UA_DataValue dv = UA_Server_read(tc.server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_GOOD);
+    UA_DataValue_clear(&dv);
+    ck_assert_uint_eq(modifyCalls, 1);
+    ck_assert_uint_eq(modifyResults[0], UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(modifyResults[1], UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(modifyResults[2], UA_STATUSCODE_GOOD);
+    res = UA_Server_readNodeClass(tc.server, UA_NODEID_NUMERIC(1, MODIFY_ADDED_NODE), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_readNodeClass(tc.server, UA_NODEID_NUMERIC(1, MODIFY_DELETED_NODE), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    modifyEnabled = false;
+} END_TEST
+#endif
+
+static Suite *
+testSuite_parallelServices(void) {
+    Suite *s = suite_create("Multithreading");
+    TCase *tc_serial = tcase_create("Services in the EventLoop");
+    tcase_add_checked_fixture(tc_serial, setupSerial, teardownLog);
+    tcase_add_test(tc_serial, parallelServices);
+    suite_add_tcase(s, tc_serial);
+
+    TCase *tc_parallel = tcase_create("Services in worker threads");
+    tcase_add_checked_fixture(tc_parallel, setupParallel, teardownLog);
+    tcase_add_test(tc_parallel, parallelServices);
+    suite_add_tcase(s, tc_parallel);
+
+#ifndef _WIN32
+    TCase *tc_batches = tcase_create("Batches match serial execution");
+    tcase_add_checked_fixture(tc_batches, setupBatches, teardownBatches);
+    tcase_add_test(tc_batches, parallelBatches);
+    tcase_add_test(tc_batches, modifyInBatch);
+    suite_add_tcase(s, tc_batches);
+#endif
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_parallelServices();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    createThreadContext(NUMBER_OF_WORKERS, NUMBER_OF_CLIENTS, NULL);
+    initTest();
+    srunner_run_all(sr, CK_NORMAL);
+    deleteThreadContext();
+
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -346,7 +346,7 @@ START_TEST(DecodeAndVerifyEncryptedNetworkMessage) {
 
     ck_assert(memcmp(buffer.data, expectedData, strlen((const char*)expectedData)) == 0);
 
-    UA_NetworkMessage_clear(&msg);
+    UA_ReaderGroup_clearNetworkMessage(psm, rg, &msg);
 
     UA_free(fields);
     UA_free(expectedData);
@@ -379,7 +379,7 @@ START_TEST(InvalidSignature) {
     UA_StatusCode rv = UA_ReaderGroup_decodeNetworkMessage(psm, rg, buffer, &msg);
     ck_assert(rv == UA_STATUSCODE_BADSECURITYCHECKSFAILED);
 
-    UA_NetworkMessage_clear(&msg);
+    UA_ReaderGroup_clearNetworkMessage(psm, rg, &msg);
 
     UA_free(fields);
     free(buffer.data);
@@ -410,7 +410,7 @@ START_TEST(InvalidSecurityModeInsufficientSig) {
     UA_StatusCode rv = UA_ReaderGroup_decodeNetworkMessage(psm, rg, buffer, &msg);
     ck_assert(rv == UA_STATUSCODE_BADSECURITYMODEINSUFFICIENT);
 
-    UA_NetworkMessage_clear(&msg);
+    UA_ReaderGroup_clearNetworkMessage(psm, rg, &msg);
 
     UA_free(fields);
     free(buffer.data);
@@ -441,7 +441,7 @@ START_TEST(InvalidSecurityModeRejectedSig) {
     UA_StatusCode rv = UA_ReaderGroup_decodeNetworkMessage(psm, rg, buffer, &msg);
     ck_assert(rv == UA_STATUSCODE_BADSECURITYMODEREJECTED);
 
-    UA_NetworkMessage_clear(&msg);
+    UA_ReaderGroup_clearNetworkMessage(psm, rg, &msg);
 
     UA_free(fields);
     free(buffer.data);
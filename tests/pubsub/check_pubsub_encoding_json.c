@@ -11,8 +11,12 @@
 #include <open62541/util.h>
 #include <open62541/pubsub.h>
 
+#include "ua_pubsub_networkmessage.h"
+
 #include <check.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 START_TEST(UA_PubSub_CompactJsonOptions) {
     UA_FieldMetaData field = {0};
@@ -502,6 +506,134 @@ START_TEST(UA_Networkmessage_malformed_array) {
 }
 END_TEST
 
+START_TEST(UA_Networkmessage_templateEncoding) {
+    /* Two writers with three fields each. The field names need escaping. */
+    UA_FieldMetaData fmd[3] = {0};
+    fmd[0].name = UA_STRING("Temperature");
+    fmd[1].name = UA_STRING("Pressure \"bar\"");
+    fmd[2].name = UA_STRING("Line\nFeed");
+    UA_DataSetMessage_EncodingMetaData emd[2] = {0};
+    emd[0].dataSetWriterId = 1;
+    emd[0].fields = fmd;
+    emd[0].fieldsSize = 3;
+    emd[1].dataSetWriterId = 2;
+    emd[1].fields = fmd;
+    emd[1].fieldsSize = 3;
+    UA_NetworkMessage_EncodingOptions eo = {0};
+    eo.metaData = emd;
+    eo.metaDataSize = 2;
+
+    UA_NetworkMessage m;
+    memset(&m, 0, sizeof(UA_NetworkMessage));
+    m.version = 1;
+    m.networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    m.payloadHeaderEnabled = true;
+    m.publisherIdEnabled = true;
+    m.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    m.publisherId.id.uint16 = 4711;
+    m.messageCount = 2;
+    m.dataSetWriterIds[0] = 1;
+    m.dataSetWriterIds[1] = 2;
+    m.payload.dataSetMessages = (UA_DataSetMessage*)
+        UA_calloc(2, sizeof(UA_DataSetMessage));
+    ck_assert_ptr_nonnull(m.payload.dataSetMessages);
+
+    for(size_t i = 0; i < 2; i++) {
+        UA_DataSetMessage *dsm = &m.payload.dataSetMessages[i];
+        dsm->header.dataSetMessageValid = true;
+        dsm->header.fieldEncoding = (i == 0) ?
+            UA_FIELDENCODING_VARIANT : UA_FIELDENCODING_DATAVALUE;
+        dsm->header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+        dsm->header.dataSetMessageSequenceNrEnabled = true;
+        dsm->header.dataSetMessageSequenceNr = (UA_UInt16)(100 + i);
+        dsm->header.timestampEnabled = true;
+        dsm->header.timestamp = 11111111111111;
+        dsm->fieldCount = 3;
+        dsm->data.keyFrameFields = (UA_DataValue*)
+            UA_Array_new(3, &UA_TYPES[UA_TYPES_DATAVALUE]);
+        for(UA_Int32 j = 0; j < 3; j++) {
+            UA_Int32 v = j * 1000;
+            UA_Variant_setScalarCopy(&dsm->data.keyFrameFields[j].value,
+                                     &v, &UA_TYPES[UA_TYPES_INT32]);
+            dsm->data.keyFrameFields[j].hasValue = true;
+        }
+    }
+
+    /* Compile the templates */
+    UA_String head = UA_STRING_NULL;
+    UA_StatusCode rv = UA_NetworkMessage_encodeJsonHeaderTemplate(&m, &head);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    UA_DataSetMessageJsonTemplate t[2];
+    UA_DataSetMessageJsonTemplate *templates[2] = {&t[0], &t[1]};
+    for(size_t i = 0; i < 2; i++) {
+        rv = UA_DataSetMessageJsonTemplate_init(&t[i], &emd[i]);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+
+    /* The generic encoding */
+    UA_ByteString generic = UA_BYTESTRING_NULL;
+    rv = UA_NetworkMessage_encodeJson(&m, &generic, &eo, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+
+    /* The template encoding has the identical output */
+    UA_Byte buf[1024];
+    CtxJson ctx;
+    memset(&ctx, 0, sizeof(CtxJson));
+    ctx.pos = buf;
+    ctx.end = buf + sizeof(buf);
+    rv = UA_NetworkMessage_encodeJsonTemplate(&ctx, &head, templates, &m);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    UA_ByteString precompiled = {(size_t)(ctx.pos - buf), buf};
+    ck_assert(UA_ByteString_equal(&generic, &precompiled));
+
+    /* Too little space */
+    memset(&ctx, 0, sizeof(CtxJson));
+    ctx.pos = buf;
+    ctx.end = buf + 16;
+    rv = UA_NetworkMessage_encodeJsonTemplate(&ctx, &head, templates, &m);
+    ck_assert_int_eq(rv, UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
+
+    /* Compare the encoding speed */
+    size_t iterations = 20000;
+    UA_Byte genericBuf[1024];
+    clock_t begin = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        UA_ByteString out = {sizeof(genericBuf), genericBuf};
+        size_t len = UA_NetworkMessage_calcSizeJson(&m, &eo, NULL);
+        ck_assert_uint_eq(len, generic.length);
+        rv = UA_NetworkMessage_encodeJson(&m, &out, &eo, NULL);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+    clock_t middle = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        memset(&ctx, 0, sizeof(CtxJson));
+        ctx.pos = buf;
+        ctx.end = buf + sizeof(buf);
+        rv = UA_NetworkMessage_encodeJsonTemplate(&ctx, &head, templates, &m);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    }
+    clock_t finish = clock();
+    printf("generic json encoding: %f s, precompiled json encoding: %f s\n",
+           (double)(middle - begin) / CLOCKS_PER_SEC,
+           (double)(finish - middle) / CLOCKS_PER_SEC);
+
+    /* A DataSetMessage that does not fit the template */
+    m.payload.dataSetMessages[1].fieldCount = 2;
+    memset(&ctx, 0, sizeof(CtxJson));
+    ctx.pos = buf;
+    ctx.end = buf + sizeof(buf);
+    rv = UA_NetworkMessage_encodeJsonTemplate(&ctx, &head, templates, &m);
+    ck_assert_int_eq(rv, UA_STATUSCODE_BADNOTSUPPORTED);
+    m.payload.dataSetMessages[1].fieldCount = 3;
+
+    UA_DataSetMessageJsonTemplate_clear(&t[0]);
+    UA_DataSetMessageJsonTemplate_clear(&t[1]);
+    UA_String_clear(&head);
+    UA_ByteString_clear(&generic);
+    UA_NetworkMessage_clear(&m);
+}
+END_TEST
+
 static Suite *testSuite_networkmessage(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Json");
     TCase *tc_json_networkmessage = tcase_create("networkmessage_json");
@@ -515,6 +647,7 @@ static Suite *testSuite_networkmessage(void) {
     tcase_add_test(tc_json_networkmessage, UA_Networkmessage_DataSetFieldsNull_json_decode);
     tcase_add_test(tc_json_networkmessage, UA_Networkmessage_metaData_oob);
     tcase_add_test(tc_json_networkmessage, UA_Networkmessage_malformed_array);
+    tcase_add_test(tc_json_networkmessage, UA_Networkmessage_templateEncoding);
 
     suite_add_tcase(s, tc_json_networkmessage);
     return s;
@@ -337,6 +337,44 @@ START_TEST(ReadPublishIntervalAndCompareWithInternalValue){
     UA_Variant_clear(&value);
     } END_TEST
 
+START_TEST(ReadGroupStatisticsAndCompareWithInternalValue){
+    setupBasicPubSubConfiguration();
+    UA_NodeId wgStatisticsId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "Statistics"),
+                                                   UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), writerGroup1);
+    ck_assert(!UA_NodeId_isNull(&wgStatisticsId));
+    UA_NodeId sentId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "SentNetworkMessages"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), wgStatisticsId);
+    UA_Variant value;
+    UA_Variant_init(&value);
+    ck_assert_int_eq(UA_Server_readValue(server, sentId, &value), UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT64]));
+    ck_assert_uint_eq(*(UA_UInt64*)value.data, 0);
+    UA_Variant_clear(&value);
+
+    /* The histogram contains the buckets and has the count as a property */
+    UA_NodeId sendTimeId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "SendTime"),
+                                               UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), wgStatisticsId);
+    ck_assert_int_eq(UA_Server_readValue(server, sendTimeId, &value), UA_STATUSCODE_GOOD);
+    ck_assert(value.type == &UA_TYPES[UA_TYPES_UINT64]);
+    ck_assert_uint_eq(value.arrayLength, UA_PUBSUB_HISTOGRAM_BUCKETS);
+    UA_Variant_clear(&value);
+    UA_NodeId countId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "Count"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_HASPROPERTY), sendTimeId);
+    ck_assert_int_eq(UA_Server_readValue(server, countId, &value), UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT64]));
+    UA_Variant_clear(&value);
+
+    UA_NodeId rgStatisticsId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "Statistics"),
+                                                   UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), readerGroup1);
+    UA_NodeId decodeTimeId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "DecodeTime"),
+                                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), rgStatisticsId);
+    UA_NodeId meanId = findSingleChildNode(server, UA_QUALIFIEDNAME(1, "Mean"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_HASPROPERTY), decodeTimeId);
+    ck_assert_int_eq(UA_Server_readValue(server, meanId, &value), UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_DURATION]));
+    UA_Variant_clear(&value);
+    } END_TEST
+
 START_TEST(WritePublishIntervalAndCompareWithInternalValue){
         setupBasicPubSubConfiguration();
         UA_NodeId publishIntervalId = findSingleChildNode(server, UA_QUALIFIEDNAME(0, "PublishingInterval"),
@@ -529,6 +567,7 @@ int main(void) {
     tcase_add_checked_fixture(tc_add_pubsub_writergroupelements, setup, teardown);
     tcase_add_test(tc_add_pubsub_writergroupelements, ReadPublishIntervalAndCompareWithInternalValue);
     tcase_add_test(tc_add_pubsub_writergroupelements, WritePublishIntervalAndCompareWithInternalValue);
+    tcase_add_test(tc_add_pubsub_writergroupelements, ReadGroupStatisticsAndCompareWithInternalValue);
 
     TCase *tc_add_pubsub_pubsubconnectionelements = tcase_create("PubSub Connection check properties");
     tcase_add_checked_fixture(tc_add_pubsub_pubsubconnectionelements, setup, teardown);
@@ -620,7 +620,7 @@ START_TEST(DeltaFrameFieldCountMatchesChangedFields){
         ck_assert_ptr_nonnull(dsw);
         dsw->config.keyFrameCount = 3;
 
-        retVal = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &keyFrame);
+        retVal = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &keyFrame, NULL);
         ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
         ck_assert_uint_eq(keyFrame.header.dataSetMessageType,
                           UA_DATASETMESSAGE_DATAKEYFRAME);
@@ -641,7 +641,7 @@ START_TEST(DeltaFrameFieldCountMatchesChangedFields){
         psm = getPSM(server);
         dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
         ck_assert_ptr_nonnull(dsw);
-        retVal = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &deltaFrame);
+        retVal = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &deltaFrame, NULL);
         ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
         ck_assert_uint_eq(deltaFrame.header.dataSetMessageType,
                           UA_DATASETMESSAGE_DATADELTAFRAME);
@@ -1056,6 +1056,151 @@ START_TEST(GetWriterGroupStateInvalid) {
     ck_assert_int_eq(r, UA_STATUSCODE_BADNOTFOUND);
 } END_TEST
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+static void
+iterateServer(size_t iterations, UA_UInt32 sleepMs) {
+    for(size_t i = 0; i < iterations; i++) {
+        UA_fakeSleep(sleepMs);
+        UA_Server_run_iterate(server, false);
+    }
+}
+
+static void
+writeInt32(const UA_NodeId nodeId, UA_Int32 value) {
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &value, &UA_TYPES[UA_TYPES_INT32]);
+    ck_assert_int_eq(UA_Server_writeValue(server, nodeId, v), UA_STATUSCODE_GOOD);
+}
+
+START_TEST(PublishOnValueChange) {
+    /* The published variable */
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 initial = 0;
+    UA_Variant_setScalar(&attr.value, &initial, &UA_TYPES[UA_TYPES_INT32]);
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_NodeId varId = UA_NODEID_STRING(1, "PublishOnValueChange");
+    ck_assert_int_eq(UA_Server_addVariableNode(server, varId,
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                         UA_QUALIFIEDNAME(1, "Value"),
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                         attr, NULL, NULL), UA_STATUSCODE_GOOD);
+
+    setupPublishedDataSetTestEnvironment();
+    UA_DataSetFieldConfig dataSetFieldConfig;
+    memset(&dataSetFieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+    dataSetFieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+    dataSetFieldConfig.field.variable.fieldNameAlias = UA_STRING("Value");
+    dataSetFieldConfig.field.variable.publishParameters.publishedVariable = varId;
+    dataSetFieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+    ck_assert_int_eq(UA_Server_addDataSetField(server, publishedDataSet1,
+                                               &dataSetFieldConfig, NULL).result,
+                     UA_STATUSCODE_GOOD);
+
+    /* Minimum interval 10ms, keep-alive after 1s */
+    UA_WriterGroupConfig writerGroupConfig;
+    memset(&writerGroupConfig, 0, sizeof(writerGroupConfig));
+    writerGroupConfig.name = UA_STRING("WriterGroup 1");
+    writerGroupConfig.publishingInterval = 10;
+    writerGroupConfig.keepAliveTime = 1000;
+    writerGroupConfig.publishOnValueChange = true;
+    ck_assert_int_eq(UA_Server_addWriterGroup(server, connection1, &writerGroupConfig,
+                                              &writerGroup1), UA_STATUSCODE_GOOD);
+    UA_DataSetWriterConfig dataSetWriterConfig;
+    memset(&dataSetWriterConfig, 0, sizeof(dataSetWriterConfig));
+    dataSetWriterConfig.name = UA_STRING("DataSetWriter 1");
+    ck_assert_int_eq(UA_Server_addDataSetWriter(server, writerGroup1, publishedDataSet1,
+                                                &dataSetWriterConfig, &dataSetWriter1),
+                     UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_Server_enableAllPubSubComponents(server), UA_STATUSCODE_GOOD);
+
+    UA_PubSubManager *psm = getPSM(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup1);
+    ck_assert(wg != NULL);
+    ck_assert_uint_eq(wg->valueChangeItemsSize, 1);
+
+    /* The initial sample is published right away */
+    iterateServer(3, 1);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 1);
+
+    /* No change, no publish */
+    iterateServer(5, 100);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 1);
+
+    /* A change is published right away */
+    writeInt32(varId, 1);
+    iterateServer(3, 1);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 2);
+
+    /* Changes within the publishingInterval are coalesced */
+    writeInt32(varId, 2);
+    iterateServer(1, 0);
+    writeInt32(varId, 3);
+    iterateServer(1, 0);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 2);
+    iterateServer(3, 10);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 3);
+
+    /* Writing the same value is no change */
+    writeInt32(varId, 3);
+    iterateServer(3, 10);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 3);
+
+    /* Keep-alive after the keepAliveTime without changes */
+    iterateServer(1, 1000);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, 4);
+
+    /* Add a field while the DataSetWriter is disabled and the WriterGroup
+     * remains operational. The new field is monitored right away. */
+    UA_NodeId var2Id = UA_NODEID_STRING(1, "PublishOnValueChange2");
+    ck_assert_int_eq(UA_Server_addVariableNode(server, var2Id,
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                         UA_QUALIFIEDNAME(1, "Value2"),
+                         UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                         attr, NULL, NULL), UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_Server_disableDataSetWriter(server, dataSetWriter1),
+                     UA_STATUSCODE_GOOD);
+    UA_NodeId field2;
+    dataSetFieldConfig.field.variable.fieldNameAlias = UA_STRING("Value2");
+    dataSetFieldConfig.field.variable.publishParameters.publishedVariable = var2Id;
+    ck_assert_int_eq(UA_Server_addDataSetField(server, publishedDataSet1,
+                                               &dataSetFieldConfig, &field2).result,
+                     UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(wg->valueChangeItemsSize, 2);
+    ck_assert_int_eq(UA_Server_enableDataSetWriter(server, dataSetWriter1),
+                     UA_STATUSCODE_GOOD);
+    iterateServer(3, 10); /* Publish the initial sample of the new field */
+    UA_UInt64 sent = wg->stats.sentNetworkMessages;
+    writeInt32(var2Id, 1);
+    iterateServer(3, 10);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, sent + 1);
+
+    /* Removing the field removes its MonitoredItem */
+    ck_assert_int_eq(UA_Server_disableDataSetWriter(server, dataSetWriter1),
+                     UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_Server_removeDataSetField(server, field2).result,
+                     UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(wg->valueChangeItemsSize, 1);
+    ck_assert_int_eq(UA_Server_enableDataSetWriter(server, dataSetWriter1),
+                     UA_STATUSCODE_GOOD);
+    iterateServer(3, 10);
+    sent = wg->stats.sentNetworkMessages;
+    writeInt32(var2Id, 2);
+    iterateServer(3, 10);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, sent);
+
+    /* Disabling removes the MonitoredItems */
+    ck_assert_int_eq(UA_Server_disableWriterGroup(server, writerGroup1),
+                     UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(wg->valueChangeItemsSize, 0);
+    sent = wg->stats.sentNetworkMessages;
+    writeInt32(varId, 4);
+    iterateServer(3, 10);
+    ck_assert_uint_eq(wg->stats.sentNetworkMessages, sent);
+} END_TEST
+#endif
+
 START_TEST(TriggerWriterGroupPublishOnDisabledGroup) {
     UA_NodeId wgId;
     UA_WriterGroupConfig wgc;
@@ -1132,6 +1277,9 @@ int main(void) {
     tcase_add_test(tc_pubsub_publish, SinglePublishDataSetFieldAndPublishTimestampTest);
     tcase_add_test(tc_pubsub_publish, PublishDataSetFieldAsDeltaFrame);
     tcase_add_test(tc_pubsub_publish, DeltaFrameFieldCountMatchesChangedFields);
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    tcase_add_test(tc_pubsub_publish, PublishOnValueChange);
+#endif
 
     TCase *tc_pubsub_datasetordering = tcase_create("PubSub DataSetOrdering (OPC UA Part 14)");
     tcase_add_checked_fixture(tc_pubsub_datasetordering, setup, teardown);
@@ -118,6 +118,23 @@ START_TEST(SinglePublishDataSetField){
     retVal = UA_Server_WriterGroup_getState(server, writerGroup1, &state);
     ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
     ck_assert_int_eq(state, UA_PUBSUBSTATE_OPERATIONAL);
+
+    /* The JSON templates were compiled in the operational state */
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
+    ck_assert(dsw != NULL);
+    ck_assert(wg->jsonHeader.data != NULL);
+    ck_assert(dsw->jsonTemplate.head.data != NULL);
+    ck_assert_uint_eq(dsw->jsonTemplate.fieldKeysSize, 1);
+
+    /* Publish again with the templates */
+    UA_WriterGroup_publishCallback(psm, wg);
+    ck_assert_uint_ge(wg->stats.sentNetworkMessages, 2);
+
+    /* Disabling the WriterGroup resets the templates */
+    retVal = UA_Server_disableWriterGroup(server, writerGroup1);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    ck_assert(wg->jsonHeader.data == NULL);
+    ck_assert(dsw->jsonTemplate.head.data == NULL);
 } END_TEST
 
 int main(void) {
@@ -1892,6 +1892,124 @@ START_TEST(Test_multiple_datasets) {
 } END_TEST
 
 
+/***************************************************************************************************/
+static void *
+countIndexEntries(void *context, UA_DataSetReader *dsr) {
+    (*(size_t*)context)++;
+    return NULL;
+}
+
+static size_t
+readerIndexSize(UA_NodeId connectionId) {
+    size_t count = 0;
+    lockServer(server);
+    UA_PubSubConnection *c = UA_PubSubConnection_find(getPSM(server), connectionId);
+    ck_assert(c != NULL);
+    ZIP_ITER(UA_DataSetReaderIndex, &c->readerIndex, countIndexEntries, &count);
+    unlockServer(server);
+    return count;
+}
+
+static UA_Int32
+readInt32(UA_NodeId nodeId) {
+    UA_Variant v;
+    UA_Variant_init(&v);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_readValue(server, nodeId, &v));
+    UA_Int32 res = *(UA_Int32*)v.data;
+    UA_Variant_clear(&v);
+    return res;
+}
+
+/* Many readers in the same ReaderGroup are routed via the reader index of the
+ * connection. Decoy readers differ in only one part of the identifier and must
+ * not receive anything. */
+START_TEST(Test_reader_index) {
+#define READER_INDEX_WRITERS 8
+    UA_PublisherId publisherId;
+    publisherId.idType = UA_PUBLISHERIDTYPE_STRING;
+    publisherId.id.string = UA_STRING("Publisher");
+    UA_PublisherId otherPublisherId;
+    otherPublisherId.idType = UA_PUBLISHERIDTYPE_STRING;
+    otherPublisherId.id.string = UA_STRING("Publishes");
+
+    UA_NodeId connId;
+    AddConnection("Conn1", publisherId, &connId);
+    UA_NodeId wgId;
+    AddWriterGroup(&connId, "WG1", 1, &wgId);
+
+    UA_NodeId pdsIds[READER_INDEX_WRITERS];
+    UA_NodeId dswIds[READER_INDEX_WRITERS];
+    UA_NodeId publisherVarIds[READER_INDEX_WRITERS];
+    UA_NodeId subscriberVarIds[READER_INDEX_WRITERS];
+    UA_DataValue *fastPathValues[READER_INDEX_WRITERS] = {0};
+    for(UA_UInt32 i = 0; i < READER_INDEX_WRITERS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "PDS%u", (unsigned)i);
+        AddPublishedDataSet(&wgId, name, name, i + 1, &pdsIds[i],
+                            &publisherVarIds[i], &fastPathValues[i], &dswIds[i]);
+    }
+
+    /* Add the readers in reverse order with decoys in between */
+    UA_NodeId rgId;
+    AddReaderGroup(&connId, "RG1", &rgId);
+    UA_NodeId dsrIds[READER_INDEX_WRITERS];
+    UA_NodeId decoyVarIds[2 * READER_INDEX_WRITERS];
+    UA_NodeId decoyDsrId;
+    for(UA_UInt32 i = READER_INDEX_WRITERS; i > 0; i--) {
+        AddDataSetReader(&rgId, "DSR", publisherId, 1, i,
+                         &subscriberVarIds[i-1], &fastPathValues[i-1], &dsrIds[i-1]);
+        AddDataSetReader(&rgId, "DecoyWG", publisherId, 2, i,
+                         &decoyVarIds[2*(i-1)], &fastPathValues[i-1], &decoyDsrId);
+        AddDataSetReader(&rgId, "DecoyPub", otherPublisherId, 1, i,
+                         &decoyVarIds[2*(i-1)+1], &fastPathValues[i-1], &decoyDsrId);
+    }
+
+    /* A second ReaderGroup with a reader for the same DataSetMessage */
+    UA_NodeId rg2Id;
+    AddReaderGroup(&connId, "RG2", &rg2Id);
+    UA_NodeId secondVarId;
+    UA_NodeId secondDsrId;
+    AddDataSetReader(&rg2Id, "DSR2", publisherId, 1, 3,
+                     &secondVarId, &fastPathValues[0], &secondDsrId);
+    ck_assert_uint_eq(readerIndexSize(connId), 3 * READER_INDEX_WRITERS + 1);
+
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_enableAllPubSubComponents(server));
+    ValidatePublishSubscribe(READER_INDEX_WRITERS, publisherVarIds, subscriberVarIds,
+                             fastPathValues, fastPathValues, 10, 100);
+    ck_assert_int_eq(readInt32(secondVarId), 12);
+    for(size_t i = 0; i < 2 * READER_INDEX_WRITERS; i++)
+        ck_assert_int_eq(readInt32(decoyVarIds[i]), 0);
+
+    /* Re-key a reader by updating its config. It now receives from DSW 5. */
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_disableDataSetReader(server, secondDsrId));
+    UA_DataSetReaderConfig config;
+    ck_assert_int_eq(UA_STATUSCODE_GOOD,
+                     UA_Server_getDataSetReaderConfig(server, secondDsrId, &config));
+    config.dataSetWriterId = 5;
+    ck_assert_int_eq(UA_STATUSCODE_GOOD,
+                     UA_Server_updateDataSetReaderConfig(server, secondDsrId, &config));
+    UA_DataSetReaderConfig_clear(&config);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_enableDataSetReader(server, secondDsrId));
+    ck_assert_uint_eq(readerIndexSize(connId), 3 * READER_INDEX_WRITERS + 1);
+    ValidatePublishSubscribe(READER_INDEX_WRITERS, publisherVarIds, subscriberVarIds,
+                             fastPathValues, fastPathValues, 20, 100);
+    ck_assert_int_eq(readInt32(secondVarId), 24);
+
+    /* Removing the readers cleans up the index */
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_disableReaderGroup(server, rg2Id));
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_removeDataSetReader(server, secondDsrId));
+    ck_assert_uint_eq(readerIndexSize(connId), 3 * READER_INDEX_WRITERS);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_disableReaderGroup(server, rgId));
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_removeReaderGroup(server, rgId));
+    ck_assert_uint_eq(readerIndexSize(connId), 0);
+
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_disableWriterGroup(server, wgId));
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_removePubSubConnection(server, connId));
+    for(size_t i = 0; i < READER_INDEX_WRITERS; i++)
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_removePublishedDataSet(server, pdsIds[i]));
+    UA_Server_run_iterate(server, false);
+} END_TEST
+
 /***************************************************************************************************/
 int main(void) {
 
@@ -1951,6 +2069,14 @@ int main(void) {
     */
     tcase_add_test(tc_basic, Test_multiple_datasets);
 
+    /* test case description:
+        - setup many DataSetReaders in one connection, including decoys that
+          differ only in the WriterGroupId or the PublisherId
+        - check that the reader index routes every DataSetMessage to its readers
+        - check that the index is updated on reader config changes and removal
+    */
+    tcase_add_test(tc_basic, Test_reader_index);
+
     Suite *s = suite_create("PubSub publisherId tests");
     suite_add_tcase(s, tc_basic);
 
@@ -21,6 +21,8 @@
 
 UA_Server *server = NULL;
 UA_NodeId connection1, writerGroup1, publishedDataSet1, dataSetWriter1;
+UA_NodeId variable1;
+UA_Boolean fastPath = false;
 
 static void setup(void) {
     server = UA_Server_newForUnitTest();
@@ -43,6 +45,17 @@ static void setup(void) {
     writerGroupConfig.name = UA_STRING("WriterGroup 1");
     writerGroupConfig.publishingInterval = 10;
     writerGroupConfig.encodingMimeType = UA_PUBSUB_ENCODING_UADP;
+    writerGroupConfig.fastPath = fastPath;
+    UA_UadpWriterGroupMessageDataType writerGroupMessage;
+    UA_UadpWriterGroupMessageDataType_init(&writerGroupMessage);
+    writerGroupMessage.networkMessageContentMask = (UA_UadpNetworkMessageContentMask)
+        (UA_UADPNETWORKMESSAGECONTENTMASK_PUBLISHERID |
+         UA_UADPNETWORKMESSAGECONTENTMASK_GROUPHEADER |
+         UA_UADPNETWORKMESSAGECONTENTMASK_WRITERGROUPID |
+         UA_UADPNETWORKMESSAGECONTENTMASK_SEQUENCENUMBER |
+         UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER);
+    UA_ExtensionObject_setValue(&writerGroupConfig.messageSettings, &writerGroupMessage,
+                                &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE]);
     retval |= UA_Server_addWriterGroup(server, connection1, &writerGroupConfig, &writerGroup1);
     retval |= UA_Server_enableWriterGroup(server, writerGroup1);
 
@@ -52,11 +65,83 @@ static void setup(void) {
     pdsConfig.name = UA_STRING("PublishedDataSet 1");
     retval |= UA_Server_addPublishedDataSet(server, &pdsConfig, &publishedDataSet1).addResult;
     ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    variable1 = UA_NODEID_STRING(1, "Variable 1");
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 value = 0;
+    UA_Variant_setScalar(&attr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    retval = UA_Server_addVariableNode(server, variable1,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                       UA_QUALIFIEDNAME(1, "Variable 1"),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                       attr, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void setupFastPath(void) {
+    fastPath = true;
+    setup();
 }
 
 static void teardown(void) {
     UA_Server_run_shutdown(server);
     UA_Server_delete(server);
+    fastPath = false;
+}
+
+static void
+addDataSetField(const UA_NodeId variable) {
+    UA_DataSetFieldConfig dataSetFieldConfig;
+    memset(&dataSetFieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+    dataSetFieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+    dataSetFieldConfig.field.variable.fieldNameAlias = UA_STRING("Field");
+    dataSetFieldConfig.field.variable.publishParameters.publishedVariable = variable;
+    dataSetFieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_StatusCode retval =
+        UA_Server_addDataSetField(server, publishedDataSet1, &dataSetFieldConfig, NULL).result;
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void
+addDataSetWriter(UA_DataSetFieldContentMask fieldContentMask) {
+    /* Writers can only be added to a disabled WriterGroup */
+    UA_StatusCode retval = UA_Server_disableWriterGroup(server, writerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DataSetWriterConfig dataSetWriterConfig;
+    memset(&dataSetWriterConfig, 0, sizeof(UA_DataSetWriterConfig));
+    dataSetWriterConfig.name = UA_STRING("DataSetWriter 1");
+    dataSetWriterConfig.dataSetWriterId = 62541;
+    dataSetWriterConfig.keyFrameCount = 10;
+    dataSetWriterConfig.dataSetFieldContentMask = fieldContentMask;
+    UA_UadpDataSetWriterMessageDataType dataSetWriterMessage;
+    UA_UadpDataSetWriterMessageDataType_init(&dataSetWriterMessage);
+    dataSetWriterMessage.dataSetMessageContentMask = (UA_UadpDataSetMessageContentMask)
+        (UA_UADPDATASETMESSAGECONTENTMASK_SEQUENCENUMBER |
+         UA_UADPDATASETMESSAGECONTENTMASK_TIMESTAMP);
+    UA_ExtensionObject_setValue(&dataSetWriterConfig.messageSettings, &dataSetWriterMessage,
+                                &UA_TYPES[UA_TYPES_UADPDATASETWRITERMESSAGEDATATYPE]);
+    retval = UA_Server_addDataSetWriter(server, writerGroup1, publishedDataSet1,
+                                        &dataSetWriterConfig, &dataSetWriter1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void
+publishAndMeasure(UA_PubSubManager *psm, UA_WriterGroup *wg) {
+    printf("start sending 8000 publish messages via UDP%s\n",
+           wg->config.fastPath ? " (fast path)" : "");
+
+    clock_t begin, finish;
+    begin = clock();
+
+    for(int i = 0; i < 8000; i++) {
+        UA_WriterGroup_publishCallback(psm, wg);
+    }
+
+    finish = clock();
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    printf("duration was %f s\n", time_spent);
 }
 
 START_TEST(PublishSpeedTest) {
@@ -75,28 +160,120 @@ START_TEST(PublishSpeedTest) {
     UA_PubSubManager *psm = getPSM(server);
     UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup1);
 
-    printf("start sending 8000 publish messages via UDP\n");
+    publishAndMeasure(psm, wg);
+} END_TEST
 
-    clock_t begin, finish;
-    begin = clock();
+START_TEST(PublishSpeedTestWriter) {
+    addDataSetField(variable1);
+    addDataSetWriter(UA_DATASETFIELDCONTENTMASK_RAWDATA);
+    UA_StatusCode retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
 
-    for(int i = 0; i < 8000; i++) {
+    UA_PubSubManager *psm = getPSM(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup1);
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
+    UA_UInt16 sequenceNumber = wg->sequenceNumber;
+    UA_UInt16 dsmSequenceNumber = dsw->actualDataSetMessageSequenceCount;
+
+    publishAndMeasure(psm, wg);
+
+    /* The fast path uses the templates after the first cycle */
+    ck_assert(wg->templatesValid == wg->config.fastPath);
+    ck_assert_uint_eq((UA_UInt16)(wg->sequenceNumber - sequenceNumber), 8000);
+    ck_assert_uint_eq((UA_UInt16)(dsw->actualDataSetMessageSequenceCount -
+                                  dsmSequenceNumber), 8000);
+} END_TEST
+
+static void
+checkTemplate(UA_WriterGroup *wg, const UA_Variant *expected) {
+    ck_assert(wg->templatesValid);
+    ck_assert_uint_eq(wg->templatesSize, 1);
+
+    UA_NetworkMessage nm;
+    UA_StatusCode retval =
+        UA_NetworkMessage_decodeBinary(&wg->templates[0].buffer, &nm, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(nm.messageCount, 1);
+    ck_assert_uint_eq(nm.groupHeader.sequenceNumber, (UA_UInt16)(wg->sequenceNumber - 1));
+    UA_DataSetMessage *dsm = &nm.payload.dataSetMessages[0];
+    ck_assert_uint_eq(dsm->fieldCount, 1);
+    ck_assert(UA_order(&dsm->data.keyFrameFields[0].value, expected,
+                       &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+    UA_NetworkMessage_clear(&nm);
+}
+
+START_TEST(FastPathUpdateInPlace) {
+    addDataSetField(variable1);
+    addDataSetWriter(UA_DATASETFIELDCONTENTMASK_NONE);
+    UA_StatusCode retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_PubSubManager *psm = getPSM(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup1);
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
+
+    /* Record the template */
+    UA_WriterGroup_publishCallback(psm, wg);
+    ck_assert(wg->templatesValid);
+    UA_Byte *templateBuffer = wg->templates[0].buffer.data;
+
+    /* The value and the sequence numbers are updated in place */
+    UA_Variant value;
+    for(UA_Int32 i = 1; i < 10; i++) {
+        UA_Variant_setScalar(&value, &i, &UA_TYPES[UA_TYPES_INT32]);
+        retval = UA_Server_writeValue(server, variable1, value);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        UA_UInt16 dsmSequenceNumber = dsw->actualDataSetMessageSequenceCount;
         UA_WriterGroup_publishCallback(psm, wg);
+        ck_assert_uint_eq(dsw->actualDataSetMessageSequenceCount,
+                          (UA_UInt16)(dsmSequenceNumber + 1));
+        ck_assert_ptr_eq(wg->templates[0].buffer.data, templateBuffer);
+        checkTemplate(wg, &value);
     }
+} END_TEST
 
-    finish = clock();
-    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
-    printf("duration was %f s\n", time_spent);
+START_TEST(FastPathSizeChange) {
+    UA_String str = UA_STRING("abc");
+    UA_Variant value;
+    UA_Variant_setScalar(&value, &str, &UA_TYPES[UA_TYPES_STRING]);
+    UA_StatusCode retval = UA_Server_writeValue(server, variable1, value);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
 
+    addDataSetField(variable1);
+    addDataSetWriter(UA_DATASETFIELDCONTENTMASK_NONE);
+    retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_PubSubManager *psm = getPSM(server);
+    UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup1);
+    UA_WriterGroup_publishCallback(psm, wg);
+    checkTemplate(wg, &value);
+    size_t length = wg->templates[0].buffer.length;
+
+    /* The longer string does not fit. The template is recorded again. */
+    str = UA_STRING("abcdef");
+    retval = UA_Server_writeValue(server, variable1, value);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_WriterGroup_publishCallback(psm, wg);
+    checkTemplate(wg, &value);
+    ck_assert_uint_eq(wg->templates[0].buffer.length, length + 3);
 } END_TEST
 
 int main(void) {
     TCase *tc_publishspeed = tcase_create("Speed of the publisher");
     tcase_add_checked_fixture(tc_publishspeed, setup, teardown);
     tcase_add_test(tc_publishspeed, PublishSpeedTest);
+    tcase_add_test(tc_publishspeed, PublishSpeedTestWriter);
+
+    TCase *tc_fastpath = tcase_create("Speed of the publisher with the fast path");
+    tcase_add_checked_fixture(tc_fastpath, setupFastPath, teardown);
+    tcase_add_test(tc_fastpath, PublishSpeedTestWriter);
+    tcase_add_test(tc_fastpath, FastPathUpdateInPlace);
+    tcase_add_test(tc_fastpath, FastPathSizeChange);
 
     Suite *s = suite_create("PubSub Speed Test");
     suite_add_tcase(s, tc_publishspeed);
+    suite_add_tcase(s, tc_fastpath);
 
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
@@ -8,6 +8,7 @@
 
 #include <open62541/server_config_default.h>
 #include <open62541/server_pubsub.h>
+#include <open62541/client_subscriptions.h>
 #include <check.h>
 #include <time.h>
 #include <stdlib.h>
@@ -35,6 +36,38 @@
 #define VALID_DATASETMESSAGE_SIZE 128    /* Valid DataSetMessage configuredSize */
 #define INVALID_DATASETMESSAGE_SIZE 1    /* Invalid DataSetMessage configuredSize */
 
+#ifdef UA_TEST_COUNT_ALLOCATIONS
+/* The test is linked with --wrap for the heap functions. This counts all heap
+ * allocations of the library while countAllocations is set. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+static UA_Boolean countAllocations = false;
+static size_t allocations = 0;
+
+void *__wrap_malloc(size_t size) {
+    if(countAllocations)
+        allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+    if(countAllocations)
+        allocations++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    if(countAllocations)
+        allocations++;
+    return __real_realloc(ptr, size);
+}
+#endif
+
 /* Global declaration for test cases  */
 UA_Server *server = NULL;
 UA_ServerConfig *config = NULL;
@@ -779,6 +812,9 @@ START_TEST(SinglePublishSubscribeInt32) {
         UA_NodeId writerGroup;
         UA_DataSetReaderConfig readerConfig;
 
+        /* Store the last samples for the delta frames between the key frames */
+        config->pubSubConfig.enableDeltaFrames = true;
+
         /* Published DataSet */
         memset(&pdsConfig, 0, sizeof(UA_PublishedDataSetConfig));
         pdsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
@@ -858,6 +894,7 @@ START_TEST(SinglePublishSubscribeInt32) {
         readerConfig.publisherId.id.uint16 = publisherIdentifier;
         readerConfig.writerGroupId    = WRITER_GROUP_ID;
         readerConfig.dataSetWriterId  = DATASET_WRITER_ID;
+        readerConfig.directValueWrite = true;
         /* Setting up Meta data configuration in DataSetReader */
         UA_DataSetMetaDataType *pMetaData = &readerConfig.dataSetMetaData;
         /* FilltestMetadata function in subscriber implementation */
@@ -885,6 +922,7 @@ START_TEST(SinglePublishSubscribeInt32) {
         vAttr.description = UA_LOCALIZEDTEXT ("en-US", "Subscribed Int32");
         vAttr.displayName = UA_LOCALIZEDTEXT ("en-US", "Subscribed Int32");
         vAttr.dataType    = UA_TYPES[UA_TYPES_INT32].typeId;
+        vAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
         retVal = UA_Server_addVariableNode(
             server, UA_NODEID_NUMERIC(1, SUBSCRIBEVARIABLE_NODEID), folderId,
             UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
@@ -912,6 +950,456 @@ START_TEST(SinglePublishSubscribeInt32) {
         UA_fakeSleep(PUBLISH_INTERVAL + 1);
         UA_Server_run_iterate(server,true);
         checkReceived();
+
+        /* The arenas have grown in the first cycles. Afterwards the publish
+         * and receive cycles don't allocate from the heap. The delta frames
+         * update the last samples and the received values are written to the
+         * target in place. */
+        lockServer(server);
+        UA_PubSubManager *psm = getPSM(server);
+        UA_WriterGroup *wg = UA_WriterGroup_find(psm, writerGroup);
+        UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroupId);
+        ck_assert(wg->arena.blockSize > 0);
+        ck_assert(rg->arena.blockSize > 0);
+        UA_UInt64 wgAllocs = wg->arena.heapAllocations;
+        UA_UInt64 rgAllocs = rg->arena.heapAllocations;
+        unlockServer(server);
+
+        for(size_t i = 0; i < 10; i++) {
+            publisherData++;
+            UA_Variant value;
+            UA_Variant_setScalar(&value, &publisherData, &UA_TYPES[UA_TYPES_INT32]);
+            retVal = UA_Server_writeValue(server, publisherNode, value);
+            ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+            UA_fakeSleep(PUBLISH_INTERVAL + 1);
+#ifdef UA_TEST_COUNT_ALLOCATIONS
+            countAllocations = true;
+#endif
+            UA_Server_run_iterate(server, true);
+#ifdef UA_TEST_COUNT_ALLOCATIONS
+            countAllocations = false;
+#endif
+        }
+        checkReceived();
+#ifdef UA_TEST_COUNT_ALLOCATIONS
+        ck_assert_uint_eq(allocations, 0);
+#endif
+
+        lockServer(server);
+        ck_assert_uint_eq(wg->arena.heapAllocations, wgAllocs);
+        ck_assert_uint_eq(rg->arena.heapAllocations, rgAllocs);
+        ck_assert_uint_eq(wg->arena.blockUsed, 0);
+        ck_assert_uint_eq(rg->arena.blockUsed, 0);
+        unlockServer(server);
+
+        /* Every cycle is recorded in the statistics */
+        UA_WriterGroupStatistics wgStats;
+        retVal = UA_Server_getWriterGroupStatistics(server, writerGroup, &wgStats);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        ck_assert_uint_ge(wgStats.sentNetworkMessages, 10);
+        ck_assert_uint_eq(wgStats.failedNetworkMessages, 0);
+        ck_assert_uint_eq(wgStats.encodeTime.count, wgStats.sendTime.count);
+        ck_assert_uint_ge(wgStats.encodeTime.count, 10);
+        ck_assert_uint_ge(wgStats.schedulingLateness.count, 10);
+        UA_UInt64 bucketSum = 0;
+        for(size_t i = 0; i < UA_PUBSUB_HISTOGRAM_BUCKETS; i++)
+            bucketSum += wgStats.schedulingLateness.buckets[i];
+        ck_assert_uint_eq(bucketSum, wgStats.schedulingLateness.count);
+        ck_assert_int_le(wgStats.schedulingLateness.min,
+                         wgStats.schedulingLateness.max);
+
+        UA_ReaderGroupStatistics rgStats;
+        retVal = UA_Server_getReaderGroupStatistics(server, readerGroupId, &rgStats);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        ck_assert_uint_ge(rgStats.receivedNetworkMessages, 10);
+        ck_assert_uint_eq(rgStats.droppedNetworkMessages, 0);
+        ck_assert_uint_eq(rgStats.decodeTime.count, rgStats.receivedNetworkMessages);
+        ck_assert_uint_eq(rgStats.processTime.count, rgStats.receivedNetworkMessages);
+
+        retVal = UA_Server_resetReaderGroupStatistics(server, readerGroupId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        retVal = UA_Server_getReaderGroupStatistics(server, readerGroupId, &rgStats);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(rgStats.receivedNetworkMessages, 0);
+        ck_assert_uint_eq(rgStats.decodeTime.count, 0);
+} END_TEST
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+static UA_UInt32 directWriteNotifications = 0;
+static UA_Int32 directWriteLastValue = 0;
+
+static void
+directWriteDataChange(UA_Server *s, UA_UInt32 monId, void *monContext,
+                      const UA_NodeId *nodeId, void *nodeContext,
+                      UA_UInt32 attributeId, const UA_DataValue *value) {
+    directWriteNotifications++;
+    if(value->hasValue && value->value.type == &UA_TYPES[UA_TYPES_INT32])
+        directWriteLastValue = *(UA_Int32*)value->value.data;
+}
+#endif
+
+/* The received fields are written directly into the target variables */
+START_TEST(SinglePublishSubscribeDirectWrite) {
+        /* Published DataSet with an Int32 field */
+        UA_PublishedDataSetConfig pdsConfig;
+        memset(&pdsConfig, 0, sizeof(UA_PublishedDataSetConfig));
+        pdsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
+        pdsConfig.name = UA_STRING("PublishedDataSet Test");
+        UA_StatusCode retVal =
+            UA_Server_addPublishedDataSet(server, &pdsConfig, &publishedDataSetId).addResult;
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_NodeId publisherNode;
+        UA_VariableAttributes attr = UA_VariableAttributes_default;
+        attr.displayName = UA_LOCALIZEDTEXT("en-US","Published Int32");
+        attr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+        UA_Int32 publisherData = 42;
+        UA_Variant_setScalar(&attr.value, &publisherData, &UA_TYPES[UA_TYPES_INT32]);
+        retVal = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, PUBLISHVARIABLE_NODEID),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                           UA_QUALIFIEDNAME(1, "Published Int32"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                           attr, NULL, &publisherNode);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_DataSetFieldConfig dataSetFieldConfig;
+        memset(&dataSetFieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+        dataSetFieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+        dataSetFieldConfig.field.variable.fieldNameAlias = UA_STRING("Published Int32");
+        dataSetFieldConfig.field.variable.publishParameters.publishedVariable = publisherNode;
+        dataSetFieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+        retVal = UA_Server_addDataSetField(server, publishedDataSetId,
+                                           &dataSetFieldConfig, NULL).result;
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_WriterGroupConfig writerGroupConfig;
+        memset(&writerGroupConfig, 0, sizeof(writerGroupConfig));
+        writerGroupConfig.name = UA_STRING("WriterGroup Test");
+        writerGroupConfig.publishingInterval = PUBLISH_INTERVAL;
+        writerGroupConfig.writerGroupId = WRITER_GROUP_ID;
+        writerGroupConfig.encodingMimeType = UA_PUBSUB_ENCODING_UADP;
+        writerGroupConfig.messageSettings.encoding = UA_EXTENSIONOBJECT_DECODED;
+        writerGroupConfig.messageSettings.content.decoded.type =
+            &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE];
+        UA_UadpWriterGroupMessageDataType *writerGroupMessage =
+            UA_UadpWriterGroupMessageDataType_new();
+        writerGroupMessage->networkMessageContentMask =
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PUBLISHERID |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_GROUPHEADER |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_WRITERGROUPID |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER;
+        writerGroupConfig.messageSettings.content.decoded.data = writerGroupMessage;
+        UA_NodeId writerGroup;
+        retVal = UA_Server_addWriterGroup(server, connectionId, &writerGroupConfig, &writerGroup);
+        UA_UadpWriterGroupMessageDataType_delete(writerGroupMessage);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_DataSetWriterConfig dataSetWriterConfig;
+        memset(&dataSetWriterConfig, 0, sizeof(dataSetWriterConfig));
+        dataSetWriterConfig.name = UA_STRING("DataSetWriter Test");
+        dataSetWriterConfig.dataSetWriterId = DATASET_WRITER_ID;
+        dataSetWriterConfig.keyFrameCount = 10;
+        retVal = UA_Server_addDataSetWriter(server, writerGroup, publishedDataSetId,
+                                            &dataSetWriterConfig, NULL);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* ReaderGroup and DataSetReader in the direct write mode */
+        UA_ReaderGroupConfig readerGroupConfig;
+        memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+        readerGroupConfig.name = UA_STRING("ReaderGroup Test");
+        retVal = UA_Server_addReaderGroup(server, connectionId, &readerGroupConfig, &readerGroupId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_DataSetReaderConfig readerConfig;
+        memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+        readerConfig.name = UA_STRING("DataSetReader Test");
+        readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+        readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+        readerConfig.writerGroupId = WRITER_GROUP_ID;
+        readerConfig.dataSetWriterId = DATASET_WRITER_ID;
+        readerConfig.directValueWrite = true;
+        UA_FieldMetaData fields[2];
+        UA_FieldMetaData_init(&fields[0]);
+        fields[0].dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+        fields[0].builtInType = UA_NS0ID_INT32;
+        fields[0].valueRank = -1; /* scalar */
+        readerConfig.dataSetMetaData.fieldsSize = 1;
+        readerConfig.dataSetMetaData.fields = fields;
+        UA_NodeId readerIdentifier;
+        retVal = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                            &readerIdentifier);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* A second reader for the same DataSet with a target of another type */
+        UA_NodeId mismatchReader;
+        retVal = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                            &mismatchReader);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* A third reader with a target that is not writable */
+        UA_NodeId readOnlyReader;
+        retVal = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                            &readOnlyReader);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_NodeId newnodeId;
+        UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+        vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Subscribed Int32");
+        vAttr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+        vAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+        retVal = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, SUBSCRIBEVARIABLE_NODEID),
+                                           folderId, UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                           UA_QUALIFIEDNAME(1, "Subscribed Int32"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                           vAttr, NULL, &newnodeId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_NodeId readOnlyNodeId;
+        vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Read-only Int32");
+        vAttr.accessLevel = UA_ACCESSLEVELMASK_READ;
+        retVal = UA_Server_addVariableNode(server, UA_NODEID_NULL, folderId,
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                           UA_QUALIFIEDNAME(1, "Read-only Int32"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                           vAttr, NULL, &readOnlyNodeId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_FieldTargetDataType targetVar;
+        UA_FieldTargetDataType_init(&targetVar);
+        targetVar.attributeId = UA_ATTRIBUTEID_VALUE;
+        targetVar.targetNodeId = newnodeId;
+        retVal = UA_Server_DataSetReader_createTargetVariables(server, readerIdentifier,
+                                                               1, &targetVar);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        targetVar.targetNodeId = nodeId32;
+        retVal = UA_Server_DataSetReader_createTargetVariables(server, mismatchReader,
+                                                               1, &targetVar);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        targetVar.targetNodeId = readOnlyNodeId;
+        retVal = UA_Server_DataSetReader_createTargetVariables(server, readOnlyReader,
+                                                               1, &targetVar);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+        /* MonitoredItem without sampling interval on the target */
+        directWriteNotifications = 0;
+        UA_ServerConfig *config = UA_Server_getConfig(server);
+        config->samplingIntervalLimits.min = 0.0;
+        UA_MonitoredItemCreateRequest item = UA_MonitoredItemCreateRequest_default(newnodeId);
+        item.requestedParameters.samplingInterval = 0.0;
+        UA_MonitoredItemCreateResult mon =
+            UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_NEITHER,
+                                                    item, NULL, directWriteDataChange);
+        ck_assert_int_eq(mon.statusCode, UA_STATUSCODE_GOOD);
+#endif
+
+        /* The targets are resolved when the readers are enabled */
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_enableAllPubSubComponents(server));
+        lockServer(server);
+        UA_DataSetReader *dsr = UA_DataSetReader_find(getPSM(server), readerIdentifier);
+        ck_assert(dsr != NULL);
+        ck_assert_uint_eq(dsr->targetsSize, 1);
+        ck_assert(dsr->targets[0].type == &UA_TYPES[UA_TYPES_INT32]);
+        dsr = UA_DataSetReader_find(getPSM(server), mismatchReader);
+        ck_assert(dsr != NULL);
+        ck_assert_uint_eq(dsr->targetsSize, 1);
+        ck_assert(dsr->targets[0].type == NULL);
+        dsr = UA_DataSetReader_find(getPSM(server), readOnlyReader);
+        ck_assert(dsr != NULL);
+        ck_assert_uint_eq(dsr->targetsSize, 1);
+        ck_assert(dsr->targets[0].type == NULL);
+        unlockServer(server);
+
+        checkReceived();
+
+        /* Update the value in place */
+        UA_Int32 newValue = 4711;
+        UA_Variant v;
+        UA_Variant_setScalar(&v, &newValue, &UA_TYPES[UA_TYPES_INT32]);
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_writeValue(server, publisherNode, v));
+        checkReceived();
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+        /* Local MonitoredItems report with the publish cycle of the admin
+         * subscription */
+        for(size_t i = 0; i < 20 && directWriteLastValue != newValue; i++) {
+            UA_fakeSleep(50);
+            UA_Server_run_iterate(server, false);
+        }
+        ck_assert_uint_gt(directWriteNotifications, 0);
+        ck_assert_int_eq(directWriteLastValue, newValue);
+#endif
+
+        /* The targets are released when the reader is disabled */
+        ck_assert_int_eq(UA_STATUSCODE_GOOD,
+                         UA_Server_disableDataSetReader(server, readerIdentifier));
+        lockServer(server);
+        dsr = UA_DataSetReader_find(getPSM(server), readerIdentifier);
+        ck_assert(dsr->targets == NULL);
+        unlockServer(server);
+} END_TEST
+
+static UA_UInt32
+readUInt32(UA_UInt32 id) {
+    UA_Variant v;
+    UA_StatusCode res = UA_Server_readValue(server, UA_NODEID_NUMERIC(1, id), &v);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    UA_UInt32 out = 0;
+    if(v.type == &UA_TYPES[UA_TYPES_UINT32])
+        out = *(UA_UInt32*)v.data;
+    UA_Variant_clear(&v);
+    return out;
+}
+
+/* Process a key frame (indices == NULL) or a delta frame */
+static void
+processFrame(UA_NodeId readerId, UA_UInt16 seq, size_t count,
+             const UA_UInt16 *indices, UA_UInt32 *values) {
+    UA_DataValue fields[2];
+    UA_DataSetMessage_DeltaFrameField deltaFields[2];
+    UA_DataSetMessage dsm;
+    memset(&dsm, 0, sizeof(UA_DataSetMessage));
+    dsm.header.dataSetMessageValid = true;
+    dsm.header.dataSetMessageSequenceNrEnabled = true;
+    dsm.header.dataSetMessageSequenceNr = seq;
+    dsm.fieldCount = (UA_UInt16)count;
+    for(size_t i = 0; i < count; i++) {
+        UA_DataValue *dv = (indices) ? &deltaFields[i].value : &fields[i];
+        UA_DataValue_init(dv);
+        UA_Variant_setScalar(&dv->value, &values[i], &UA_TYPES[UA_TYPES_UINT32]);
+        dv->hasValue = true;
+        if(indices)
+            deltaFields[i].index = indices[i];
+    }
+    if(indices) {
+        dsm.header.dataSetMessageType = UA_DATASETMESSAGE_DATADELTAFRAME;
+        dsm.data.deltaFrameFields = deltaFields;
+    } else {
+        dsm.header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+        dsm.data.keyFrameFields = fields;
+    }
+    lockServer(server);
+    UA_PubSubManager *psm = getPSM(server);
+    UA_DataSetReader_process(psm, UA_DataSetReader_find(psm, readerId), &dsm);
+    unlockServer(server);
+}
+
+/* Delta frames are applied on top of the last key frame. They are discarded
+ * before the first key frame and after a gap in the sequence numbers. */
+START_TEST(SubscribeDeltaFrames) {
+        UA_ReaderGroupConfig readerGroupConfig;
+        memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+        readerGroupConfig.name = UA_STRING("ReaderGroup Test");
+        UA_StatusCode retVal =
+            UA_Server_addReaderGroup(server, connectionId, &readerGroupConfig, &readerGroupId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_DataSetReaderConfig readerConfig;
+        memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+        readerConfig.name = UA_STRING("DataSetReader Test");
+        readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+        readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+        readerConfig.writerGroupId = WRITER_GROUP_ID;
+        readerConfig.dataSetWriterId = DATASET_WRITER_ID;
+        UA_FieldMetaData fields[2];
+        for(size_t i = 0; i < 2; i++) {
+            UA_FieldMetaData_init(&fields[i]);
+            fields[i].dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+            fields[i].builtInType = UA_NS0ID_UINT32;
+            fields[i].valueRank = -1; /* scalar */
+        }
+        readerConfig.dataSetMetaData.fieldsSize = 2;
+        readerConfig.dataSetMetaData.fields = fields;
+        UA_NodeId readerIdentifier;
+        retVal = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                            &readerIdentifier);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_FieldTargetDataType targetVars[2];
+        UA_UInt32 ids[2] = {SUBSCRIBEVARIABLE_NODEID, SUBSCRIBEVARIABLE2_NODEID};
+        for(size_t i = 0; i < 2; i++) {
+            UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+            vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Subscribed UInt32");
+            vAttr.dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+            retVal = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, ids[i]), folderId,
+                                               UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                               UA_QUALIFIEDNAME(1, "Subscribed UInt32"),
+                                               UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                               vAttr, NULL, NULL);
+            ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+            UA_FieldTargetDataType_init(&targetVars[i]);
+            targetVars[i].attributeId = UA_ATTRIBUTEID_VALUE;
+            targetVars[i].targetNodeId = UA_NODEID_NUMERIC(1, ids[i]);
+        }
+        retVal = UA_Server_DataSetReader_createTargetVariables(server, readerIdentifier,
+                                                               2, targetVars);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_enableAllPubSubComponents(server));
+
+        UA_UInt16 second = 1;
+        UA_UInt16 both[2] = {0, 1};
+
+        /* Delta frame before the first key frame */
+        UA_UInt32 v1[2] = {5, 6};
+        processFrame(readerIdentifier, 10, 1, &second, v1);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 0);
+
+        /* Key frame */
+        UA_UInt32 v2[2] = {1, 2};
+        processFrame(readerIdentifier, 11, 2, NULL, v2);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 1);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 2);
+
+        /* Delta frame for the second field only */
+        UA_UInt32 v3[2] = {3, 0};
+        processFrame(readerIdentifier, 12, 1, &second, v3);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 1);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 3);
+
+        /* Repeated and outdated delta frames are discarded */
+        UA_UInt32 v4[2] = {4, 0};
+        processFrame(readerIdentifier, 12, 1, &second, v4);
+        processFrame(readerIdentifier, 9, 1, &second, v4);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 3);
+
+        /* A gap in the sequence numbers. Wait for the next key frame. */
+        UA_UInt32 v5[2] = {7, 8};
+        processFrame(readerIdentifier, 14, 2, both, v5);
+        processFrame(readerIdentifier, 15, 2, both, v5);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 1);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 3);
+
+        /* A key frame that does not match the TargetVariables is rejected and
+         * does not resynchronize the delta frames */
+        processFrame(readerIdentifier, 16, 1, NULL, v5);
+        processFrame(readerIdentifier, 17, 2, both, v5);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 1);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 3);
+
+        /* Resynchronize with a key frame. The sequence number wraps around. */
+        UA_UInt32 v6[2] = {9, 10};
+        processFrame(readerIdentifier, 0xffff, 2, NULL, v6);
+        UA_UInt16 first = 0;
+        UA_UInt32 v7[2] = {11, 0};
+        processFrame(readerIdentifier, 0, 1, &first, v7);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 11);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE2_NODEID), 10);
+
+        /* Delta frame with an index outside of the DataSet */
+        UA_UInt16 outside = 2;
+        UA_UInt32 v8[2] = {12, 0};
+        processFrame(readerIdentifier, 1, 1, &outside, v8);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 11);
+
+        /* The synchronization is reset when the reader is disabled */
+        ck_assert_int_eq(UA_STATUSCODE_GOOD,
+                         UA_Server_disableDataSetReader(server, readerIdentifier));
+        ck_assert_int_eq(UA_STATUSCODE_GOOD,
+                         UA_Server_enableDataSetReader(server, readerIdentifier));
+        UA_UInt32 v9[2] = {13, 0};
+        processFrame(readerIdentifier, 2, 1, &first, v9);
+        ck_assert_uint_eq(readUInt32(SUBSCRIBEVARIABLE_NODEID), 11);
 } END_TEST
 
 START_TEST(SinglePublishSubscribeInt32StatusCode) {
@@ -2862,6 +3350,8 @@ int main(void) {
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeDateTime);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeDateTimeRaw);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeInt32);
+    tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeDirectWrite);
+    tcase_add_test(tc_pubsub_publish_subscribe, SubscribeDeltaFrames);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeInt32StatusCode);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeInt64);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeBool);
@@ -23,6 +23,10 @@ static void setupZipTree(void) {
     ns = UA_Nodestore_ZipTree();
 }
 
+static void setupHashMap(void) {
+    ns = UA_Nodestore_HashMap();
+}
+
 static void teardown(void) {
     ns->free(ns);
 }
@@ -71,6 +75,45 @@ START_TEST(replaceOldNode) {
 }
 END_TEST
 
+START_TEST(getNodeFromDirectPointer) {
+    UA_Node *n1 = createNode(0, 2253);
+    ns->insertNode(ns, n1, NULL);
+    UA_NodeId id = UA_NODEID_NUMERIC(0, 2253);
+    const UA_Node *cached = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                        UA_REFERENCETYPESET_ALL,
+                                        UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(cached, NULL);
+
+    /* The direct pointer resolves to the same node */
+    UA_NodePointer ptr = UA_NodePointer_fromNode(&cached->head);
+    ck_assert_ptr_eq(UA_NodePointer_getNode(ptr), &cached->head);
+    UA_NodeId ptrId = UA_NodePointer_toNodeId(ptr);
+    ck_assert(UA_NodeId_equal(&ptrId, &id));
+    const UA_Node *n = ns->getNodeFromPtr(ns, ptr, ~(UA_UInt32)0,
+                                          UA_REFERENCETYPESET_ALL,
+                                          UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(n, cached);
+    ns->releaseNode(ns, n);
+
+    /* After a replace, the current node is returned */
+    UA_Node *n2;
+    ns->getNodeCopy(ns, &id, &n2);
+    ck_assert_int_eq(ns->replaceNode(ns, n2), UA_STATUSCODE_GOOD);
+    n = ns->getNodeFromPtr(ns, ptr, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(n, NULL);
+    ck_assert_ptr_ne(n, cached);
+    ns->releaseNode(ns, n);
+
+    /* After a remove, the node is no longer found */
+    ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    n = ns->getNodeFromPtr(ns, ptr, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(n, NULL);
+    ns->releaseNode(ns, cached);
+}
+END_TEST
+
 START_TEST(findNodeInUA_NodeStoreWithSingleEntry) {
     UA_Node* n1 = createNode(0,2253);
     ns->insertNode(ns, n1, NULL);
@@ -387,6 +430,84 @@ START_TEST(removeNodeThenFind) {
     ns->releaseNode(ns, nr2);
 } END_TEST
 
+START_TEST(insertRemoveManyNodes) {
+    /* Grow the table beyond its initial size, then shrink it again. Lookups
+     * must survive the rehashing and leave no stale tombstones behind. */
+    for(UA_UInt32 i = 1; i <= 5000; i++) {
+        UA_Node *n = createNode(1, i);
+        UA_StatusCode retval = ns->insertNode(ns, n, NULL);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    for(UA_UInt32 i = 1; i <= 5000; i += 2) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, i);
+        ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    }
+    for(UA_UInt32 i = 1; i <= 5000; i++) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, i);
+        const UA_Node *nr = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                        UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+        if(i % 2 == 1) {
+            ck_assert_ptr_eq(nr, NULL);
+        } else {
+            ck_assert_ptr_ne(nr, NULL);
+            ck_assert_uint_eq(nr->head.nodeId.identifier.numeric, i);
+            ns->releaseNode(ns, nr);
+        }
+    }
+    for(UA_UInt32 i = 2; i <= 5000; i += 2) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, i);
+        ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    }
+    visitCnt = 0;
+    ns->iterate(ns, checkZeroVisitor, NULL);
+    ck_assert_int_eq(visitCnt, 0);
+
+    /* Reinsert after everything was removed */
+    UA_Node *n = createNode(1, 42);
+    ck_assert_int_eq(ns->insertNode(ns, n, NULL), UA_STATUSCODE_GOOD);
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 42);
+    const UA_Node *nr = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                    UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(nr, n);
+    ns->releaseNode(ns, nr);
+} END_TEST
+
+START_TEST(removeNodeWhileReferenced) {
+    UA_Node *n = createNode(0, 11000);
+    ns->insertNode(ns, n, NULL);
+    UA_NodeId id = UA_NODEID_NUMERIC(0, 11000);
+    const UA_Node *nr = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                    UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(nr, n);
+
+    /* The node stays accessible until the last reference is released */
+    ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(nr->head.nodeId.identifier.numeric, 11000);
+    ns->releaseNode(ns, nr);
+
+    nr = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                     UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(nr, NULL);
+} END_TEST
+
+START_TEST(insertRandomNodeId) {
+    /* ns=1;i=0 is replaced by an unused random identifier */
+    UA_NodeId outIds[100];
+    for(size_t i = 0; i < 100; i++) {
+        UA_Node *n = createNode(1, 0);
+        ck_assert_int_eq(ns->insertNode(ns, n, &outIds[i]), UA_STATUSCODE_GOOD);
+        ck_assert_uint_ge(outIds[i].identifier.numeric, 50000);
+        for(size_t j = 0; j < i; j++)
+            ck_assert(!UA_NodeId_equal(&outIds[i], &outIds[j]));
+    }
+    for(size_t i = 0; i < 100; i++) {
+        const UA_Node *nr = ns->getNode(ns, &outIds[i], ~(UA_UInt32)0,
+                                        UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+        ck_assert_ptr_ne(nr, NULL);
+        ns->releaseNode(ns, nr);
+    }
+} END_TEST
+
 static Suite * namespace_suite (void) {
     Suite *s = suite_create ("UA_NodeStore");
 
@@ -403,6 +524,7 @@ static Suite * namespace_suite (void) {
     tcase_add_checked_fixture(tc_replace, setupZipTree, teardown);
     tcase_add_test (tc_replace, replaceExistingNode);
     tcase_add_test (tc_replace, replaceOldNode);
+    tcase_add_test (tc_replace, getNodeFromDirectPointer);
     suite_add_tcase (s, tc_replace);
 
     TCase* tc_iterate = tcase_create ("Iterate-ZipTree");
@@ -426,8 +548,53 @@ static Suite * namespace_suite (void) {
     tcase_add_test (tc_ext, insertNodeWithOutNodeId);
     tcase_add_test (tc_ext, iterateEmptyStore);
     tcase_add_test (tc_ext, removeNodeThenFind);
+    tcase_add_test (tc_ext, insertRemoveManyNodes);
+    tcase_add_test (tc_ext, removeNodeWhileReferenced);
+    tcase_add_test (tc_ext, insertRandomNodeId);
     suite_add_tcase (s, tc_ext);
 
+    TCase* tc_findhm = tcase_create ("Find-HashMap");
+    tcase_add_checked_fixture(tc_findhm, setupHashMap, teardown);
+    tcase_add_test (tc_findhm, findNodeInUA_NodeStoreWithSingleEntry);
+    tcase_add_test (tc_findhm, findNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_findhm, findNodeInExpandedNamespace);
+    tcase_add_test (tc_findhm, failToFindNonExistentNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_findhm, failToFindNodeInOtherUA_NodeStore);
+    suite_add_tcase (s, tc_findhm);
+
+    TCase *tc_replacehm = tcase_create("Replace-HashMap");
+    tcase_add_checked_fixture(tc_replacehm, setupHashMap, teardown);
+    tcase_add_test (tc_replacehm, replaceExistingNode);
+    tcase_add_test (tc_replacehm, replaceOldNode);
+    tcase_add_test (tc_replacehm, getNodeFromDirectPointer);
+    suite_add_tcase (s, tc_replacehm);
+
+    TCase* tc_iteratehm = tcase_create ("Iterate-HashMap");
+    tcase_add_checked_fixture(tc_iteratehm, setupHashMap, teardown);
+    tcase_add_test (tc_iteratehm, iterateOverUA_NodeStoreShallNotVisitEmptyNodes);
+    tcase_add_test (tc_iteratehm, iterateOverExpandedNamespaceShallNotVisitEmptyNodes);
+    suite_add_tcase (s, tc_iteratehm);
+
+    TCase* tc_profilehm = tcase_create ("Profile-HashMap");
+    tcase_add_checked_fixture(tc_profilehm, setupHashMap, teardown);
+    tcase_add_test (tc_profilehm, profileGetDelete);
+    suite_add_tcase (s, tc_profilehm);
+
+    TCase* tc_exthm = tcase_create ("Extended-HashMap");
+    tcase_add_checked_fixture(tc_exthm, setupHashMap, teardown);
+    tcase_add_test (tc_exthm, insertAndDeleteNode);
+    tcase_add_test (tc_exthm, insertDuplicateNode);
+    tcase_add_test (tc_exthm, getNodeCopy_modifyAndReplace);
+    tcase_add_test (tc_exthm, getNodeCopy_nonExistent);
+    tcase_add_test (tc_exthm, newNodeAllClasses);
+    tcase_add_test (tc_exthm, insertNodeWithOutNodeId);
+    tcase_add_test (tc_exthm, iterateEmptyStore);
+    tcase_add_test (tc_exthm, removeNodeThenFind);
+    tcase_add_test (tc_exthm, insertRemoveManyNodes);
+    tcase_add_test (tc_exthm, removeNodeWhileReferenced);
+    tcase_add_test (tc_exthm, insertRandomNodeId);
+    suite_add_tcase (s, tc_exthm);
+
     return s;
 }
 
@@ -585,6 +585,44 @@ START_TEST(Server_HistorizingUpdateDelete)
 }
 END_TEST
 
+START_TEST(Server_HistorizingRegisteredNode)
+{
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_Memory(1, 1);
+    UA_HistorizingNodeIdSettings setting;
+    setting.historizingBackend = backend;
+    setting.maxHistoryDataResponseSize = 1000;
+    setting.historizingUpdateStrategy = UA_HISTORIZINGUPDATESTRATEGY_USER;
+    UA_StatusCode ret = gathering->registerNodeId(server, gathering->context, &outNodeId, setting);
+    ck_assert_str_eq(UA_StatusCode_name(ret), UA_StatusCode_name(UA_STATUSCODE_GOOD));
+    ck_assert_uint_eq(fillHistoricalDataBackend(backend), true);
+
+    /* Use a handle from the RegisterNodes service in the requests */
+    UA_RegisterNodesRequest regRequest;
+    UA_RegisterNodesRequest_init(&regRequest);
+    regRequest.nodesToRegisterSize = 1;
+    regRequest.nodesToRegister = &outNodeId;
+    UA_RegisterNodesResponse regResponse;
+    UA_RegisterNodesResponse_init(&regResponse);
+    lockServer(server);
+    Service_RegisterNodes(server, &server->adminSession, &regRequest, &regResponse);
+    unlockServer(server);
+    ck_assert_uint_eq(regResponse.registeredNodeIdsSize, 1);
+    ck_assert_uint_eq(regResponse.registeredNodeIds[0].namespaceIndex,
+                      UA_REGISTEREDNODES_NS);
+    UA_NodeId nodeId = outNodeId;
+    outNodeId = regResponse.registeredNodeIds[0];
+
+    /* HistoryUpdate and HistoryRead with the handle */
+    ck_assert_str_eq(UA_StatusCode_name(deleteHistory(DELETE_START_TIME, DELETE_STOP_TIME)),
+                     UA_StatusCode_name(UA_STATUSCODE_GOOD));
+    testResult(testDataAfterDelete, NULL);
+
+    outNodeId = nodeId;
+    UA_RegisterNodesResponse_clear(&regResponse);
+    UA_HistoryDataBackend_Memory_clear(&setting.historizingBackend);
+}
+END_TEST
+
 START_TEST(Server_HistorizingUpdateInsert)
 {
     UA_HistoryDataBackend backend = UA_HistoryDataBackend_Memory(1, 1);
@@ -966,6 +1004,7 @@ testSuite_Client(void) {
     tcase_add_test(tc_server, Server_HistorizingBackendMemory);
     tcase_add_test(tc_server, Server_HistorizingRandomIndexBackend);
     tcase_add_test(tc_server, Server_HistorizingUpdateDelete);
+    tcase_add_test(tc_server, Server_HistorizingRegisteredNode);
     tcase_add_test(tc_server, Server_HistorizingUpdateInsert);
     tcase_add_test(tc_server, Server_HistorizingUpdateReplace);
     tcase_add_test(tc_server, Server_HistorizingUpdateUpdate);
@@ -8,6 +8,7 @@
 
 #include "server/ua_subscription.h"
 #include "ua_server_internal.h"
+#include "ua_services.h"
 #include "test_helpers.h"
 
 #include <check.h>
@@ -83,14 +84,336 @@ START_TEST(monitorIntegerNoChanges) {
 }
 END_TEST
 
+static size_t readCount = 0;
+static UA_Int32 counterValue = 42;
+
+static UA_StatusCode
+readCounter(UA_Server *s, const UA_NodeId *sessionId, void *sessionContext,
+            const UA_NodeId *nodeId, void *nodeContext, UA_Boolean sourceTimeStamp,
+            const UA_NumericRange *range, UA_DataValue *value) {
+    readCount++;
+    UA_Variant_setScalarCopy(&value->value, &counterValue, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+#define SAMPLING_NODES 100
+#define SAMPLING_ITEMS_PER_NODE 100
+
+/* Many cyclic MonitoredItems on few nodes with the same SamplingInterval. They
+ * are sampled from a single callback and every node is read once per cycle. */
+START_TEST(monitorManyItemsGroupedSampling) {
+    UA_DataSource counterSource;
+    counterSource.read = readCounter;
+    counterSource.write = NULL;
+
+    UA_NodeId parentNodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    UA_NodeId parentReferenceNodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    UA_StatusCode retval;
+    for(UA_UInt32 n = 0; n < SAMPLING_NODES; n++) {
+        UA_VariableAttributes attr = UA_VariableAttributes_default;
+        attr.displayName = UA_LOCALIZEDTEXT("en-US","counter");
+        retval = UA_Server_addDataSourceVariableNode(server, UA_NODEID_NUMERIC(1, 10000 + n),
+                                                     parentNodeId, parentReferenceNodeId,
+                                                     UA_QUALIFIEDNAME(1, "counter"),
+                                                     UA_NODEID_NULL, attr, counterSource,
+                                                     NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    clock_t begin, finish;
+    begin = clock();
+
+    for(UA_UInt32 n = 0; n < SAMPLING_NODES; n++) {
+        for(size_t i = 0; i < SAMPLING_ITEMS_PER_NODE; i++) {
+            UA_MonitoredItemCreateRequest item;
+            UA_MonitoredItemCreateRequest_init(&item);
+            item.itemToMonitor.nodeId = UA_NODEID_NUMERIC(1, 10000 + n);
+            item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+            item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+            item.requestedParameters.samplingInterval = 100.0;
+            UA_MonitoredItemCreateResult res =
+                UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_NEITHER,
+                                                        item, NULL,
+                                                        dataChangeNotificationCallback);
+            ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+        }
+    }
+
+    finish = clock();
+    printf("creating %d MonitoredItems took %f s\n",
+           SAMPLING_NODES * SAMPLING_ITEMS_PER_NODE,
+           (double)(finish - begin) / CLOCKS_PER_SEC);
+
+    /* All items are in the same SamplingGroup */
+    UA_SamplingGroup *sg = LIST_FIRST(&server->samplingGroups);
+    ck_assert_ptr_ne(sg, NULL);
+    ck_assert_ptr_eq(LIST_NEXT(sg, listEntry), NULL);
+    ck_assert_uint_eq(sg->liveItems, SAMPLING_NODES * SAMPLING_ITEMS_PER_NODE);
+
+    /* Every node is read once per sampling cycle. The initial value was
+     * already reported when the MonitoredItems were created. */
+    callbackCount = 0;
+    readCount = 0;
+    begin = clock();
+
+    UA_LOCK(&server->serviceMutex);
+    for(int i = 0; i < 100; i++)
+        UA_SamplingGroup_sample(server, sg);
+    UA_UNLOCK(&server->serviceMutex);
+
+    finish = clock();
+    printf("100 sampling cycles took %f s\n",
+           (double)(finish - begin) / CLOCKS_PER_SEC);
+
+    ck_assert_uint_eq(readCount, 100 * SAMPLING_NODES);
+    ck_assert_uint_eq(callbackCount, 0);
+
+    /* A changed value is shared once for all items of a node */
+    counterValue++;
+    UA_LOCK(&server->serviceMutex);
+    UA_SamplingGroup_sample(server, sg);
+    UA_UNLOCK(&server->serviceMutex);
+    UA_MonitoredItem *mon, *mon_tmp;
+    LIST_FOREACH(mon, &server->adminSubscription->monitoredItems, listEntry) {
+        UA_SharedValue *sv = mon->lastSharedValue;
+        ck_assert_ptr_ne(sv, NULL);
+        ck_assert(UA_NodeId_equal(&sv->key.nodeId, &mon->itemToMonitor.nodeId));
+        ck_assert_ptr_eq(mon->lastValue.value.data, sv->value.data);
+        ck_assert_int_eq(*(UA_Int32*)sv->value.data, counterValue);
+        ck_assert_uint_ge(sv->refCount, SAMPLING_ITEMS_PER_NODE);
+    }
+
+    /* Remove every second item. The group remains until the last item is
+     * removed. */
+    size_t i = 0;
+    LIST_FOREACH_SAFE(mon, &server->adminSubscription->monitoredItems, listEntry, mon_tmp) {
+        if(i++ % 2 == 0)
+            continue;
+        retval = UA_Server_deleteMonitoredItem(server, mon->monitoredItemId);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_ptr_eq(LIST_FIRST(&server->samplingGroups), sg);
+    ck_assert_uint_eq(sg->liveItems, SAMPLING_NODES * SAMPLING_ITEMS_PER_NODE / 2);
+
+    readCount = 0;
+    UA_LOCK(&server->serviceMutex);
+    UA_SamplingGroup_sample(server, sg);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(readCount, SAMPLING_NODES);
+    ck_assert_uint_eq(sg->itemsSize, sg->liveItems);
+
+    LIST_FOREACH_SAFE(mon, &server->adminSubscription->monitoredItems, listEntry, mon_tmp) {
+        retval = UA_Server_deleteMonitoredItem(server, mon->monitoredItemId);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    ck_assert(LIST_EMPTY(&server->samplingGroups));
+}
+END_TEST
+
+static UA_DateTime sourceTime = 0;
+
+static UA_StatusCode
+readTimestamped(UA_Server *s, const UA_NodeId *sessionId, void *sessionContext,
+                const UA_NodeId *nodeId, void *nodeContext, UA_Boolean sourceTimeStamp,
+                const UA_NumericRange *range, UA_DataValue *value) {
+    UA_Int32 val = 42;
+    UA_Variant_setScalarCopy(&value->value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    value->sourceTimestamp = sourceTime;
+    value->hasSourceTimestamp = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Items in a SamplingGroup share the sampled variant. With the
+ * StatusValueTimestamp trigger a changed SourceTimestamp is still reported
+ * when the variant is equal. */
+START_TEST(groupedSamplingSourceTimestampTrigger) {
+    UA_DataSource timestampedSource;
+    timestampedSource.read = readTimestamped;
+    timestampedSource.write = NULL;
+    sourceTime = UA_DateTime_now();
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","timestamped");
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 20000);
+    UA_StatusCode retval =
+        UA_Server_addDataSourceVariableNode(server, nodeId,
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "timestamped"),
+                                            UA_NODEID_NULL, attr, timestampedSource,
+                                            NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DataChangeFilter filter;
+    UA_DataChangeFilter_init(&filter);
+    filter.trigger = UA_DATACHANGETRIGGER_STATUSVALUETIMESTAMP;
+    for(size_t i = 0; i < 2; i++) {
+        UA_MonitoredItemCreateRequest item;
+        UA_MonitoredItemCreateRequest_init(&item);
+        item.itemToMonitor.nodeId = nodeId;
+        item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+        item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+        item.requestedParameters.samplingInterval = 100.0;
+        UA_ExtensionObject_setValue(&item.requestedParameters.filter, &filter,
+                                    &UA_TYPES[UA_TYPES_DATACHANGEFILTER]);
+        UA_MonitoredItemCreateResult res =
+            UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_BOTH,
+                                                    item, NULL,
+                                                    dataChangeNotificationCallback);
+        ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+    }
+
+    UA_SamplingGroup *sg = LIST_FIRST(&server->samplingGroups);
+    ck_assert_ptr_ne(sg, NULL);
+    ck_assert_uint_eq(sg->liveItems, 2);
+
+    /* Sample the unchanged value. The items keep the shared value. */
+    UA_LOCK(&server->serviceMutex);
+    UA_SamplingGroup_sample(server, sg);
+    UA_UNLOCK(&server->serviceMutex);
+    UA_MonitoredItem *mon;
+    LIST_FOREACH(mon, &server->adminSubscription->monitoredItems, listEntry) {
+        ck_assert_ptr_ne(mon->lastSharedValue, NULL);
+        ck_assert_int_eq(mon->lastValue.sourceTimestamp, sourceTime);
+    }
+    UA_SharedValue *sv = LIST_FIRST(&server->adminSubscription->monitoredItems)->lastSharedValue;
+
+    /* Only the SourceTimestamp changes */
+    sourceTime += UA_DATETIME_SEC;
+    UA_LOCK(&server->serviceMutex);
+    UA_SamplingGroup_sample(server, sg);
+    UA_UNLOCK(&server->serviceMutex);
+    LIST_FOREACH(mon, &server->adminSubscription->monitoredItems, listEntry) {
+        ck_assert_ptr_eq(mon->lastSharedValue, sv);
+        ck_assert_int_eq(mon->lastValue.sourceTimestamp, sourceTime);
+        ck_assert_uint_eq(mon->queueSize, 1);
+    }
+}
+END_TEST
+
+#define LOOKUP_SESSIONS 1000
+#define LOOKUP_ITEMS 10000
+
+/* Sessions, Subscriptions and MonitoredItems are resolved by their identifier
+ * for every request. The lookup must not scale with their number. */
+START_TEST(lookupManySessionsAndSubscriptions) {
+    server->config.maxSessions = LOOKUP_SESSIONS;
+
+    UA_Session **sessions = (UA_Session**)
+        UA_calloc(LOOKUP_SESSIONS, sizeof(UA_Session*));
+    UA_UInt32 *subscriptionIds = (UA_UInt32*)
+        UA_calloc(LOOKUP_SESSIONS, sizeof(UA_UInt32));
+    ck_assert_ptr_ne(sessions, NULL);
+    ck_assert_ptr_ne(subscriptionIds, NULL);
+
+    UA_LOCK(&server->serviceMutex);
+    UA_CreateSessionRequest sessionReq;
+    UA_CreateSessionRequest_init(&sessionReq);
+    for(size_t i = 0; i < LOOKUP_SESSIONS; i++) {
+        UA_StatusCode retval =
+            UA_Session_create(server, NULL, &sessionReq, &sessions[i]);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        UA_CreateSubscriptionRequest subReq;
+        UA_CreateSubscriptionRequest_init(&subReq);
+        subReq.requestedPublishingInterval = 100.0;
+        UA_CreateSubscriptionResponse subRes;
+        UA_CreateSubscriptionResponse_init(&subRes);
+        Service_CreateSubscription(server, sessions[i], &subReq, &subRes);
+        ck_assert_uint_eq(subRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+        subscriptionIds[i] = subRes.subscriptionId;
+        UA_CreateSubscriptionResponse_clear(&subRes);
+    }
+    UA_UNLOCK(&server->serviceMutex);
+
+    for(size_t i = 0; i < LOOKUP_ITEMS; i++) {
+        UA_MonitoredItemCreateRequest item;
+        UA_MonitoredItemCreateRequest_init(&item);
+        item.itemToMonitor.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE);
+        item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+        item.monitoringMode = UA_MONITORINGMODE_DISABLED;
+        UA_MonitoredItemCreateResult res =
+            UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_NEITHER,
+                                                    item, NULL,
+                                                    dataChangeNotificationCallback);
+        ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+    }
+
+    clock_t begin, finish;
+    begin = clock();
+
+    UA_LOCK(&server->serviceMutex);
+    for(int round = 0; round < 100; round++) {
+        for(size_t i = 0; i < LOOKUP_SESSIONS; i++) {
+            UA_Session *session = sessions[i];
+            ck_assert_ptr_eq(findSessionByToken(server, &session->authenticationToken),
+                             session);
+            ck_assert_ptr_eq(getSessionById(server, &session->sessionId), session);
+            UA_Subscription *sub = getSubscriptionById(server, subscriptionIds[i]);
+            ck_assert_ptr_ne(sub, NULL);
+            ck_assert_ptr_eq(sub->session, session);
+            ck_assert_ptr_eq(UA_Session_getSubscriptionById(session, subscriptionIds[i]),
+                             sub);
+        }
+    }
+    finish = clock();
+    printf("%d session and subscription lookups took %f s\n",
+           100 * LOOKUP_SESSIONS, (double)(finish - begin) / CLOCKS_PER_SEC);
+
+    begin = clock();
+    UA_Subscription *adminSub = server->adminSubscription;
+    for(int round = 0; round < 10; round++) {
+        for(UA_UInt32 id = 1; id <= LOOKUP_ITEMS; id++) {
+            UA_MonitoredItem *mon = UA_Subscription_getMonitoredItem(adminSub, id);
+            ck_assert_ptr_ne(mon, NULL);
+            ck_assert_uint_eq(mon->monitoredItemId, id);
+        }
+    }
+    finish = clock();
+    printf("%d MonitoredItem lookups took %f s\n",
+           10 * LOOKUP_ITEMS, (double)(finish - begin) / CLOCKS_PER_SEC);
+
+    /* Unknown identifiers are not found */
+    UA_NodeId unknown = UA_NODEID_GUID(1, UA_Guid_random());
+    ck_assert_ptr_eq(findSessionByToken(server, &unknown), NULL);
+    ck_assert_ptr_eq(getSessionById(server, &unknown), NULL);
+    ck_assert_ptr_eq(getSubscriptionById(server, server->lastSubscriptionId + 1), NULL);
+    ck_assert_ptr_eq(UA_Subscription_getMonitoredItem(adminSub, LOOKUP_ITEMS + 1), NULL);
+
+    /* Removed entries are no longer found */
+    UA_Session *removed = sessions[LOOKUP_SESSIONS / 2];
+    UA_NodeId removedToken = removed->authenticationToken;
+    UA_UInt32 removedSubId = subscriptionIds[LOOKUP_SESSIONS / 2];
+    UA_Session_remove(server, removed, UA_SHUTDOWNREASON_CLOSE);
+    ck_assert_ptr_eq(findSessionByToken(server, &removedToken), NULL);
+    ck_assert_ptr_eq(getSubscriptionById(server, removedSubId), NULL);
+    UA_UNLOCK(&server->serviceMutex);
+
+    ck_assert_uint_eq(UA_Server_deleteMonitoredItem(server, 1), UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(UA_Subscription_getMonitoredItem(adminSub, 1), NULL);
+
+    UA_free(sessions);
+    UA_free(subscriptionIds);
+}
+END_TEST
+
 static Suite * monitoring_speed_suite (void) {
     Suite *s = suite_create ("Monitoring Speed");
 
     TCase* tc_datachange = tcase_create ("DataChange");
     tcase_add_checked_fixture(tc_datachange, setup, teardown);
     tcase_add_test (tc_datachange, monitorIntegerNoChanges);
+    tcase_add_test (tc_datachange, monitorManyItemsGroupedSampling);
+    tcase_add_test (tc_datachange, groupedSamplingSourceTimestampTrigger);
     suite_add_tcase (s, tc_datachange);
 
+    TCase* tc_lookup = tcase_create ("Lookup");
+    tcase_add_checked_fixture(tc_lookup, setup, teardown);
+    tcase_add_test (tc_lookup, lookupManySessionsAndSubscriptions);
+    suite_add_tcase (s, tc_lookup);
+
     return s;
 }
 
@@ -1701,6 +1701,72 @@ START_TEST(DeleteReference_BidirectionalSecondDirection) {
     ck_assert_uint_ne(st, UA_STATUSCODE_GOOD);
 } END_TEST
 
+/* The subtype checks of the write path use the cached supertypes. The cache is
+ * flushed when HasSubtype references are added or removed. */
+START_TEST(SubtypeChecksFollowDataTypeHierarchy) {
+    /* Add a supertype and an intermediate type. Make Int32 a subtype of the
+     * intermediate type. */
+    UA_DataTypeAttributes dtAttr = UA_DataTypeAttributes_default;
+    dtAttr.displayName = UA_LOCALIZEDTEXT("en-US", "TestSuperType");
+    UA_NodeId superTypeId;
+    UA_StatusCode res =
+        UA_Server_addDataTypeNode(server, UA_NODEID_NULL,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                  UA_QUALIFIEDNAME(1, "TestSuperType"),
+                                  dtAttr, NULL, &superTypeId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    dtAttr.displayName = UA_LOCALIZEDTEXT("en-US", "TestMidType");
+    UA_NodeId midTypeId;
+    res = UA_Server_addDataTypeNode(server, UA_NODEID_NULL, superTypeId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                    UA_QUALIFIEDNAME(1, "TestMidType"),
+                                    dtAttr, NULL, &midTypeId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_ExpandedNodeId int32Id = UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_INT32);
+    res = UA_Server_addReference(server, midTypeId,
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                 int32Id, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Add a variable with the supertype as its DataType */
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "TestVariable");
+    vAttr.dataType = superTypeId;
+    UA_NodeId varId;
+    res = UA_Server_addVariableNode(server, UA_NODEID_NULL,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "TestVariable"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    vAttr, NULL, &varId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Int32 value = 42;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &value, &UA_TYPES[UA_TYPES_INT32]);
+    res = UA_Server_writeValue(server, varId, v);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Remove the reference */
+    res = UA_Server_deleteReference(server, midTypeId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                    true, int32Id, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_writeValue(server, varId, v);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADTYPEMISMATCH);
+
+    /* Add the reference again */
+    res = UA_Server_addReference(server, midTypeId,
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                 int32Id, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_writeValue(server, varId, v);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+} END_TEST
+
 START_TEST(SetNodeTypeLifecycle) {
     /* Set a lifecycle callback on BaseObjectType */
     UA_NodeTypeLifecycle nlc;
@@ -1993,6 +2059,7 @@ int main(void) {
     tcase_add_test(tc_addreferences, DeleteReference_InvalidRefType_rejected);
     tcase_add_test(tc_addreferences, DeleteReference_SourceNodeUnknown_rejected);
     tcase_add_test(tc_addreferences, DeleteReference_BidirectionalSecondDirection);
+    tcase_add_test(tc_addreferences, SubtypeChecksFollowDataTypeHierarchy);
     suite_add_tcase(s, tc_addreferences);
 
     TCase *tc_ext = tcase_create("extendedCoverage");
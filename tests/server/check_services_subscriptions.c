@@ -1723,6 +1723,211 @@ START_TEST(Server_dataSourceSamplingIntervalZero) {
 }
 END_TEST
 
+static UA_MonitoredItem *
+createValueMonitoredItem(UA_Session *sess, const UA_NodeId nodeId,
+                         UA_Double samplingInterval, UA_TimestampsToReturn ttr) {
+    UA_CreateSubscriptionRequest subRequest;
+    UA_CreateSubscriptionRequest_init(&subRequest);
+    subRequest.publishingEnabled = true;
+    UA_CreateSubscriptionResponse subResponse;
+    UA_CreateSubscriptionResponse_init(&subResponse);
+    lockServer(server);
+    Service_CreateSubscription(server, sess, &subRequest, &subResponse);
+    unlockServer(server);
+    ck_assert_uint_eq(subResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_UInt32 subId = subResponse.subscriptionId;
+    UA_CreateSubscriptionResponse_clear(&subResponse);
+
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId = nodeId;
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    item.requestedParameters.samplingInterval = samplingInterval;
+    item.requestedParameters.queueSize = 10;
+    UA_CreateMonitoredItemsRequest request;
+    UA_CreateMonitoredItemsRequest_init(&request);
+    request.subscriptionId = subId;
+    request.timestampsToReturn = ttr;
+    request.itemsToCreateSize = 1;
+    request.itemsToCreate = &item;
+    UA_CreateMonitoredItemsResponse response;
+    UA_CreateMonitoredItemsResponse_init(&response);
+    lockServer(server);
+    Service_CreateMonitoredItems(server, sess, &request, &response);
+    unlockServer(server);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 1);
+    ck_assert_uint_eq(response.results[0].statusCode, UA_STATUSCODE_GOOD);
+    UA_UInt32 monId = response.results[0].monitoredItemId;
+    UA_CreateMonitoredItemsResponse_clear(&response);
+
+    UA_Subscription *sub = UA_Session_getSubscriptionById(sess, subId);
+    ck_assert_ptr_ne(sub, NULL);
+    UA_MonitoredItem *mon = UA_Subscription_getMonitoredItem(sub, monId);
+    ck_assert_ptr_ne(mon, NULL);
+    return mon;
+}
+
+static UA_MonitoredItem *
+createSharedValueMonitoredItem(UA_Session *sess, const UA_NodeId nodeId) {
+    return createValueMonitoredItem(sess, nodeId, 0.0, UA_TIMESTAMPSTORETURN_BOTH);
+}
+
+static const UA_Variant *
+lastNotificationValue(UA_MonitoredItem *mon) {
+    UA_Notification *n = TAILQ_LAST(&mon->queue, NotificationQueue);
+    ck_assert_ptr_ne(n, NULL);
+    ck_assert_ptr_ne(n->sharedValue, NULL);
+    return &n->data.dataChange.value.value;
+}
+
+/* MonitoredItems of different Sessions on the same node share the variant of
+ * an equal sample in their notifications */
+START_TEST(Server_sharedNotificationValues) {
+    UA_Int32 arr[4] = {1, 2, 3, 4};
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_Variant_setArray(&vattr.value, arr, 4, &UA_TYPES[UA_TYPES_INT32]);
+    vattr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    vattr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 62200);
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, nodeId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "SharedValue"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  vattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Session *session2 = createSecondSession();
+    UA_MonitoredItem *mon1 = createSharedValueMonitoredItem(session, nodeId);
+    UA_MonitoredItem *mon2 = createSharedValueMonitoredItem(session2, nodeId);
+
+    /* The initial samples share the variant */
+    const UA_Variant *v1 = lastNotificationValue(mon1);
+    const UA_Variant *v2 = lastNotificationValue(mon2);
+    ck_assert_ptr_eq(v1->data, v2->data);
+    ck_assert_ptr_eq(mon1->lastValue.value.data, v1->data);
+    ck_assert_int_eq(((const UA_Int32*)v1->data)[3], 4);
+
+    /* The written value is shared as well */
+    arr[3] = 5;
+    UA_Variant v;
+    UA_Variant_setArray(&v, arr, 4, &UA_TYPES[UA_TYPES_INT32]);
+    res = UA_Server_writeValue(server, nodeId, v);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(mon1->queueSize, 2);
+    ck_assert_uint_eq(mon2->queueSize, 2);
+    const UA_Variant *w1 = lastNotificationValue(mon1);
+    const UA_Variant *w2 = lastNotificationValue(mon2);
+    ck_assert_ptr_eq(w1->data, w2->data);
+    ck_assert_ptr_ne(w1->data, v1->data);
+    ck_assert_int_eq(((const UA_Int32*)w1->data)[3], 5);
+
+    /* Delete the first Subscription. The second Session still holds a
+     * reference to the shared value. */
+    UA_UInt32 subId1 = mon1->subscription->subscriptionId;
+    UA_DeleteSubscriptionsRequest delRequest;
+    UA_DeleteSubscriptionsRequest_init(&delRequest);
+    delRequest.subscriptionIdsSize = 1;
+    delRequest.subscriptionIds = &subId1;
+    UA_DeleteSubscriptionsResponse delResponse;
+    UA_DeleteSubscriptionsResponse_init(&delResponse);
+    lockServer(server);
+    Service_DeleteSubscriptions(server, session, &delRequest, &delResponse);
+    unlockServer(server);
+    ck_assert_uint_eq(delResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteSubscriptionsResponse_clear(&delResponse);
+    ck_assert_int_eq(((const UA_Int32*)w2->data)[3], 5);
+
+    lockServer(server);
+    UA_Server_closeSession(server, &session2->sessionId);
+    unlockServer(server);
+} END_TEST
+
+static size_t sampledReadCount = 0;
+static UA_NodeId deniedSessionId;
+
+static UA_StatusCode
+readSampledValue(UA_Server *s, const UA_NodeId *sessionId, void *sessionContext,
+                 const UA_NodeId *nodeId, void *nodeContext, UA_Boolean sourceTimeStamp,
+                 const UA_NumericRange *range, UA_DataValue *value) {
+    sampledReadCount++;
+    UA_Int32 val = 7;
+    UA_Variant_setScalarCopy(&value->value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    value->hasValue = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_Byte
+denySessionAccessLevel(UA_Server *s, UA_AccessControl *ac,
+                       const UA_NodeId *sessionId, void *sessionContext,
+                       const UA_NodeId *nodeId, void *nodeContext) {
+    if(sessionId && UA_NodeId_equal(sessionId, &deniedSessionId))
+        return 0;
+    return 0xFF;
+}
+
+/* MonitoredItems of different Sessions with the same SamplingInterval share a
+ * single read of the value per sampling cycle. The access check and the
+ * TimestampsToReturn are applied for each item. */
+START_TEST(Server_sampleValueOnceForAllSessions) {
+    UA_DataSource dataSource;
+    dataSource.read = readSampledValue;
+    dataSource.write = NULL;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    vattr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 62201);
+    UA_StatusCode res =
+        UA_Server_addDataSourceVariableNode(server, nodeId,
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "SampledValue"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                            vattr, dataSource, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Session *session2 = createSecondSession();
+    UA_Session *session3 = createSecondSession();
+    deniedSessionId = session3->sessionId;
+    server->config.accessControl.getUserAccessLevel = denySessionAccessLevel;
+
+    UA_MonitoredItem *mon1 =
+        createValueMonitoredItem(session, nodeId, 250.0, UA_TIMESTAMPSTORETURN_SOURCE);
+    UA_MonitoredItem *mon2 =
+        createValueMonitoredItem(session2, nodeId, 250.0, UA_TIMESTAMPSTORETURN_NEITHER);
+    UA_MonitoredItem *mon3 =
+        createValueMonitoredItem(session3, nodeId, 250.0, UA_TIMESTAMPSTORETURN_BOTH);
+    ck_assert_int_eq(mon1->samplingType, UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC);
+    UA_SamplingGroup *sg = mon1->sampling.cyclic.group;
+    ck_assert_ptr_eq(mon2->sampling.cyclic.group, sg);
+    ck_assert_ptr_eq(mon3->sampling.cyclic.group, sg);
+
+    /* One read for the three Sessions */
+    sampledReadCount = 0;
+    lockServer(server);
+    UA_SamplingGroup_sample(server, sg);
+    unlockServer(server);
+    ck_assert_uint_eq(sampledReadCount, 1);
+
+    ck_assert(mon1->lastValue.hasValue);
+    ck_assert_int_eq(*(UA_Int32*)mon1->lastValue.value.data, 7);
+    ck_assert(mon1->lastValue.hasSourceTimestamp);
+    ck_assert(!mon1->lastValue.hasServerTimestamp);
+    ck_assert(mon2->lastValue.hasValue);
+    ck_assert_ptr_eq(mon2->lastValue.value.data, mon1->lastValue.value.data);
+    ck_assert(!mon2->lastValue.hasSourceTimestamp);
+    ck_assert(!mon2->lastValue.hasServerTimestamp);
+    ck_assert(!mon3->lastValue.hasValue);
+    ck_assert_uint_eq(mon3->lastValue.status, UA_STATUSCODE_BADUSERACCESSDENIED);
+
+    lockServer(server);
+    UA_Server_closeSession(server, &session2->sessionId);
+    UA_Server_closeSession(server, &session3->sessionId);
+    unlockServer(server);
+} END_TEST
+
 /* ==== Subscription / MonitoredItem limit guards (white-box) ==== */
 
 START_TEST(Server_republish_unknownSequenceNumber) {
@@ -1994,6 +2199,8 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_server, Server_subscriptionSurvivesSessionTimeoutButIsNotTransferable);
     tcase_add_test(tc_server, Server_subscriptionRecoverableWithOverride);
     tcase_add_test(tc_server, Server_dataSourceSamplingIntervalZero);
+    tcase_add_test(tc_server, Server_sharedNotificationValues);
+    tcase_add_test(tc_server, Server_sampleValueOnceForAllSessions);
     suite_add_tcase(s, tc_server);
 
     return s;
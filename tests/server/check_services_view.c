@@ -1055,6 +1055,294 @@ START_TEST(Service_UnregisterNodes_tooMany) {
     UA_Server_delete(server);
 } END_TEST
 
+static UA_NodeId
+addRegisterTestVariable(UA_Server *server, UA_Int32 value) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_Variant_setScalar(&attr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 7000);
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, id, UA_NS0ID(OBJECTSFOLDER),
+                                  UA_NS0ID(ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "registered"),
+                                  UA_NS0ID(BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return id;
+}
+
+static UA_NodeId
+registerNode(UA_Server *server, UA_NodeId id) {
+    UA_RegisterNodesRequest req;
+    UA_RegisterNodesRequest_init(&req);
+    req.nodesToRegisterSize = 1;
+    req.nodesToRegister = &id;
+    UA_RegisterNodesResponse resp;
+    UA_RegisterNodesResponse_init(&resp);
+    lockServer(server);
+    Service_RegisterNodes(server, &server->adminSession, &req, &resp);
+    unlockServer(server);
+    ck_assert_uint_eq(resp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(resp.registeredNodeIdsSize, 1);
+    UA_NodeId handle = resp.registeredNodeIds[0];
+    UA_NodeId_init(&resp.registeredNodeIds[0]);
+    UA_RegisterNodesResponse_clear(&resp);
+    return handle;
+}
+
+static UA_DataValue
+readHandle(UA_Server *server, const UA_NodeId *handle) {
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = *handle;
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    lockServer(server);
+    UA_DataValue dv = readWithSession(server, &server->adminSession, &rvi,
+                                      UA_TIMESTAMPSTORETURN_NEITHER);
+    unlockServer(server);
+    return dv;
+}
+
+START_TEST(Service_RegisterNodes_handleReadWrite) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_NodeId id = addRegisterTestVariable(server, 42);
+
+    /* The handle is a compact numeric NodeId */
+    UA_NodeId handle = registerNode(server, id);
+    ck_assert_uint_eq(handle.identifierType, UA_NODEIDTYPE_NUMERIC);
+    ck_assert_uint_eq(handle.namespaceIndex, UA_REGISTEREDNODES_NS);
+
+    /* Read via the handle */
+    UA_DataValue dv = readHandle(server, &handle);
+    ck_assert(dv.hasValue);
+    ck_assert_int_eq(*(UA_Int32*)dv.value.data, 42);
+    UA_DataValue_clear(&dv);
+
+    /* Write via the handle */
+    UA_Int32 newValue = 43;
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = handle;
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    wv.value.hasValue = true;
+    UA_Variant_setScalar(&wv.value.value, &newValue, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    lockServer(server);
+    Operation_Write(server, &server->adminSession, &wv, &res);
+    unlockServer(server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Variant value;
+    res = UA_Server_readValue(server, id, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)value.data, 43);
+    UA_Variant_clear(&value);
+
+    /* Browse via the handle */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = handle;
+    bd.browseDirection = UA_BROWSEDIRECTION_BOTH;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(br.referencesSize, 0);
+    UA_BrowseResult_clear(&br);
+
+    /* The handle is no longer valid after unregistering */
+    UA_UnregisterNodesRequest ureq;
+    UA_UnregisterNodesRequest_init(&ureq);
+    ureq.nodesToUnregisterSize = 1;
+    ureq.nodesToUnregister = &handle;
+    UA_UnregisterNodesResponse uresp;
+    UA_UnregisterNodesResponse_init(&uresp);
+    lockServer(server);
+    Service_UnregisterNodes(server, &server->adminSession, &ureq, &uresp);
+    unlockServer(server);
+    ck_assert_uint_eq(uresp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_UnregisterNodesResponse_clear(&uresp);
+
+    dv = readHandle(server, &handle);
+    ck_assert(dv.hasStatus);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue_clear(&dv);
+
+    /* The entry is reused with a different handle */
+    UA_NodeId handle2 = registerNode(server, id);
+    ck_assert(!UA_NodeId_equal(&handle, &handle2));
+    dv = readHandle(server, &handle2);
+    ck_assert(dv.hasValue);
+    UA_DataValue_clear(&dv);
+
+    /* Registered nodes are released when the server is deleted */
+    UA_Server_delete(server);
+} END_TEST
+
+START_TEST(Service_RegisterNodes_nodeRemovedAndReadded) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_NodeId id = addRegisterTestVariable(server, 42);
+    UA_NodeId handle = registerNode(server, id);
+
+    /* The cached node is removed */
+    UA_StatusCode res = UA_Server_deleteNode(server, id, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_DataValue dv = readHandle(server, &handle);
+    ck_assert(dv.hasStatus);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue_clear(&dv);
+
+    /* A new node with the same NodeId is found with the handle */
+    addRegisterTestVariable(server, 44);
+    dv = readHandle(server, &handle);
+    ck_assert(dv.hasValue);
+    ck_assert_int_eq(*(UA_Int32*)dv.value.data, 44);
+    UA_DataValue_clear(&dv);
+
+    UA_Server_delete(server);
+} END_TEST
+
+START_TEST(Service_RegisterNodes_nodeManagement) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_NodeId id = addRegisterTestVariable(server, 46);
+    UA_NodeId handle = registerNode(server, id);
+    UA_NodeId objectsHandle = registerNode(server, UA_NS0ID(OBJECTSFOLDER));
+    UA_NodeId refTypeHandle = registerNode(server, UA_NS0ID(HASCOMPONENT));
+
+    /* Add and delete a reference between handles */
+    UA_AddReferencesItem addRef;
+    UA_AddReferencesItem_init(&addRef);
+    addRef.sourceNodeId = objectsHandle;
+    addRef.referenceTypeId = refTypeHandle;
+    addRef.isForward = true;
+    addRef.targetNodeId.nodeId = handle;
+    addRef.targetNodeClass = UA_NODECLASS_VARIABLE;
+    UA_AddReferencesRequest addRefReq;
+    UA_AddReferencesRequest_init(&addRefReq);
+    addRefReq.referencesToAddSize = 1;
+    addRefReq.referencesToAdd = &addRef;
+    UA_AddReferencesResponse addRefResp;
+    UA_AddReferencesResponse_init(&addRefResp);
+    lockServer(server);
+    Service_AddReferences(server, &server->adminSession, &addRefReq, &addRefResp);
+    unlockServer(server);
+    ck_assert_uint_eq(addRefResp.resultsSize, 1);
+    ck_assert_uint_eq(addRefResp.results[0], UA_STATUSCODE_GOOD);
+    UA_AddReferencesResponse_clear(&addRefResp);
+
+    UA_DeleteReferencesItem delRef;
+    UA_DeleteReferencesItem_init(&delRef);
+    delRef.sourceNodeId = objectsHandle;
+    delRef.referenceTypeId = refTypeHandle;
+    delRef.isForward = true;
+    delRef.targetNodeId.nodeId = handle;
+    delRef.deleteBidirectional = true;
+    UA_DeleteReferencesRequest delRefReq;
+    UA_DeleteReferencesRequest_init(&delRefReq);
+    delRefReq.referencesToDeleteSize = 1;
+    delRefReq.referencesToDelete = &delRef;
+    UA_DeleteReferencesResponse delRefResp;
+    UA_DeleteReferencesResponse_init(&delRefResp);
+    lockServer(server);
+    Service_DeleteReferences(server, &server->adminSession, &delRefReq, &delRefResp);
+    unlockServer(server);
+    ck_assert_uint_eq(delRefResp.resultsSize, 1);
+    ck_assert_uint_eq(delRefResp.results[0], UA_STATUSCODE_GOOD);
+    UA_DeleteReferencesResponse_clear(&delRefResp);
+
+    /* Add a node below a handle */
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    UA_AddNodesItem addNode;
+    UA_AddNodesItem_init(&addNode);
+    addNode.parentNodeId.nodeId = objectsHandle;
+    addNode.referenceTypeId = UA_NS0ID(ORGANIZES);
+    addNode.requestedNewNodeId.nodeId = UA_NODEID_NUMERIC(1, 7001);
+    addNode.browseName = UA_QUALIFIEDNAME(1, "below handle");
+    addNode.nodeClass = UA_NODECLASS_OBJECT;
+    UA_ExtensionObject_setValue(&addNode.nodeAttributes, &oAttr,
+                                &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES]);
+    addNode.typeDefinition.nodeId = UA_NS0ID(BASEOBJECTTYPE);
+    UA_AddNodesRequest addNodeReq;
+    UA_AddNodesRequest_init(&addNodeReq);
+    addNodeReq.nodesToAddSize = 1;
+    addNodeReq.nodesToAdd = &addNode;
+    UA_AddNodesResponse addNodeResp;
+    UA_AddNodesResponse_init(&addNodeResp);
+    lockServer(server);
+    Service_AddNodes(server, &server->adminSession, &addNodeReq, &addNodeResp);
+    unlockServer(server);
+    ck_assert_uint_eq(addNodeResp.resultsSize, 1);
+    ck_assert_uint_eq(addNodeResp.results[0].statusCode, UA_STATUSCODE_GOOD);
+    UA_AddNodesResponse_clear(&addNodeResp);
+
+    /* Delete the node of a handle */
+    UA_DeleteNodesItem delNode;
+    UA_DeleteNodesItem_init(&delNode);
+    delNode.nodeId = handle;
+    delNode.deleteTargetReferences = true;
+    UA_DeleteNodesRequest delNodeReq;
+    UA_DeleteNodesRequest_init(&delNodeReq);
+    delNodeReq.nodesToDeleteSize = 1;
+    delNodeReq.nodesToDelete = &delNode;
+    UA_DeleteNodesResponse delNodeResp;
+    UA_DeleteNodesResponse_init(&delNodeResp);
+    lockServer(server);
+    Service_DeleteNodes(server, &server->adminSession, &delNodeReq, &delNodeResp);
+    unlockServer(server);
+    ck_assert_uint_eq(delNodeResp.resultsSize, 1);
+    ck_assert_uint_eq(delNodeResp.results[0], UA_STATUSCODE_GOOD);
+    UA_DeleteNodesResponse_clear(&delNodeResp);
+
+    UA_DataValue dv = readHandle(server, &handle);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue_clear(&dv);
+
+    UA_Server_delete(server);
+} END_TEST
+
+START_TEST(Service_RegisterNodes_unknownNode) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    /* Unknown NodeIds can be registered and resolve once the node exists */
+    UA_NodeId handle = registerNode(server, UA_NODEID_NUMERIC(1, 7000));
+    ck_assert_uint_eq(handle.namespaceIndex, UA_REGISTEREDNODES_NS);
+    UA_DataValue dv = readHandle(server, &handle);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue_clear(&dv);
+
+    addRegisterTestVariable(server, 45);
+    dv = readHandle(server, &handle);
+    ck_assert(dv.hasValue);
+    ck_assert_int_eq(*(UA_Int32*)dv.value.data, 45);
+    UA_DataValue_clear(&dv);
+
+    UA_Server_delete(server);
+} END_TEST
+
+START_TEST(Service_RegisterNodes_tableFull) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    /* The default covers large tag lists */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    ck_assert_uint_ge(config->maxRegisteredNodesPerSession, 20000);
+
+    /* When the table is full, the NodeId itself is returned */
+    config->maxRegisteredNodesPerSession = 100;
+    UA_NodeId id = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    for(size_t i = 0; i < 100; i++) {
+        UA_NodeId handle = registerNode(server, id);
+        ck_assert_uint_eq(handle.namespaceIndex, UA_REGISTEREDNODES_NS);
+    }
+    UA_NodeId fallback = registerNode(server, id);
+    ck_assert(UA_NodeId_equal(&fallback, &id));
+
+    UA_Server_delete(server);
+} END_TEST
+
 START_TEST(Service_TranslateBrowsePathsToNodeIds_maxNodesPerTranslate) {
     /* src/server/ua_services_view.c:1429-1433:
      *   if(maxNodesPerTranslateBrowsePathsToNodeIds != 0 &&
@@ -1166,6 +1454,11 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     tcase_add_test(tc_view_edge, Service_RegisterNodes_tooMany);
     tcase_add_test(tc_view_edge, Service_UnregisterNodes_emptyList_returnsNothingToDo);
     tcase_add_test(tc_view_edge, Service_UnregisterNodes_tooMany);
+    tcase_add_test(tc_view_edge, Service_RegisterNodes_handleReadWrite);
+    tcase_add_test(tc_view_edge, Service_RegisterNodes_nodeRemovedAndReadded);
+    tcase_add_test(tc_view_edge, Service_RegisterNodes_nodeManagement);
+    tcase_add_test(tc_view_edge, Service_RegisterNodes_unknownNode);
+    tcase_add_test(tc_view_edge, Service_RegisterNodes_tableFull);
     tcase_add_test(tc_view_edge, Service_TranslateBrowsePathsToNodeIds_maxNodesPerTranslate);
     tcase_add_test(tc_view_edge, BrowseSimplifiedBrowsePath_tooLong_returnsInternalError);
     suite_add_tcase(s, tc_view_edge);
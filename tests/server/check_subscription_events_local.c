@@ -264,6 +264,78 @@ START_TEST(generateEvents) {
     ck_assert_uint_eq(callbackCount, 3);
 } END_TEST
 
+static void
+createSourceEvent(const UA_NodeId source) {
+    UA_LocalizedText message = UA_LOCALIZEDTEXT("en-US", "Generated Event");
+    UA_StatusCode res = UA_Server_createEvent(server, source, eventType,
+                                              100, message, NULL, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+/* Without Event MonitoredItems the event is not routed. With a listener the
+ * route is cached. Adding and removing references flushes the cache. */
+START_TEST(eventRouteCache) {
+    const UA_NodeId notifierId = UA_NODEID_NUMERIC(1, 6100);
+    const UA_NodeId sourceId = UA_NODEID_NUMERIC(1, 6101);
+    addObject(sourceId, "RouteSource");
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    attr.eventNotifier = UA_EVENTNOTIFIER_SUBSCRIBE_TO_EVENT;
+    UA_StatusCode retval =
+        UA_Server_addObjectNode(server, notifierId, UA_NS0ID(OBJECTSFOLDER),
+                                UA_NS0ID(ORGANIZES), UA_QUALIFIEDNAME(1, "RouteNotifier"),
+                                UA_NS0ID(BASEOBJECTTYPE), attr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    ck_assert_uint_eq(server->eventMonitoredItemsSize, 0);
+    createSourceEvent(sourceId);
+    ck_assert_uint_eq(server->eventRoutesSize, 0);
+
+    UA_EventFilter ef;
+    UA_EventFilter_init(&ef);
+    ef.selectClauses = (UA_SimpleAttributeOperand *)
+        UA_Array_new(1, &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]);
+    ef.selectClausesSize = 1;
+    UA_SimpleAttributeOperand_parse(&ef.selectClauses[0], UA_STRING("/Severity"));
+    UA_MonitoredItemCreateResult res =
+        UA_Server_createEventMonitoredItem(server, notifierId, ef, NULL, eventCallback);
+    ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+    UA_EventFilter_clear(&ef);
+    ck_assert_uint_eq(server->eventMonitoredItemsSize, 1);
+
+    /* The source is not connected to the notifier */
+    callbackCount = 0;
+    createSourceEvent(sourceId);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(callbackCount, 0);
+    ck_assert_uint_eq(server->eventRoutesSize, 1);
+
+    /* Connect the source. The cached route is flushed. */
+    retval = UA_Server_addReference(server, notifierId, UA_NS0ID(HASEVENTSOURCE),
+                                    UA_EXPANDEDNODEID_NUMERIC(1, 6101), true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(server->eventRoutesSize, 0);
+
+    createSourceEvent(sourceId);
+    createSourceEvent(sourceId);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(callbackCount, 2);
+    ck_assert_uint_eq(server->eventRoutesSize, 1);
+
+    /* Disconnect the source again */
+    retval = UA_Server_deleteReference(server, notifierId, UA_NS0ID(HASEVENTSOURCE),
+                                       true, UA_EXPANDEDNODEID_NUMERIC(1, 6101), true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(server->eventRoutesSize, 0);
+
+    createSourceEvent(sourceId);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(callbackCount, 2);
+
+    retval = UA_Server_deleteMonitoredItem(server, res.monitoredItemId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(server->eventMonitoredItemsSize, 0);
+} END_TEST
+
 /* ==== UA_Server_createEventMonitoredItemEx input-validation guards ==== */
 
 START_TEST(Server_createEventMonitoredItemEx_wrongAttribute) {
@@ -875,6 +947,11 @@ static Suite *testSuite_event(void) {
     tcase_add_unchecked_fixture(tc_subtype, setup, teardown);
     tcase_add_test(tc_subtype, semanticChangeHasPropertySubtype);
     suite_add_tcase(s, tc_subtype);
+
+    TCase *tc_route = tcase_create("Event Route Cache");
+    tcase_add_unchecked_fixture(tc_route, setup, teardown);
+    tcase_add_test(tc_route, eventRouteCache);
+    suite_add_tcase(s, tc_route);
     return s;
 }
 
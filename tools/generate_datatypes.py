@@ -163,6 +163,64 @@ def splitNodeidNs(nodeId):
         return parts[0][3:], parts[1] if len(parts) > 1 else ""
     return "0", nodeId
 
+def getNumericNodeid(nodeId):
+    """Returns (namespaceindex, numeric identifier) or None for non-numeric
+    NodeIds."""
+    nsIdx, bareNodeId = splitNodeidNs(nodeId)
+    if not bareNodeId:
+        return (int(nsIdx), 0)
+    if bareNodeId.startswith("i="):
+        bareNodeId = bareNodeId[2:]
+    if '=' in bareNodeId:
+        return None
+    return (int(nsIdx), int(bareNodeId))
+
+# Perfect hashing (hash-and-displace) of numeric NodeId identifiers to an index
+# in the types array. The lookup in ua_types.c uses the identical hash
+# functions. The keys are first distributed into buckets. For each bucket (the
+# largest first) a displacement is searched such that all keys of the bucket
+# land in free slots.
+PERFECTHASH_MULT1 = 0x9E3779B1
+PERFECTHASH_MULT2 = 0x85EBCA6B
+
+def perfecthash_bucket(key, bucketBits):
+    return ((key * PERFECTHASH_MULT1) & 0xFFFFFFFF) >> (32 - bucketBits)
+
+def perfecthash_slot(key, disp, slotBits):
+    d = (disp * PERFECTHASH_MULT1) & 0xFFFFFFFF
+    return (((key ^ d) * PERFECTHASH_MULT2) & 0xFFFFFFFF) >> (32 - slotBits)
+
+def perfecthash_create(keys):
+    """keys is a list of (key, index) with unique keys. Returns (bucketBits,
+    slotBits, displacements, slots)."""
+    slotBits = max(2, (len(keys) - 1).bit_length())
+    while slotBits < 24:
+        bucketBits = slotBits - 1
+        buckets = [[] for _ in range(1 << bucketBits)]
+        for key, index in keys:
+            buckets[perfecthash_bucket(key, bucketBits)].append((key, index))
+        order = sorted(range(len(buckets)), key=lambda b: -len(buckets[b]))
+        slots = [0xFFFF] * (1 << slotBits)
+        disp = [0] * len(buckets)
+        success = True
+        for b in order:
+            if len(buckets[b]) == 0:
+                break
+            for d in range(0xFFFF):
+                pos = [perfecthash_slot(key, d, slotBits) for key, _ in buckets[b]]
+                if len(set(pos)) == len(pos) and all(slots[x] == 0xFFFF for x in pos):
+                    break
+            else:
+                success = False
+                break
+            disp[b] = d
+            for x, (_, index) in zip(pos, buckets[b]):
+                slots[x] = index
+        if success:
+            return (bucketBits, slotBits, disp, slots)
+        slotBits += 1
+    raise RuntimeError("Could not create a perfect hash for the type identifiers")
+
 def _types_definition_equal(t1, t2):
     """Compare two Type objects by structural definition (ignoring nodeId/outname).
     Used to detect cross-namespace same-name types that are ABI-compatible vs
@@ -201,6 +259,7 @@ class CGenerator:
         self.fc = None
         self.fd = None
         self.fe = None
+        self.perfecthash_tables = {}
 
     @staticmethod
     def get_type_index(datatype):
@@ -473,6 +532,7 @@ class CGenerator:
         self.fc = open(self.outfile + "_generated.c", 'w')
 
         self.filtered_types = self.iter_types(self.parser.types)
+        self.create_perfecthash()
 
         self.print_header()
         self.print_description_array()
@@ -620,6 +680,18 @@ _UA_BEGIN_DECLS
         else:
             self.printh("#define UA_" + self.parser.outname.upper() + " NULL")
 
+        if self.has_perfecthash():
+            self.printh('''
+/* Perfect hash tables mapping the numeric typeId and binaryEncodingId (in
+ * namespace zero) to the index in UA_TYPES. Used for the O(1) lookup of
+ * UA_findDataType and during the decoding of ExtensionObjects. */''')
+            for name, keys in self.perfecthash_keys():
+                (bucketBits, slotBits, _, _) = self.perfecthash_tables[name]
+                self.printh("#define UA_TYPES_%s_HASH_BUCKETBITS %d" % (name, bucketBits))
+                self.printh("#define UA_TYPES_%s_HASH_SLOTBITS %d" % (name, slotBits))
+                self.printh("extern const UA_UInt16 UA_TYPES_%s_HASH_DISP[%d];" % (name, 1 << bucketBits))
+                self.printh("extern const UA_UInt16 UA_TYPES_%s_HASH_SLOTS[%d];" % (name, 1 << slotBits))
+
         self.printh('''
 _UA_END_DECLS
 
@@ -667,6 +739,63 @@ _UA_END_DECLS
                     self.printc(self.print_datatype(t) + ",")
             self.printc("};\n")
 
+        if self.has_perfecthash():
+            for name, _ in self.perfecthash_keys():
+                (bucketBits, slotBits, disp, slots) = self.perfecthash_tables[name]
+                self.printc("const UA_UInt16 UA_TYPES_%s_HASH_DISP[%d] = {" % (name, 1 << bucketBits))
+                self.printc(self.print_uint16_table(disp))
+                self.printc("};\n")
+                self.printc("const UA_UInt16 UA_TYPES_%s_HASH_SLOTS[%d] = {" % (name, 1 << slotBits))
+                self.printc(self.print_uint16_table(slots))
+                self.printc("};\n")
+
+    @staticmethod
+    def print_uint16_table(values):
+        lines = []
+        for i in range(0, len(values), 12):
+            lines.append("    " + ", ".join(str(v) for v in values[i:i+12]) + ",")
+        return "\n".join(lines)
+
+    # The perfect hash tables are only generated for the namespace zero types
+    # in UA_TYPES. These are looked up by UA_findDataType.
+    def has_perfecthash(self):
+        return self.parser.outname == "types" and len(self.perfecthash_tables) > 0
+
+    def perfecthash_keys(self):
+        typeIds = []
+        binaryIds = []
+        seenTypeIds = set()
+        seenBinaryIds = set()
+        index = 0
+        for ns in self.filtered_types:
+            for t_name in self.filtered_types[ns]:
+                t = self.filtered_types[ns][t_name]
+                typeId = getNumericNodeid(t.nodeId)
+                binaryId = getNumericNodeid(t.binaryEncodingId)
+                if typeId is None or typeId[0] != 0 or \
+                   binaryId is None or binaryId[0] != 0:
+                    raise RuntimeError("The type %s in UA_TYPES does not have a numeric "
+                                       "NodeId in namespace zero" % t.name)
+                # Keep the first occurrence (same as a linear search)
+                if typeId[1] not in seenTypeIds:
+                    seenTypeIds.add(typeId[1])
+                    typeIds.append((typeId[1], index))
+                if binaryId[1] not in seenBinaryIds:
+                    seenBinaryIds.add(binaryId[1])
+                    binaryIds.append((binaryId[1], index))
+                index += 1
+        return [("TYPEID", typeIds), ("BINARYID", binaryIds)]
+
+    def create_perfecthash(self):
+        self.perfecthash_tables = {}
+        if self.parser.outname != "types":
+            return
+        for name, keys in self.perfecthash_keys():
+            if len(keys) == 0:
+                self.perfecthash_tables = {}
+                return
+            self.perfecthash_tables[name] = perfecthash_create(keys)
+
 ###########################################
 # Execute with the command line arguments #
 ###########################################